@@ -0,0 +1,1980 @@
+/*
+ * SPDX-License-Identifier: Apache-2.0 OR MIT
+ *
+ * Runtime for the C++ that SHADERed's SPIRV-Cross C++ backend (src/SHADERed/Objects/Debug/CompilerCPP.cpp) generates
+ * from a pixel shader. SHADERed builds the generated code into a shared library so that the frame
+ * analysis can run the shader natively instead of through the SPIR-V VM.
+ *
+ * GLSL types and built-ins are implemented on top of plain C++17, the host talks to the library
+ * through the C interface at the bottom of this file.
+ */
+
+#ifndef SPIRV_CROSS_RUNTIME_HPP
+#define SPIRV_CROSS_RUNTIME_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <type_traits>
+#include <utility>
+
+#define SPIRV_CROSS_INTERFACE_VERSION 1
+
+#ifdef _WIN32
+#define SPIRV_CROSS_EXPORT __declspec(dllexport)
+#else
+#define SPIRV_CROSS_EXPORT __attribute__((visibility("default")))
+#endif
+
+extern "C"
+{
+	// statistics of one invocation - the host zeroes them before calling invoke()
+	typedef struct spirv_cross_stats
+	{
+		uint32_t instruction_count;
+		uint32_t line;
+		uint32_t ub_last_type; // spirv_cross_runtime::ub_*
+		uint32_t ub_last_line;
+		uint32_t ub_count;
+	} spirv_cross_stats;
+
+	enum spirv_cross_resource_kind
+	{
+		SPIRV_CROSS_RESOURCE_INPUT = 0,
+		SPIRV_CROSS_RESOURCE_OUTPUT = 1,
+		SPIRV_CROSS_RESOURCE_UNIFORM = 2,
+		SPIRV_CROSS_RESOURCE_IMAGE = 3
+	};
+
+	typedef struct spirv_cross_resource
+	{
+		uint32_t id; // SPIR-V ID of the variable
+		uint32_t kind;
+		int32_t location; // -1 if not decorated
+		const char *name;
+	} spirv_cross_resource;
+
+	// values are streamed as 8 byte slots, one per scalar in declaration order (struct members,
+	// array elements, matrix columns, vector components) - each slot holds the value in its first bytes
+	typedef struct spirv_cross_interface
+	{
+		uint32_t version;
+		uint32_t resource_count;
+		const spirv_cross_resource *resources;
+
+		void *(*create)(void);
+		void (*destroy)(void *shader);
+		uint32_t (*write)(void *shader, uint32_t resource, const uint64_t *values, uint32_t count);
+		uint32_t (*read)(void *shader, uint32_t resource, uint64_t *values, uint32_t count);
+		void (*bind_image)(void *shader, uint32_t resource, const float *texels, int32_t width, int32_t height,
+		                   int32_t depth); // RGBA32F, cube maps have 6 layers
+		int32_t (*invoke)(void *shader, const float *frag_coord, spirv_cross_stats *stats); // 0 -> discarded
+	} spirv_cross_interface;
+
+	typedef const spirv_cross_interface *(*spirv_cross_get_interface_fn)(void);
+}
+
+namespace spirv_cross_runtime
+{
+enum ub_type : uint32_t
+{
+	ub_none = 0,
+	ub_div_by_zero,
+	ub_mod_by_zero,
+	ub_image_read_out_of_bounds,
+	ub_vector_extract_dynamic,
+	ub_asin,
+	ub_acos,
+	ub_acosh,
+	ub_atanh,
+	ub_atan2,
+	ub_pow,
+	ub_log,
+	ub_log2,
+	ub_sqrt,
+	ub_inverse_sqrt,
+	ub_fmin,
+	ub_fmax,
+	ub_clamp,
+	ub_smoothstep,
+	ub_frexp,
+	ub_ldexp
+};
+
+inline spirv_cross_stats *&current_stats()
+{
+	static thread_local spirv_cross_stats *stats = nullptr;
+	return stats;
+}
+
+inline void report(ub_type type)
+{
+	spirv_cross_stats *stats = current_stats();
+	if (stats)
+	{
+		stats->ub_last_type = type;
+		stats->ub_last_line = stats->line;
+		stats->ub_count++;
+	}
+}
+
+struct discard_exception
+{
+};
+
+[[noreturn]] inline void discard_invocation()
+{
+	throw discard_exception();
+}
+
+// vectors
+template <typename T, int N>
+struct vec_storage;
+
+template <typename T>
+struct vec_storage<T, 2>
+{
+	T x, y;
+};
+
+template <typename T>
+struct vec_storage<T, 3>
+{
+	T x, y, z;
+};
+
+template <typename T>
+struct vec_storage<T, 4>
+{
+	T x, y, z, w;
+};
+
+template <typename T, int N>
+struct vec;
+
+template <typename T>
+struct component_count
+{
+	static constexpr int value = 1;
+};
+
+template <typename T, int N>
+struct component_count<vec<T, N>>
+{
+	static constexpr int value = N;
+};
+
+#define SPIRV_CROSS_INDEX_x 0
+#define SPIRV_CROSS_INDEX_y 1
+#define SPIRV_CROSS_INDEX_z 2
+#define SPIRV_CROSS_INDEX_w 3
+
+#define SPIRV_CROSS_SWIZZLE2(a, b)                                               \
+	vec<T, 2> a##b() const                                                       \
+	{                                                                            \
+		return swizzle<2>(SPIRV_CROSS_INDEX_##a, SPIRV_CROSS_INDEX_##b, 0, 0); \
+	}
+#define SPIRV_CROSS_SWIZZLE3(a, b, c)                                                                \
+	vec<T, 3> a##b##c() const                                                                        \
+	{                                                                                                \
+		return swizzle<3>(SPIRV_CROSS_INDEX_##a, SPIRV_CROSS_INDEX_##b, SPIRV_CROSS_INDEX_##c, 0); \
+	}
+#define SPIRV_CROSS_SWIZZLE4(a, b, c, d)                                                                                 \
+	vec<T, 4> a##b##c##d() const                                                                                         \
+	{                                                                                                                    \
+		return swizzle<4>(SPIRV_CROSS_INDEX_##a, SPIRV_CROSS_INDEX_##b, SPIRV_CROSS_INDEX_##c, SPIRV_CROSS_INDEX_##d); \
+	}
+
+#define SPIRV_CROSS_SWIZZLES2(a) \
+	SPIRV_CROSS_SWIZZLE2(a, x) SPIRV_CROSS_SWIZZLE2(a, y) SPIRV_CROSS_SWIZZLE2(a, z) SPIRV_CROSS_SWIZZLE2(a, w)
+#define SPIRV_CROSS_SWIZZLES3_(a, b) \
+	SPIRV_CROSS_SWIZZLE3(a, b, x) SPIRV_CROSS_SWIZZLE3(a, b, y) SPIRV_CROSS_SWIZZLE3(a, b, z) SPIRV_CROSS_SWIZZLE3(a, b, w)
+#define SPIRV_CROSS_SWIZZLES3(a) \
+	SPIRV_CROSS_SWIZZLES3_(a, x) SPIRV_CROSS_SWIZZLES3_(a, y) SPIRV_CROSS_SWIZZLES3_(a, z) SPIRV_CROSS_SWIZZLES3_(a, w)
+#define SPIRV_CROSS_SWIZZLES4__(a, b, c)                                                               \
+	SPIRV_CROSS_SWIZZLE4(a, b, c, x) SPIRV_CROSS_SWIZZLE4(a, b, c, y) SPIRV_CROSS_SWIZZLE4(a, b, c, z) \
+	    SPIRV_CROSS_SWIZZLE4(a, b, c, w)
+#define SPIRV_CROSS_SWIZZLES4_(a, b)                                                       \
+	SPIRV_CROSS_SWIZZLES4__(a, b, x) SPIRV_CROSS_SWIZZLES4__(a, b, y) SPIRV_CROSS_SWIZZLES4__(a, b, z) \
+	    SPIRV_CROSS_SWIZZLES4__(a, b, w)
+#define SPIRV_CROSS_SWIZZLES4(a) \
+	SPIRV_CROSS_SWIZZLES4_(a, x) SPIRV_CROSS_SWIZZLES4_(a, y) SPIRV_CROSS_SWIZZLES4_(a, z) SPIRV_CROSS_SWIZZLES4_(a, w)
+
+template <typename T, int N>
+struct vec : vec_storage<T, N>
+{
+	vec() = default;
+
+	explicit vec(T s)
+	{
+		for (int i = 0; i < N; i++)
+			at(i) = s;
+	}
+
+	// conversions and truncation, vec3(v4)
+	template <typename U, int M, typename = typename std::enable_if<(M >= N)>::type>
+	explicit vec(const vec<U, M> &v)
+	{
+		for (int i = 0; i < N; i++)
+			at(i) = T(v.at(i));
+	}
+
+	// vec4(v2, z, w) and friends
+	template <typename A, typename B, typename... Rest>
+	vec(const A &a, const B &b, const Rest &... rest)
+	{
+		static_assert(component_count<A>::value + component_count<B>::value + (0 + ... + component_count<Rest>::value) >= N,
+		              "Not enough components to construct a vector.");
+		int i = 0;
+		fill(i, a);
+		fill(i, b);
+		(fill(i, rest), ...);
+	}
+
+	T &at(int i)
+	{
+		return (&this->x)[i];
+	}
+
+	const T &at(int i) const
+	{
+		return (&this->x)[i];
+	}
+
+	// dynamic indexing - out of range reads and writes go to a dummy component
+	T &operator[](int i)
+	{
+		if (uint32_t(i) >= uint32_t(N))
+		{
+			report(ub_vector_extract_dynamic);
+			static thread_local T dummy;
+			dummy = T(0);
+			return dummy;
+		}
+		return at(i);
+	}
+
+	const T &operator[](int i) const
+	{
+		return const_cast<vec &>(*this)[i];
+	}
+
+	template <typename U>
+	vec &operator+=(const U &v)
+	{
+		return *this = *this + v;
+	}
+	template <typename U>
+	vec &operator-=(const U &v)
+	{
+		return *this = *this - v;
+	}
+	template <typename U>
+	vec &operator*=(const U &v)
+	{
+		return *this = *this * v;
+	}
+	template <typename U>
+	vec &operator/=(const U &v)
+	{
+		return *this = *this / v;
+	}
+	template <typename U>
+	vec &operator%=(const U &v)
+	{
+		return *this = *this % v;
+	}
+	template <typename U>
+	vec &operator&=(const U &v)
+	{
+		return *this = *this & v;
+	}
+	template <typename U>
+	vec &operator|=(const U &v)
+	{
+		return *this = *this | v;
+	}
+	template <typename U>
+	vec &operator^=(const U &v)
+	{
+		return *this = *this ^ v;
+	}
+	template <typename U>
+	vec &operator<<=(const U &v)
+	{
+		return *this = *this << v;
+	}
+	template <typename U>
+	vec &operator>>=(const U &v)
+	{
+		return *this = *this >> v;
+	}
+
+	SPIRV_CROSS_SWIZZLES2(x)
+	SPIRV_CROSS_SWIZZLES2(y)
+	SPIRV_CROSS_SWIZZLES2(z)
+	SPIRV_CROSS_SWIZZLES2(w)
+	SPIRV_CROSS_SWIZZLES3(x)
+	SPIRV_CROSS_SWIZZLES3(y)
+	SPIRV_CROSS_SWIZZLES3(z)
+	SPIRV_CROSS_SWIZZLES3(w)
+	SPIRV_CROSS_SWIZZLES4(x)
+	SPIRV_CROSS_SWIZZLES4(y)
+	SPIRV_CROSS_SWIZZLES4(z)
+	SPIRV_CROSS_SWIZZLES4(w)
+
+private:
+	template <int M>
+	vec<T, M> swizzle(int a, int b, int c, int d) const
+	{
+		const int index[4] = { a, b, c, d };
+		vec<T, M> ret;
+		for (int i = 0; i < M; i++)
+			ret.at(i) = at(std::min(index[i], N - 1));
+		return ret;
+	}
+
+	template <typename U>
+	void fill(int &i, const U &s)
+	{
+		if (i < N)
+			at(i++) = T(s);
+	}
+
+	template <typename U, int M>
+	void fill(int &i, const vec<U, M> &v)
+	{
+		for (int j = 0; j < M && i < N; j++)
+			at(i++) = T(v.at(j));
+	}
+};
+
+#undef SPIRV_CROSS_SWIZZLE2
+#undef SPIRV_CROSS_SWIZZLE3
+#undef SPIRV_CROSS_SWIZZLE4
+#undef SPIRV_CROSS_SWIZZLES2
+#undef SPIRV_CROSS_SWIZZLES3_
+#undef SPIRV_CROSS_SWIZZLES3
+#undef SPIRV_CROSS_SWIZZLES4__
+#undef SPIRV_CROSS_SWIZZLES4_
+#undef SPIRV_CROSS_SWIZZLES4
+
+template <typename T, int N, typename F>
+inline auto map(const vec<T, N> &a, F &&f) -> vec<decltype(f(a.at(0))), N>
+{
+	vec<decltype(f(a.at(0))), N> ret;
+	for (int i = 0; i < N; i++)
+		ret.at(i) = f(a.at(i));
+	return ret;
+}
+
+template <typename T, typename U, int N, typename F>
+inline auto map(const vec<T, N> &a, const vec<U, N> &b, F &&f) -> vec<decltype(f(a.at(0), b.at(0))), N>
+{
+	vec<decltype(f(a.at(0), b.at(0))), N> ret;
+	for (int i = 0; i < N; i++)
+		ret.at(i) = f(a.at(i), b.at(i));
+	return ret;
+}
+
+template <typename T, typename U, typename V, int N, typename F>
+inline auto map(const vec<T, N> &a, const vec<U, N> &b, const vec<V, N> &c, F &&f)
+    -> vec<decltype(f(a.at(0), b.at(0), c.at(0))), N>
+{
+	vec<decltype(f(a.at(0), b.at(0), c.at(0))), N> ret;
+	for (int i = 0; i < N; i++)
+		ret.at(i) = f(a.at(i), b.at(i), c.at(i));
+	return ret;
+}
+
+// same type arithmetic - SPIR-V never mixes component types
+#define SPIRV_CROSS_VEC_OPERATOR(op)                                                                \
+	template <typename T, int N>                                                                    \
+	inline vec<T, N> operator op(const vec<T, N> &a, const vec<T, N> &b)                            \
+	{                                                                                               \
+		vec<T, N> ret;                                                                              \
+		for (int i = 0; i < N; i++)                                                                 \
+			ret.at(i) = T(a.at(i) op b.at(i));                                                      \
+		return ret;                                                                                 \
+	}                                                                                               \
+	template <typename T, int N>                                                                    \
+	inline vec<T, N> operator op(const vec<T, N> &a, const typename std::common_type<T>::type &b)   \
+	{                                                                                               \
+		vec<T, N> ret;                                                                              \
+		for (int i = 0; i < N; i++)                                                                 \
+			ret.at(i) = T(a.at(i) op b);                                                            \
+		return ret;                                                                                 \
+	}                                                                                               \
+	template <typename T, int N>                                                                    \
+	inline vec<T, N> operator op(const typename std::common_type<T>::type &a, const vec<T, N> &b)   \
+	{                                                                                               \
+		vec<T, N> ret;                                                                              \
+		for (int i = 0; i < N; i++)                                                                 \
+			ret.at(i) = T(a op b.at(i));                                                            \
+		return ret;                                                                                 \
+	}
+
+SPIRV_CROSS_VEC_OPERATOR(+)
+SPIRV_CROSS_VEC_OPERATOR(-)
+SPIRV_CROSS_VEC_OPERATOR(*)
+SPIRV_CROSS_VEC_OPERATOR(/)
+SPIRV_CROSS_VEC_OPERATOR(%)
+SPIRV_CROSS_VEC_OPERATOR(&)
+SPIRV_CROSS_VEC_OPERATOR(|)
+SPIRV_CROSS_VEC_OPERATOR(^)
+SPIRV_CROSS_VEC_OPERATOR(<<)
+SPIRV_CROSS_VEC_OPERATOR(>>)
+
+#undef SPIRV_CROSS_VEC_OPERATOR
+
+template <typename T, int N>
+inline vec<T, N> operator-(const vec<T, N> &a)
+{
+	return map(a, [](T v) { return T(-v); });
+}
+
+template <typename T, int N>
+inline vec<T, N> operator~(const vec<T, N> &a)
+{
+	return map(a, [](T v) { return T(~v); });
+}
+
+// not(b) in GLSL
+template <int N>
+inline vec<bool, N> operator!(const vec<bool, N> &a)
+{
+	return map(a, [](bool v) { return !v; });
+}
+
+template <typename T, int N>
+inline bool operator==(const vec<T, N> &a, const vec<T, N> &b)
+{
+	for (int i = 0; i < N; i++)
+		if (!(a.at(i) == b.at(i)))
+			return false;
+	return true;
+}
+
+template <typename T, int N>
+inline bool operator!=(const vec<T, N> &a, const vec<T, N> &b)
+{
+	return !(a == b);
+}
+
+// matrices - C columns of R components
+template <typename T, int C, int R>
+struct mat
+{
+	vec<T, R> columns[C];
+
+	mat() = default;
+
+	explicit mat(T s)
+	{
+		for (int c = 0; c < C; c++)
+			for (int r = 0; r < R; r++)
+				columns[c].at(r) = c == r ? s : T(0);
+	}
+
+	template <typename U, int C2, int R2>
+	explicit mat(const mat<U, C2, R2> &m)
+	{
+		for (int c = 0; c < C; c++)
+			for (int r = 0; r < R; r++)
+				columns[c].at(r) = (c < C2 && r < R2) ? T(m.columns[c].at(r)) : T(c == r ? 1 : 0);
+	}
+
+	template <typename A, typename B, typename... Rest>
+	mat(const A &a, const B &b, const Rest &... rest)
+	{
+		int i = 0;
+		fill(i, a);
+		fill(i, b);
+		(fill(i, rest), ...);
+	}
+
+	vec<T, R> &operator[](int i)
+	{
+		return columns[std::min(uint32_t(i), uint32_t(C - 1))];
+	}
+
+	const vec<T, R> &operator[](int i) const
+	{
+		return columns[std::min(uint32_t(i), uint32_t(C - 1))];
+	}
+
+	template <typename U>
+	mat &operator+=(const U &m)
+	{
+		return *this = *this + m;
+	}
+	template <typename U>
+	mat &operator-=(const U &m)
+	{
+		return *this = *this - m;
+	}
+	template <typename U>
+	mat &operator*=(const U &m)
+	{
+		return *this = *this * m;
+	}
+	template <typename U>
+	mat &operator/=(const U &m)
+	{
+		return *this = *this / m;
+	}
+
+private:
+	template <typename U>
+	void fill(int &i, const U &s)
+	{
+		if (i < C * R)
+		{
+			columns[i / R].at(i % R) = T(s);
+			i++;
+		}
+	}
+
+	template <typename U, int M>
+	void fill(int &i, const vec<U, M> &v)
+	{
+		for (int j = 0; j < M; j++)
+			fill(i, v.at(j));
+	}
+};
+
+template <typename T, int C, int R>
+inline mat<T, C, R> operator+(const mat<T, C, R> &a, const mat<T, C, R> &b)
+{
+	mat<T, C, R> ret;
+	for (int c = 0; c < C; c++)
+		ret.columns[c] = a.columns[c] + b.columns[c];
+	return ret;
+}
+
+template <typename T, int C, int R>
+inline mat<T, C, R> operator-(const mat<T, C, R> &a, const mat<T, C, R> &b)
+{
+	mat<T, C, R> ret;
+	for (int c = 0; c < C; c++)
+		ret.columns[c] = a.columns[c] - b.columns[c];
+	return ret;
+}
+
+template <typename T, int C, int R>
+inline mat<T, C, R> operator-(const mat<T, C, R> &a)
+{
+	mat<T, C, R> ret;
+	for (int c = 0; c < C; c++)
+		ret.columns[c] = -a.columns[c];
+	return ret;
+}
+
+template <typename T, int C, int R>
+inline mat<T, C, R> operator*(const mat<T, C, R> &a, const typename std::common_type<T>::type &s)
+{
+	mat<T, C, R> ret;
+	for (int c = 0; c < C; c++)
+		ret.columns[c] = a.columns[c] * s;
+	return ret;
+}
+
+template <typename T, int C, int R>
+inline mat<T, C, R> operator*(const typename std::common_type<T>::type &s, const mat<T, C, R> &a)
+{
+	return a * s;
+}
+
+template <typename T, int C, int R>
+inline mat<T, C, R> operator/(const mat<T, C, R> &a, const typename std::common_type<T>::type &s)
+{
+	mat<T, C, R> ret;
+	for (int c = 0; c < C; c++)
+		ret.columns[c] = a.columns[c] / s;
+	return ret;
+}
+
+template <typename T, int C, int R>
+inline vec<T, R> operator*(const mat<T, C, R> &m, const vec<T, C> &v)
+{
+	vec<T, R> ret = m.columns[0] * v.at(0);
+	for (int c = 1; c < C; c++)
+		ret = ret + m.columns[c] * v.at(c);
+	return ret;
+}
+
+template <typename T, int C, int R>
+inline vec<T, C> operator*(const vec<T, R> &v, const mat<T, C, R> &m)
+{
+	vec<T, C> ret;
+	for (int c = 0; c < C; c++)
+	{
+		T sum = T(0);
+		for (int r = 0; r < R; r++)
+			sum += v.at(r) * m.columns[c].at(r);
+		ret.at(c) = sum;
+	}
+	return ret;
+}
+
+template <typename T, int K, int C, int R>
+inline mat<T, C, R> operator*(const mat<T, K, R> &a, const mat<T, C, K> &b)
+{
+	mat<T, C, R> ret;
+	for (int c = 0; c < C; c++)
+		ret.columns[c] = a * b.columns[c];
+	return ret;
+}
+
+// arrays are values in GLSL - copyable, indexable with a clamped index
+template <typename T, int N>
+struct array
+{
+	T elements[N];
+
+	array() = default;
+
+	array(std::initializer_list<T> list)
+	{
+		std::copy(list.begin(), list.begin() + std::min<size_t>(list.size(), N), elements);
+	}
+
+	T &operator[](int i)
+	{
+		return elements[std::min(uint32_t(i), uint32_t(N - 1))];
+	}
+
+	const T &operator[](int i) const
+	{
+		return elements[std::min(uint32_t(i), uint32_t(N - 1))];
+	}
+
+	bool operator==(const array &other) const
+	{
+		for (int i = 0; i < N; i++)
+			if (!(elements[i] == other.elements[i]))
+				return false;
+		return true;
+	}
+};
+
+typedef vec<float, 2> vec2;
+typedef vec<float, 3> vec3;
+typedef vec<float, 4> vec4;
+typedef vec<double, 2> dvec2;
+typedef vec<double, 3> dvec3;
+typedef vec<double, 4> dvec4;
+typedef vec<int32_t, 2> ivec2;
+typedef vec<int32_t, 3> ivec3;
+typedef vec<int32_t, 4> ivec4;
+typedef vec<uint32_t, 2> uvec2;
+typedef vec<uint32_t, 3> uvec3;
+typedef vec<uint32_t, 4> uvec4;
+typedef vec<int64_t, 2> i64vec2;
+typedef vec<int64_t, 3> i64vec3;
+typedef vec<int64_t, 4> i64vec4;
+typedef vec<uint64_t, 2> u64vec2;
+typedef vec<uint64_t, 3> u64vec3;
+typedef vec<uint64_t, 4> u64vec4;
+typedef vec<bool, 2> bvec2;
+typedef vec<bool, 3> bvec3;
+typedef vec<bool, 4> bvec4;
+
+typedef mat<float, 2, 2> mat2;
+typedef mat<float, 3, 3> mat3;
+typedef mat<float, 4, 4> mat4;
+typedef mat<float, 2, 2> mat2x2;
+typedef mat<float, 2, 3> mat2x3;
+typedef mat<float, 2, 4> mat2x4;
+typedef mat<float, 3, 2> mat3x2;
+typedef mat<float, 3, 3> mat3x3;
+typedef mat<float, 3, 4> mat3x4;
+typedef mat<float, 4, 2> mat4x2;
+typedef mat<float, 4, 3> mat4x3;
+typedef mat<float, 4, 4> mat4x4;
+typedef mat<double, 2, 2> dmat2;
+typedef mat<double, 3, 3> dmat3;
+typedef mat<double, 4, 4> dmat4;
+typedef mat<double, 2, 2> dmat2x2;
+typedef mat<double, 2, 3> dmat2x3;
+typedef mat<double, 2, 4> dmat2x4;
+typedef mat<double, 3, 2> dmat3x2;
+typedef mat<double, 3, 3> dmat3x3;
+typedef mat<double, 3, 4> dmat3x4;
+typedef mat<double, 4, 2> dmat4x2;
+typedef mat<double, 4, 3> dmat4x3;
+typedef mat<double, 4, 4> dmat4x4;
+
+// checked integer & float arithmetic that the backend routes divisions through
+template <typename T>
+inline T checked_div(T a, T b)
+{
+	if (b == T(0))
+	{
+		report(ub_div_by_zero);
+		if (std::is_integral<T>::value)
+			return T(0);
+	}
+	else if (std::is_signed<T>::value && std::is_integral<T>::value && b == T(-1))
+		return T(0) - a; // INT_MIN / -1 traps on x86
+	return a / b;
+}
+
+template <typename T>
+inline T checked_rem(T a, T b) // SRem & UMod - sign of the dividend
+{
+	if (b == T(0))
+	{
+		report(ub_mod_by_zero);
+		return T(0);
+	}
+	if (std::is_signed<T>::value && b == T(-1))
+		return T(0);
+	return a % b;
+}
+
+template <typename T>
+inline T checked_smod(T a, T b) // SMod - sign of the divisor
+{
+	T r = checked_rem(a, b);
+	if (r != T(0) && ((r < T(0)) != (b < T(0))))
+		r += b;
+	return r;
+}
+
+#define SPIRV_CROSS_VECTORIZE_BINARY(name)                                \
+	template <typename T, int N>                                          \
+	inline vec<T, N> name(const vec<T, N> &a, const vec<T, N> &b)         \
+	{                                                                     \
+		return map(a, b, [](T x, T y) { return name(x, y); });            \
+	}
+
+SPIRV_CROSS_VECTORIZE_BINARY(checked_div)
+SPIRV_CROSS_VECTORIZE_BINARY(checked_rem)
+SPIRV_CROSS_VECTORIZE_BINARY(checked_smod)
+
+// component-wise built-ins
+#define SPIRV_CROSS_VECTORIZE_UNARY(name)                     \
+	template <typename T, int N>                              \
+	inline auto name(const vec<T, N> &a)                      \
+	{                                                         \
+		return map(a, [](T x) { return name(x); });           \
+	}
+#define SPIRV_CROSS_VECTORIZE_TERNARY(name)                                           \
+	template <typename T, int N>                                                      \
+	inline vec<T, N> name(const vec<T, N> &a, const vec<T, N> &b, const vec<T, N> &c) \
+	{                                                                                 \
+		return map(a, b, c, [](T x, T y, T z) { return name(x, y, z); });             \
+	}
+
+#define SPIRV_CROSS_FLOAT_UNARY(name, expr)         \
+	inline float name(float x)                      \
+	{                                               \
+		return expr;                                \
+	}                                               \
+	inline double name(double x)                    \
+	{                                               \
+		return expr;                                \
+	}                                               \
+	SPIRV_CROSS_VECTORIZE_UNARY(name)
+
+#define SPIRV_CROSS_FLOAT_UNARY_CHECKED(name, check, ub, expr) \
+	inline float name(float x)                                 \
+	{                                                          \
+		if (check)                                             \
+			report(ub);                                        \
+		return expr;                                           \
+	}                                                          \
+	inline double name(double x)                               \
+	{                                                          \
+		if (check)                                             \
+			report(ub);                                        \
+		return expr;                                           \
+	}                                                          \
+	SPIRV_CROSS_VECTORIZE_UNARY(name)
+
+SPIRV_CROSS_FLOAT_UNARY(radians, x * decltype(x)(0.017453292519943295))
+SPIRV_CROSS_FLOAT_UNARY(degrees, x * decltype(x)(57.29577951308232))
+SPIRV_CROSS_FLOAT_UNARY(sin, std::sin(x))
+SPIRV_CROSS_FLOAT_UNARY(cos, std::cos(x))
+SPIRV_CROSS_FLOAT_UNARY(tan, std::tan(x))
+SPIRV_CROSS_FLOAT_UNARY_CHECKED(asin, x < -1 || x > 1, ub_asin, std::asin(x))
+SPIRV_CROSS_FLOAT_UNARY_CHECKED(acos, x < -1 || x > 1, ub_acos, std::acos(x))
+SPIRV_CROSS_FLOAT_UNARY(atan, std::atan(x))
+SPIRV_CROSS_FLOAT_UNARY(sinh, std::sinh(x))
+SPIRV_CROSS_FLOAT_UNARY(cosh, std::cosh(x))
+SPIRV_CROSS_FLOAT_UNARY(tanh, std::tanh(x))
+SPIRV_CROSS_FLOAT_UNARY(asinh, std::asinh(x))
+SPIRV_CROSS_FLOAT_UNARY_CHECKED(acosh, x < 1, ub_acosh, std::acosh(x))
+SPIRV_CROSS_FLOAT_UNARY_CHECKED(atanh, x <= -1 || x >= 1, ub_atanh, std::atanh(x))
+SPIRV_CROSS_FLOAT_UNARY(exp, std::exp(x))
+SPIRV_CROSS_FLOAT_UNARY_CHECKED(log, x <= 0, ub_log, std::log(x))
+SPIRV_CROSS_FLOAT_UNARY(exp2, std::exp2(x))
+SPIRV_CROSS_FLOAT_UNARY_CHECKED(log2, x <= 0, ub_log2, std::log2(x))
+SPIRV_CROSS_FLOAT_UNARY_CHECKED(sqrt, x < 0, ub_sqrt, std::sqrt(x))
+SPIRV_CROSS_FLOAT_UNARY_CHECKED(inversesqrt, x <= 0, ub_inverse_sqrt, 1 / std::sqrt(x))
+SPIRV_CROSS_FLOAT_UNARY(floor, std::floor(x))
+SPIRV_CROSS_FLOAT_UNARY(ceil, std::ceil(x))
+SPIRV_CROSS_FLOAT_UNARY(trunc, std::trunc(x))
+SPIRV_CROSS_FLOAT_UNARY(round, std::round(x))
+SPIRV_CROSS_FLOAT_UNARY(roundEven, std::nearbyint(x))
+SPIRV_CROSS_FLOAT_UNARY(fract, x - std::floor(x))
+
+#undef SPIRV_CROSS_FLOAT_UNARY
+#undef SPIRV_CROSS_FLOAT_UNARY_CHECKED
+
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type abs(T x)
+{
+	return x < T(0) ? T(0) - x : x;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type sign(T x)
+{
+	return T((T(0) < x) - (x < T(0)));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, bool>::type isnan(T x)
+{
+	return std::isnan(double(x));
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, bool>::type isinf(T x)
+{
+	return std::isinf(double(x));
+}
+
+SPIRV_CROSS_VECTORIZE_UNARY(abs)
+SPIRV_CROSS_VECTORIZE_UNARY(sign)
+SPIRV_CROSS_VECTORIZE_UNARY(isnan)
+SPIRV_CROSS_VECTORIZE_UNARY(isinf)
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type atan(T y, T x)
+{
+	if (x == T(0) && y == T(0))
+		report(ub_atan2);
+	return std::atan2(y, x);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type pow(T x, T y)
+{
+	if (x < T(0) || (x == T(0) && y <= T(0)))
+		report(ub_pow);
+	return std::pow(x, y);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type mod(T x, T y)
+{
+	if (y == T(0))
+		report(ub_mod_by_zero);
+	return x - y * std::floor(x / y);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type min(T x, T y)
+{
+	if (std::is_floating_point<T>::value && (isnan(x) || isnan(y)))
+		report(ub_fmin);
+	return y < x ? y : x;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type max(T x, T y)
+{
+	if (std::is_floating_point<T>::value && (isnan(x) || isnan(y)))
+		report(ub_fmax);
+	return x < y ? y : x;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type step(T edge, T x)
+{
+	return x < edge ? T(0) : T(1);
+}
+
+SPIRV_CROSS_VECTORIZE_BINARY(atan)
+SPIRV_CROSS_VECTORIZE_BINARY(pow)
+SPIRV_CROSS_VECTORIZE_BINARY(mod)
+SPIRV_CROSS_VECTORIZE_BINARY(min)
+SPIRV_CROSS_VECTORIZE_BINARY(max)
+SPIRV_CROSS_VECTORIZE_BINARY(step)
+
+template <typename T>
+inline typename std::enable_if<std::is_arithmetic<T>::value, T>::type clamp(T x, T lo, T hi)
+{
+	if (lo > hi)
+		report(ub_clamp);
+	return std::min(std::max(x, lo), hi);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type mix(T x, T y, T a)
+{
+	return x * (T(1) - a) + y * a;
+}
+
+template <typename T>
+inline T mix(const T &x, const T &y, bool a)
+{
+	return a ? y : x;
+}
+
+template <typename T, int N>
+inline vec<T, N> mix(const vec<T, N> &x, const vec<T, N> &y, const vec<bool, N> &a)
+{
+	vec<T, N> ret;
+	for (int i = 0; i < N; i++)
+		ret.at(i) = a.at(i) ? y.at(i) : x.at(i);
+	return ret;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type smoothstep(T edge0, T edge1, T x)
+{
+	if (edge0 >= edge1)
+		report(ub_smoothstep);
+	T t = std::min(std::max((x - edge0) / (edge1 - edge0), T(0)), T(1));
+	return t * t * (T(3) - T(2) * t);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type fma(T a, T b, T c)
+{
+	return a * b + c;
+}
+
+SPIRV_CROSS_VECTORIZE_TERNARY(clamp)
+SPIRV_CROSS_VECTORIZE_TERNARY(mix)
+SPIRV_CROSS_VECTORIZE_TERNARY(smoothstep)
+SPIRV_CROSS_VECTORIZE_TERNARY(fma)
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type modf(T x, T &i)
+{
+	return std::modf(x, &i);
+}
+
+template <typename T, int N>
+inline vec<T, N> modf(const vec<T, N> &x, vec<T, N> &i)
+{
+	vec<T, N> ret;
+	for (int c = 0; c < N; c++)
+		ret.at(c) = modf(x.at(c), i.at(c));
+	return ret;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type frexp(T x, int32_t &e)
+{
+	if (std::isnan(x) || std::isinf(x))
+		report(ub_frexp);
+	int exponent = 0;
+	T ret = std::frexp(x, &exponent);
+	e = exponent;
+	return ret;
+}
+
+template <typename T, int N>
+inline vec<T, N> frexp(const vec<T, N> &x, vec<int32_t, N> &e)
+{
+	vec<T, N> ret;
+	for (int c = 0; c < N; c++)
+		ret.at(c) = frexp(x.at(c), e.at(c));
+	return ret;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type ldexp(T x, int32_t e)
+{
+	if (e > (sizeof(T) == sizeof(float) ? 128 : 1024))
+		report(ub_ldexp);
+	return std::ldexp(x, e);
+}
+
+template <typename T, int N>
+inline vec<T, N> ldexp(const vec<T, N> &x, const vec<int32_t, N> &e)
+{
+	vec<T, N> ret;
+	for (int c = 0; c < N; c++)
+		ret.at(c) = ldexp(x.at(c), e.at(c));
+	return ret;
+}
+
+// geometry
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type dot(T a, T b)
+{
+	return a * b;
+}
+
+template <typename T, int N>
+inline T dot(const vec<T, N> &a, const vec<T, N> &b)
+{
+	T ret = T(0);
+	for (int i = 0; i < N; i++)
+		ret += a.at(i) * b.at(i);
+	return ret;
+}
+
+template <typename T>
+inline auto length(const T &v)
+{
+	return std::sqrt(dot(v, v));
+}
+
+template <typename T>
+inline auto distance(const T &a, const T &b)
+{
+	return length(a - b);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_floating_point<T>::value, T>::type normalize(T x)
+{
+	return x < T(0) ? T(-1) : T(1);
+}
+
+template <typename T, int N>
+inline vec<T, N> normalize(const vec<T, N> &v)
+{
+	return v / length(v);
+}
+
+template <typename T>
+inline vec<T, 3> cross(const vec<T, 3> &a, const vec<T, 3> &b)
+{
+	return vec<T, 3>(a.y * b.z - b.y * a.z, a.z * b.x - b.z * a.x, a.x * b.y - b.x * a.y);
+}
+
+template <typename T>
+inline T faceforward(const T &n, const T &i, const T &nref)
+{
+	return dot(nref, i) < 0 ? n : -n;
+}
+
+template <typename T>
+inline T reflect(const T &i, const T &n)
+{
+	return i - n * (dot(n, i) * 2);
+}
+
+template <typename T, typename E>
+inline T refract(const T &i, const T &n, E eta)
+{
+	E d = E(dot(n, i));
+	E k = E(1) - eta * eta * (E(1) - d * d);
+	if (k < E(0))
+		return T(E(0));
+	return i * eta - n * (eta * d + E(std::sqrt(k)));
+}
+
+// relational
+#define SPIRV_CROSS_RELATIONAL(name, op)                                    \
+	template <typename T, int N>                                            \
+	inline vec<bool, N> name(const vec<T, N> &a, const vec<T, N> &b)        \
+	{                                                                       \
+		return map(a, b, [](T x, T y) { return x op y; });                  \
+	}
+
+SPIRV_CROSS_RELATIONAL(lessThan, <)
+SPIRV_CROSS_RELATIONAL(lessThanEqual, <=)
+SPIRV_CROSS_RELATIONAL(greaterThan, >)
+SPIRV_CROSS_RELATIONAL(greaterThanEqual, >=)
+SPIRV_CROSS_RELATIONAL(equal, ==)
+SPIRV_CROSS_RELATIONAL(notEqual, !=)
+
+#undef SPIRV_CROSS_RELATIONAL
+
+template <int N>
+inline bool any(const vec<bool, N> &v)
+{
+	for (int i = 0; i < N; i++)
+		if (v.at(i))
+			return true;
+	return false;
+}
+
+template <int N>
+inline bool all(const vec<bool, N> &v)
+{
+	for (int i = 0; i < N; i++)
+		if (!v.at(i))
+			return false;
+	return true;
+}
+
+// bit manipulation & casts
+template <typename To, typename From>
+inline To bit_cast(const From &v)
+{
+	static_assert(sizeof(To) == sizeof(From), "bit_cast needs types of the same size.");
+	To ret;
+	std::memcpy(&ret, &v, sizeof(To));
+	return ret;
+}
+
+inline int32_t floatBitsToInt(float v)
+{
+	return bit_cast<int32_t>(v);
+}
+inline uint32_t floatBitsToUint(float v)
+{
+	return bit_cast<uint32_t>(v);
+}
+inline float intBitsToFloat(int32_t v)
+{
+	return bit_cast<float>(v);
+}
+inline float uintBitsToFloat(uint32_t v)
+{
+	return bit_cast<float>(v);
+}
+inline int64_t doubleBitsToInt64(double v)
+{
+	return bit_cast<int64_t>(v);
+}
+inline uint64_t doubleBitsToUint64(double v)
+{
+	return bit_cast<uint64_t>(v);
+}
+inline double int64BitsToDouble(int64_t v)
+{
+	return bit_cast<double>(v);
+}
+inline double uint64BitsToDouble(uint64_t v)
+{
+	return bit_cast<double>(v);
+}
+
+SPIRV_CROSS_VECTORIZE_UNARY(floatBitsToInt)
+SPIRV_CROSS_VECTORIZE_UNARY(floatBitsToUint)
+SPIRV_CROSS_VECTORIZE_UNARY(intBitsToFloat)
+SPIRV_CROSS_VECTORIZE_UNARY(uintBitsToFloat)
+SPIRV_CROSS_VECTORIZE_UNARY(doubleBitsToInt64)
+SPIRV_CROSS_VECTORIZE_UNARY(doubleBitsToUint64)
+SPIRV_CROSS_VECTORIZE_UNARY(int64BitsToDouble)
+SPIRV_CROSS_VECTORIZE_UNARY(uint64BitsToDouble)
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, int32_t>::type bitCount(T v)
+{
+	uint32_t u = uint32_t(v);
+	int32_t ret = 0;
+	for (; u; u &= u - 1)
+		ret++;
+	return ret;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, int32_t>::type findLSB(T v)
+{
+	uint32_t u = uint32_t(v);
+	if (u == 0)
+		return -1;
+	int32_t ret = 0;
+	while (!(u & 1u))
+	{
+		u >>= 1;
+		ret++;
+	}
+	return ret;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, int32_t>::type findMSB(T v)
+{
+	uint32_t u = uint32_t(v);
+	if (std::is_signed<T>::value && v < T(0))
+		u = ~u;
+	int32_t ret = -1;
+	for (; u; u >>= 1)
+		ret++;
+	return ret;
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, T>::type bitfieldReverse(T v)
+{
+	uint32_t u = uint32_t(v), ret = 0;
+	for (int i = 0; i < 32; i++)
+		ret |= ((u >> i) & 1u) << (31 - i);
+	return T(ret);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, T>::type bitfieldExtract(T v, int32_t offset, int32_t bits)
+{
+	if (bits <= 0)
+		return T(0);
+	uint32_t u = uint32_t(v) >> offset;
+	if (bits < 32)
+	{
+		u &= (1u << bits) - 1u;
+		if (std::is_signed<T>::value && (u & (1u << (bits - 1))))
+			u |= ~((1u << bits) - 1u);
+	}
+	return T(u);
+}
+
+template <typename T>
+inline typename std::enable_if<std::is_integral<T>::value, T>::type bitfieldInsert(T base, T insert, int32_t offset,
+                                                                                     int32_t bits)
+{
+	if (bits <= 0)
+		return base;
+	uint32_t mask = (bits < 32 ? ((1u << bits) - 1u) : ~0u) << offset;
+	return T((uint32_t(base) & ~mask) | ((uint32_t(insert) << offset) & mask));
+}
+
+SPIRV_CROSS_VECTORIZE_UNARY(bitCount)
+SPIRV_CROSS_VECTORIZE_UNARY(findLSB)
+SPIRV_CROSS_VECTORIZE_UNARY(findMSB)
+SPIRV_CROSS_VECTORIZE_UNARY(bitfieldReverse)
+
+template <typename T, int N>
+inline vec<T, N> bitfieldExtract(const vec<T, N> &v, int32_t offset, int32_t bits)
+{
+	return map(v, [&](T x) { return bitfieldExtract(x, offset, bits); });
+}
+
+template <typename T, int N>
+inline vec<T, N> bitfieldInsert(const vec<T, N> &base, const vec<T, N> &insert, int32_t offset, int32_t bits)
+{
+	return map(base, insert, [&](T x, T y) { return bitfieldInsert(x, y, offset, bits); });
+}
+
+// packing
+inline uint32_t packUnorm4x8(const vec4 &v)
+{
+	uint32_t ret = 0;
+	for (int i = 0; i < 4; i++)
+		ret |= uint32_t(std::round(std::min(std::max(v.at(i), 0.0f), 1.0f) * 255.0f)) << (8 * i);
+	return ret;
+}
+
+inline uint32_t packSnorm4x8(const vec4 &v)
+{
+	uint32_t ret = 0;
+	for (int i = 0; i < 4; i++)
+		ret |= (uint32_t(int32_t(std::round(std::min(std::max(v.at(i), -1.0f), 1.0f) * 127.0f))) & 0xffu) << (8 * i);
+	return ret;
+}
+
+inline vec4 unpackUnorm4x8(uint32_t p)
+{
+	vec4 ret;
+	for (int i = 0; i < 4; i++)
+		ret.at(i) = float((p >> (8 * i)) & 0xffu) / 255.0f;
+	return ret;
+}
+
+inline vec4 unpackSnorm4x8(uint32_t p)
+{
+	vec4 ret;
+	for (int i = 0; i < 4; i++)
+		ret.at(i) = std::min(std::max(float(int8_t((p >> (8 * i)) & 0xffu)) / 127.0f, -1.0f), 1.0f);
+	return ret;
+}
+
+inline uint32_t packUnorm2x16(const vec2 &v)
+{
+	return uint32_t(std::round(std::min(std::max(v.x, 0.0f), 1.0f) * 65535.0f)) |
+	       (uint32_t(std::round(std::min(std::max(v.y, 0.0f), 1.0f) * 65535.0f)) << 16);
+}
+
+inline uint32_t packSnorm2x16(const vec2 &v)
+{
+	return (uint32_t(int32_t(std::round(std::min(std::max(v.x, -1.0f), 1.0f) * 32767.0f))) & 0xffffu) |
+	       (uint32_t(int32_t(std::round(std::min(std::max(v.y, -1.0f), 1.0f) * 32767.0f))) << 16);
+}
+
+inline vec2 unpackUnorm2x16(uint32_t p)
+{
+	return vec2(float(p & 0xffffu) / 65535.0f, float(p >> 16) / 65535.0f);
+}
+
+inline vec2 unpackSnorm2x16(uint32_t p)
+{
+	return vec2(std::min(std::max(float(int16_t(p & 0xffffu)) / 32767.0f, -1.0f), 1.0f),
+	            std::min(std::max(float(int16_t(p >> 16)) / 32767.0f, -1.0f), 1.0f));
+}
+
+inline uint32_t float_to_half(float v)
+{
+	uint32_t f = bit_cast<uint32_t>(v);
+	uint32_t sign = (f >> 16) & 0x8000u;
+	int32_t exponent = int32_t((f >> 23) & 0xffu) - 127 + 15;
+	uint32_t mantissa = f & 0x7fffffu;
+
+	if (((f >> 23) & 0xffu) == 0xffu)
+		return sign | 0x7c00u | (mantissa ? 0x200u : 0u);
+	if (exponent >= 31)
+		return sign | 0x7c00u;
+	if (exponent <= 0)
+	{
+		if (exponent < -10)
+			return sign;
+		mantissa |= 0x800000u;
+		return sign | (mantissa >> (14 - exponent));
+	}
+	return sign | (uint32_t(exponent) << 10) | (mantissa >> 13);
+}
+
+inline float half_to_float(uint32_t h)
+{
+	uint32_t sign = (h & 0x8000u) << 16;
+	uint32_t exponent = (h >> 10) & 0x1fu;
+	uint32_t mantissa = h & 0x3ffu;
+
+	if (exponent == 0)
+		return (sign ? -1.0f : 1.0f) * std::ldexp(float(mantissa), -24);
+	if (exponent == 31)
+		return bit_cast<float>(sign | 0x7f800000u | (mantissa << 13));
+	return bit_cast<float>(sign | ((exponent + 127 - 15) << 23) | (mantissa << 13));
+}
+
+inline uint32_t packHalf2x16(const vec2 &v)
+{
+	return float_to_half(v.x) | (float_to_half(v.y) << 16);
+}
+
+inline vec2 unpackHalf2x16(uint32_t p)
+{
+	return vec2(half_to_float(p & 0xffffu), half_to_float(p >> 16));
+}
+
+// matrix functions
+template <typename T, int C, int R>
+inline mat<T, R, C> transpose(const mat<T, C, R> &m)
+{
+	mat<T, R, C> ret;
+	for (int c = 0; c < C; c++)
+		for (int r = 0; r < R; r++)
+			ret.columns[r].at(c) = m.columns[c].at(r);
+	return ret;
+}
+
+template <typename T, int C, int R>
+inline mat<T, C, R> matrixCompMult(const mat<T, C, R> &a, const mat<T, C, R> &b)
+{
+	mat<T, C, R> ret;
+	for (int c = 0; c < C; c++)
+		ret.columns[c] = a.columns[c] * b.columns[c];
+	return ret;
+}
+
+template <typename T, int C, int R>
+inline mat<T, C, R> outerProduct(const vec<T, R> &c, const vec<T, C> &r)
+{
+	mat<T, C, R> ret;
+	for (int i = 0; i < C; i++)
+		ret.columns[i] = c * r.at(i);
+	return ret;
+}
+
+template <typename T>
+inline T determinant(const mat<T, 2, 2> &m)
+{
+	return m.columns[0].x * m.columns[1].y - m.columns[1].x * m.columns[0].y;
+}
+
+template <typename T>
+inline T determinant(const mat<T, 3, 3> &m)
+{
+	return dot(m.columns[0], cross(m.columns[1], m.columns[2]));
+}
+
+template <typename T>
+inline T minor3(const mat<T, 4, 4> &m, int c0, int c1, int c2, int r0, int r1, int r2)
+{
+	return m.columns[c0].at(r0) * (m.columns[c1].at(r1) * m.columns[c2].at(r2) - m.columns[c2].at(r1) * m.columns[c1].at(r2)) -
+	       m.columns[c1].at(r0) * (m.columns[c0].at(r1) * m.columns[c2].at(r2) - m.columns[c2].at(r1) * m.columns[c0].at(r2)) +
+	       m.columns[c2].at(r0) * (m.columns[c0].at(r1) * m.columns[c1].at(r2) - m.columns[c1].at(r1) * m.columns[c0].at(r2));
+}
+
+template <typename T>
+inline T determinant(const mat<T, 4, 4> &m)
+{
+	return m.columns[0].x * minor3(m, 1, 2, 3, 1, 2, 3) - m.columns[1].x * minor3(m, 0, 2, 3, 1, 2, 3) +
+	       m.columns[2].x * minor3(m, 0, 1, 3, 1, 2, 3) - m.columns[3].x * minor3(m, 0, 1, 2, 1, 2, 3);
+}
+
+// inverse through the adjugate - the cofactor of element (c, r) is the signed determinant of the rest
+template <typename T, int N>
+inline mat<T, N, N> inverse(const mat<T, N, N> &m)
+{
+	mat<T, N, N> ret;
+	T det = determinant(m);
+	for (int c = 0; c < N; c++)
+	{
+		for (int r = 0; r < N; r++)
+		{
+			mat<T, N - 1, N - 1> rest;
+			for (int sc = 0, dc = 0; sc < N; sc++)
+			{
+				if (sc == c)
+					continue;
+				for (int sr = 0, dr = 0; sr < N; sr++)
+				{
+					if (sr == r)
+						continue;
+					rest.columns[dc].at(dr++) = m.columns[sc].at(sr);
+				}
+				dc++;
+			}
+			T cofactor = determinant(rest) * T(((c + r) & 1) ? -1 : 1);
+			ret.columns[r].at(c) = cofactor / det;
+		}
+	}
+	return ret;
+}
+
+template <typename T>
+inline mat<T, 2, 2> inverse(const mat<T, 2, 2> &m)
+{
+	T det = determinant(m);
+	return mat<T, 2, 2>(m.columns[1].y / det, -m.columns[0].y / det, -m.columns[1].x / det, m.columns[0].x / det);
+}
+
+#undef SPIRV_CROSS_VECTORIZE_UNARY
+#undef SPIRV_CROSS_VECTORIZE_BINARY
+#undef SPIRV_CROSS_VECTORIZE_TERNARY
+
+// textures - RGBA32F data from the VM's images, sampled with the nearest texel & repeat addressing like the VM
+struct image_data
+{
+	const float *texels = nullptr;
+	int32_t width = 0, height = 0, depth = 0;
+
+	vec4 fetch(int32_t x, int32_t y, int32_t z) const
+	{
+		if (!texels || x < 0 || y < 0 || z < 0 || x >= width || y >= height || z >= depth)
+		{
+			report(ub_image_read_out_of_bounds);
+			return vec4(0.0f);
+		}
+		const float *texel = texels + ((size_t(z) * height + y) * width + x) * 4;
+		return vec4(texel[0], texel[1], texel[2], texel[3]);
+	}
+
+	static int32_t wrap(float coord, int32_t size)
+	{
+		if (size <= 0)
+			return 0;
+		int32_t i = int32_t(std::floor(coord * float(size))) % size;
+		return i < 0 ? i + size : i;
+	}
+
+	vec4 sample(float u, float v, float w) const
+	{
+		if (!texels)
+			return vec4(0.0f);
+		const float *texel =
+		    texels + ((size_t(wrap(w, depth)) * height + wrap(v, height)) * width + wrap(u, width)) * 4;
+		return vec4(texel[0], texel[1], texel[2], texel[3]);
+	}
+
+	vec4 sample_cube(const vec3 &dir) const
+	{
+		// face selection from the GL spec, faces are +X -X +Y -Y +Z -Z
+		float ax = std::fabs(dir.x), ay = std::fabs(dir.y), az = std::fabs(dir.z);
+		int face;
+		float sc, tc, ma;
+		if (ax >= ay && ax >= az)
+		{
+			face = dir.x >= 0.0f ? 0 : 1;
+			sc = dir.x >= 0.0f ? -dir.z : dir.z;
+			tc = -dir.y;
+			ma = ax;
+		}
+		else if (ay >= az)
+		{
+			face = dir.y >= 0.0f ? 2 : 3;
+			sc = dir.x;
+			tc = dir.y >= 0.0f ? dir.z : -dir.z;
+			ma = ay;
+		}
+		else
+		{
+			face = dir.z >= 0.0f ? 4 : 5;
+			sc = dir.z >= 0.0f ? dir.x : -dir.x;
+			tc = -dir.y;
+			ma = az;
+		}
+		if (!texels || ma == 0.0f || depth < 6)
+			return vec4(0.0f);
+
+		int32_t x = std::min(std::max(int32_t(std::floor((sc / ma * 0.5f + 0.5f) * float(width))), 0), width - 1);
+		int32_t y = std::min(std::max(int32_t(std::floor((tc / ma * 0.5f + 0.5f) * float(height))), 0), height - 1);
+		const float *texel = texels + ((size_t(face) * height + y) * width + x) * 4;
+		return vec4(texel[0], texel[1], texel[2], texel[3]);
+	}
+};
+
+struct sampler
+{
+};
+
+#define SPIRV_CROSS_TEXTURE_TYPE(texture_type, sampler_type) \
+	struct texture_type                                      \
+	{                                                        \
+		image_data image;                                    \
+	};                                                       \
+	struct sampler_type                                      \
+	{                                                        \
+		image_data image;                                    \
+		sampler_type() = default;                            \
+		sampler_type(const texture_type &t, const sampler &) \
+		    : image(t.image)                                 \
+		{                                                    \
+		}                                                    \
+	};
+
+SPIRV_CROSS_TEXTURE_TYPE(texture2D, sampler2D)
+SPIRV_CROSS_TEXTURE_TYPE(texture3D, sampler3D)
+SPIRV_CROSS_TEXTURE_TYPE(textureCube, samplerCube)
+
+#undef SPIRV_CROSS_TEXTURE_TYPE
+
+template <typename T>
+struct is_image : std::false_type
+{
+};
+template <>
+struct is_image<texture2D> : std::true_type
+{
+};
+template <>
+struct is_image<texture3D> : std::true_type
+{
+};
+template <>
+struct is_image<textureCube> : std::true_type
+{
+};
+template <>
+struct is_image<sampler2D> : std::true_type
+{
+};
+template <>
+struct is_image<sampler3D> : std::true_type
+{
+};
+template <>
+struct is_image<samplerCube> : std::true_type
+{
+};
+
+// explicit LOD, bias and gradients are accepted but ignored - the VM only reads the base level as well
+inline vec4 texture(const sampler2D &s, const vec2 &uv)
+{
+	return s.image.sample(uv.x, uv.y, 0.0f);
+}
+inline vec4 texture(const sampler2D &s, const vec2 &uv, float)
+{
+	return texture(s, uv);
+}
+inline vec4 texture(const sampler3D &s, const vec3 &uvw)
+{
+	return s.image.sample(uvw.x, uvw.y, uvw.z);
+}
+inline vec4 texture(const sampler3D &s, const vec3 &uvw, float)
+{
+	return texture(s, uvw);
+}
+inline vec4 texture(const samplerCube &s, const vec3 &dir)
+{
+	return s.image.sample_cube(dir);
+}
+inline vec4 texture(const samplerCube &s, const vec3 &dir, float)
+{
+	return texture(s, dir);
+}
+
+template <typename S, typename C>
+inline vec4 textureLod(const S &s, const C &coord, float)
+{
+	return texture(s, coord);
+}
+
+template <typename S, typename C, typename D>
+inline vec4 textureGrad(const S &s, const C &coord, const D &, const D &)
+{
+	return texture(s, coord);
+}
+
+inline vec4 textureOffset(const sampler2D &s, const vec2 &uv, const ivec2 &offset)
+{
+	return texture(s, uv + vec2(offset) / vec2(float(s.image.width), float(s.image.height)));
+}
+inline vec4 textureOffset(const sampler2D &s, const vec2 &uv, const ivec2 &offset, float)
+{
+	return textureOffset(s, uv, offset);
+}
+inline vec4 textureLodOffset(const sampler2D &s, const vec2 &uv, float, const ivec2 &offset)
+{
+	return textureOffset(s, uv, offset);
+}
+
+inline vec4 textureProj(const sampler2D &s, const vec3 &uvq)
+{
+	return texture(s, vec2(uvq.x, uvq.y) / uvq.z);
+}
+inline vec4 textureProj(const sampler2D &s, const vec4 &uvq)
+{
+	return texture(s, vec2(uvq.x, uvq.y) / uvq.w);
+}
+inline vec4 textureProj(const sampler3D &s, const vec4 &uvq)
+{
+	return texture(s, vec3(uvq.x, uvq.y, uvq.z) / uvq.w);
+}
+
+inline vec4 texelFetch(const image_data &image, const ivec2 &coord)
+{
+	return image.fetch(coord.x, coord.y, 0);
+}
+inline vec4 texelFetch(const sampler2D &s, const ivec2 &coord, int32_t)
+{
+	return texelFetch(s.image, coord);
+}
+inline vec4 texelFetch(const texture2D &t, const ivec2 &coord, int32_t)
+{
+	return texelFetch(t.image, coord);
+}
+inline vec4 texelFetch(const sampler3D &s, const ivec3 &coord, int32_t)
+{
+	return s.image.fetch(coord.x, coord.y, coord.z);
+}
+inline vec4 texelFetch(const texture3D &t, const ivec3 &coord, int32_t)
+{
+	return t.image.fetch(coord.x, coord.y, coord.z);
+}
+
+inline ivec2 textureSize(const sampler2D &s, int32_t)
+{
+	return ivec2(s.image.width, s.image.height);
+}
+inline ivec2 textureSize(const texture2D &t, int32_t)
+{
+	return ivec2(t.image.width, t.image.height);
+}
+inline ivec3 textureSize(const sampler3D &s, int32_t)
+{
+	return ivec3(s.image.width, s.image.height, s.image.depth);
+}
+inline ivec3 textureSize(const texture3D &t, int32_t)
+{
+	return ivec3(t.image.width, t.image.height, t.image.depth);
+}
+inline ivec2 textureSize(const samplerCube &s, int32_t)
+{
+	return ivec2(s.image.width, s.image.height);
+}
+inline ivec2 textureSize(const textureCube &t, int32_t)
+{
+	return ivec2(t.image.width, t.image.height);
+}
+
+// streaming of the values - leaf by leaf, in declaration order
+template <typename T, typename F>
+inline typename std::enable_if<std::is_arithmetic<T>::value>::type for_each_leaf(T &v, F &f);
+template <typename T, int N, typename F>
+inline void for_each_leaf(vec<T, N> &v, F &f);
+template <typename T, int C, int R, typename F>
+inline void for_each_leaf(mat<T, C, R> &m, F &f);
+template <typename T, int N, typename F>
+inline void for_each_leaf(array<T, N> &a, F &f);
+template <typename T, typename F>
+inline typename std::enable_if<is_image<T>::value || std::is_same<T, sampler>::value>::type for_each_leaf(T &, F &f);
+template <typename T, typename F>
+inline auto for_each_leaf(T &s, F &f) -> decltype(s.spvc_visit(f));
+
+template <typename T, typename F>
+inline typename std::enable_if<std::is_arithmetic<T>::value>::type for_each_leaf(T &v, F &f)
+{
+	f(v);
+}
+
+template <typename T, int N, typename F>
+inline void for_each_leaf(vec<T, N> &v, F &f)
+{
+	for (int i = 0; i < N; i++)
+		f(v.at(i));
+}
+
+template <typename T, int C, int R, typename F>
+inline void for_each_leaf(mat<T, C, R> &m, F &f)
+{
+	for (int c = 0; c < C; c++)
+		for_each_leaf(m.columns[c], f);
+}
+
+template <typename T, int N, typename F>
+inline void for_each_leaf(array<T, N> &a, F &f)
+{
+	for (int i = 0; i < N; i++)
+		for_each_leaf(a.elements[i], f);
+}
+
+// opaque types still take up a slot in the VM
+template <typename T, typename F>
+inline typename std::enable_if<is_image<T>::value || std::is_same<T, sampler>::value>::type for_each_leaf(T &, F &f)
+{
+	f.skip();
+}
+
+// generated structs call f(member) for each of their members
+template <typename T, typename F>
+inline auto for_each_leaf(T &s, F &f) -> decltype(s.spvc_visit(f))
+{
+	return s.spvc_visit(f);
+}
+
+struct leaf_reader
+{
+	const uint64_t *values;
+	uint32_t count;
+	uint32_t index;
+
+	template <typename T>
+	void operator()(T &member)
+	{
+		for_each_leaf(member, *this);
+	}
+
+	template <typename T>
+	typename std::enable_if<std::is_arithmetic<T>::value>::type read(T &v)
+	{
+		if (index < count)
+		{
+			if (std::is_same<T, bool>::value)
+				v = T((values[index] & 0xffu) != 0);
+			else
+				std::memcpy(&v, &values[index], sizeof(T));
+		}
+		index++;
+	}
+
+	void operator()(float &v)
+	{
+		read(v);
+	}
+	void operator()(double &v)
+	{
+		read(v);
+	}
+	void operator()(int32_t &v)
+	{
+		read(v);
+	}
+	void operator()(uint32_t &v)
+	{
+		read(v);
+	}
+	void operator()(int64_t &v)
+	{
+		read(v);
+	}
+	void operator()(uint64_t &v)
+	{
+		read(v);
+	}
+	void operator()(bool &v)
+	{
+		read(v);
+	}
+	void skip()
+	{
+		index++;
+	}
+};
+
+struct leaf_writer
+{
+	uint64_t *values;
+	uint32_t count;
+	uint32_t index;
+
+	template <typename T>
+	void operator()(T &member)
+	{
+		for_each_leaf(member, *this);
+	}
+
+	template <typename T>
+	typename std::enable_if<std::is_arithmetic<T>::value>::type write(const T &v)
+	{
+		if (index < count)
+		{
+			values[index] = 0;
+			std::memcpy(&values[index], &v, sizeof(T));
+		}
+		index++;
+	}
+
+	void operator()(float &v)
+	{
+		write(v);
+	}
+	void operator()(double &v)
+	{
+		write(v);
+	}
+	void operator()(int32_t &v)
+	{
+		write(v);
+	}
+	void operator()(uint32_t &v)
+	{
+		write(v);
+	}
+	void operator()(int64_t &v)
+	{
+		write(v);
+	}
+	void operator()(uint64_t &v)
+	{
+		write(v);
+	}
+	void operator()(bool &v)
+	{
+		write(v);
+	}
+	void skip()
+	{
+		index++;
+	}
+};
+
+struct image_binder
+{
+	image_data image;
+
+	template <typename T>
+	typename std::enable_if<is_image<T>::value>::type operator()(T &t)
+	{
+		t.image = image;
+	}
+
+	template <typename T>
+	typename std::enable_if<!is_image<T>::value>::type operator()(T &)
+	{
+	}
+};
+
+// members every generated shader has
+struct shader_base
+{
+	spirv_cross_stats *spvc_stats = nullptr;
+
+	vec4 gl_FragCoord = vec4(0.0f);
+	bool gl_FrontFacing = true;
+	float gl_FragDepth = 0.0f;
+	vec2 gl_PointCoord = vec2(0.0f);
+	int32_t gl_PrimitiveID = 0;
+	int32_t gl_SampleID = 0;
+	vec2 gl_SamplePosition = vec2(0.5f);
+	bool gl_HelperInvocation = false;
+	int32_t gl_Layer = 0;
+	int32_t gl_ViewportIndex = 0;
+};
+
+// the C interface for a generated shader type S
+template <typename S>
+struct shader_interface
+{
+	static void *create()
+	{
+		return new S();
+	}
+
+	static void destroy(void *shader)
+	{
+		delete static_cast<S *>(shader);
+	}
+
+	static uint32_t write(void *shader, uint32_t resource, const uint64_t *values, uint32_t count)
+	{
+		leaf_reader reader = { values, count, 0 };
+		static_cast<S *>(shader)->spvc_visit_resource(resource, reader);
+		return reader.index;
+	}
+
+	static uint32_t read(void *shader, uint32_t resource, uint64_t *values, uint32_t count)
+	{
+		leaf_writer writer = { values, count, 0 };
+		static_cast<S *>(shader)->spvc_visit_resource(resource, writer);
+		return writer.index;
+	}
+
+	static void bind_image(void *shader, uint32_t resource, const float *texels, int32_t width, int32_t height,
+	                       int32_t depth)
+	{
+		image_binder binder;
+		binder.image.texels = texels;
+		binder.image.width = width;
+		binder.image.height = height;
+		binder.image.depth = depth;
+		static_cast<S *>(shader)->spvc_visit_resource(resource, binder);
+	}
+
+	static int32_t invoke(void *shader, const float *frag_coord, spirv_cross_stats *stats)
+	{
+		S &s = *static_cast<S *>(shader);
+		s.spvc_stats = stats;
+		s.gl_FragCoord = vec4(frag_coord[0], frag_coord[1], frag_coord[2], frag_coord[3]);
+		current_stats() = stats;
+
+		int32_t ret = 1;
+		try
+		{
+			s.spvc_reset();
+			s.main();
+		}
+		catch (const discard_exception &)
+		{
+			ret = 0;
+		}
+
+		current_stats() = nullptr;
+		return ret;
+	}
+
+	static const spirv_cross_interface *get()
+	{
+		static spirv_cross_interface iface = {
+			SPIRV_CROSS_INTERFACE_VERSION,
+			S::spvc_resource_count,
+			S::spvc_resources(),
+			create,
+			destroy,
+			write,
+			read,
+			bind_image,
+			invoke
+		};
+		return &iface;
+	}
+};
+} // namespace spirv_cross_runtime
+
+// instrumentation emitted by the backend - expressions so that they can live in for-loop continue blocks
+#define SPIRV_CROSS_COUNT(n) (spvc_stats->instruction_count += (n))
+#define SPIRV_CROSS_LINE(n) (spvc_stats->line = (n))
+
+#define SPIRV_CROSS_DEFINE_INTERFACE(shader_type)                                              \
+	extern "C" SPIRV_CROSS_EXPORT const spirv_cross_interface *spirv_cross_get_interface(void) \
+	{                                                                                          \
+		return spirv_cross_runtime::shader_interface<shader_type>::get();                      \
+	}
+
+#endif
@@ -5,10 +5,14 @@
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 #include <SHADERed/EditorEngine.h>
+#include <SHADERed/HeadlessRenderer.h>
+#include <SHADERed/Engine/HeadlessContext.h>
+#include <SHADERed/Objects/Benchmark.h>
 #include <SHADERed/Objects/CommandLineOptionParser.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/ShaderCache.h>
 #include <SHADERed/Objects/Export/ExportCPP.h>
 #include <glslang/Public/ShaderLang.h>
 
@@ -71,6 +75,9 @@ int main(int argc, char* argv[])
 	coptsParser.Parse(cmdDir, argc - 1, argv + 1);
 	coptsParser.Execute();
 
+	if ((coptsParser.Render && coptsParser.RenderPath == "-") || (coptsParser.Benchmark && coptsParser.BenchmarkPath == "-"))
+		ed::Logger::Get().UseStderr = true;
+
 	if (!coptsParser.LaunchUI)
 		return 0;
 
@@ -138,6 +145,16 @@ int main(int argc, char* argv[])
 	if (!std::filesystem::exists(ed::Settings::Instance().ConvertPath("temp/"), fsError))
 		std::filesystem::create_directory(ed::Settings::Instance().ConvertPath("temp/"), fsError);
 
+	// --cacheclear
+	if (coptsParser.ClearShaderCache) {
+		ed::ShaderCache::Instance().Initialize(ed::Settings::Instance().ConvertPath("cache/shaders/"), 0);
+		ed::ShaderCache::Instance().Clear();
+		printf("Cleared the shader cache.\n");
+
+		if (coptsParser.ProjectFile.empty())
+			return 0;
+	}
+
 	// delete log.txt on startup
 	if (std::filesystem::exists(ed::Settings::Instance().ConvertPath("log.txt"), fsError))
 		std::filesystem::remove(ed::Settings::Instance().ConvertPath("log.txt"), fsError);
@@ -146,6 +163,33 @@ int main(int argc, char* argv[])
 	stbi_flip_vertically_on_write(1);
 	stbi_set_flip_vertically_on_load(1);
 
+	// render with no window, display server or UI
+	if ((coptsParser.Render || coptsParser.Benchmark) && coptsParser.RenderHeadless) {
+		ed::eng::HeadlessContext context;
+		if (!context.Create()) {
+			fprintf(stderr, "Failed to create a headless OpenGL context.\n");
+			ed::Logger::Get().Save();
+			return 1;
+		}
+
+		int exitCode = 0;
+		{
+			ed::HeadlessRenderer renderer;
+			renderer.Open(coptsParser.ProjectFile);
+			if (coptsParser.Benchmark)
+				exitCode = renderer.RunBenchmark(coptsParser);
+			else {
+				fprintf(coptsParser.RenderPath == "-" ? stderr : stdout, "Rendering to file...\n");
+				renderer.Render(coptsParser);
+			}
+		}
+
+		context.Destroy();
+		ed::Logger::Get().Save();
+
+		return exitCode;
+	}
+
 	// init sdl2
 	if (!glfwInit()) {
 		ed::Logger::Get().Log("Failed to initialize SDL2", true);
@@ -233,7 +277,7 @@ int main(int argc, char* argv[])
 
 	bool run = true; // should we enter the infinite loop?
 	// make the window invisible if only rendering to a file
-	if (coptsParser.Render || coptsParser.ConvertCPP) {
+	if (coptsParser.Render || coptsParser.Benchmark || coptsParser.ConvertCPP || coptsParser.PrewarmShaderCache) {
 		maximized = false;
 		fullscreen = false;
 		run = false;
@@ -303,10 +347,30 @@ int main(int argc, char* argv[])
 	// render to file
 	if (coptsParser.Render) {
 		engine.UI().Open(coptsParser.ProjectFile);
-		printf("Rendering to file...\n");
+		fprintf(coptsParser.RenderPath == "-" ? stderr : stdout, "Rendering to file...\n");
 		engine.UI().SavePreviewToFile();
 	}
 
+	// measure the GPU & CPU time of each pass
+	int exitCode = 0;
+	if (coptsParser.Benchmark) {
+		engine.UI().Open(coptsParser.ProjectFile);
+		ed::Benchmark benchmark;
+		benchmark.LoadCommandLineOptions(coptsParser);
+		benchmark.Run(&engine.Interface().Renderer);
+		exitCode = benchmark.Report();
+	}
+
+	// compile all of the shaders so that the next launch can load them from the cache
+	if (coptsParser.PrewarmShaderCache) {
+		ed::ShaderCache::Instance().SetEnabled(true);
+		engine.UI().Open(coptsParser.ProjectFile);
+		printf("Prewarming the shader cache...\n");
+		engine.Interface().Renderer.Render();
+		engine.Interface().Renderer.FinishCompilation();
+		printf("Shader cache: %d hits, %d misses, %d entries\n", ed::ShaderCache::Instance().GetHitCount(), ed::ShaderCache::Instance().GetMissCount(), ed::ShaderCache::Instance().GetEntryCount());
+	}
+
 	// start the DAP server
 	if (coptsParser.StartDAPServer)
 		engine.Interface().DAP.Initialize();
@@ -453,7 +517,7 @@ int main(int argc, char* argv[])
 
 	// save window size
 	preloadDatPath = ed::Settings::Instance().ConvertPath("data/preload.dat");
-	if (!coptsParser.Render && !coptsParser.ConvertCPP) {
+	if (!coptsParser.Render && !coptsParser.Benchmark && !coptsParser.ConvertCPP && !coptsParser.PrewarmShaderCache) {
 		ed::Logger::Get().Log("Saving window information");
 
 		std::ofstream save(preloadDatPath);
@@ -483,7 +547,7 @@ int main(int argc, char* argv[])
 
 	ed::Logger::Get().Save();
 
-	return 0;
+	return exitCode;
 }
 
 void SetIcon(GLFWwindow* wnd)
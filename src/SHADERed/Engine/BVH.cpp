@@ -0,0 +1,244 @@
+#include <SHADERed/Engine/BVH.h>
+#include <SHADERed/Engine/Ray.h>
+
+#include <algorithm>
+#include <limits>
+
+#define BVH_BIN_COUNT 12
+#define BVH_LEAF_SIZE 4
+
+namespace ed {
+	namespace eng {
+		BVH::BVH()
+		{
+		}
+		void BVH::Clear()
+		{
+			m_nodes.clear();
+			m_positions.clear();
+			m_indices.clear();
+		}
+		void BVH::Build(std::vector<glm::vec3>&& positions, std::vector<unsigned int>&& indices)
+		{
+			Clear();
+
+			// drop the triangles that reference vertices which don't exist
+			size_t triCount = 0;
+			for (size_t i = 0; i + 2 < indices.size(); i += 3) {
+				if (indices[i] >= positions.size() || indices[i + 1] >= positions.size() || indices[i + 2] >= positions.size())
+					continue;
+				indices[triCount * 3 + 0] = indices[i + 0];
+				indices[triCount * 3 + 1] = indices[i + 1];
+				indices[triCount * 3 + 2] = indices[i + 2];
+				triCount++;
+			}
+			indices.resize(triCount * 3);
+
+			if (triCount == 0)
+				return;
+
+			m_positions = std::move(positions);
+
+			// per triangle bounds & centroids, sorted through a list of triangle IDs
+			std::vector<glm::vec3> triMin(triCount), triMax(triCount), centroid(triCount);
+			std::vector<unsigned int> tris(triCount);
+			for (size_t i = 0; i < triCount; i++) {
+				const glm::vec3& v0 = m_positions[indices[i * 3 + 0]];
+				const glm::vec3& v1 = m_positions[indices[i * 3 + 1]];
+				const glm::vec3& v2 = m_positions[indices[i * 3 + 2]];
+				triMin[i] = glm::min(v0, glm::min(v1, v2));
+				triMax[i] = glm::max(v0, glm::max(v1, v2));
+				centroid[i] = (triMin[i] + triMax[i]) * 0.5f;
+				tris[i] = i;
+			}
+
+			auto area = [](const glm::vec3& minb, const glm::vec3& maxb) -> float {
+				glm::vec3 e = maxb - minb;
+				return e.x * e.y + e.y * e.z + e.z * e.x;
+			};
+
+			struct BuildTask {
+				unsigned int Node, Start, Count;
+			};
+			std::vector<BuildTask> tasks;
+
+			m_nodes.reserve(triCount * 2 / BVH_LEAF_SIZE + 1);
+			m_nodes.push_back(Node());
+			tasks.push_back({ 0, 0, (unsigned int)triCount });
+
+			while (!tasks.empty()) {
+				BuildTask task = tasks.back();
+				tasks.pop_back();
+
+				glm::vec3 minb(std::numeric_limits<float>::infinity()), maxb(-std::numeric_limits<float>::infinity());
+				glm::vec3 cmin = minb, cmax = maxb;
+				for (unsigned int i = task.Start; i < task.Start + task.Count; i++) {
+					minb = glm::min(minb, triMin[tris[i]]);
+					maxb = glm::max(maxb, triMax[tris[i]]);
+					cmin = glm::min(cmin, centroid[tris[i]]);
+					cmax = glm::max(cmax, centroid[tris[i]]);
+				}
+				m_nodes[task.Node].Min = minb;
+				m_nodes[task.Node].Max = maxb;
+
+				// find the cheapest split plane - SAH, evaluated on BVH_BIN_COUNT bins along each axis
+				int bestAxis = -1, bestSplit = 0;
+				float bestCost = area(minb, maxb) * task.Count; // cost of not splitting at all
+				if (task.Count > BVH_LEAF_SIZE) {
+					for (int axis = 0; axis < 3; axis++) {
+						float extent = cmax[axis] - cmin[axis];
+						if (extent <= 0.0f)
+							continue;
+
+						struct Bin {
+							glm::vec3 Min, Max;
+							unsigned int Count;
+						} bins[BVH_BIN_COUNT];
+						for (int b = 0; b < BVH_BIN_COUNT; b++) {
+							bins[b].Min = glm::vec3(std::numeric_limits<float>::infinity());
+							bins[b].Max = glm::vec3(-std::numeric_limits<float>::infinity());
+							bins[b].Count = 0;
+						}
+
+						float scale = BVH_BIN_COUNT / extent;
+						for (unsigned int i = task.Start; i < task.Start + task.Count; i++) {
+							unsigned int tri = tris[i];
+							int b = std::min<int>(BVH_BIN_COUNT - 1, (int)((centroid[tri][axis] - cmin[axis]) * scale));
+							bins[b].Min = glm::min(bins[b].Min, triMin[tri]);
+							bins[b].Max = glm::max(bins[b].Max, triMax[tri]);
+							bins[b].Count++;
+						}
+
+						// sweep from the right, then from the left
+						float rightArea[BVH_BIN_COUNT];
+						unsigned int rightCount[BVH_BIN_COUNT];
+						glm::vec3 rmin(std::numeric_limits<float>::infinity()), rmax(-std::numeric_limits<float>::infinity());
+						unsigned int rcount = 0;
+						for (int b = BVH_BIN_COUNT - 1; b > 0; b--) {
+							rmin = glm::min(rmin, bins[b].Min);
+							rmax = glm::max(rmax, bins[b].Max);
+							rcount += bins[b].Count;
+							rightArea[b] = rcount ? area(rmin, rmax) : 0.0f;
+							rightCount[b] = rcount;
+						}
+
+						glm::vec3 lmin(std::numeric_limits<float>::infinity()), lmax(-std::numeric_limits<float>::infinity());
+						unsigned int lcount = 0;
+						for (int b = 0; b < BVH_BIN_COUNT - 1; b++) {
+							lmin = glm::min(lmin, bins[b].Min);
+							lmax = glm::max(lmax, bins[b].Max);
+							lcount += bins[b].Count;
+
+							if (lcount == 0 || rightCount[b + 1] == 0)
+								continue;
+
+							float cost = area(lmin, lmax) * lcount + rightArea[b + 1] * rightCount[b + 1];
+							if (cost < bestCost) {
+								bestCost = cost;
+								bestAxis = axis;
+								bestSplit = b;
+							}
+						}
+					}
+				}
+
+				// leaf
+				if (bestAxis == -1) {
+					m_nodes[task.Node].Start = task.Start;
+					m_nodes[task.Node].Count = task.Count;
+					continue;
+				}
+
+				float extent = cmax[bestAxis] - cmin[bestAxis];
+				float scale = BVH_BIN_COUNT / extent;
+				float splitMin = cmin[bestAxis];
+				auto mid = std::partition(tris.begin() + task.Start, tris.begin() + task.Start + task.Count, [&](unsigned int tri) {
+					return std::min<int>(BVH_BIN_COUNT - 1, (int)((centroid[tri][bestAxis] - splitMin) * scale)) <= bestSplit;
+				});
+				unsigned int leftCount = (unsigned int)(mid - tris.begin()) - task.Start;
+
+				unsigned int left = m_nodes.size();
+				unsigned int right = left + 1;
+				m_nodes.push_back(Node());
+				m_nodes.push_back(Node());
+
+				m_nodes[task.Node].Start = left;
+				m_nodes[task.Node].Count = 0;
+
+				tasks.push_back({ right, task.Start + leftCount, task.Count - leftCount });
+				tasks.push_back({ left, task.Start, leftCount });
+			}
+
+			// store the triangles in the leaf order
+			m_indices.resize(triCount * 3);
+			for (size_t i = 0; i < triCount; i++) {
+				m_indices[i * 3 + 0] = indices[tris[i] * 3 + 0];
+				m_indices[i * 3 + 1] = indices[tris[i] * 3 + 1];
+				m_indices[i * 3 + 2] = indices[tris[i] * 3 + 2];
+			}
+
+			m_nodes.shrink_to_fit();
+		}
+		bool BVH::Intersect(const glm::vec3& orig, const glm::vec3& dir, float& distHit) const
+		{
+			if (m_nodes.empty())
+				return false;
+
+			glm::vec3 invDir = 1.0f / dir;
+			float closest = std::numeric_limits<float>::infinity();
+
+			// slab test, returns the entry distance
+			auto hitBox = [&](const Node& node, float& tnear) -> bool {
+				glm::vec3 t0 = (node.Min - orig) * invDir;
+				glm::vec3 t1 = (node.Max - orig) * invDir;
+				glm::vec3 tmin = glm::min(t0, t1), tmax = glm::max(t0, t1);
+				tnear = std::max<float>(std::max<float>(tmin.x, tmin.y), std::max<float>(tmin.z, 0.0f));
+				float tfar = std::min<float>(std::min<float>(tmax.x, tmax.y), tmax.z);
+				return tnear <= tfar && tnear < closest;
+			};
+
+			std::vector<unsigned int> stack;
+			stack.reserve(64);
+
+			float tnear = 0.0f;
+			if (hitBox(m_nodes[0], tnear))
+				stack.push_back(0);
+
+			while (!stack.empty()) {
+				const Node& node = m_nodes[stack.back()];
+				stack.pop_back();
+
+				if (node.Count > 0) {
+					for (unsigned int i = node.Start; i < node.Start + node.Count; i++) {
+						float hit = 0.0f;
+						if (ray::IntersectTriangle(orig, dir, m_positions[m_indices[i * 3 + 0]], m_positions[m_indices[i * 3 + 1]], m_positions[m_indices[i * 3 + 2]], hit) && hit < closest)
+							closest = hit;
+					}
+					continue;
+				}
+
+				// visit the closer child first
+				unsigned int left = node.Start, right = node.Start + 1;
+				float tleft = 0.0f, tright = 0.0f;
+				bool hitLeft = hitBox(m_nodes[left], tleft);
+				bool hitRight = hitBox(m_nodes[right], tright);
+
+				if (hitLeft && hitRight) {
+					if (tleft < tright)
+						std::swap(left, right);
+					stack.push_back(left); // farther one
+					stack.push_back(right);
+				} else if (hitLeft)
+					stack.push_back(left);
+				else if (hitRight)
+					stack.push_back(right);
+			}
+
+			if (closest == std::numeric_limits<float>::infinity())
+				return false;
+
+			distHit = closest;
+			return true;
+		}
+	}
+}
\ No newline at end of file
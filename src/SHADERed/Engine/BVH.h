@@ -0,0 +1,39 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <vector>
+
+namespace ed {
+	namespace eng {
+		// bounding volume hierarchy over an indexed triangle list - used for picking
+		// nodes are stored in a single array with the siblings next to each other, built with a binned SAH
+		class BVH {
+		public:
+			BVH();
+
+			// indices: 3 per triangle, positions are moved into the BVH
+			void Build(std::vector<glm::vec3>&& positions, std::vector<unsigned int>&& indices);
+			void Clear();
+
+			// closest hit, distance is in the units of dir (dir doesn't have to be normalized)
+			bool Intersect(const glm::vec3& orig, const glm::vec3& dir, float& distHit) const;
+
+			inline bool IsEmpty() const { return m_nodes.empty(); }
+			inline glm::vec3 GetMinBound() const { return m_nodes.empty() ? glm::vec3(0.0f) : m_nodes[0].Min; }
+			inline glm::vec3 GetMaxBound() const { return m_nodes.empty() ? glm::vec3(0.0f) : m_nodes[0].Max; }
+			inline size_t GetTriangleCount() const { return m_indices.size() / 3; }
+			inline const std::vector<glm::vec3>& GetPositions() const { return m_positions; }
+
+		private:
+			struct Node {
+				glm::vec3 Min;
+				unsigned int Start; // leaf: first triangle, inner node: left child (right child is at Start + 1)
+				glm::vec3 Max;
+				unsigned int Count; // 0 -> inner node
+			};
+
+			std::vector<Node> m_nodes;
+			std::vector<glm::vec3> m_positions;
+			std::vector<unsigned int> m_indices; // reordered so that each leaf's triangles are contiguous
+		};
+	}
+}
\ No newline at end of file
@@ -187,7 +187,24 @@ namespace ed {
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 		}
 
-		void CreateVAO(GLuint& geoVAO, GLuint geoVBO, const std::vector<InputLayoutItem>& ilayout, GLuint geoEBO, GLuint bufVBO, std::vector<ed::ShaderVariable::ValueType> types)
+		// attributes that aren't stored in the vertex buffer read a constant from here
+		// (a huge divisor makes every instance read the first element - constant vertex attributes aren't a part of the VAO state)
+		static GLuint GetMissingAttributeBuffer()
+		{
+			static GLuint buffer = 0;
+			if (buffer == 0) {
+				const GLfloat values[] = { 0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+				glGenBuffers(1, &buffer);
+				glBindBuffer(GL_ARRAY_BUFFER, buffer);
+				glBufferData(GL_ARRAY_BUFFER, sizeof(values), values, GL_STATIC_DRAW);
+			}
+			return buffer;
+		}
+		void CreateVAO(eng::Model* model, const std::vector<InputLayoutItem>& ilayout, GLuint bufVBO, std::vector<ed::ShaderVariable::ValueType> types)
+		{
+			CreateVAO(model->VAO, model->VBO, ilayout, model->EBO, bufVBO, types, model->GetVertexFormat());
+		}
+		void CreateVAO(GLuint& geoVAO, GLuint geoVBO, const std::vector<InputLayoutItem>& ilayout, GLuint geoEBO, GLuint bufVBO, std::vector<ed::ShaderVariable::ValueType> types, const VertexFormat& vfmt)
 		{
 			int fmtIndex = 0;
 
@@ -202,12 +219,21 @@ namespace ed {
 			GLuint layOffset = 0;
 			for (const auto& layitem : ilayout) {
 				GLint size = InputLayoutItem::GetValueSize(layitem.Value);
-				GLint offset = InputLayoutItem::GetValueOffset(layitem.Value) * sizeof(GLfloat);
+
 				if (layitem.Value >= InputLayoutValue::BufferFloat && layitem.Value <= InputLayoutValue::BufferInt4)
-					offset = layOffset;
+					glVertexAttribPointer(fmtIndex, size, GL_FLOAT, GL_FALSE, vfmt.Stride, (void*)layOffset);
+				else {
+					const VertexAttributeFormat& attr = vfmt.Get(layitem.Value);
+					if (attr.Type == 0) {
+						// not stored -> (0,0,0,1) or white for colors
+						glBindBuffer(GL_ARRAY_BUFFER, GetMissingAttributeBuffer());
+						glVertexAttribPointer(fmtIndex, 4, GL_FLOAT, GL_FALSE, 0, (void*)((layitem.Value == InputLayoutValue::Color) * 4 * sizeof(GLfloat)));
+						glVertexAttribDivisor(fmtIndex, 0xFFFFFFFF);
+						glBindBuffer(GL_ARRAY_BUFFER, geoVBO);
+					} else
+						glVertexAttribPointer(fmtIndex, attr.Components, attr.Type, attr.Normalized, vfmt.Stride, (void*)attr.Offset);
+				}
 
-				// vertex positions
-				glVertexAttribPointer(fmtIndex, size, GL_FLOAT, GL_FALSE, 18 * sizeof(float), (void*)offset);
 				glEnableVertexAttribArray(fmtIndex);
 				fmtIndex++;
 				layOffset += size;
@@ -276,40 +302,7 @@ namespace ed {
 				return;
 			}
 
-			std::vector<ShaderVariable::ValueType> tData = objs->ParseBufferFormat(buffer->ViewFormat);
-
-			int stride = 0;
-			for (const auto& dataEl : tData)
-				stride += ShaderVariable::GetSize(dataEl, true);
-
-			GLfloat* bufPtr = (GLfloat*)malloc(buffer->Size);
-
-			glBindBuffer(GL_ARRAY_BUFFER, buffer->ID);
-			glGetBufferSubData(GL_ARRAY_BUFFER, 0, buffer->Size, &bufPtr[0]);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-			int rows = buffer->Size / stride;
-
-			if (tData.size() > 0) {
-				minPosItem = glm::vec3(0.0f);
-				maxPosItem = glm::vec3(0.0f);
-
-				int rowStride = stride / 4;
-
-				for (int r = 0; r < rows; r++) {
-					GLfloat* curPtr = bufPtr + r * rowStride;
-
-					int elCount = ShaderVariable::GetSize(tData[0]) / 4;
-					if (elCount >= 4) elCount = 3;
-
-					for (int c = 0; c < elCount; c++) {
-						minPosItem[c] = glm::min(minPosItem[c], curPtr[c]);
-						maxPosItem[c] = glm::max(maxPosItem[c], curPtr[c]);
-					}
-				}
-			}
-
-			free(bufPtr);
+			objs->GetBufferBounds(buffer, minPosItem, maxPosItem);
 		}
 
 		bool isAllDigits(const std::string& str)
@@ -326,7 +319,8 @@ namespace ed {
 			std::istringstream f(str);
 			std::string line;
 			while (std::getline(f, line)) {
-				if (line.find("ERROR:") != std::string::npos) {
+				bool isWarning = line.find("WARNING:") != std::string::npos;
+				if (line.find("ERROR:") != std::string::npos || isWarning) {
 					size_t firstD = line.find_first_of(':');
 					size_t secondD = line.find_first_of(':', firstD + 1);
 					size_t thirdD = line.find_first_of(':', secondD + 1);
@@ -339,7 +333,7 @@ namespace ed {
 					if (isAllDigits(lineStr))
 						lineNr = std::stoi(lineStr);
 					std::string msg = line.substr(thirdD + 2);
-					ret.push_back(MessageStack::Message(MessageStack::Type::Error, owner, msg, lineNr, stage));
+					ret.push_back(MessageStack::Message(isWarning ? MessageStack::Type::Warning : MessageStack::Type::Error, owner, msg, lineNr, stage));
 				} else if (line.size() > 0 && line[0] == '(' && line.find("error") != std::string::npos) {
 					size_t firstP = line.find_first_of(')');
 
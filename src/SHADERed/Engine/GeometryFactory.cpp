@@ -259,6 +259,7 @@ namespace ed {
 			glGenBuffers(1, &vbo);
 			glBindBuffer(GL_ARRAY_BUFFER, vbo);
 			glBufferData(GL_ARRAY_BUFFER, 36 * 18 * sizeof(GLfloat), cubeData, GL_STATIC_DRAW | GL_STATIC_READ);
+			m_storeVertexData(vbo, cubeData, 36 * 18);
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 			GLuint vao = 0;
@@ -299,6 +300,7 @@ namespace ed {
 			glGenBuffers(1, &vbo);
 			glBindBuffer(GL_ARRAY_BUFFER, vbo);
 			glBufferData(GL_ARRAY_BUFFER, numPoints * 18 * sizeof(GLfloat), circleData, GL_STATIC_DRAW);
+			m_storeVertexData(vbo, circleData, numPoints * 18);
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 			GLuint vao = 0;
@@ -328,6 +330,7 @@ namespace ed {
 			glGenBuffers(1, &vbo);
 			glBindBuffer(GL_ARRAY_BUFFER, vbo);
 			glBufferData(GL_ARRAY_BUFFER, 6 * 18 * sizeof(GLfloat), planeData, GL_STATIC_DRAW);
+			m_storeVertexData(vbo, planeData, 6 * 18);
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 			GLuint vao = 0;
@@ -362,6 +365,7 @@ namespace ed {
 			glGenBuffers(1, &vbo);
 			glBindBuffer(GL_ARRAY_BUFFER, vbo);
 			glBufferData(GL_ARRAY_BUFFER, count * 18 * sizeof(GLfloat), sphereData, GL_STATIC_DRAW);
+			m_storeVertexData(vbo, sphereData, count * 18);
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 			GLuint vao = 0;
@@ -386,6 +390,7 @@ namespace ed {
 			glGenBuffers(1, &vbo);
 			glBindBuffer(GL_ARRAY_BUFFER, vbo);
 			glBufferData(GL_ARRAY_BUFFER, 3 * 18 * sizeof(GLfloat), triData, GL_STATIC_DRAW);
+			m_storeVertexData(vbo, triData, 3 * 18);
 			glBindBuffer(GL_ARRAY_BUFFER, 0);
 
 			GLuint vao = 0;
@@ -418,6 +423,7 @@ namespace ed {
 
 			// vbo data
 			glBufferData(GL_ARRAY_BUFFER, 6 * 4 * sizeof(GLfloat), sqData, GL_STATIC_DRAW);
+			m_storeVertexData(vbo, sqData, 6 * 4);
 
 			// vertex positions
 			glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (void*)0);
@@ -432,5 +438,23 @@ namespace ed {
 
 			return vao;
 		}
+
+		std::unordered_map<unsigned int, std::vector<float>> GeometryFactory::m_vertexData;
+
+		const std::vector<float>* GeometryFactory::GetVertexData(unsigned int vbo)
+		{
+			auto it = m_vertexData.find(vbo);
+			if (it == m_vertexData.end())
+				return nullptr;
+			return &it->second;
+		}
+		void GeometryFactory::ReleaseVertexData(unsigned int vbo)
+		{
+			m_vertexData.erase(vbo);
+		}
+		void GeometryFactory::m_storeVertexData(unsigned int vbo, const float* data, size_t count)
+		{
+			m_vertexData[vbo] = std::vector<float>(data, data + count);
+		}
 	}
 }
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 #include <glm/glm.hpp>
+#include <unordered_map>
 #include <vector>
 
 #include <SHADERed/Objects/InputLayout.h>
@@ -25,6 +26,14 @@ namespace ed {
 			static unsigned int CreateSphere(unsigned int& vbo, float r, const std::vector<InputLayoutItem>& inp);
 			static unsigned int CreateTriangle(unsigned int& vbo, float s, const std::vector<InputLayoutItem>& inp);
 			static unsigned int CreateScreenQuadNDC(unsigned int& vbo, const std::vector<InputLayoutItem>& inp);
+
+			// CPU copy of the data uploaded to the vbo (18 floats per vertex, 4 for the NDC screen quad) - nullptr if the vbo wasn't created here
+			static const std::vector<float>* GetVertexData(unsigned int vbo);
+			static void ReleaseVertexData(unsigned int vbo);
+
+		private:
+			static void m_storeVertexData(unsigned int vbo, const float* data, size_t count);
+			static std::unordered_map<unsigned int, std::vector<float>> m_vertexData;
 		};
 	}
 }
\ No newline at end of file
@@ -0,0 +1,175 @@
+#include <SHADERed/Engine/HeadlessContext.h>
+#include <SHADERed/Objects/Logger.h>
+
+#include <GL/glew.h>
+#if defined(SHADERED_HEADLESS_EGL)
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#elif defined(SHADERED_HEADLESS_OSMESA)
+#include <GL/osmesa.h>
+#endif
+
+#include <string.h>
+#include <string>
+
+namespace ed {
+	namespace eng {
+		HeadlessContext::HeadlessContext()
+		{
+			m_created = false;
+			m_display = nullptr;
+			m_context = nullptr;
+			m_osmesa = nullptr;
+		}
+		HeadlessContext::~HeadlessContext()
+		{
+			Destroy();
+		}
+		bool HeadlessContext::IsSupported()
+		{
+#if defined(SHADERED_HEADLESS_EGL) || defined(SHADERED_HEADLESS_OSMESA)
+			return true;
+#else
+			return false;
+#endif
+		}
+		bool HeadlessContext::Create()
+		{
+			Destroy();
+
+#if defined(SHADERED_HEADLESS_EGL)
+			EGLDisplay display = EGL_NO_DISPLAY;
+
+			// surfaceless platform doesn't need X/Wayland or a DRM device
+			const char* clientExts = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+			PFNEGLGETPLATFORMDISPLAYEXTPROC getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC)eglGetProcAddress("eglGetPlatformDisplayEXT");
+			if (getPlatformDisplay != nullptr && clientExts != nullptr && strstr(clientExts, "EGL_MESA_platform_surfaceless") != nullptr)
+				display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+			if (display == EGL_NO_DISPLAY)
+				display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+
+			EGLint major = 0, minor = 0;
+			if (display == EGL_NO_DISPLAY || !eglInitialize(display, &major, &minor)) {
+				Logger::Get().Log("Failed to initialize EGL", true);
+				return false;
+			}
+			Logger::Get().Log("Initialized EGL " + std::to_string(major) + "." + std::to_string(minor));
+
+			if (!eglBindAPI(EGL_OPENGL_API)) {
+				Logger::Get().Log("EGL implementation doesn't support desktop OpenGL", true);
+				eglTerminate(display);
+				return false;
+			}
+
+			// we only render to FBOs - no surface needed
+			const EGLint configAttribs[] = {
+				EGL_SURFACE_TYPE, 0,
+				EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+				EGL_RED_SIZE, 8,
+				EGL_GREEN_SIZE, 8,
+				EGL_BLUE_SIZE, 8,
+				EGL_ALPHA_SIZE, 8,
+				EGL_DEPTH_SIZE, 24,
+				EGL_STENCIL_SIZE, 8,
+				EGL_NONE
+			};
+			EGLConfig config = nullptr;
+			EGLint configCount = 0;
+			if (!eglChooseConfig(display, configAttribs, &config, 1, &configCount) || configCount == 0) {
+				Logger::Get().Log("Failed to find an EGL config", true);
+				eglTerminate(display);
+				return false;
+			}
+
+			const EGLint contextAttribs[] = {
+				EGL_CONTEXT_MAJOR_VERSION, 3,
+				EGL_CONTEXT_MINOR_VERSION, 3,
+				EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+				EGL_NONE
+			};
+			EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+			if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+				Logger::Get().Log("Failed to create an EGL context", true);
+				if (context != EGL_NO_CONTEXT)
+					eglDestroyContext(display, context);
+				eglTerminate(display);
+				return false;
+			}
+
+			m_display = display;
+			m_context = context;
+#elif defined(SHADERED_HEADLESS_OSMESA)
+			const int attribs[] = {
+				OSMESA_FORMAT, OSMESA_RGBA,
+				OSMESA_DEPTH_BITS, 24,
+				OSMESA_STENCIL_BITS, 8,
+				OSMESA_PROFILE, OSMESA_CORE_PROFILE,
+				OSMESA_CONTEXT_MAJOR_VERSION, 3,
+				OSMESA_CONTEXT_MINOR_VERSION, 3,
+				0
+			};
+			OSMesaContext context = OSMesaCreateContextAttribs(attribs, nullptr);
+
+			// OSMesa needs a color buffer to make the context current, we only render to FBOs so it can be tiny
+			m_osmesaBuffer.resize(16 * 16 * 4);
+			if (context == nullptr || !OSMesaMakeCurrent(context, m_osmesaBuffer.data(), GL_UNSIGNED_BYTE, 16, 16)) {
+				Logger::Get().Log("Failed to create an OSMesa context", true);
+				if (context != nullptr)
+					OSMesaDestroyContext(context);
+				return false;
+			}
+
+			m_osmesa = context;
+#else
+			Logger::Get().Log("SHADERed was built without the headless backend (SHADERED_HEADLESS)", true);
+			return false;
+#endif
+
+			m_created = true;
+
+			glewExperimental = true;
+			GLenum glewStatus = glewInit();
+#ifdef GLEW_ERROR_NO_GLX_DISPLAY
+			// GLEW checks for a GLX display after it has loaded the GL functions
+			if (glewStatus == GLEW_ERROR_NO_GLX_DISPLAY)
+				glewStatus = GLEW_OK;
+#endif
+			if (glewStatus != GLEW_OK) {
+				Logger::Get().Log("Failed to initialize GLEW", true);
+				Destroy();
+				return false;
+			}
+			Logger::Get().Log("Initialized GLEW");
+
+			// glewInit might have generated GL_INVALID_ENUM
+			while (glGetError() != GL_NO_ERROR)
+				;
+
+			Logger::Get().Log(std::string("Headless renderer: ") + (const char*)glGetString(GL_RENDERER));
+
+			glEnable(GL_DEPTH_TEST);
+			glEnable(GL_STENCIL_TEST);
+
+			return true;
+		}
+		void HeadlessContext::Destroy()
+		{
+			if (!m_created)
+				return;
+
+#if defined(SHADERED_HEADLESS_EGL)
+			eglMakeCurrent((EGLDisplay)m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+			eglDestroyContext((EGLDisplay)m_display, (EGLContext)m_context);
+			eglTerminate((EGLDisplay)m_display);
+#elif defined(SHADERED_HEADLESS_OSMESA)
+			OSMesaDestroyContext((OSMesaContext)m_osmesa);
+			m_osmesaBuffer.clear();
+#endif
+
+			m_display = nullptr;
+			m_context = nullptr;
+			m_osmesa = nullptr;
+			m_created = false;
+		}
+	}
+}
\ No newline at end of file
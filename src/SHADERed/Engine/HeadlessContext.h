@@ -0,0 +1,31 @@
+#pragma once
+#include <vector>
+
+namespace ed {
+	namespace eng {
+		// OpenGL 3.3 core context with no window & no display server
+		// EGL (surfaceless platform if available) when built with SHADERED_HEADLESS_EGL, OSMesa with SHADERED_HEADLESS_OSMESA
+		// Mesa's llvmpipe works with both, so no GPU is needed either
+		class HeadlessContext {
+		public:
+			HeadlessContext();
+			~HeadlessContext();
+
+			bool Create(); // creates the context, makes it current and loads the GL functions
+			void Destroy();
+
+			static bool IsSupported();
+
+		private:
+			bool m_created;
+
+			// EGL
+			void* m_display;
+			void* m_context;
+
+			// OSMesa
+			void* m_osmesa;
+			std::vector<unsigned char> m_osmesaBuffer;
+		};
+	}
+}
\ No newline at end of file
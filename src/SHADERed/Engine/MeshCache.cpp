@@ -0,0 +1,249 @@
+#include <SHADERed/Engine/MeshCache.h>
+#include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Objects/ShaderCache.h>
+
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#define MESHCACHE_MAGIC 0x48534D45 // "EMSH"
+#define MESHCACHE_VERSION 1
+#define MESHCACHE_ALIGN 16
+
+namespace ed {
+	namespace eng {
+		struct MeshCacheHeader {
+			uint32_t Magic;
+			uint32_t Version;
+			uint64_t Key;
+			uint32_t MeshCount;
+			uint32_t VertexSize; // sizeof(Model::Mesh::Vertex) - old entries are ignored if the layout changes
+			float MinBound[3];
+			float MaxBound[3];
+		};
+		struct MeshCacheEntry {
+			uint64_t NameOffset;
+			uint64_t VertexOffset;
+			uint64_t IndexOffset;
+			uint32_t NameLength;
+			uint32_t VertexCount;
+			uint32_t IndexCount;
+			uint32_t Padding;
+		};
+
+		static uint64_t alignOffset(uint64_t offset)
+		{
+			return (offset + MESHCACHE_ALIGN - 1) & ~(uint64_t)(MESHCACHE_ALIGN - 1);
+		}
+
+		MeshCache::MeshCache()
+		{
+			m_enabled = false;
+		}
+		void MeshCache::Initialize(const std::string& dir, size_t maxSize)
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+
+			if (!m_files.Open(dir, ".mesh", maxSize, "3D model cache")) {
+				Logger::Get().Log("Failed to create the 3D model cache directory " + dir, true);
+				m_enabled = false;
+				return;
+			}
+
+			m_enabled = true;
+		}
+		uint64_t MeshCache::GetKey(const std::string& path, unsigned int importFlags, unsigned int options)
+		{
+			std::error_code fsError;
+			std::filesystem::path fsPath = std::filesystem::absolute(std::filesystem::u8path(path), fsError);
+
+			uint64_t fileSize = std::filesystem::file_size(fsPath, fsError);
+			if (fsError)
+				return 0;
+			int64_t writeTime = std::filesystem::last_write_time(fsPath, fsError).time_since_epoch().count();
+			if (fsError)
+				return 0;
+
+			// hashing the contents of large models would take as long as parsing them
+			uint32_t version = MESHCACHE_VERSION;
+			uint64_t key = ShaderCache::Hash(fsPath.u8string());
+			key = ShaderCache::Hash(&fileSize, sizeof(fileSize), key);
+			key = ShaderCache::Hash(&writeTime, sizeof(writeTime), key);
+			key = ShaderCache::Hash(&importFlags, sizeof(importFlags), key);
+			key = ShaderCache::Hash(&version, sizeof(version), key);
+			if (options != 0)
+				key = ShaderCache::Hash(&options, sizeof(options), key);
+
+			return key == 0 ? 1 : key;
+		}
+		bool MeshCache::Load(uint64_t key, std::vector<Model::Mesh>& meshes, glm::vec3& minBound, glm::vec3& maxBound)
+		{
+			std::string path;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (!m_files.Contains(key))
+					return false;
+				path = m_files.GetPath(key);
+			}
+
+			bool opened = false, loaded = false;
+			std::ifstream file(path, std::ios::binary);
+			if (file.is_open()) {
+				opened = true;
+
+				file.seekg(0, std::ios::end);
+				uint64_t fileSize = file.tellg();
+				file.seekg(0, std::ios::beg);
+
+				// validate everything before touching the output
+				MeshCacheHeader header;
+				file.read((char*)&header, sizeof(header));
+				bool valid = file && fileSize >= sizeof(MeshCacheHeader) && header.Magic == MESHCACHE_MAGIC && header.Version == MESHCACHE_VERSION && header.Key == key && header.VertexSize == sizeof(Model::Mesh::Vertex) && sizeof(MeshCacheHeader) + (uint64_t)header.MeshCount * sizeof(MeshCacheEntry) <= fileSize;
+
+				std::vector<MeshCacheEntry> entries;
+				if (valid) {
+					entries.resize(header.MeshCount);
+					file.read((char*)entries.data(), entries.size() * sizeof(MeshCacheEntry));
+					valid = (bool)file;
+				}
+				for (uint32_t i = 0; valid && i < header.MeshCount; i++) {
+					const MeshCacheEntry& entry = entries[i];
+					valid = entry.NameOffset + entry.NameLength <= fileSize
+						&& entry.VertexOffset + (uint64_t)entry.VertexCount * sizeof(Model::Mesh::Vertex) <= fileSize
+						&& entry.IndexOffset + (uint64_t)entry.IndexCount * sizeof(unsigned int) <= fileSize;
+				}
+
+				if (valid) {
+					// the arrays are read straight into the meshes - no copy of the whole file in memory
+					std::vector<Model::Mesh> ret(header.MeshCount);
+					for (uint32_t i = 0; file && i < header.MeshCount; i++) {
+						const MeshCacheEntry& entry = entries[i];
+
+						ret[i].Name.resize(entry.NameLength);
+						file.seekg(entry.NameOffset);
+						file.read(&ret[i].Name[0], entry.NameLength);
+
+						ret[i].Vertices.resize(entry.VertexCount);
+						file.seekg(entry.VertexOffset);
+						file.read((char*)ret[i].Vertices.data(), (uint64_t)entry.VertexCount * sizeof(Model::Mesh::Vertex));
+
+						ret[i].Indices.resize(entry.IndexCount);
+						file.seekg(entry.IndexOffset);
+						file.read((char*)ret[i].Indices.data(), (uint64_t)entry.IndexCount * sizeof(unsigned int));
+					}
+
+					if (file) {
+						meshes = std::move(ret);
+						minBound = glm::vec3(header.MinBound[0], header.MinBound[1], header.MinBound[2]);
+						maxBound = glm::vec3(header.MaxBound[0], header.MaxBound[1], header.MaxBound[2]);
+						loaded = true;
+					}
+				}
+				file.close();
+			}
+
+			if (!loaded) {
+				// corrupted or deleted
+				if (opened)
+					Logger::Get().Log("Removing a corrupted 3D model cache entry " + path, true);
+
+				std::lock_guard<std::mutex> lock(m_mutex);
+				m_files.Remove(key);
+				return false;
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_files.Touch(key);
+
+			return true;
+		}
+		void MeshCache::Store(uint64_t key, const std::vector<Model::Mesh>& meshes, glm::vec3 minBound, glm::vec3 maxBound)
+		{
+			std::string path;
+			{
+				std::lock_guard<std::mutex> lock(m_mutex);
+				if (!m_files.IsOpen())
+					return;
+				path = m_files.GetPath(key);
+			}
+
+			MeshCacheHeader header;
+			header.Magic = MESHCACHE_MAGIC;
+			header.Version = MESHCACHE_VERSION;
+			header.Key = key;
+			header.MeshCount = meshes.size();
+			header.VertexSize = sizeof(Model::Mesh::Vertex);
+			for (int c = 0; c < 3; c++) {
+				header.MinBound[c] = minBound[c];
+				header.MaxBound[c] = maxBound[c];
+			}
+
+			// layout: header, entries, names, then the vertex & index arrays (aligned)
+			std::vector<MeshCacheEntry> entries(meshes.size());
+			uint64_t offset = sizeof(MeshCacheHeader) + entries.size() * sizeof(MeshCacheEntry);
+			for (int i = 0; i < meshes.size(); i++) {
+				entries[i].NameOffset = offset;
+				entries[i].NameLength = meshes[i].Name.size();
+				offset += meshes[i].Name.size();
+			}
+			for (int i = 0; i < meshes.size(); i++) {
+				entries[i].VertexOffset = offset = alignOffset(offset);
+				entries[i].VertexCount = meshes[i].Vertices.size();
+				offset += meshes[i].Vertices.size() * sizeof(Model::Mesh::Vertex);
+
+				entries[i].IndexOffset = offset = alignOffset(offset);
+				entries[i].IndexCount = meshes[i].Indices.size();
+				offset += meshes[i].Indices.size() * sizeof(unsigned int);
+
+				entries[i].Padding = 0;
+			}
+
+			// write to a temporary file first - other threads or SHADERed instances might be reading this entry
+			std::stringstream tempPath;
+			tempPath << path << "." << std::this_thread::get_id() << ".tmp";
+
+			std::ofstream file(tempPath.str(), std::ios::binary | std::ios::trunc);
+			if (!file.is_open())
+				return;
+
+			const char zeros[MESHCACHE_ALIGN] = { 0 };
+			auto pad = [&](uint64_t target) {
+				uint64_t pos = file.tellp();
+				if (target > pos)
+					file.write(zeros, target - pos);
+			};
+
+			file.write((const char*)&header, sizeof(header));
+			file.write((const char*)entries.data(), entries.size() * sizeof(MeshCacheEntry));
+			for (const auto& mesh : meshes)
+				file.write(mesh.Name.data(), mesh.Name.size());
+			for (int i = 0; i < meshes.size(); i++) {
+				pad(entries[i].VertexOffset);
+				file.write((const char*)meshes[i].Vertices.data(), meshes[i].Vertices.size() * sizeof(Model::Mesh::Vertex));
+				pad(entries[i].IndexOffset);
+				file.write((const char*)meshes[i].Indices.data(), meshes[i].Indices.size() * sizeof(unsigned int));
+			}
+			bool written = (bool)file;
+			file.close();
+
+			std::error_code fsError;
+			if (written)
+				std::filesystem::rename(tempPath.str(), path, fsError);
+			if (!written || fsError) {
+				std::filesystem::remove(tempPath.str(), fsError);
+				return;
+			}
+
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_files.Add(key, offset);
+		}
+		void MeshCache::Clear()
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_files.Clear();
+
+			Logger::Get().Log("Cleared the 3D model cache");
+		}
+	}
+}
\ No newline at end of file
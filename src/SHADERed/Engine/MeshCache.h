@@ -0,0 +1,46 @@
+#pragma once
+#include <SHADERed/Engine/Model.h>
+#include <SHADERed/Objects/CacheDirectory.h>
+#include <glm/glm.hpp>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace ed {
+	namespace eng {
+		// binary cache of imported 3D models - names, bounds and vertex/index arrays in the same layout as Model::Mesh
+		// entries are keyed by the source file's path, size, last write time & import flags and they are read straight into the mesh arrays
+		// least recently used entries are removed once the cache grows over the size limit
+		class MeshCache {
+		public:
+			MeshCache();
+
+			void Initialize(const std::string& dir, size_t maxSize);
+			inline bool IsEnabled() { return m_enabled; }
+			inline void SetEnabled(bool enabled) { m_enabled = enabled && m_files.IsOpen(); }
+			inline void SetMaxSize(size_t maxSize) { m_files.SetMaxSize(maxSize); }
+
+			// 0 -> file doesn't exist, options = SHADERed's own processing steps
+			static uint64_t GetKey(const std::string& path, unsigned int importFlags, unsigned int options = 0);
+
+			// meshes are left untouched if the entry doesn't exist or is corrupted
+			bool Load(uint64_t key, std::vector<Model::Mesh>& meshes, glm::vec3& minBound, glm::vec3& maxBound);
+			void Store(uint64_t key, const std::vector<Model::Mesh>& meshes, glm::vec3 minBound, glm::vec3 maxBound);
+			void Clear();
+
+			inline int GetEntryCount() { return m_files.GetEntryCount(); }
+			inline size_t GetSize() { return m_files.GetSize(); }
+
+			static inline MeshCache& Instance()
+			{
+				static MeshCache ret;
+				return ret;
+			}
+
+		private:
+			std::mutex m_mutex;
+			CacheDirectory m_files;
+			bool m_enabled;
+		};
+	}
+}
\ No newline at end of file
@@ -0,0 +1,272 @@
+#include <SHADERed/Engine/MeshOptimizer.h>
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace ed {
+	namespace eng {
+		// Forsyth's parameters
+		static const int VertexCacheSize = 32;
+		static const float CacheDecayPower = 1.5f;
+		static const float LastTriangleScore = 0.75f;
+		static const float ValenceBoostScale = 2.0f;
+		static const float ValenceBoostPower = 0.5f;
+
+		static float GetVertexScore(int cachePosition, unsigned int valence)
+		{
+			// no triangles left -> never pick it
+			if (valence == 0)
+				return -1.0f;
+
+			float score = 0.0f;
+			if (cachePosition >= 0) {
+				// the last triangle's vertices get a fixed score so that the next triangle doesn't just reuse its edge
+				if (cachePosition < 3)
+					score = LastTriangleScore;
+				else
+					score = std::pow(1.0f - (cachePosition - 3) / (float)(VertexCacheSize - 3), CacheDecayPower);
+			}
+
+			// prefer vertices with only a few triangles left so that they can leave the cache
+			score += ValenceBoostScale * std::pow((float)valence, -ValenceBoostPower);
+
+			return score;
+		}
+
+		MeshOptimizer::Statistics MeshOptimizer::AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize)
+		{
+			Statistics ret;
+			ret.Triangles = indices.size() / 3;
+
+			// a vertex is in the FIFO if less than cacheSize misses happened since it was added
+			std::vector<unsigned int> timestamps(vertexCount, 0);
+			unsigned int time = cacheSize + 1;
+
+			for (unsigned int index : indices) {
+				if (index >= vertexCount)
+					continue;
+
+				if (timestamps[index] == 0)
+					ret.Vertices++;
+
+				if (time - timestamps[index] > (unsigned int)cacheSize) {
+					timestamps[index] = time++;
+					ret.Transformed++;
+				}
+			}
+
+			return ret;
+		}
+		void MeshOptimizer::OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount)
+		{
+			size_t triCount = indices.size() / 3;
+			if (triCount == 0)
+				return;
+
+			for (unsigned int index : indices)
+				if (index >= vertexCount)
+					return;
+
+			// triangles that use each vertex - only the first valence[v] are still waiting to be drawn
+			std::vector<unsigned int> valence(vertexCount, 0);
+			for (unsigned int index : indices)
+				valence[index]++;
+
+			std::vector<unsigned int> adjacencyStart(vertexCount + 1, 0);
+			for (size_t v = 0; v < vertexCount; v++)
+				adjacencyStart[v + 1] = adjacencyStart[v] + valence[v];
+
+			std::vector<unsigned int> adjacency(triCount * 3);
+			std::vector<unsigned int> fill(adjacencyStart.begin(), adjacencyStart.end() - 1);
+			for (size_t t = 0; t < triCount; t++)
+				for (int k = 0; k < 3; k++)
+					adjacency[fill[indices[t * 3 + k]]++] = t;
+
+			// initial scores
+			std::vector<int> cachePosition(vertexCount, -1);
+			std::vector<float> vertexScore(vertexCount);
+			for (size_t v = 0; v < vertexCount; v++)
+				vertexScore[v] = GetVertexScore(-1, valence[v]);
+
+			std::vector<float> triangleScore(triCount);
+			for (size_t t = 0; t < triCount; t++)
+				triangleScore[t] = vertexScore[indices[t * 3 + 0]] + vertexScore[indices[t * 3 + 1]] + vertexScore[indices[t * 3 + 2]];
+
+			std::vector<bool> emitted(triCount, false);
+			std::vector<unsigned int> cache, newCache;
+			cache.reserve(VertexCacheSize + 3);
+			newCache.reserve(VertexCacheSize + 3);
+
+			std::vector<unsigned int> ret;
+			ret.reserve(indices.size());
+
+			size_t nextInput = 0; // used when none of the triangles in the cache can be drawn
+			int best = -1;
+			while (ret.size() < indices.size()) {
+				if (best < 0) {
+					while (emitted[nextInput])
+						nextInput++;
+					best = nextInput;
+				}
+
+				const unsigned int* tri = &indices[best * 3];
+				ret.insert(ret.end(), tri, tri + 3);
+				emitted[best] = true;
+
+				// remove the triangle from its vertices' lists
+				for (int k = 0; k < 3; k++) {
+					unsigned int v = tri[k];
+					unsigned int* list = &adjacency[adjacencyStart[v]];
+					for (unsigned int i = 0; i < valence[v]; i++) {
+						if ((int)list[i] == best) {
+							std::swap(list[i], list[valence[v] - 1]);
+							break;
+						}
+					}
+					valence[v]--;
+				}
+
+				// triangle's vertices go to the front of the cache
+				newCache.assign(tri, tri + 3);
+				for (unsigned int v : cache)
+					if (v != tri[0] && v != tri[1] && v != tri[2])
+						newCache.push_back(v);
+
+				for (int i = 0; i < newCache.size(); i++) {
+					unsigned int v = newCache[i];
+					cachePosition[v] = i < VertexCacheSize ? i : -1;
+					vertexScore[v] = GetVertexScore(cachePosition[v], valence[v]);
+				}
+
+				// rescore the triangles that touch the cache and pick the best one
+				best = -1;
+				float bestScore = -1.0f;
+				for (unsigned int v : newCache) {
+					const unsigned int* list = &adjacency[adjacencyStart[v]];
+					for (unsigned int i = 0; i < valence[v]; i++) {
+						unsigned int t = list[i];
+						const unsigned int* ttri = &indices[t * 3];
+						triangleScore[t] = vertexScore[ttri[0]] + vertexScore[ttri[1]] + vertexScore[ttri[2]];
+
+						if (triangleScore[t] > bestScore) {
+							bestScore = triangleScore[t];
+							best = t;
+						}
+					}
+				}
+
+				cache.assign(newCache.begin(), newCache.begin() + std::min<size_t>(newCache.size(), VertexCacheSize));
+			}
+
+			indices = std::move(ret);
+		}
+		void MeshOptimizer::OptimizeOverdraw(std::vector<unsigned int>& indices, const float* positions, size_t stride, size_t vertexCount)
+		{
+			size_t triCount = indices.size() / 3;
+			if (triCount == 0 || vertexCount == 0)
+				return;
+
+			for (unsigned int index : indices)
+				if (index >= vertexCount)
+					return;
+
+			auto getPosition = [&](unsigned int index) {
+				const float* pos = (const float*)((const char*)positions + index * stride);
+				return glm::vec3(pos[0], pos[1], pos[2]);
+			};
+
+			// a new cluster starts when a triangle misses all three of its vertices
+			std::vector<size_t> clusterStart;
+			std::vector<unsigned int> timestamps(vertexCount, 0);
+			unsigned int time = 17;
+			for (size_t t = 0; t < triCount; t++) {
+				int misses = 0;
+				for (int k = 0; k < 3; k++) {
+					unsigned int index = indices[t * 3 + k];
+					if (time - timestamps[index] > 16) {
+						timestamps[index] = time++;
+						misses++;
+					}
+				}
+
+				if (t == 0 || misses == 3)
+					clusterStart.push_back(t);
+			}
+			clusterStart.push_back(triCount);
+
+			glm::vec3 meshCenter(0.0f);
+			for (size_t v = 0; v < vertexCount; v++)
+				meshCenter = meshCenter + getPosition(v);
+			meshCenter = meshCenter * (1.0f / vertexCount);
+
+			// clusters that point away from the center are more likely to hide the rest of the mesh
+			size_t clusterCount = clusterStart.size() - 1;
+			std::vector<float> sortKey(clusterCount);
+			for (size_t c = 0; c < clusterCount; c++) {
+				glm::vec3 center(0.0f), normal(0.0f);
+				float area = 0.0f;
+
+				for (size_t t = clusterStart[c]; t < clusterStart[c + 1]; t++) {
+					glm::vec3 p0 = getPosition(indices[t * 3 + 0]);
+					glm::vec3 p1 = getPosition(indices[t * 3 + 1]);
+					glm::vec3 p2 = getPosition(indices[t * 3 + 2]);
+
+					glm::vec3 n = glm::cross(p1 - p0, p2 - p0); // length = 2 * area
+					float triArea = std::sqrt(glm::dot(n, n));
+
+					center = center + (p0 + p1 + p2) * (triArea / 3.0f);
+					normal = normal + n;
+					area += triArea;
+				}
+
+				if (area > 0.0f)
+					center = center * (1.0f / area);
+				float normalLength = std::sqrt(glm::dot(normal, normal));
+				if (normalLength > 0.0f)
+					normal = normal * (1.0f / normalLength);
+
+				sortKey[c] = glm::dot(center - meshCenter, normal);
+			}
+
+			std::vector<size_t> order(clusterCount);
+			for (size_t c = 0; c < clusterCount; c++)
+				order[c] = c;
+			std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+				return sortKey[a] > sortKey[b];
+			});
+
+			std::vector<unsigned int> ret;
+			ret.reserve(indices.size());
+			for (size_t c : order)
+				ret.insert(ret.end(), indices.begin() + clusterStart[c] * 3, indices.begin() + clusterStart[c + 1] * 3);
+
+			indices = std::move(ret);
+		}
+		std::vector<unsigned int> MeshOptimizer::OptimizeVertexFetch(std::vector<unsigned int>& indices, size_t vertexCount)
+		{
+			const unsigned int unused = ~0u;
+
+			std::vector<unsigned int> remap(vertexCount, unused);
+			std::vector<unsigned int> order;
+			order.reserve(vertexCount);
+
+			for (unsigned int& index : indices) {
+				if (index >= vertexCount)
+					continue;
+
+				if (remap[index] == unused) {
+					remap[index] = order.size();
+					order.push_back(index);
+				}
+				index = remap[index];
+			}
+
+			for (size_t v = 0; v < vertexCount; v++)
+				if (remap[v] == unused)
+					order.push_back(v);
+
+			return order;
+		}
+	}
+}
\ No newline at end of file
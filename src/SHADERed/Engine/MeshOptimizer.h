@@ -0,0 +1,51 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+namespace ed {
+	namespace eng {
+		// index & vertex reordering for triangle lists
+		class MeshOptimizer {
+		public:
+			// post-transform vertex cache efficiency, simulated with a FIFO cache
+			struct Statistics {
+				Statistics() { Triangles = Vertices = Transformed = 0; }
+
+				size_t Triangles, Vertices, Transformed; // Vertices = unique vertices that are referenced
+
+				inline float GetACMR() const { return Triangles == 0 ? 0.0f : Transformed / (float)Triangles; } // 0.5 - 3, lower is better
+				inline float GetATVR() const { return Vertices == 0 ? 0.0f : Transformed / (float)Vertices; }	 // 1 is the best
+				inline Statistics& operator+=(const Statistics& s)
+				{
+					Triangles += s.Triangles;
+					Vertices += s.Vertices;
+					Transformed += s.Transformed;
+					return *this;
+				}
+			};
+
+			static Statistics AnalyzeVertexCache(const std::vector<unsigned int>& indices, size_t vertexCount, int cacheSize = 16);
+
+			// Tom Forsyth's "Linear-Speed Vertex Cache Optimisation"
+			static void OptimizeVertexCache(std::vector<unsigned int>& indices, size_t vertexCount);
+
+			// splits the (cache optimized) triangles into clusters at the points where the cache gets flushed
+			// and draws the clusters that face away from the mesh center first - keeps most of the cache efficiency
+			static void OptimizeOverdraw(std::vector<unsigned int>& indices, const float* positions, size_t stride, size_t vertexCount);
+
+			// rewrites the indices so that the vertices are fetched in order
+			// returns the new vertex order (new index -> old index), unreferenced vertices are placed at the end
+			static std::vector<unsigned int> OptimizeVertexFetch(std::vector<unsigned int>& indices, size_t vertexCount);
+
+			// reorders a vertex array with the table returned by OptimizeVertexFetch()
+			template <typename T>
+			static void RemapVertices(std::vector<T>& vertices, const std::vector<unsigned int>& order)
+			{
+				std::vector<T> ret(order.size());
+				for (size_t i = 0; i < order.size(); i++)
+					ret[i] = vertices[order[i]];
+				vertices = std::move(ret);
+			}
+		};
+	}
+}
\ No newline at end of file
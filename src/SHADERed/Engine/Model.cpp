@@ -1,5 +1,9 @@
+#include <SHADERed/Engine/MeshCache.h>
 #include <SHADERed/Engine/Model.h>
+#include <SHADERed/Engine/ThreadPool.h>
 #include <SHADERed/Objects/Logger.h>
+#include <assimp/ProgressHandler.hpp>
+#include <glm/gtc/packing.hpp>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -11,105 +15,473 @@
 #include <GL/gl.h>
 #endif
 
+#include <cstring>
 #include <iostream>
 
 namespace ed {
 	namespace eng {
-		Model::Mesh::Mesh(const std::string& name, const std::vector<Model::Mesh::Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<Model::Mesh::Texture>& textures)
+		// first half of the progress bar is assimp's import, second half is the mesh conversion
+		class ModelImportProgress : public Assimp::ProgressHandler {
+		public:
+			ModelImportProgress(std::atomic<float>& progress, std::atomic<bool>& cancel)
+					: m_progress(progress)
+					, m_cancel(cancel)
+			{
+			}
+			virtual bool Update(float percentage = -1.f)
+			{
+				if (percentage >= 0.0f)
+					m_progress = std::min<float>(percentage, 1.0f) * 0.5f;
+				return !m_cancel; // false -> assimp stops reading the file
+			}
+
+		private:
+			std::atomic<float>& m_progress;
+			std::atomic<bool>& m_cancel;
+		};
+
+		Model::Mesh::Mesh()
+		{
+			BaseVertex = IndexOffset = 0;
+		}
+		Model::Mesh::Mesh(const std::string& name, std::vector<Model::Mesh::Vertex> vertices, std::vector<unsigned int> indices, std::vector<Model::Mesh::Texture> textures)
 		{
 			Name = name;
-			Vertices = vertices;
-			Indices = indices;
-			Textures = textures;
-			m_setup();
+			Vertices = std::move(vertices);
+			Indices = std::move(indices);
+			Textures = std::move(textures);
+			BaseVertex = IndexOffset = 0;
 		}
-		void Model::Mesh::m_setup()
+
+		Model::Model()
 		{
-			glGenVertexArrays(1, &VAO);
-			glGenBuffers(1, &VBO);
-			glGenBuffers(1, &EBO);
-			glBindVertexArray(VAO);
+			m_progress = 0.0f;
+			m_cancel = false;
+			m_loaded = false;
+			m_indexCount = 0;
+			m_vertexCount = 0;
+			m_compression = VertexCompression::None;
+			m_optimizeVertexCache = m_optimizeOverdraw = m_optimized = false;
+			m_minBound = m_maxBound = glm::vec3(0.0f);
+			VAO = VBO = EBO = 0;
+		}
+		Model::~Model()
+		{
+			// stop the import and wait for the workers that are reading the meshes
+			m_cancel = true;
+			if (m_loadTask.valid())
+				m_loadTask.wait();
 
-			glBindBuffer(GL_ARRAY_BUFFER, VBO);
-			glBufferData(GL_ARRAY_BUFFER, Vertices.size() * sizeof(Vertex), &Vertices[0],
-				GL_STATIC_DRAW);
+			for (auto& task : m_bvhTasks)
+				if (task.valid())
+					task.wait();
 
-			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-			glBufferData(GL_ELEMENT_ARRAY_BUFFER, Indices.size() * sizeof(unsigned int),
-				&Indices[0], GL_STATIC_DRAW);
+			if (VAO != 0) {
+				glDeleteVertexArrays(1, &VAO);
+				glDeleteBuffers(1, &VBO);
+				glDeleteBuffers(1, &EBO);
+			}
+		}
 
-			// vertex positions
-			glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Model::Mesh::Vertex), (void*)0);
-			glEnableVertexAttribArray(0);
+		bool Model::LoadFromFile(const std::string& path, bool upload)
+		{
+			ed::Logger::Get().Log("Loading a 3D model from file \"" + path + "\"");
 
-			// vertex normals
-			glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(Model::Mesh::Vertex), (void*)offsetof(Vertex, Normal));
-			glEnableVertexAttribArray(1);
+			std::string error;
+			MeshOptimizer::Statistics stats[2];
+			if (!m_import(path, Meshes, m_minBound, m_maxBound, stats, error)) {
+				ed::Logger::Get().Log("Assimp has detected an error \"" + error + "\"", true);
+				Meshes.clear();
+				return false;
+			}
 
-			// vertex texture coords
-			glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, sizeof(Model::Mesh::Vertex), (void*)offsetof(Vertex, TexCoords));
-			glEnableVertexAttribArray(2);
+			Directory = path.substr(0, path.find_last_of("/\\"));
 
-			glBindVertexArray(0);
-		}
-		void Model::Mesh::Draw(bool instanced, int iCount)
-		{
-			// draw mesh
-			glBindVertexArray(VAO);
+			m_originalCacheStats = stats[0];
+			m_cacheStats = stats[1];
+			m_optimized = m_optimizeVertexCache;
 
-			if (instanced)
-				glDrawElementsInstanced(GL_TRIANGLES, Indices.size(), GL_UNSIGNED_INT, nullptr, iCount);
-			else
-				glDrawElements(GL_TRIANGLES, Indices.size(), GL_UNSIGNED_INT, 0);
-		}
+			if (upload)
+				m_upload();
 
-		Model::~Model()
+			m_loaded = true;
+
+			return true;
+		}
+		void Model::LoadFromFileAsync(const std::string& path)
 		{
-			for (int i = 0; i < Meshes.size(); i++) {
-				glDeleteVertexArrays(1, &Meshes[i].VAO);
-				glDeleteBuffers(1, &Meshes[i].VBO);
-				glDeleteBuffers(1, &Meshes[i].EBO);
+			ed::Logger::Get().Log("Loading a 3D model from file \"" + path + "\" in the background");
+
+			// restart if it's already being loaded
+			if (m_loadTask.valid()) {
+				m_cancel = true;
+				m_loadTask.wait();
+				m_loadTask = std::future<bool>();
+				m_cancel = false;
 			}
+
+			Directory = path.substr(0, path.find_last_of("/\\"));
+			m_loadedMeshes.clear();
+			m_loadError.clear();
+			m_progress = 0.0f;
+			m_loaded = false;
+
+			// one thread per file - the meshes are converted on the thread pool
+			m_loadTask = std::async(std::launch::async, [this, path]() {
+				return m_import(path, m_loadedMeshes, m_loadedMinBound, m_loadedMaxBound, m_loadedStats, m_loadError);
+			});
 		}
+		bool Model::Update(bool wait)
+		{
+			if (!m_loadTask.valid())
+				return false;
+			if (!wait && m_loadTask.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+				return false;
 
-		bool Model::LoadFromFile(const std::string& path)
+			if (m_loadTask.get()) {
+				Meshes = std::move(m_loadedMeshes);
+				m_minBound = m_loadedMinBound;
+				m_maxBound = m_loadedMaxBound;
+				m_originalCacheStats = m_loadedStats[0];
+				m_cacheStats = m_loadedStats[1];
+				m_optimized = m_optimizeVertexCache;
+				m_upload();
+				BuildBVH();
+
+				m_loaded = true;
+			} else
+				ed::Logger::Get().Log("Assimp has detected an error \"" + m_loadError + "\"", true);
+
+			m_loadedMeshes.clear();
+
+			return true;
+		}
+		bool Model::m_import(const std::string& path, std::vector<Mesh>& meshes, glm::vec3& minBound, glm::vec3& maxBound, MeshOptimizer::Statistics* stats, std::string& error)
 		{
-			ed::Logger::Get().Log("Loading a 3D model from file \"" + path + "\"");
+			const unsigned int importFlags = aiProcess_Triangulate | aiProcess_FlipUVs;
+			const unsigned int options = m_optimizeVertexCache | (m_optimizeOverdraw << 1);
+
+			m_progress = 0.0f;
+
+			// skip assimp if this file was already imported
+			MeshCache& cache = MeshCache::Instance();
+			uint64_t cacheKey = cache.IsEnabled() ? MeshCache::GetKey(path, importFlags, options) : 0;
+			if (cacheKey != 0 && cache.Load(cacheKey, meshes, minBound, maxBound)) {
+				stats[0] = stats[1] = MeshOptimizer::Statistics();
+				for (const auto& mesh : meshes)
+					stats[1] += MeshOptimizer::AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size());
+				if (!m_optimizeVertexCache)
+					stats[0] = stats[1];
+
+				m_progress = 1.0f;
+				return true;
+			}
 
 			// read file via ASSIMP
 			Assimp::Importer importer;
-			const aiScene* scene = importer.ReadFile(path, aiProcess_Triangulate | aiProcess_FlipUVs);
+			importer.SetProgressHandler(new ModelImportProgress(m_progress, m_cancel)); // importer deletes it
+			const aiScene* scene = importer.ReadFile(path, importFlags);
 
 			// check for errors
 			if (!scene || scene->mFlags & AI_SCENE_FLAGS_INCOMPLETE || !scene->mRootNode) // if is Not Zero
 			{
-				ed::Logger::Get().Log("Assimp has detected an error \"" + std::string(importer.GetErrorString()) + "\"", true);
+				error = m_cancel ? "Import canceled" : importer.GetErrorString();
 				return false;
 			}
 
-			Directory = path.substr(0, path.find_last_of("/\\"));
-			m_processNode(scene->mRootNode, scene);
+			std::vector<aiMesh*> sceneMeshes;
+			m_processNode(scene->mRootNode, scene, sceneMeshes);
+
+			// convert the meshes in parallel, each job writes only to its own element
+			meshes.resize(sceneMeshes.size());
+
+			std::atomic<int> converted(0);
+			std::vector<MeshOptimizer::Statistics> originalStats(sceneMeshes.size());
+			std::vector<std::future<void>> tasks(sceneMeshes.size());
+			for (int i = 0; i < sceneMeshes.size(); i++) {
+				tasks[i] = ThreadPool::Instance().Enqueue([&, i]() {
+					if (m_cancel)
+						return;
+
+					meshes[i] = m_processMesh(sceneMeshes[i], scene);
 
-			m_findBounds();
+					if (m_optimizeVertexCache)
+						m_optimize(meshes[i], originalStats[i]);
+
+					m_progress = 0.5f + 0.5f * (++converted) / (float)sceneMeshes.size();
+				});
+			}
+			for (auto& task : tasks)
+				task.wait();
+
+			if (m_cancel) {
+				error = "Import canceled";
+				return false;
+			}
+
+			stats[0] = stats[1] = MeshOptimizer::Statistics();
+			for (int i = 0; i < meshes.size(); i++) {
+				stats[0] += originalStats[i];
+				stats[1] += MeshOptimizer::AnalyzeVertexCache(meshes[i].Indices, meshes[i].Vertices.size());
+			}
+			if (!m_optimizeVertexCache)
+				stats[0] = stats[1];
+
+			m_findBounds(meshes, minBound, maxBound);
+
+			if (cacheKey != 0)
+				cache.Store(cacheKey, meshes, minBound, maxBound);
+
+			m_progress = 1.0f;
 
 			return true;
 		}
-		void Model::m_findBounds()
+		void Model::m_upload()
 		{
-			m_minBound = glm::vec3(std::numeric_limits<float>::infinity());
-			m_maxBound = glm::vec3(-std::numeric_limits<float>::infinity());
+			if (VAO != 0) {
+				glDeleteVertexArrays(1, &VAO);
+				glDeleteBuffers(1, &VBO);
+				glDeleteBuffers(1, &EBO);
+			}
 
+			// place the meshes one after another
+			m_vertexCount = 0;
+			m_indexCount = 0;
 			for (auto& mesh : Meshes) {
+				mesh.BaseVertex = m_vertexCount;
+				mesh.IndexOffset = m_indexCount;
+				m_vertexCount += mesh.Vertices.size();
+				m_indexCount += mesh.Indices.size();
+			}
+
+			m_format = m_buildFormat();
+
+			glGenVertexArrays(1, &VAO);
+			glGenBuffers(1, &VBO);
+			glGenBuffers(1, &EBO);
+			glBindVertexArray(VAO);
+
+			glBindBuffer(GL_ARRAY_BUFFER, VBO);
+			if (m_compression == VertexCompression::None) {
+				glBufferData(GL_ARRAY_BUFFER, m_vertexCount * sizeof(Mesh::Vertex), nullptr, GL_STATIC_DRAW);
+				for (const auto& mesh : Meshes)
+					if (!mesh.Vertices.empty())
+						glBufferSubData(GL_ARRAY_BUFFER, mesh.BaseVertex * sizeof(Mesh::Vertex), mesh.Vertices.size() * sizeof(Mesh::Vertex), mesh.Vertices.data());
+			} else {
+				// each mesh writes to its own part of the buffer
+				std::vector<unsigned char> packed(m_vertexCount * m_format.Stride);
+				std::vector<std::future<void>> tasks;
+				for (const auto& mesh : Meshes) {
+					unsigned char* out = packed.data() + mesh.BaseVertex * m_format.Stride;
+					tasks.push_back(ThreadPool::Instance().Enqueue([this, &mesh, out]() {
+						m_encode(mesh, out);
+					}));
+				}
+				for (auto& task : tasks)
+					task.wait();
+
+				glBufferData(GL_ARRAY_BUFFER, packed.size(), packed.data(), GL_STATIC_DRAW);
+			}
+
+			// indices are rebased so that the whole model can be drawn without glDrawElementsBaseVertex
+			glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+			glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexCount * sizeof(unsigned int), nullptr, GL_STATIC_DRAW);
+			std::vector<unsigned int> rebased;
+			for (const auto& mesh : Meshes) {
+				if (mesh.Indices.empty())
+					continue;
+
+				rebased.resize(mesh.Indices.size());
+				for (size_t i = 0; i < mesh.Indices.size(); i++)
+					rebased[i] = mesh.Indices[i] + mesh.BaseVertex;
+				glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, mesh.IndexOffset * sizeof(unsigned int), rebased.size() * sizeof(unsigned int), rebased.data());
+			}
+
+			// vertex positions, normals and texture coords
+			const InputLayoutValue attributes[] = { InputLayoutValue::Position, InputLayoutValue::Normal, InputLayoutValue::Texcoord };
+			for (int i = 0; i < 3; i++) {
+				const VertexAttributeFormat& attr = m_format.Get(attributes[i]);
+				if (attr.Type == 0)
+					continue;
+
+				glVertexAttribPointer(i, attr.Components, attr.Type, attr.Normalized, m_format.Stride, (void*)(size_t)attr.Offset);
+				glEnableVertexAttribArray(i);
+			}
+
+			glBindVertexArray(0);
+
+			if (m_compression != VertexCompression::None)
+				ed::Logger::Get().Log("Vertex data of a 3D model was compressed from " + std::to_string(GetUncompressedVertexBufferSize() / 1024) + " KB to " + std::to_string(GetVertexBufferSize() / 1024) + " KB");
+		}
+		VertexFormat Model::m_buildFormat()
+		{
+			VertexFormat ret;
+			if (m_compression == VertexCompression::None)
+				return ret;
+
+			// attributes that assimp didn't find were filled with the defaults from m_processMesh()
+			bool hasNormals = false, hasTexCoords = false, hasTangents = false, hasBinormals = false, hasColors = false;
+			for (const auto& mesh : Meshes) {
+				for (const auto& v : mesh.Vertices) {
+					hasNormals |= v.Normal != glm::vec3(0.0f);
+					hasTexCoords |= v.TexCoords != glm::vec2(0.0f);
+					hasTangents |= v.Tangent != glm::vec3(0.0f);
+					hasBinormals |= v.Binormal != glm::vec3(0.0f);
+					hasColors |= v.Color != glm::vec4(1.0f);
+				}
+			}
+
+			bool quantize = m_compression == VertexCompression::Quantized;
+			const bool present[] = { true, hasNormals, hasTexCoords, hasTangents, hasBinormals, hasColors };
+
+			ret.Stride = 0;
+			for (int i = 0; i <= (int)InputLayoutValue::Color; i++) {
+				VertexAttributeFormat& attr = ret.Attributes[i];
+				InputLayoutValue val = (InputLayoutValue)i;
+
+				if (!present[i]) {
+					attr.Type = 0;
+					continue;
+				}
+
+				attr.Offset = ret.Stride;
+				if (!quantize || val == InputLayoutValue::Position) {
+					attr.Type = GL_FLOAT;
+					attr.Components = InputLayoutItem::GetValueSize(val);
+					attr.Normalized = false;
+				} else if (val == InputLayoutValue::Texcoord) {
+					attr.Type = GL_HALF_FLOAT;
+					attr.Components = 2;
+					attr.Normalized = false;
+				} else if (val == InputLayoutValue::Color) {
+					attr.Type = GL_UNSIGNED_BYTE;
+					attr.Components = 4;
+					attr.Normalized = true;
+				} else {
+					attr.Type = GL_INT_2_10_10_10_REV;
+					attr.Components = 4;
+					attr.Normalized = true;
+				}
+
+				if (attr.Type == GL_FLOAT)
+					ret.Stride += attr.Components * sizeof(float);
+				else
+					ret.Stride += 4;
+			}
+
+			return ret;
+		}
+		void Model::m_encode(const Mesh& mesh, unsigned char* out)
+		{
+			const VertexAttributeFormat* attrs = m_format.Attributes;
+			for (const auto& v : mesh.Vertices) {
+				const float* values[] = { &v.Position.x, &v.Normal.x, &v.TexCoords.x, &v.Tangent.x, &v.Binormal.x, &v.Color.x };
+
+				for (int i = 0; i <= (int)InputLayoutValue::Color; i++) {
+					unsigned char* dst = out + attrs[i].Offset;
+					const float* src = values[i];
+
+					switch (attrs[i].Type) {
+					case GL_FLOAT:
+						memcpy(dst, src, attrs[i].Components * sizeof(float));
+						break;
+					case GL_HALF_FLOAT: {
+						glm::uint32 packed = glm::packHalf2x16(glm::vec2(src[0], src[1]));
+						memcpy(dst, &packed, sizeof(packed));
+					} break;
+					case GL_UNSIGNED_BYTE: {
+						glm::uint32 packed = glm::packUnorm4x8(glm::vec4(src[0], src[1], src[2], src[3]));
+						memcpy(dst, &packed, sizeof(packed));
+					} break;
+					case GL_INT_2_10_10_10_REV: {
+						glm::uint32 packed = glm::packSnorm3x10_1x2(glm::vec4(src[0], src[1], src[2], 1.0f));
+						memcpy(dst, &packed, sizeof(packed));
+					} break;
+					}
+				}
+
+				out += m_format.Stride;
+			}
+		}
+		bool Model::SetVertexCompression(VertexCompression comp)
+		{
+			if (comp == m_compression)
+				return false;
+
+			m_compression = comp;
+
+			// loaded with upload = false or still loading
+			if (!m_loaded || VAO == 0)
+				return false;
+
+			m_upload();
+			return true;
+		}
+		void Model::m_optimize(Mesh& mesh, MeshOptimizer::Statistics& original)
+		{
+			original = MeshOptimizer::AnalyzeVertexCache(mesh.Indices, mesh.Vertices.size());
+			if (mesh.Vertices.empty())
+				return;
+
+			MeshOptimizer::OptimizeVertexCache(mesh.Indices, mesh.Vertices.size());
+			if (m_optimizeOverdraw)
+				MeshOptimizer::OptimizeOverdraw(mesh.Indices, &mesh.Vertices[0].Position.x, sizeof(Mesh::Vertex), mesh.Vertices.size());
+
+			std::vector<unsigned int> order = MeshOptimizer::OptimizeVertexFetch(mesh.Indices, mesh.Vertices.size());
+			MeshOptimizer::RemapVertices(mesh.Vertices, order);
+		}
+		void Model::m_findBounds(const std::vector<Mesh>& meshes, glm::vec3& minBound, glm::vec3& maxBound)
+		{
+			minBound = glm::vec3(std::numeric_limits<float>::infinity());
+			maxBound = glm::vec3(-std::numeric_limits<float>::infinity());
+
+			for (auto& mesh : meshes) {
 				for (auto& v : mesh.Vertices) {
-					m_minBound.x = std::min<float>(m_minBound.x, v.Position.x);
-					m_minBound.y = std::min<float>(m_minBound.y, v.Position.y);
-					m_minBound.z = std::min<float>(m_minBound.z, v.Position.z);
-					m_maxBound.x = std::max<float>(m_maxBound.x, v.Position.x);
-					m_maxBound.y = std::max<float>(m_maxBound.y, v.Position.y);
-					m_maxBound.z = std::max<float>(m_maxBound.z, v.Position.z);
+					minBound.x = std::min<float>(minBound.x, v.Position.x);
+					minBound.y = std::min<float>(minBound.y, v.Position.y);
+					minBound.z = std::min<float>(minBound.z, v.Position.z);
+					maxBound.x = std::max<float>(maxBound.x, v.Position.x);
+					maxBound.y = std::max<float>(maxBound.y, v.Position.y);
+					maxBound.z = std::max<float>(maxBound.z, v.Position.z);
 				}
 			}
 		}
+		void Model::BuildBVH()
+		{
+			for (auto& task : m_bvhTasks)
+				if (task.valid())
+					task.wait();
+
+			m_bvh.clear();
+			m_bvh.resize(Meshes.size());
+			m_bvhTasks.clear();
+			m_bvhTasks.resize(Meshes.size());
+
+			for (int i = 0; i < Meshes.size(); i++) {
+				m_bvhTasks[i] = ThreadPool::Instance().Enqueue([this, i]() {
+					const Mesh& mesh = Meshes[i];
+
+					std::vector<glm::vec3> positions(mesh.Vertices.size());
+					for (int j = 0; j < mesh.Vertices.size(); j++)
+						positions[j] = mesh.Vertices[j].Position;
+
+					m_bvh[i].Build(std::move(positions), std::vector<unsigned int>(mesh.Indices));
+				});
+			}
+		}
+		const BVH* Model::GetBVH(int mesh)
+		{
+			if (mesh < 0 || mesh >= m_bvh.size())
+				return nullptr;
+
+			if (m_bvhTasks[mesh].valid()) {
+				if (m_bvhTasks[mesh].wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+					return nullptr;
+				m_bvhTasks[mesh].get();
+			}
+
+			return &m_bvh[mesh];
+		}
 		std::vector<std::string> Model::GetMeshNames()
 		{
 			std::vector<std::string> ret;
@@ -119,24 +491,40 @@ namespace ed {
 		}
 		void Model::Draw(bool inst, int iCount)
 		{
-			for (unsigned int i = 0; i < Meshes.size(); i++)
-				Meshes[i].Draw(inst, iCount);
+			if (m_indexCount == 0)
+				return;
+
+			glBindVertexArray(VAO);
+
+			if (inst)
+				glDrawElementsInstanced(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, nullptr, iCount);
+			else
+				glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, nullptr);
 		}
 		void Model::Draw(const std::string& mesh)
 		{
-			for (unsigned int i = 0; i < Meshes.size(); i++)
-				if (Meshes[i].Name == mesh)
-					Meshes[i].Draw();
+			std::vector<GLsizei> counts;
+			std::vector<const void*> offsets;
+			for (const auto& m : Meshes) {
+				if (m.Name == mesh && !m.Indices.empty()) {
+					counts.push_back(m.Indices.size());
+					offsets.push_back((const void*)(m.IndexOffset * sizeof(unsigned int)));
+				}
+			}
+
+			if (counts.empty())
+				return;
+
+			glBindVertexArray(VAO);
+			glMultiDrawElements(GL_TRIANGLES, counts.data(), GL_UNSIGNED_INT, offsets.data(), counts.size());
 		}
-		void Model::m_processNode(aiNode* node, const aiScene* scene)
+		void Model::m_processNode(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& meshes)
 		{
-			for (unsigned int i = 0; i < node->mNumMeshes; i++) {
-				aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-				Meshes.push_back(m_processMesh(mesh, scene));
-			}
+			for (unsigned int i = 0; i < node->mNumMeshes; i++)
+				meshes.push_back(scene->mMeshes[node->mMeshes[i]]);
 
 			for (unsigned int i = 0; i < node->mNumChildren; i++)
-				m_processNode(node->mChildren[i], scene);
+				m_processNode(node->mChildren[i], scene, meshes);
 		}
 		Model::Mesh Model::m_processMesh(aiMesh* mesh, const aiScene* scene)
 		{
@@ -206,11 +594,11 @@ namespace ed {
 					vertex.Color = glm::vec4(1, 1, 1, 1);
 			}
 
-			// now walk through each of the mesh's faces
+			// now walk through each of the mesh's faces (all of them are triangles)
+			indices.reserve(mesh->mNumFaces * 3);
 			for (unsigned int i = 0; i < mesh->mNumFaces; i++) {
-				aiFace face = mesh->mFaces[i];
-				for (unsigned int j = 0; j < face.mNumIndices; j++)
-					indices.push_back(face.mIndices[j]);
+				const aiFace& face = mesh->mFaces[i];
+				indices.insert(indices.end(), face.mIndices, face.mIndices + face.mNumIndices);
 			}
 
 			// process materials
@@ -219,7 +607,7 @@ namespace ed {
 			// TODO: textures
 
 			// return a mesh object created from the extracted mesh data
-			return Model::Mesh(mesh->mName.data, vertices, indices, textures);
+			return Model::Mesh(mesh->mName.data, std::move(vertices), std::move(indices), std::move(textures));
 		}
 	}
 }
\ No newline at end of file
@@ -2,7 +2,12 @@
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
 #include <assimp/Importer.hpp>
+#include <SHADERed/Engine/BVH.h>
+#include <SHADERed/Engine/MeshOptimizer.h>
+#include <SHADERed/Objects/InputLayout.h>
 #include <glm/glm.hpp>
+#include <atomic>
+#include <future>
 #include <string>
 #include <vector>
 
@@ -31,34 +36,101 @@ namespace ed {
 				std::vector<unsigned int> Indices;
 				std::vector<Texture> Textures;
 
-				Mesh(const std::string& name, const std::vector<Vertex>& vertices, const std::vector<unsigned int>& indices, const std::vector<Texture>& textures);
+				// location of this mesh in the model's shared buffers (indices are already offset by BaseVertex)
+				unsigned int BaseVertex, IndexOffset;
 
-				void Draw(bool instanced = false, int iCount = 0);
-
-				unsigned int VAO, VBO, EBO;
+				Mesh();
+				Mesh(const std::string& name, std::vector<Vertex> vertices, std::vector<unsigned int> indices, std::vector<Texture> textures);
+			};
 
-			private:
-				void m_setup();
+			// how the vertices are stored on the GPU (Mesh::Vertex is always used on the CPU)
+			enum class VertexCompression {
+				None,	  // all attributes, 32 bit floats
+				Compact,  // attributes that the file doesn't have are left out
+				Quantized // Compact + 10 bit snorm normals/tangents, half float texcoords and 8 bit colors
 			};
 
+			Model();
 			~Model();
 
 			std::vector<Mesh> Meshes;
 			std::string Directory;
 
+			// all meshes are packed into one vertex & one index buffer
+			unsigned int VAO, VBO, EBO;
+			inline unsigned int GetIndexCount() { return m_indexCount; }
+
+			// recreates the GPU buffers if the model is already loaded - the VAOs have to be recreated after that
+			bool SetVertexCompression(VertexCompression comp);
+			inline VertexCompression GetVertexCompression() { return m_compression; }
+			inline const VertexFormat& GetVertexFormat() { return m_format; }
+			inline size_t GetVertexBufferSize() { return m_vertexCount * m_format.Stride; }
+			inline size_t GetUncompressedVertexBufferSize() { return m_vertexCount * sizeof(Mesh::Vertex); }
+
 			std::vector<std::string> GetMeshNames();
-			bool LoadFromFile(const std::string& path);
-			void Draw(bool instanced = false, int iCount = 0);
-			void Draw(const std::string& mesh);
+
+			// upload = false -> only the CPU data is loaded
+			bool LoadFromFile(const std::string& path, bool upload = true);
+
+			// the file is imported on a separate thread and the meshes are converted on eng::ThreadPool
+			// Meshes stay empty until Update() uploads them on the GL thread
+			void LoadFromFileAsync(const std::string& path);
+			bool Update(bool wait = false); // true -> loading has just finished (check IsLoaded())
+			inline bool IsLoading() { return m_loadTask.valid(); }
+			inline bool IsLoaded() { return m_loaded; }
+			inline float GetLoadProgress() { return m_progress; }
+			void Draw(bool instanced = false, int iCount = 0); // whole model in one draw call
+			void Draw(const std::string& mesh);				   // every mesh with this name in one glMultiDrawElements call
+
+			// reorder the triangles & vertices while importing (call before loading)
+			inline void SetOptimization(bool vertexCache, bool overdraw)
+			{
+				m_optimizeVertexCache = vertexCache;
+				m_optimizeOverdraw = vertexCache && overdraw;
+			}
+			inline bool IsOptimized() { return m_optimized; }
+
+			// vertex cache statistics of all meshes - original order is only known if the model was optimized while it was being imported (not loaded from the cache)
+			inline const MeshOptimizer::Statistics& GetCacheStatistics() { return m_cacheStats; }
+			inline const MeshOptimizer::Statistics& GetOriginalCacheStatistics() { return m_originalCacheStats; }
 
 			inline glm::vec3 GetMinBound() { return m_minBound; }
 			inline glm::vec3 GetMaxBound() { return m_maxBound; }
 
+			// builds a BVH for each mesh on eng::ThreadPool (call it once the model is loaded)
+			void BuildBVH();
+			const BVH* GetBVH(int mesh); // nullptr -> still being built
+
 		private:
-			void m_findBounds();
+			bool m_import(const std::string& path, std::vector<Mesh>& meshes, glm::vec3& minBound, glm::vec3& maxBound, MeshOptimizer::Statistics* stats, std::string& error); // stats[0] = original, stats[1] = final
+			void m_optimize(Mesh& mesh, MeshOptimizer::Statistics& original);
+			void m_upload(); // creates the GPU objects
+			VertexFormat m_buildFormat();
+			void m_encode(const Mesh& mesh, unsigned char* out);
+			static void m_findBounds(const std::vector<Mesh>& meshes, glm::vec3& minBound, glm::vec3& maxBound);
+
+			std::future<bool> m_loadTask;
+			std::vector<Mesh> m_loadedMeshes;
+			glm::vec3 m_loadedMinBound, m_loadedMaxBound;
+			MeshOptimizer::Statistics m_loadedStats[2];
+			std::string m_loadError;
+			std::atomic<float> m_progress;
+			std::atomic<bool> m_cancel;
+			bool m_loaded;
+			unsigned int m_indexCount;
+			size_t m_vertexCount;
+			VertexCompression m_compression;
+			VertexFormat m_format;
+
+			bool m_optimizeVertexCache, m_optimizeOverdraw;
+			bool m_optimized;
+			MeshOptimizer::Statistics m_cacheStats, m_originalCacheStats;
+
+			std::vector<BVH> m_bvh;
+			std::vector<std::future<void>> m_bvhTasks;
 
 			glm::vec3 m_minBound, m_maxBound;
-			void m_processNode(aiNode* node, const aiScene* scene);
+			void m_processNode(aiNode* node, const aiScene* scene, std::vector<aiMesh*>& meshes);
 			Model::Mesh m_processMesh(aiMesh* mesh, const aiScene* scene);
 		};
 	}
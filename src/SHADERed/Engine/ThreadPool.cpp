@@ -0,0 +1,62 @@
+#include <SHADERed/Engine/ThreadPool.h>
+
+namespace ed {
+	namespace eng {
+		ThreadPool::ThreadPool(int threadCount)
+		{
+			m_stop = false;
+
+			if (threadCount <= 0)
+				threadCount = std::thread::hardware_concurrency();
+			if (threadCount <= 0)
+				threadCount = 2;
+
+			for (int i = 0; i < threadCount; i++)
+				m_threads.push_back(std::thread(&ThreadPool::m_worker, this));
+		}
+		ThreadPool::~ThreadPool()
+		{
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_stop = true;
+			}
+			m_cond.notify_all();
+
+			for (auto& thread : m_threads)
+				if (thread.joinable())
+					thread.join();
+		}
+		std::future<void> ThreadPool::Enqueue(std::function<void()> job)
+		{
+			std::packaged_task<void()> task(job);
+			std::future<void> ret = task.get_future();
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_jobs.push_back(std::move(task));
+			}
+			m_cond.notify_one();
+
+			return ret;
+		}
+		void ThreadPool::m_worker()
+		{
+			while (true) {
+				std::packaged_task<void()> task;
+
+				{
+					std::unique_lock<std::mutex> lock(m_mutex);
+					m_cond.wait(lock, [&]() { return m_stop || !m_jobs.empty(); });
+
+					if (m_stop && m_jobs.empty())
+						return;
+
+					task = std::move(m_jobs.front());
+					m_jobs.pop_front();
+				}
+
+				task();
+			}
+		}
+	}
+}
\ No newline at end of file
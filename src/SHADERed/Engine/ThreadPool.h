@@ -0,0 +1,38 @@
+#pragma once
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ed {
+	namespace eng {
+		class ThreadPool {
+		public:
+			ThreadPool(int threadCount = 0); // 0 -> number of hardware threads
+			~ThreadPool();
+
+			// queue a job - returned future becomes ready once the job has finished
+			std::future<void> Enqueue(std::function<void()> job);
+
+			inline int GetThreadCount() { return m_threads.size(); }
+
+			static inline ThreadPool& Instance()
+			{
+				static ThreadPool ret;
+				return ret;
+			}
+
+		private:
+			void m_worker();
+
+			std::vector<std::thread> m_threads;
+			std::deque<std::packaged_task<void()>> m_jobs;
+			std::mutex m_mutex;
+			std::condition_variable m_cond;
+			bool m_stop;
+		};
+	}
+}
\ No newline at end of file
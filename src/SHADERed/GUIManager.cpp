@@ -2,6 +2,7 @@
 #include <GLFW/glfw3.h>
 
 #include <SHADERed/AppEvent.h>
+#include <SHADERed/Engine/MeshCache.h>
 #include <SHADERed/GUIManager.h>
 #include <SHADERed/InterfaceManager.h>
 #include <SHADERed/Objects/CameraSnapshots.h>
@@ -11,7 +12,9 @@
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Names.h>
 #include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/PreviewExporter.h>
 #include <SHADERed/Objects/SPIRVParser.h>
+#include <SHADERed/Objects/ShaderCache.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
 #include <SHADERed/Objects/SystemVariableManager.h>
 #include <SHADERed/Objects/ThemeContainer.h>
@@ -106,6 +109,11 @@ namespace ed {
 		m_isChangelogOpened = false;
 		m_savePreviewSeqDuration = 5.5f;
 		m_savePreviewSeqFPS = 30;
+		m_savePreviewSeqFrameStart = 0;
+		m_savePreviewSeqFrameEnd = -1;
+		m_savePreviewSeqShard = 0;
+		m_savePreviewSeqShardCount = 1;
+		m_savePreviewSeqResume = false;
 		m_savePreviewSupersample = 0;
 		m_iconFontLarge = nullptr;
 		m_expcppBackend = 0;
@@ -136,6 +144,14 @@ namespace ed {
 		Settings::Instance().Load();
 		m_loadTemplateList();
 
+		// SPIR-V & GLSL cache
+		ShaderCache::Instance().Initialize(Settings::Instance().ConvertPath("cache/shaders/"), (size_t)Settings::Instance().General.ShaderCacheSize * 1024 * 1024);
+		ShaderCache::Instance().SetEnabled(Settings::Instance().General.ShaderCache);
+
+		// imported 3D models
+		eng::MeshCache::Instance().Initialize(Settings::Instance().ConvertPath("cache/models/"), (size_t)Settings::Instance().General.MeshCacheSize * 1024 * 1024);
+		eng::MeshCache::Instance().SetEnabled(Settings::Instance().General.MeshCache);
+
 		glfwGetWindowSize(m_wnd, &m_width, &m_height);
 
 		// set vsync on startup
@@ -816,9 +832,7 @@ namespace ed {
 				if (ImGui::MenuItem("Rebuild project", KeyboardShortcuts::Instance().GetString("Project.Rebuild").c_str())) {
 					((CodeEditorUI*)Get(ViewID::Code))->SaveAll();
 
-					std::vector<PipelineItem*> passes = m_data->Pipeline.GetList();
-					for (PipelineItem*& pass : passes)
-						m_data->Renderer.Recompile(pass->Name);
+					m_data->Renderer.RecompileAll();
 				}
 				if (ImGui::MenuItem("Render", KeyboardShortcuts::Instance().GetString("Preview.SaveImage").c_str()))
 					m_savePreviewPopupOpened = true;
@@ -1438,9 +1452,7 @@ namespace ed {
 
 		if (ImGui::Button(UI_ICON_REFRESH)) { // REBUILD PROJECT
 			((CodeEditorUI*)Get(ViewID::Code))->SaveAll();
-			std::vector<PipelineItem*> passes = m_data->Pipeline.GetList();
-			for (PipelineItem*& pass : passes)
-				m_data->Renderer.Recompile(pass->Name);
+			m_data->Renderer.RecompileAll();
 		}
 		m_tooltip("Rebuild");
 		ImGui::SameLine();
@@ -1972,9 +1984,7 @@ namespace ed {
 
 		((CodeEditorUI*)Get(ViewID::Code))->SaveAll();
 
-		std::vector<PipelineItem*> passes = m_data->Pipeline.GetList();
-		for (PipelineItem*& pass : passes)
-			m_data->Renderer.Recompile(pass->Name);
+		m_data->Renderer.RecompileAll();
 
 		m_recompiledAll = true; 
 
@@ -2029,226 +2039,45 @@ namespace ed {
 			}
 
 			m_previewSavePath = options.RenderPath;
+			m_savePreviewFormat = options.RenderFormat;
 			m_previewSaveSize = glm::ivec2(options.RenderWidth, options.RenderHeight);
 			m_savePreviewSeq = options.RenderSequence;
 			m_savePreviewSeqDuration = options.RenderSequenceDuration;
 			m_savePreviewSeqFPS = options.RenderSequenceFPS;
+			m_savePreviewSeqFrameStart = options.RenderFrameStart;
+			m_savePreviewSeqFrameEnd = options.RenderFrameEnd;
+			m_savePreviewSeqShard = options.RenderShardIndex;
+			m_savePreviewSeqShardCount = options.RenderShardCount;
+			m_savePreviewSeqResume = options.RenderResume;
 		}
 	}
 
 	void GUIManager::SavePreviewToFile()
 	{
-		int sizeMulti = 1;
-		switch (m_savePreviewSupersample) {
-		case 1: sizeMulti = 2; break;
-		case 2: sizeMulti = 4; break;
-		case 3: sizeMulti = 8; break;
-		}
-		int actualSizeX = m_previewSaveSize.x * sizeMulti;
-		int actualSizeY = m_previewSaveSize.y * sizeMulti;
-
-		SystemVariableManager::Instance().SetSavingToFile(true);
-
-		// normal render
-		if (!m_savePreviewSeq) {
-			if (actualSizeX > 0 && actualSizeY > 0) {
-				SystemVariableManager::Instance().CopyState();
-
-				SystemVariableManager::Instance().SetTimeDelta(m_savePreviewTimeDelta);
-				SystemVariableManager::Instance().SetFrameIndex(m_savePreviewFrameIndex);
-				SystemVariableManager::Instance().SetKeysWASD(m_savePreviewWASD[0], m_savePreviewWASD[1], m_savePreviewWASD[2], m_savePreviewWASD[3]);
-				SystemVariableManager::Instance().SetMousePosition(m_savePreviewMouse.x, m_savePreviewMouse.y);
-				SystemVariableManager::Instance().SetMouse(m_savePreviewMouse.x, m_savePreviewMouse.y, m_savePreviewMouse.z, m_savePreviewMouse.w);
-
-				m_data->Renderer.Render(actualSizeX, actualSizeY);
-
-				SystemVariableManager::Instance().AdvanceTimer(m_savePreviewCachedTime - m_savePreviewTime);
-			}
-
-			unsigned char* pixels = (unsigned char*)malloc(actualSizeX * actualSizeY * 4);
-			unsigned char* outPixels = nullptr;
-
-			if (sizeMulti != 1)
-				outPixels = (unsigned char*)malloc(m_previewSaveSize.x * m_previewSaveSize.y * 4);
-			else
-				outPixels = pixels;
-
-			GLuint tex = m_data->Renderer.GetTexture();
-			glBindTexture(GL_TEXTURE_2D, tex);
-			glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
-			glBindTexture(GL_TEXTURE_2D, 0);
-
-			// resize image
-			if (sizeMulti != 1) {
-				stbir_resize_uint8(pixels, actualSizeX, actualSizeY, actualSizeX * 4,
-					outPixels, m_previewSaveSize.x, m_previewSaveSize.y, m_previewSaveSize.x * 4, 4);
-			}
-
-			std::string ext = m_previewSavePath.substr(m_previewSavePath.find_last_of('.') + 1);
-
-			if (ext == "jpg" || ext == "jpeg")
-				stbi_write_jpg(m_previewSavePath.c_str(), m_previewSaveSize.x, m_previewSaveSize.y, 4, outPixels, 100);
-			else if (ext == "bmp")
-				stbi_write_bmp(m_previewSavePath.c_str(), m_previewSaveSize.x, m_previewSaveSize.y, 4, outPixels);
-			else if (ext == "tga")
-				stbi_write_tga(m_previewSavePath.c_str(), m_previewSaveSize.x, m_previewSaveSize.y, 4, outPixels);
-			else
-				stbi_write_png(m_previewSavePath.c_str(), m_previewSaveSize.x, m_previewSaveSize.y, 4, outPixels, m_previewSaveSize.x * 4);
-
-			if (sizeMulti != 1) free(outPixels);
-			free(pixels);
-		} 
-		else { // sequence render
-			float seqDelta = 1.0f / m_savePreviewSeqFPS;
-
-			if (actualSizeX > 0 && actualSizeY > 0) {
-				SystemVariableManager::Instance().SetKeysWASD(m_savePreviewWASD[0], m_savePreviewWASD[1], m_savePreviewWASD[2], m_savePreviewWASD[3]);
-				SystemVariableManager::Instance().SetMousePosition(m_savePreviewMouse.x, m_savePreviewMouse.y);
-				SystemVariableManager::Instance().SetMouse(m_savePreviewMouse.x, m_savePreviewMouse.y, m_savePreviewMouse.z, m_savePreviewMouse.w);
-
-				float curTime = 0.0f;
-
-				GLuint tex = m_data->Renderer.GetTexture();
-
-				size_t lastDot = m_previewSavePath.find_last_of('.');
-				std::string ext = lastDot == std::string::npos ? "png" : m_previewSavePath.substr(lastDot + 1);
-				std::string filename = m_previewSavePath;
-
-				// allow only one %??d
-				bool inFormat = false;
-				int lastFormatPos = -1;
-				int formatCount = 0;
-				for (int i = 0; i < filename.size(); i++) {
-					if (filename[i] == '%') {
-						inFormat = true;
-						lastFormatPos = i;
-						continue;
-					}
-
-					if (inFormat) {
-						if (isdigit(filename[i])) {
-						} else {
-							if (filename[i] != '%' && ((filename[i] == 'd' && formatCount > 0) || (filename[i] != 'd'))) {
-								filename.insert(lastFormatPos, 1, '%');
-							}
-
-							if (filename[i] == 'd')
-								formatCount++;
-							inFormat = false;
-						}
-					}
-				}
-
-				// no %d found? add one
-				if (formatCount == 0) {
-					int frameCountDigits = log10((int)(m_savePreviewSeqDuration / seqDelta)) + 1;
-					filename.insert(lastDot == std::string::npos ? filename.size() : lastDot, "%0" + std::to_string(frameCountDigits) + "d"); // frame%d
-				}
-
-				SystemVariableManager::Instance().AdvanceTimer(m_savePreviewCachedTime - m_savePreviewTimeDelta);
-				SystemVariableManager::Instance().SetTimeDelta(seqDelta);
-
-				stbi_write_png_compression_level = 5; // set to lowest compression level
-
-				int tCount = std::thread::hardware_concurrency();
-				tCount = tCount == 0 ? 2 : tCount;
-
-				unsigned char** pixels = new unsigned char*[tCount];
-				unsigned char** outPixels = new unsigned char*[tCount];
-				int* curFrame = new int[tCount];
-				bool* needsUpdate = new bool[tCount];
-				std::thread** threadPool = new std::thread*[tCount];
-				std::atomic<bool> isOver = false;
-
-				for (int i = 0; i < tCount; i++) {
-					curFrame[i] = 0;
-					needsUpdate[i] = true;
-					pixels[i] = (unsigned char*)malloc(actualSizeX * actualSizeY * 4);
-
-					if (sizeMulti != 1)
-						outPixels[i] = (unsigned char*)malloc(m_previewSaveSize.x * m_previewSaveSize.y * 4);
-					else
-						outPixels[i] = nullptr;
-
-					threadPool[i] = new std::thread([ext, filename, sizeMulti, actualSizeX, actualSizeY, &outPixels, &pixels, &needsUpdate, &curFrame, &isOver](int worker, int w, int h) {
-						char prevSavePath[SHADERED_MAX_PATH];
-						while (!isOver) {
-							if (needsUpdate[worker])
-								continue;
-
-							// resize image
-							if (sizeMulti != 1) {
-								stbir_resize_uint8(pixels[worker], actualSizeX, actualSizeY, actualSizeX * 4,
-									outPixels[worker], w, h, w * 4, 4);
-							} else
-								outPixels[worker] = pixels[worker];
-
-							sprintf(prevSavePath, filename.c_str(), curFrame[worker]);
-
-							if (ext == "jpg" || ext == "jpeg")
-								stbi_write_jpg(prevSavePath, w, h, 4, outPixels[worker], 100);
-							else if (ext == "bmp")
-								stbi_write_bmp(prevSavePath, w, h, 4, outPixels[worker]);
-							else if (ext == "tga")
-								stbi_write_tga(prevSavePath, w, h, 4, outPixels[worker]);
-							else
-								stbi_write_png(prevSavePath, w, h, 4, outPixels[worker], w * 4);
-
-							needsUpdate[worker] = true;
-						}
-					},
-						i, m_previewSaveSize.x, m_previewSaveSize.y);
-				}
-
-				int globalFrame = 0;
-				while (curTime < m_savePreviewSeqDuration) {
-					int hasWork = -1;
-					for (int i = 0; i < tCount; i++)
-						if (needsUpdate[i]) {
-							hasWork = i;
-							break;
-						}
-
-					if (hasWork == -1)
-						continue;
-
-					SystemVariableManager::Instance().CopyState();
-					SystemVariableManager::Instance().SetFrameIndex(m_savePreviewFrameIndex + globalFrame);
-
-					m_data->Renderer.Render(actualSizeX, actualSizeY);
-
-					glBindTexture(GL_TEXTURE_2D, tex);
-					glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels[hasWork]);
-					glBindTexture(GL_TEXTURE_2D, 0);
-
-					SystemVariableManager::Instance().AdvanceTimer(seqDelta);
-
-					curTime += seqDelta;
-					curFrame[hasWork] = globalFrame;
-					needsUpdate[hasWork] = false;
-					globalFrame++;
-				}
-				isOver = true;
-
-				for (int i = 0; i < tCount; i++) {
-					if (threadPool[i]->joinable())
-						threadPool[i]->join();
-					free(pixels[i]);
-					if (sizeMulti != 1)
-						free(outPixels[i]);
-					delete threadPool[i];
-				}
-				delete[] pixels;
-				delete[] outPixels;
-				delete[] curFrame;
-				delete[] needsUpdate;
-				delete[] threadPool;
-
-				stbi_write_png_compression_level = 8; // set back to default compression level
-			}
-		}
-
-		SystemVariableManager::Instance().SetSavingToFile(false);
+		PreviewExporter exporter;
+		exporter.Path = m_previewSavePath;
+		exporter.Format = m_savePreviewFormat;
+		exporter.Size = m_previewSaveSize;
+		exporter.Supersample = 1 << m_savePreviewSupersample;
+
+		exporter.Time = m_savePreviewTime;
+		exporter.CachedTime = m_savePreviewCachedTime;
+		exporter.TimeDelta = m_savePreviewTimeDelta;
+		exporter.FrameIndex = m_savePreviewFrameIndex;
+		for (int i = 0; i < 4; i++)
+			exporter.WASD[i] = m_savePreviewWASD[i];
+		exporter.Mouse = m_savePreviewMouse;
+
+		exporter.Sequence = m_savePreviewSeq;
+		exporter.SequenceDuration = m_savePreviewSeqDuration;
+		exporter.SequenceFPS = m_savePreviewSeqFPS;
+		exporter.FrameStart = m_savePreviewSeqFrameStart;
+		exporter.FrameEnd = m_savePreviewSeqFrameEnd;
+		exporter.ShardIndex = m_savePreviewSeqShard;
+		exporter.ShardCount = m_savePreviewSeqShardCount;
+		exporter.Resume = m_savePreviewSeqResume;
+
+		exporter.Export(&m_data->Renderer);
 	}
 
 	void GUIManager::CreateNewShaderPass()
@@ -2291,6 +2120,7 @@ namespace ed {
 		if (m_savePreviewPopupOpened) {
 			ImGui::OpenPopup("Save Preview##main_save_preview");
 			m_previewSavePath = "render.png";
+			m_savePreviewFormat = "";
 			m_savePreviewPopupOpened = false;
 			m_wasPausedPrior = m_data->Renderer.IsPaused();
 			m_savePreviewCachedTime = m_savePreviewTime = SystemVariableManager::Instance().GetTime();
@@ -3060,9 +2890,7 @@ namespace ed {
 		KeyboardShortcuts::Instance().SetCallback("Project.Rebuild", [=]() {
 			((CodeEditorUI*)Get(ViewID::Code))->SaveAll();
 
-			std::vector<PipelineItem*> passes = m_data->Pipeline.GetList();
-			for (PipelineItem*& pass : passes)
-				m_data->Renderer.Recompile(pass->Name);
+			m_data->Renderer.RecompileAll();
 		});
 		KeyboardShortcuts::Instance().SetCallback("Project.Save", [=]() {
 			Save();
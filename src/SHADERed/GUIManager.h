@@ -204,6 +204,10 @@ namespace ed {
 		bool m_savePreviewSeq;
 		float m_savePreviewSeqDuration;
 		int m_savePreviewSeqFPS;
+		std::string m_savePreviewFormat; // empty -> pick by the extension
+		int m_savePreviewSeqFrameStart, m_savePreviewSeqFrameEnd; // end is inclusive, -1 -> last frame
+		int m_savePreviewSeqShard, m_savePreviewSeqShardCount;
+		bool m_savePreviewSeqResume;
 
 		bool m_performanceMode, m_perfModeFake;
 		eng::Timer m_perfModeClock;
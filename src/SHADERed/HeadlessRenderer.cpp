@@ -0,0 +1,72 @@
+#include <SHADERed/HeadlessRenderer.h>
+#include <SHADERed/Engine/MeshCache.h>
+#include <SHADERed/Objects/Benchmark.h>
+#include <SHADERed/Objects/CommandLineOptionParser.h>
+#include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Objects/PreviewExporter.h>
+#include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/ShaderCache.h>
+
+namespace ed {
+	HeadlessRenderer::HeadlessRenderer()
+			: Renderer(&Pipeline, &Objects, &Parser, &Messages, &Plugins, &Debugger)
+			, Pipeline(&Parser, &Plugins)
+			, Objects(&Parser, &Renderer)
+			, Parser(&Pipeline, &Objects, &Renderer, &Plugins, &Messages, &Debugger, nullptr)
+			, Debugger(&Objects, &Renderer, &Messages)
+	{
+		Settings::Instance().Load();
+
+		ShaderCache::Instance().Initialize(Settings::Instance().ConvertPath("cache/shaders/"), (size_t)Settings::Instance().General.ShaderCacheSize * 1024 * 1024);
+		ShaderCache::Instance().SetEnabled(Settings::Instance().General.ShaderCache);
+		eng::MeshCache::Instance().Initialize(Settings::Instance().ConvertPath("cache/models/"), (size_t)Settings::Instance().General.MeshCacheSize * 1024 * 1024);
+		eng::MeshCache::Instance().SetEnabled(Settings::Instance().General.MeshCache);
+
+		Pipeline.AddEventHandler([&](PipelineManager::EventType type, PipelineItem* item) {
+			Renderer.OnPipelineEvent(type, item);
+		});
+
+		Renderer.AllowComputeShaders(GLEW_ARB_compute_shader);
+		Renderer.AllowTessellationShaders(GLEW_ARB_tessellation_shader);
+	}
+	HeadlessRenderer::~HeadlessRenderer()
+	{
+		Pipeline.Clear();
+		Objects.Clear();
+	}
+	void HeadlessRenderer::Open(const std::string& file)
+	{
+		Renderer.Pause(false);
+
+		if (file.empty()) {
+			Parser.SetTemplate(Settings::Instance().General.StartUpTemplate);
+			Pipeline.New();
+		} else
+			Parser.Open(file);
+	}
+	void HeadlessRenderer::Render(const CommandLineOptionParser& options)
+	{
+		PreviewExporter exporter;
+		exporter.LoadCommandLineOptions(options);
+		exporter.Export(&Renderer);
+
+		m_logErrors();
+	}
+	int HeadlessRenderer::RunBenchmark(const CommandLineOptionParser& options)
+	{
+		Benchmark benchmark;
+		benchmark.LoadCommandLineOptions(options);
+		benchmark.Run(&Renderer);
+
+		m_logErrors();
+
+		return benchmark.Report();
+	}
+	void HeadlessRenderer::m_logErrors()
+	{
+		// log compilation errors - there is no UI to show them
+		for (const auto& msg : Messages.GetMessages())
+			if (msg.MType == MessageStack::Type::Error)
+				Logger::Get().Log(msg.Group + ": " + msg.Text, true);
+	}
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include <SHADERed/Objects/DebugInformation.h>
+#include <SHADERed/Objects/MessageStack.h>
+#include <SHADERed/Objects/ObjectManager.h>
+#include <SHADERed/Objects/PipelineManager.h>
+#include <SHADERed/Objects/PluginManager.h>
+#include <SHADERed/Objects/ProjectParser.h>
+#include <SHADERed/Objects/RenderEngine.h>
+
+namespace ed {
+	class CommandLineOptionParser;
+
+	// --render/--rendersequence/--benchmark with --headless: only the objects needed for rendering, no window, ImGui or GUIManager
+	// GL context must be current before this object is created (see eng::HeadlessContext)
+	class HeadlessRenderer {
+	public:
+		HeadlessRenderer();
+		~HeadlessRenderer();
+
+		void Open(const std::string& file); // empty -> startup template
+		void Render(const CommandLineOptionParser& options);
+		int RunBenchmark(const CommandLineOptionParser& options); // returns the exit code
+
+		PluginManager Plugins; // never initialized - plugins need the UI
+		RenderEngine Renderer;
+		PipelineManager Pipeline;
+		ObjectManager Objects;
+		ProjectParser Parser;
+		MessageStack Messages;
+		DebugInformation Debugger;
+
+	private:
+		void m_logErrors();
+	};
+}
\ No newline at end of file
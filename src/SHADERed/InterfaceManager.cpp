@@ -1,4 +1,5 @@
 #include <SHADERed/AppEvent.h>
+#include <SHADERed/Engine/GeometryFactory.h>
 #include <SHADERed/GUIManager.h>
 #include <SHADERed/InterfaceManager.h>
 #include <SHADERed/Objects/Names.h>
@@ -52,6 +53,10 @@ namespace ed {
 			, DAP(&Debugger, gui, &Run)
 	{
 		m_ui = gui;
+
+		Pipeline.AddEventHandler([&](PipelineManager::EventType type, PipelineItem* item) {
+			Renderer.OnPipelineEvent(type, item);
+		});
 	}
 	InterfaceManager::~InterfaceManager()
 	{
@@ -320,11 +325,16 @@ namespace ed {
 			pipe::GeometryItem::GeometryType geoType = ((pipe::GeometryItem*)pixel.Object->Data)->Type;
 			GLuint vbo = ((pipe::GeometryItem*)pixel.Object->Data)->VBO;
 
-			// TODO: don't bother GPU so much
+			// GeometryFactory keeps a CPU copy of the vertex data, read it from the GPU only if it's missing
+			const std::vector<float>* vertData = eng::GeometryFactory::GetVertexData(vbo);
+
 			glBindBuffer(GL_ARRAY_BUFFER, vbo);
 			if (geoType == pipe::GeometryItem::GeometryType::ScreenQuadNDC) {
 				GLfloat bufData[6 * 4] = { 0.0f };
-				glGetBufferSubData(GL_ARRAY_BUFFER, 0, 6 * 4 * sizeof(float), &bufData[0]);
+				if (vertData != nullptr)
+					memcpy(&bufData[0], vertData->data(), std::min<size_t>(6 * 4, vertData->size()) * sizeof(float));
+				else
+					glGetBufferSubData(GL_ARRAY_BUFFER, 0, 6 * 4 * sizeof(float), &bufData[0]);
 
 				for (int i = 0; i < pixel.VertexCount; i++) {
 					int actualIndex = pixel.VertexID + i;
@@ -334,7 +344,10 @@ namespace ed {
 				}
 			} else {
 				GLfloat bufData[3 * 18] = { 0.0f };
-				glGetBufferSubData(GL_ARRAY_BUFFER, pixel.VertexID * 18 * sizeof(float), pixel.VertexCount * 18 * sizeof(float), &bufData[0]);
+				if (vertData != nullptr && (pixel.VertexID + pixel.VertexCount) * 18 <= vertData->size())
+					memcpy(&bufData[0], vertData->data() + pixel.VertexID * 18, pixel.VertexCount * 18 * sizeof(float));
+				else
+					glGetBufferSubData(GL_ARRAY_BUFFER, pixel.VertexID * 18 * sizeof(float), pixel.VertexCount * 18 * sizeof(float), &bufData[0]);
 
 				copyFloatData(pixel.Vertex[0], &bufData[0]);
 				copyFloatData(pixel.Vertex[1], &bufData[18]);
@@ -345,16 +358,16 @@ namespace ed {
 		else if (pixel.Object->Type == PipelineItem::ItemType::Model) {
 			pipe::Model* mdl = ((pipe::Model*)pixel.Object->Data);
 
-			int curOffset = 0;
+			// VertexID is an offset in the model's shared index buffer
 			for (const auto& mesh : mdl->Data->Meshes) {
-				if (pixel.VertexID >= curOffset + mesh.Indices.size()) {
-					curOffset += mesh.Indices.size();
+				if (pixel.VertexID < mesh.IndexOffset || pixel.VertexID + 2 >= mesh.IndexOffset + mesh.Indices.size())
 					continue;
-				}
 
-				pixel.Vertex[0] = mesh.Vertices[mesh.Indices[pixel.VertexID + 0]];
-				pixel.Vertex[1] = mesh.Vertices[mesh.Indices[pixel.VertexID + 1]];
-				pixel.Vertex[2] = mesh.Vertices[mesh.Indices[pixel.VertexID + 2]];
+				int localID = pixel.VertexID - mesh.IndexOffset;
+				pixel.Vertex[0] = mesh.Vertices[mesh.Indices[localID + 0]];
+				pixel.Vertex[1] = mesh.Vertices[mesh.Indices[localID + 1]];
+				pixel.Vertex[2] = mesh.Vertices[mesh.Indices[localID + 2]];
+				break;
 			}
 		} 
 		else if (pixel.Object->Type == PipelineItem::ItemType::VertexBuffer) {
@@ -367,11 +380,10 @@ namespace ed {
 			for (const auto& dataEl : tData)
 				stride += ShaderVariable::GetSize(dataEl, true); 
 			
-			GLfloat* bufPtr = (GLfloat*)malloc(pixel.VertexCount * stride);
-
-			glBindBuffer(GL_ARRAY_BUFFER, bufData->ID);
-			glGetBufferSubData(GL_ARRAY_BUFFER, pixel.VertexID * stride, pixel.VertexCount * stride, &bufPtr[0]);
-			glBindBuffer(GL_ARRAY_BUFFER, 0);
+			Objects.SyncBuffer(bufData);
+			if (stride == 0 || bufData->Data == nullptr || (pixel.VertexID + pixel.VertexCount) * stride > bufData->Size)
+				return;
+			const GLfloat* bufPtr = (const GLfloat*)((char*)bufData->Data + pixel.VertexID * stride);
 
 			for (int i = 0; i < pixel.VertexCount; i++) {
 				int iOffset = 0;
@@ -389,8 +401,6 @@ namespace ed {
 					iOffset += ShaderVariable::GetSize(tData[j]) / 4;
 				}
 			}
-
-			free(bufPtr);
 		} 
 		else if (pixel.Object->Type == PipelineItem::ItemType::PluginItem) {
 			pipe::PluginItemData* pdata = (pipe::PluginItemData*)pixel.Object->Data;
@@ -104,6 +104,7 @@ namespace ed {
 		gl::FreeSimpleFramebuffer(m_fbo, m_rt, m_depth);
 		glDeleteVertexArrays(1, &m_fsRectVAO);
 		glDeleteBuffers(1, &m_fsRectVBO);
+		ed::eng::GeometryFactory::ReleaseVertexData(m_fsRectVBO);
 		glDeleteProgram(m_shader);
 	}
 
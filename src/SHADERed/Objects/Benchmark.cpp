@@ -0,0 +1,340 @@
+#include <SHADERed/Objects/Benchmark.h>
+#include <SHADERed/Objects/CommandLineOptionParser.h>
+#include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Objects/RenderEngine.h>
+#include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/SystemVariableManager.h>
+#include <SHADERed/Engine/Timer.h>
+
+#include <json/single_include/nlohmann/json.hpp>
+
+#include <algorithm>
+#include <ctype.h>
+#include <fstream>
+#include <stdlib.h>
+#include <unordered_map>
+
+#define BENCHMARK_MIN_DIFFERENCE 0.005 // ms - ignore the slowdowns that are too small to measure reliably
+
+namespace ed {
+	Benchmark::Benchmark()
+	{
+		ReportPath = "-";
+		BaselinePath = "";
+		Project = "";
+		Size = glm::ivec2(1920, 1080);
+		WarmupFrames = 10;
+		Frames = 100;
+		FPS = 60;
+		StartTime = 0.0f;
+		StartFrameIndex = 0;
+		Threshold = 10.0f;
+	}
+	void Benchmark::LoadCommandLineOptions(const CommandLineOptionParser& options)
+	{
+		ReportPath = options.BenchmarkPath;
+		BaselinePath = options.BenchmarkBaseline;
+		Project = options.ProjectFile;
+		Size = glm::ivec2(options.RenderWidth, options.RenderHeight);
+		WarmupFrames = options.BenchmarkWarmup;
+		Frames = options.BenchmarkFrames;
+		FPS = options.RenderSequenceFPS;
+		StartTime = options.RenderTime;
+		StartFrameIndex = options.RenderFrameIndex;
+		Threshold = options.BenchmarkThreshold;
+	}
+	void Benchmark::Run(RenderEngine* renderer)
+	{
+		m_series.clear();
+		if (Size.x <= 0 || Size.y <= 0 || Frames <= 0)
+			return;
+
+		// every pass has to be measured, draw call timers would only add overhead
+		Settings& settings = Settings::Instance();
+		bool profiler = settings.General.Profiler, profilerDraws = settings.General.ProfilerDraws;
+		settings.General.Profiler = true;
+		settings.General.ProfilerDraws = false;
+
+		// Time & FrameIndex are set manually for each frame so that two runs render exactly the same frames
+		bool paused = renderer->IsPaused();
+		renderer->Pause(true);
+
+		SystemVariableManager& sysVars = SystemVariableManager::Instance();
+		sysVars.SetSavingToFile(true); // compile synchronously, run the compute passes even though the renderer is paused
+		float delta = 1.0f / std::max<int>(1, FPS);
+		sysVars.SetTimeDelta(delta);
+
+		// the first frame compiles the shaders - never measure it
+		int warmup = std::max<int>(1, WarmupFrames);
+
+		m_series.resize(2);
+		m_series[0] = { "Frame", "frame", -1.0f, {} };
+		m_series[1] = { "Render()", "cpu", -1.0f, {} };
+
+		for (int i = 0; i < warmup + Frames; i++) {
+			bool measure = i >= warmup;
+			int frame = measure ? i - warmup : 0; // warmup frames all render the first frame
+
+			sysVars.CopyState();
+			sysVars.SetFrameIndex(StartFrameIndex + frame);
+			sysVars.AdvanceTimer(StartTime + frame * delta - sysVars.GetTime());
+
+			eng::Timer cpuTimer;
+			renderer->Render(Size.x, Size.y);
+			float cpuTime = cpuTimer.GetElapsedTime();
+
+			// wait for the GPU so that the timer results of this frame can be read right away
+			glFinish();
+			renderer->PollPerformanceTimers();
+
+			const std::vector<PerformanceTimer>& timers = renderer->GetPerformanceTimers();
+			if (i == warmup - 1) {
+				for (const auto& timer : timers) {
+					Series pass;
+					pass.Name = timer.Pass->Name;
+					pass.Type = "plugin";
+					if (timer.Pass->Type == PipelineItem::ItemType::ShaderPass)
+						pass.Type = "shader";
+					else if (timer.Pass->Type == PipelineItem::ItemType::ComputePass)
+						pass.Type = "compute";
+					else if (timer.Pass->Type == PipelineItem::ItemType::AudioPass)
+						pass.Type = "audio";
+
+					float compileTime = renderer->GetCompileTime(timer.Pass);
+					pass.CompileTime = compileTime < 0.0f ? -1.0f : compileTime * 1000.0f;
+
+					m_series.push_back(pass);
+				}
+			}
+
+			if (measure) {
+				m_series[0].Samples.push_back(renderer->GetFrameTimer().LastTime / 1000000.0);
+				m_series[1].Samples.push_back(cpuTime * 1000.0);
+				for (int j = 0; j < timers.size() && j + 2 < m_series.size(); j++)
+					m_series[j + 2].Samples.push_back(timers[j].LastTime / 1000000.0);
+			}
+		}
+
+		sysVars.SetSavingToFile(false);
+		renderer->Pause(paused);
+
+		settings.General.Profiler = profiler;
+		settings.General.ProfilerDraws = profilerDraws;
+
+		Logger::Get().Log("Benchmark rendered " + std::to_string(Frames) + " frames");
+	}
+	int Benchmark::Report()
+	{
+		if (!SaveReport())
+			return 1;
+
+		if (!BaselinePath.empty()) {
+			int slower = CompareBaseline();
+			if (slower < 0)
+				return 1;
+			if (slower > 0)
+				return 2;
+		}
+
+		return 0;
+	}
+	bool Benchmark::SaveReport()
+	{
+		if (m_series.empty())
+			return false;
+
+		bool toStdout = ReportPath == "-";
+		FILE* file = toStdout ? stdout : fopen(ReportPath.c_str(), "w");
+		if (file == nullptr) {
+			Logger::Get().Log("Failed to open " + ReportPath + " for writing", true);
+			return false;
+		}
+
+		size_t lastDot = ReportPath.find_last_of('.');
+		std::string ext = lastDot == std::string::npos ? "" : ReportPath.substr(lastDot + 1);
+		std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+		bool ret = ext == "csv" ? m_saveCSV(file) : m_saveJSON(file);
+
+		if (toStdout)
+			fflush(stdout);
+		else
+			fclose(file);
+
+		return ret;
+	}
+	int Benchmark::CompareBaseline()
+	{
+		std::ifstream file(BaselinePath);
+		if (!file.is_open()) {
+			Logger::Get().Log("Failed to open the benchmark baseline " + BaselinePath, true);
+			return -1;
+		}
+
+		// JSON or CSV - same as SaveReport(), but also check the contents in case the extension doesn't match
+		size_t lastDot = BaselinePath.find_last_of('.');
+		std::string ext = lastDot == std::string::npos ? "" : BaselinePath.substr(lastDot + 1);
+		std::transform(ext.begin(), ext.end(), ext.begin(), ::tolower);
+
+		file >> std::ws;
+		bool isJSON = ext == "json" || (ext != "csv" && file.peek() == '{');
+
+		std::unordered_map<std::string, double> baseline;
+		bool loaded = isJSON ? m_loadBaselineJSON(file, baseline) : m_loadBaselineCSV(file, baseline);
+		if (!loaded) {
+			Logger::Get().Log("Failed to parse the benchmark baseline " + BaselinePath, true);
+			return -1;
+		}
+
+		int slower = 0, matched = 0;
+		for (const auto& series : m_series) {
+			auto it = baseline.find(series.Type + "/" + series.Name);
+			if (it == baseline.end())
+				continue;
+
+			matched++;
+
+			double oldTime = it->second;
+			double newTime = m_getStats(series.Samples).Median;
+			if (newTime - oldTime > BENCHMARK_MIN_DIFFERENCE && newTime > oldTime * (1.0 + Threshold / 100.0)) {
+				fprintf(stderr, "Slower: %s (%s) %.4f ms -> %.4f ms (+%.1f%%)\n", series.Name.c_str(), series.Type.c_str(), oldTime, newTime, oldTime > 0.0 ? (newTime / oldTime - 1.0) * 100.0 : 100.0);
+				slower++;
+			}
+		}
+
+		// wrong or outdated baseline - nothing was compared, so don't report success
+		if (matched == 0) {
+			Logger::Get().Log("None of the measured passes were found in the benchmark baseline " + BaselinePath, true);
+			return -1;
+		}
+
+		return slower;
+	}
+	bool Benchmark::m_loadBaselineJSON(std::istream& file, std::unordered_map<std::string, double>& baseline)
+	{
+		nlohmann::json report = nlohmann::json::parse(file, nullptr, false);
+		if (report.is_discarded() || !report.is_object() || !report.contains("results") || !report["results"].is_array())
+			return false;
+
+		for (const auto& result : report["results"]) {
+			if (!result.is_object())
+				continue;
+
+			auto name = result.find("name"), type = result.find("type"), median = result.find("median_ms");
+			if (name == result.end() || type == result.end() || median == result.end() || !name->is_string() || !type->is_string() || !median->is_number())
+				continue;
+
+			baseline[type->get<std::string>() + "/" + name->get<std::string>()] = median->get<double>();
+		}
+
+		return true;
+	}
+	bool Benchmark::m_loadBaselineCSV(std::istream& file, std::unordered_map<std::string, double>& baseline)
+	{
+		std::string line;
+		if (!std::getline(file, line)) // header
+			return false;
+
+		while (std::getline(file, line)) {
+			std::vector<std::string> cells;
+			std::string cell;
+			bool quoted = false;
+			for (int i = 0; i < line.size(); i++) {
+				char c = line[i];
+				if (c == '"') {
+					if (quoted && i + 1 < line.size() && line[i + 1] == '"') {
+						cell += '"';
+						i++;
+					} else
+						quoted = !quoted;
+				} else if (c == ',' && !quoted) {
+					cells.push_back(cell);
+					cell.clear();
+				} else if (c != '\r')
+					cell += c;
+			}
+			cells.push_back(cell);
+
+			// name, type, compile_ms, samples, min_ms, avg_ms, median_ms, ...
+			if (cells.size() >= 7)
+				baseline[cells[1] + "/" + cells[0]] = atof(cells[6].c_str());
+		}
+
+		return true;
+	}
+	Benchmark::Stats Benchmark::m_getStats(const std::vector<double>& samples)
+	{
+		Stats ret = { 0, 0, 0, 0, 0, 0 };
+		if (samples.empty())
+			return ret;
+
+		std::vector<double> sorted = samples;
+		std::sort(sorted.begin(), sorted.end());
+
+		auto percentile = [&](int p) {
+			return sorted[std::min<size_t>((sorted.size() * p) / 100, sorted.size() - 1)];
+		};
+
+		double sum = 0.0;
+		for (double s : sorted)
+			sum += s;
+
+		ret.Min = sorted.front();
+		ret.Max = sorted.back();
+		ret.Avg = sum / sorted.size();
+		ret.Median = percentile(50);
+		ret.P95 = percentile(95);
+		ret.P99 = percentile(99);
+
+		return ret;
+	}
+	bool Benchmark::m_saveJSON(FILE* file)
+	{
+		auto escape = [](const std::string& str) {
+			std::string ret;
+			for (char c : str) {
+				if (c == '"' || c == '\\')
+					ret += '\\';
+				if ((unsigned char)c >= 0x20)
+					ret += c;
+			}
+			return ret;
+		};
+
+		fprintf(file, "{\n\t\"project\": \"%s\",\n", escape(Project).c_str());
+		fprintf(file, "\t\"width\": %d,\n\t\"height\": %d,\n\t\"warmup\": %d,\n\t\"frames\": %d,\n\t\"fps\": %d,\n", Size.x, Size.y, std::max<int>(1, WarmupFrames), Frames, FPS);
+		fprintf(file, "\t\"results\": [\n");
+		for (int i = 0; i < m_series.size(); i++) {
+			const Series& series = m_series[i];
+			Stats stats = m_getStats(series.Samples);
+
+			fprintf(file, "\t\t{ \"name\": \"%s\", \"type\": \"%s\", ", escape(series.Name).c_str(), series.Type.c_str());
+			if (series.CompileTime >= 0.0f)
+				fprintf(file, "\"compile_ms\": %.4f, ", series.CompileTime);
+			fprintf(file, "\"samples\": %d, \"min_ms\": %.4f, \"avg_ms\": %.4f, \"median_ms\": %.4f, \"p95_ms\": %.4f, \"p99_ms\": %.4f, \"max_ms\": %.4f }%s\n",
+				(int)series.Samples.size(), stats.Min, stats.Avg, stats.Median, stats.P95, stats.P99, stats.Max,
+				i + 1 < m_series.size() ? "," : "");
+		}
+		fprintf(file, "\t]\n}\n");
+
+		return !ferror(file);
+	}
+	bool Benchmark::m_saveCSV(FILE* file)
+	{
+		fprintf(file, "name,type,compile_ms,samples,min_ms,avg_ms,median_ms,p95_ms,p99_ms,max_ms\n");
+		for (const auto& series : m_series) {
+			Stats stats = m_getStats(series.Samples);
+
+			std::string name;
+			for (char c : series.Name)
+				name += c == '"' ? std::string("\"\"") : std::string(1, c);
+
+			fprintf(file, "\"%s\",%s,", name.c_str(), series.Type.c_str());
+			if (series.CompileTime >= 0.0f)
+				fprintf(file, "%.4f", series.CompileTime);
+			fprintf(file, ",%d,%.4f,%.4f,%.4f,%.4f,%.4f,%.4f\n", (int)series.Samples.size(), stats.Min, stats.Avg, stats.Median, stats.P95, stats.P99, stats.Max);
+		}
+
+		return !ferror(file);
+	}
+}
\ No newline at end of file
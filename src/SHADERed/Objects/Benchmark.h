@@ -0,0 +1,54 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <cstdio>
+#include <istream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace ed {
+	class RenderEngine;
+	class CommandLineOptionParser;
+
+	// --benchmark: renders a fixed number of frames with deterministic Time/FrameIndex and reports
+	// the GPU time of the frame and of each pass (PerformanceTimer), the CPU time spent in RenderEngine::Render and the compile times
+	class Benchmark {
+	public:
+		Benchmark();
+
+		void LoadCommandLineOptions(const CommandLineOptionParser& options);
+		void Run(RenderEngine* renderer);
+
+		int Report();		   // saves the report & compares it with the baseline, returns the exit code: 0 -> ok, 1 -> error, 2 -> something got slower
+		bool SaveReport();	   // JSON or CSV, picked by the extension - "-" -> JSON to stdout
+		int CompareBaseline(); // returns the number of slower entries, -1 if the baseline couldn't be loaded or if it has none of the measured entries
+
+		std::string ReportPath, BaselinePath, Project;
+		glm::ivec2 Size;
+		int WarmupFrames, Frames, FPS;
+		float StartTime;
+		int StartFrameIndex;
+		float Threshold; // allowed slowdown of the median time, in percent
+
+	private:
+		struct Series {
+			std::string Name;
+			std::string Type; // frame, cpu, shader, compute, audio, plugin
+			float CompileTime; // ms, < 0 -> not compiled
+			std::vector<double> Samples; // ms
+		};
+		struct Stats {
+			double Min, Avg, Median, P95, P99, Max;
+		};
+
+		Stats m_getStats(const std::vector<double>& samples);
+
+		// type + "/" + name -> median, from a report saved by SaveReport()
+		bool m_loadBaselineJSON(std::istream& file, std::unordered_map<std::string, double>& baseline);
+		bool m_loadBaselineCSV(std::istream& file, std::unordered_map<std::string, double>& baseline);
+		bool m_saveJSON(FILE* file);
+		bool m_saveCSV(FILE* file);
+
+		std::vector<Series> m_series; // [0] -> GPU frame time, [1] -> CPU frame time, then the pipeline items
+	};
+}
\ No newline at end of file
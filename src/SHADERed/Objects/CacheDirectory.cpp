@@ -0,0 +1,120 @@
+#include <SHADERed/Objects/CacheDirectory.h>
+#include <SHADERed/Objects/Logger.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+namespace ed {
+	CacheDirectory::CacheDirectory()
+	{
+		m_maxSize = 0;
+		m_size = 0;
+	}
+	bool CacheDirectory::Open(const std::string& dir, const std::string& ext, size_t maxSize, const std::string& name)
+	{
+		m_dir = dir;
+		m_ext = ext;
+		m_name = name;
+		m_maxSize = maxSize;
+		m_size = 0;
+		m_entries.clear();
+
+		std::error_code fsError;
+		std::filesystem::create_directories(m_dir, fsError);
+		if (fsError) {
+			m_dir = "";
+			return false;
+		}
+
+		for (const auto& file : std::filesystem::directory_iterator(m_dir, fsError)) {
+			if (file.path().extension() != m_ext)
+				continue;
+
+			std::string stem = file.path().stem().string();
+			char* stemEnd = nullptr;
+			uint64_t key = strtoull(stem.c_str(), &stemEnd, 16);
+			if (stem.empty() || *stemEnd != 0)
+				continue;
+
+			EntryInfo info;
+			info.Size = file.file_size(fsError);
+			info.LastUse = file.last_write_time(fsError);
+
+			m_entries[key] = info;
+			m_size += info.Size;
+		}
+
+		return true;
+	}
+	std::string CacheDirectory::GetPath(uint64_t key)
+	{
+		char name[32] = { 0 };
+		snprintf(name, 32, "%016llx", (unsigned long long)key);
+		return (std::filesystem::path(m_dir) / (name + m_ext)).string();
+	}
+	void CacheDirectory::Touch(uint64_t key)
+	{
+		// update the file too so that the LRU order survives restarts
+		std::error_code fsError;
+		auto now = std::filesystem::file_time_type::clock::now();
+		std::filesystem::last_write_time(GetPath(key), now, fsError);
+
+		auto it = m_entries.find(key);
+		if (it != m_entries.end())
+			it->second.LastUse = now;
+	}
+	void CacheDirectory::Add(uint64_t key, size_t size)
+	{
+		auto it = m_entries.find(key);
+		if (it != m_entries.end())
+			m_size -= it->second.Size;
+
+		EntryInfo info;
+		info.Size = size;
+		info.LastUse = std::filesystem::file_time_type::clock::now();
+		m_entries[key] = info;
+		m_size += size;
+
+		if (m_maxSize != 0 && m_size > m_maxSize)
+			m_evict();
+	}
+	void CacheDirectory::Remove(uint64_t key)
+	{
+		std::error_code fsError;
+		std::filesystem::remove(GetPath(key), fsError);
+
+		auto it = m_entries.find(key);
+		if (it != m_entries.end()) {
+			m_size -= it->second.Size;
+			m_entries.erase(it);
+		}
+	}
+	void CacheDirectory::Clear()
+	{
+		std::error_code fsError;
+		if (!m_dir.empty())
+			for (const auto& file : std::filesystem::directory_iterator(m_dir, fsError))
+				if (file.path().extension() == m_ext || file.path().extension() == ".tmp")
+					std::filesystem::remove(file.path(), fsError);
+
+		m_entries.clear();
+		m_size = 0;
+	}
+	void CacheDirectory::m_evict()
+	{
+		std::vector<std::pair<std::filesystem::file_time_type, uint64_t>> lru;
+		for (const auto& entry : m_entries)
+			lru.push_back(std::make_pair(entry.second.LastUse, entry.first));
+		std::sort(lru.begin(), lru.end());
+
+		// remove a bit more than needed so that we don't evict on every store
+		size_t target = m_maxSize - m_maxSize / 10;
+
+		for (int i = 0; i < lru.size() && m_size > target; i++)
+			Remove(lru[i].second);
+
+		Logger::Get().Log(m_name + " evicted entries, " + std::to_string(m_entries.size()) + " left");
+	}
+}
\ No newline at end of file
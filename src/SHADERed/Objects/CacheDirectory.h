@@ -0,0 +1,41 @@
+#pragma once
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+
+namespace ed {
+	// index of a disk cache's files (<key in hex><extension>) - shared by the shader, program & 3D model caches
+	// least recently used entries are removed once they take up more than the size limit, last write time is the "last used" time
+	// not thread safe - the owning cache guards it with its own mutex
+	class CacheDirectory {
+	public:
+		CacheDirectory();
+
+		bool Open(const std::string& dir, const std::string& ext, size_t maxSize, const std::string& name); // false -> can't create the directory
+		inline bool IsOpen() { return !m_dir.empty(); }
+		inline void SetMaxSize(size_t maxSize) { m_maxSize = maxSize; }
+
+		inline bool Contains(uint64_t key) { return m_entries.count(key) != 0; }
+		std::string GetPath(uint64_t key);
+
+		void Touch(uint64_t key);			 // entry was read
+		void Add(uint64_t key, size_t size); // entry was (re)written, might evict other entries
+		void Remove(uint64_t key);			 // also deletes the file
+		void Clear();						 // deletes every entry & temporary file
+
+		inline int GetEntryCount() { return m_entries.size(); }
+		inline size_t GetSize() { return m_size; }
+
+	private:
+		struct EntryInfo {
+			size_t Size;
+			std::filesystem::file_time_type LastUse;
+		};
+
+		void m_evict();
+
+		std::string m_dir, m_ext, m_name;
+		size_t m_maxSize, m_size;
+		std::unordered_map<uint64_t, EntryInfo> m_entries;
+	};
+}
\ No newline at end of file
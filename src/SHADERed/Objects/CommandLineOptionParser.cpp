@@ -39,12 +39,29 @@ namespace ed {
 		RenderSupersampling = 1;
 		RenderTime = 0.0f;
 		RenderPath = "render.png";
+		RenderFormat = "";
 		RenderFrameIndex = 0;
 		RenderSequenceFPS = 30;
 		RenderSequenceDuration = 0.5f;
+		RenderFrameStart = 0;
+		RenderFrameEnd = -1;
+		RenderShardIndex = 0;
+		RenderShardCount = 1;
+		RenderResume = false;
+		RenderHeadless = false;
+
+		Benchmark = false;
+		BenchmarkPath = "-";
+		BenchmarkBaseline = "";
+		BenchmarkWarmup = 10;
+		BenchmarkFrames = 100;
+		BenchmarkThreshold = 10.0f;
 
 		ConvertCPP = false;
 		CMakePath = "";
+
+		ClearShaderCache = false;
+		PrewarmShaderCache = false;
 	}
 	void CommandLineOptionParser::Parse(const std::filesystem::path& cmdDir, int argc, char* argv[])
 	{
@@ -95,7 +112,7 @@ namespace ed {
 				Render = true;
 
 				if (i + 1 < argc) {
-					RenderPath = (cmdDir / argv[i + 1]).generic_string();
+					RenderPath = strcmp(argv[i + 1], "-") == 0 ? "-" : (cmdDir / argv[i + 1]).generic_string();
 					i++;
 				}
 			}
@@ -168,6 +185,94 @@ namespace ed {
 				}
 				RenderSequenceDuration = std::max<float>(0.0f, dur);
 			}
+			// --frame-start, -fst [index]
+			else if (strcmp(argv[i], "--frame-start") == 0 || strcmp(argv[i], "-fst") == 0) {
+				int frame = 0;
+				if (i + 1 < argc) {
+					frame = atoi(argv[i + 1]);
+					i++;
+				}
+				RenderFrameStart = std::max<int>(0, frame);
+			}
+			// --frame-end, -fe [index]
+			else if (strcmp(argv[i], "--frame-end") == 0 || strcmp(argv[i], "-fe") == 0) {
+				int frame = -1;
+				if (i + 1 < argc) {
+					frame = atoi(argv[i + 1]);
+					i++;
+				}
+				RenderFrameEnd = std::max<int>(-1, frame);
+			}
+			// --shard, -sh [i/N]
+			else if (strcmp(argv[i], "--shard") == 0 || strcmp(argv[i], "-sh") == 0) {
+				int index = 0, count = 0;
+				if (i + 1 < argc) {
+					sscanf(argv[i + 1], "%d/%d", &index, &count);
+					i++;
+				}
+				if (count >= 1 && index >= 1 && index <= count) {
+					RenderShardIndex = index - 1;
+					RenderShardCount = count;
+				} else
+					printf("The argument for --shard is invalid - it should be i/N where 1 <= i <= N\n");
+			}
+			// --resume, -res
+			else if (strcmp(argv[i], "--resume") == 0 || strcmp(argv[i], "-res") == 0) {
+				RenderResume = true;
+			}
+			// --headless, -hl
+			else if (strcmp(argv[i], "--headless") == 0 || strcmp(argv[i], "-hl") == 0) {
+				RenderHeadless = true;
+			}
+			// --benchmark, -bm [report]
+			else if (strcmp(argv[i], "--benchmark") == 0 || strcmp(argv[i], "-bm") == 0) {
+				Benchmark = true;
+				if (i + 1 < argc) {
+					BenchmarkPath = strcmp(argv[i + 1], "-") == 0 ? "-" : (cmdDir / argv[i + 1]).generic_string();
+					i++;
+				}
+			}
+			// --bench-warmup, -bmw [count]
+			else if (strcmp(argv[i], "--bench-warmup") == 0 || strcmp(argv[i], "-bmw") == 0) {
+				int count = 0;
+				if (i + 1 < argc) {
+					count = atoi(argv[i + 1]);
+					i++;
+				}
+				BenchmarkWarmup = std::max<int>(0, count);
+			}
+			// --bench-frames, -bmf [count]
+			else if (strcmp(argv[i], "--bench-frames") == 0 || strcmp(argv[i], "-bmf") == 0) {
+				int count = 0;
+				if (i + 1 < argc) {
+					count = atoi(argv[i + 1]);
+					i++;
+				}
+				BenchmarkFrames = std::max<int>(1, count);
+			}
+			// --bench-baseline, -bmb [report]
+			else if (strcmp(argv[i], "--bench-baseline") == 0 || strcmp(argv[i], "-bmb") == 0) {
+				if (i + 1 < argc) {
+					BenchmarkBaseline = (cmdDir / argv[i + 1]).generic_string();
+					i++;
+				}
+			}
+			// --bench-threshold, -bmt [percent]
+			else if (strcmp(argv[i], "--bench-threshold") == 0 || strcmp(argv[i], "-bmt") == 0) {
+				float percent = 0;
+				if (i + 1 < argc) {
+					percent = atof(argv[i + 1]);
+					i++;
+				}
+				BenchmarkThreshold = std::max<float>(0.0f, percent);
+			}
+			// --format, -fmt [png|jpg|bmp|tga|raw|y4m]
+			else if (strcmp(argv[i], "--format") == 0 || strcmp(argv[i], "-fmt") == 0) {
+				if (i + 1 < argc) {
+					RenderFormat = argv[i + 1];
+					i++;
+				}
+			}
 			// --rendertime, -rt [time]
 			else if (strcmp(argv[i], "--rendertime") == 0 || strcmp(argv[i], "-rt") == 0) {
 				float tm = 0;
@@ -230,6 +335,7 @@ namespace ed {
 				CompileOutput = "";
 				if (i + 1 < argc) {
 					CompileOutput = argv[i + 1];
+					RenderPath = strcmp(argv[i + 1], "-") == 0 ? "-" : (cmdDir / argv[i + 1]).generic_string(); // also the render output
 					i++;
 				}
 			}
@@ -292,6 +398,12 @@ namespace ed {
 					i++;
 				}
 			}
+			// --cacheclear, -ccl
+			else if (strcmp(argv[i], "--cacheclear") == 0 || strcmp(argv[i], "-ccl") == 0)
+				ClearShaderCache = true;
+			// --cacheprewarm, -cpw
+			else if (strcmp(argv[i], "--cacheprewarm") == 0 || strcmp(argv[i], "-cpw") == 0)
+				PrewarmShaderCache = true;
 			// -dap
 			else if (strcmp(argv[i], "-dap") == 0)
 				StartDAPServer = true;
@@ -315,11 +427,23 @@ namespace ed {
 					{ "--rendersequence | -rseq", "render a sequence" },
 					{ "--renderseqfps | -rseqfps <index>", "set sequence FPS" },
 					{ "--renderseqduration | -rseqdur <time>", "set sequence duration" },
+					{ "--frame-start | -fst <index>", "first frame of the sequence to render" },
+					{ "--frame-end | -fe <index>", "last frame of the sequence to render" },
+					{ "--shard | -sh <i/N>", "render only the i-th of N equal parts of the frame range" },
+					{ "--resume | -res", "skip the frames whose image files already exist" },
+					{ "--headless | -hl", "render with no window or display server (EGL/OSMesa)" },
+					{ "--format | -fmt <format>", "render output format: png, jpg, bmp, tga or raw/y4m to stream the sequence into a single file" },
+
+					{ "--benchmark | -bm <report>", "render the project at --renderwidth x --renderheight and save a .json or .csv timing report (- prints JSON)" },
+					{ "--bench-warmup | -bmw <count>", "number of frames rendered before measuring (default: 10)" },
+					{ "--bench-frames | -bmf <count>", "number of measured frames (default: 100), Time advances by 1/--renderseqfps" },
+					{ "--bench-baseline | -bmb <report>", "compare against an earlier .json or .csv report, exit code 2 if any pass got slower, 1 if none of the passes are in the report" },
+					{ "--bench-threshold | -bmt <percent>", "allowed slowdown of the median GPU time (default: 10)" },
 
 					{ "--compile | -c <file>", "compile a shader file" },
 					{ "--language | -cl <language>", "compiler input language" },
 					{ "--stage | -cs <stage>", "compiler input stage; stage can be one of these: vert, geom, tesc, tese, frag, comp" },
-					{ "--output | -o <path>", "compiler output path" },
+					{ "--output | -o <path>", "compiler/render output path, - writes the rendered stream to stdout" },
 					{ "--target | -t <spirv|glsl>", "choose whether to compile to SPIR-V or GLSL" },
 					{ "--entry | -e <funcname>", "shader entry" },
 
@@ -328,6 +452,9 @@ namespace ed {
 
 					{ "--generatecmake | -gcm <path>", "convert SHADERed project to C++/CMake" },
 
+					{ "--cacheclear | -ccl", "delete the compiled shaders cache" },
+					{ "--cacheprewarm | -cpw", "compile the project's shaders into the shader cache and exit" },
+
 					{ "<file>", "open a file" }
 				};
 
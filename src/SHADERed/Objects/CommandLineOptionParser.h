@@ -22,10 +22,20 @@ namespace ed {
 
 		std::string ConvertPath;
 
-		std::string RenderPath;
+		std::string RenderPath, RenderFormat; // RenderPath "-" -> stdout
 		bool Render, RenderSequence;
 		int RenderWidth, RenderHeight, RenderSupersampling, RenderFrameIndex, RenderSequenceFPS;
 		float RenderTime, RenderSequenceDuration;
+		int RenderFrameStart, RenderFrameEnd;	// RenderFrameEnd is inclusive, -1 -> last frame
+		int RenderShardIndex, RenderShardCount; // render only the RenderShardIndex-th part (0-based) of the frame range
+		bool RenderResume;
+		bool RenderHeadless; // no window - EGL/OSMesa context
+
+		// --benchmark: also uses the RenderWidth/RenderHeight/RenderSequenceFPS/RenderTime/RenderFrameIndex options
+		bool Benchmark;
+		std::string BenchmarkPath, BenchmarkBaseline; // report: .json or .csv, "-" -> JSON to stdout; baseline: .csv report
+		int BenchmarkWarmup, BenchmarkFrames;
+		float BenchmarkThreshold; // percent
 
 		bool Fullscreen;
 		bool Maximized;
@@ -38,5 +48,7 @@ namespace ed {
 
 		bool ConvertCPP;
 		std::string CMakePath;
+
+		bool ClearShaderCache, PrewarmShaderCache;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,496 @@
+#include <SHADERed/Engine/ThreadPool.h>
+#include <SHADERed/Objects/Debug/CompiledShader.h>
+#include <SHADERed/Objects/Debug/CompilerCPP.h>
+#include <SHADERed/Objects/ShaderCache.h>
+#include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/Logger.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <filesystem>
+#include <algorithm>
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+#include <dlfcn.h>
+#else
+#include <windows.h>
+#endif
+
+#define COMPILED_SHADER_RUNTIME "data/analysis/spirv_cross_runtime.hpp"
+
+// appended to every library once it was built, checked before dlopen() - ELF & PE loaders ignore trailing bytes
+// layout: uint64 key, uint64 hash of the library, uint32 interface version, uint32 magic
+#define COMPILED_SHADER_MAGIC 0x4c534345 // "ECSL"
+#define COMPILED_SHADER_STAMP_SIZE (2 * sizeof(uint64_t) + 2 * sizeof(uint32_t))
+
+// the library's ABI - keep in sync with data/analysis/spirv_cross_runtime.hpp
+#define SPIRV_CROSS_INTERFACE_VERSION 1
+extern "C" {
+	typedef struct spirv_cross_stats {
+		uint32_t instruction_count;
+		uint32_t line;
+		uint32_t ub_last_type;
+		uint32_t ub_last_line;
+		uint32_t ub_count;
+	} spirv_cross_stats;
+
+	enum spirv_cross_resource_kind {
+		SPIRV_CROSS_RESOURCE_INPUT = 0,
+		SPIRV_CROSS_RESOURCE_OUTPUT = 1,
+		SPIRV_CROSS_RESOURCE_UNIFORM = 2,
+		SPIRV_CROSS_RESOURCE_IMAGE = 3
+	};
+
+	typedef struct spirv_cross_resource {
+		uint32_t id;
+		uint32_t kind;
+		int32_t location;
+		const char* name;
+	} spirv_cross_resource;
+
+	struct spirv_cross_interface {
+		uint32_t version;
+		uint32_t resource_count;
+		const spirv_cross_resource* resources;
+
+		void* (*create)(void);
+		void (*destroy)(void* shader);
+		uint32_t (*write)(void* shader, uint32_t resource, const uint64_t* values, uint32_t count);
+		uint32_t (*read)(void* shader, uint32_t resource, uint64_t* values, uint32_t count);
+		void (*bind_image)(void* shader, uint32_t resource, const float* texels, int32_t width, int32_t height, int32_t depth);
+		int32_t (*invoke)(void* shader, const float* frag_coord, spirv_cross_stats* stats);
+	};
+
+	typedef const spirv_cross_interface* (*spirv_cross_get_interface_fn)(void);
+}
+
+namespace ed {
+	// spirv_cross_runtime::ub_* -> spvm_undefined_behavior_*
+	static spvm_word getUndefinedBehaviorType(uint32_t type)
+	{
+		switch (type) {
+		case 1: return spvm_undefined_behavior_div_by_zero;
+		case 2: return spvm_undefined_behavior_mod_by_zero;
+		case 3: return spvm_undefined_behavior_image_read_out_of_bounds;
+		case 4: return spvm_undefined_behavior_vector_extract_dynamic;
+		case 5: return spvm_undefined_behavior_asin;
+		case 6: return spvm_undefined_behavior_acos;
+		case 7: return spvm_undefined_behavior_acosh;
+		case 8: return spvm_undefined_behavior_atanh;
+		case 9: return spvm_undefined_behavior_atan2;
+		case 10: return spvm_undefined_behavior_pow;
+		case 11: return spvm_undefined_behavior_log;
+		case 12: return spvm_undefined_behavior_log2;
+		case 13: return spvm_undefined_behavior_sqrt;
+		case 14: return spvm_undefined_behavior_inverse_sqrt;
+		case 15: return spvm_undefined_behavior_fmin;
+		case 16: return spvm_undefined_behavior_fmax;
+		case 17: return spvm_undefined_behavior_clamp;
+		case 18: return spvm_undefined_behavior_smoothstep;
+		case 19: return spvm_undefined_behavior_frexp;
+		case 20: return spvm_undefined_behavior_ldexp;
+		default: return 0;
+		}
+		return 0;
+	}
+
+	// one 8 byte slot per scalar, in the same order as the generated code visits them
+	static void flattenMembers(spvm_member_t mems, spvm_word count, std::vector<uint64_t>& out)
+	{
+		for (spvm_word i = 0; i < count; i++) {
+			if (mems[i].member_count == 0) {
+				uint64_t value = 0;
+				memcpy(&value, &mems[i].value, std::min(sizeof(value), sizeof(mems[i].value)));
+				out.push_back(value);
+			} else
+				flattenMembers(mems[i].members, mems[i].member_count, out);
+		}
+	}
+
+	CompiledShader::CompiledShader(void* library, const spirv_cross_interface* iface)
+	{
+		m_library = library;
+		m_iface = iface;
+
+		for (uint32_t i = 0; i < iface->resource_count; i++) {
+			const spirv_cross_resource& res = iface->resources[i];
+			switch (res.kind) {
+			case SPIRV_CROSS_RESOURCE_INPUT: m_inputs.push_back(i); break;
+			case SPIRV_CROSS_RESOURCE_OUTPUT: m_outputs.push_back(std::make_pair(i, res.location)); break;
+			case SPIRV_CROSS_RESOURCE_UNIFORM: m_uniforms.push_back(i); break;
+			case SPIRV_CROSS_RESOURCE_IMAGE: m_images.push_back(i); break;
+			}
+		}
+	}
+	CompiledShader::~CompiledShader()
+	{
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+		dlclose(m_library);
+#else
+		FreeLibrary((HINSTANCE)m_library);
+#endif
+	}
+	void* CompiledShader::CreateInstance(spvm_state_t vm)
+	{
+		void* instance = m_iface->create();
+
+		std::vector<uint64_t> values;
+		for (uint32_t res : m_uniforms) {
+			spvm_result_t slot = &vm->results[m_iface->resources[res].id];
+
+			values.clear();
+			flattenMembers(slot->members, slot->member_count, values);
+			m_iface->write(instance, res, values.data(), values.size());
+		}
+
+		// textures were already read back from the GPU by DebugInformation::PreparePixelShader()
+		for (uint32_t res : m_images) {
+			spvm_result_t slot = &vm->results[m_iface->resources[res].id];
+			if (slot->member_count == 0 || slot->members[0].image_data == nullptr)
+				continue;
+
+			spvm_image_t img = slot->members[0].image_data;
+			m_iface->bind_image(instance, res, img->data, img->width, img->height, img->depth);
+		}
+
+		return instance;
+	}
+	void CompiledShader::DestroyInstance(void* instance)
+	{
+		m_iface->destroy(instance);
+	}
+	bool CompiledShader::Execute(void* instance, spvm_state_t vm, int x, int y, int loc, glm::vec4& color, Stats& stats)
+	{
+		static thread_local std::vector<uint64_t> values;
+
+		for (uint32_t res : m_inputs) {
+			spvm_result_t slot = &vm->results[m_iface->resources[res].id];
+
+			values.clear();
+			flattenMembers(slot->members, slot->member_count, values);
+			m_iface->write(instance, res, values.data(), values.size());
+		}
+
+		float fragCoord[4] = { x + 0.5f, y + 0.5f, 1.0f, 1.0f }; // same as the VM
+		spirv_cross_stats rawStats;
+		memset(&rawStats, 0, sizeof(rawStats));
+		bool executed = m_iface->invoke(instance, fragCoord, &rawStats) != 0;
+
+		stats.InstructionCount = rawStats.instruction_count;
+		stats.UBLastType = getUndefinedBehaviorType(rawStats.ub_last_type);
+		stats.UBLastLine = rawStats.ub_last_line;
+		stats.UBCount = std::min<spvm_word>(rawStats.ub_count, 11);
+
+		// first output with a matching location, like DebugInformation::GetPixelShaderOutput()
+		color = glm::vec4(0.0f);
+		for (const auto& output : m_outputs) {
+			if (output.second != loc && output.second != -1)
+				continue;
+
+			uint64_t components[4] = { 0, 0, 0, 0 };
+			uint32_t count = std::min<uint32_t>(m_iface->read(instance, output.first, components, 4), 4);
+			for (uint32_t i = 0; i < count; i++)
+				memcpy(&color[i], &components[i], sizeof(float));
+
+			break;
+		}
+		color = glm::clamp(color, 0.0f, 1.0f);
+
+		return executed;
+	}
+
+	CompiledShaderCache::CompiledShaderCache()
+	{
+		m_compilerSearched = false;
+		m_runtimeHash = 0;
+	}
+	CompiledShaderCache::~CompiledShaderCache()
+	{
+		// jobs use this object
+		for (auto& build : m_builds) {
+			if (build.second->Task.valid())
+				build.second->Task.wait();
+			delete build.second;
+		}
+
+		for (auto& shader : m_shaders)
+			delete shader.second;
+	}
+	void CompiledShaderCache::SetMaxSize(size_t maxSize)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_files.SetMaxSize(maxSize);
+	}
+	bool CompiledShaderCache::IsCompilerAvailable()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (m_compilerSearched)
+			return !m_compiler.empty();
+		m_compilerSearched = true;
+
+		// the runtime is part of every compiled shader
+		std::ifstream runtimeFile(COMPILED_SHADER_RUNTIME, std::ios::binary);
+		if (!runtimeFile.is_open())
+			return false;
+		std::stringstream runtime;
+		runtime << runtimeFile.rdbuf();
+
+		// $CXX first, then the usual compilers on $PATH
+		const char* cxx = getenv("CXX");
+		if (cxx != nullptr && cxx[0] != 0)
+			m_compiler = cxx;
+		else {
+#if defined(_WIN32)
+			const char pathSeparator = ';';
+			const char* names[] = { "clang++.exe", "g++.exe", "c++.exe" };
+#else
+			const char pathSeparator = ':';
+			const char* names[] = { "c++", "g++", "clang++" };
+#endif
+			const char* pathEnv = getenv("PATH");
+			std::stringstream paths(pathEnv == nullptr ? "" : pathEnv);
+			std::string dir;
+			std::error_code fsError;
+			while (m_compiler.empty() && std::getline(paths, dir, pathSeparator)) {
+				if (dir.empty())
+					continue;
+
+				for (const char* name : names) {
+					std::filesystem::path candidate = std::filesystem::path(dir) / name;
+					if (std::filesystem::is_regular_file(candidate, fsError)) {
+						m_compiler = candidate.string();
+						break;
+					}
+				}
+			}
+		}
+
+		if (m_compiler.empty())
+			return false;
+
+		// a different runtime or compiler invalidates the cached libraries
+		m_runtimeHash = ShaderCache::Hash(m_compiler, ShaderCache::Hash(runtime.str()));
+
+		// same size limit as the shader cache
+		std::string dir = Settings::Instance().ConvertPath("cache/analysis/");
+		size_t maxSize = (size_t)Settings::Instance().General.ShaderCacheSize * 1024 * 1024;
+#if defined(_WIN32)
+		bool opened = m_files.Open(dir, ".dll", maxSize, "Compiled shader cache");
+#else
+		bool opened = m_files.Open(dir, ".so", maxSize, "Compiled shader cache");
+#endif
+		if (!opened) {
+			Logger::Get().Log("Failed to create the compiled shader cache directory " + dir, true);
+			m_compiler = "";
+		}
+
+		return !m_compiler.empty();
+	}
+	CompiledShader* CompiledShaderCache::Get(const std::vector<unsigned int>& spv)
+	{
+		if (spv.empty() || !IsCompilerAvailable())
+			return nullptr;
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		uint64_t key = ShaderCache::Hash(spv.data(), spv.size() * sizeof(unsigned int), m_runtimeHash);
+		auto it = m_shaders.find(key);
+		if (it != m_shaders.end())
+			return it->second;
+
+		std::string libPath = m_files.GetPath(key);
+
+		// VM until the library is built
+		auto buildIt = m_builds.find(key);
+		if (buildIt != m_builds.end()) {
+			Build* build = buildIt->second;
+			if (build->Task.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+				return nullptr;
+
+			bool built = build->Succeeded;
+			delete build;
+			m_builds.erase(buildIt);
+
+			CompiledShader* shader = nullptr;
+			if (built) {
+				std::error_code fsError;
+				size_t size = std::filesystem::file_size(libPath, fsError);
+				m_files.Add(key, fsError ? 0 : size);
+
+				shader = m_load(key, libPath);
+				if (shader == nullptr)
+					m_files.Remove(key);
+			}
+
+			m_shaders[key] = shader;
+			return shader;
+		}
+
+		if (m_files.Contains(key)) {
+			CompiledShader* shader = m_load(key, libPath);
+			if (shader != nullptr) {
+				m_files.Touch(key);
+				m_shaders[key] = shader;
+				return shader;
+			}
+
+			// stale or corrupted -> build it again
+			m_files.Remove(key);
+		}
+
+		Build* build = new Build();
+		build->Succeeded = false;
+		build->Task = eng::ThreadPool::Instance().Enqueue([this, build, spv, key, libPath]() {
+			build->Succeeded = m_build(spv, key, libPath);
+		});
+		m_builds[key] = build;
+
+		return nullptr;
+	}
+	bool CompiledShaderCache::m_build(const std::vector<unsigned int>& spv, uint64_t key, const std::string& libPath)
+	{
+		std::string source;
+		try {
+			CompilerCPP cpp(spv.data(), spv.size());
+			source = cpp.compile();
+		} catch (spirv_cross::CompilerError& e) {
+			Logger::Get().Log("Failed to translate the pixel shader to C++, using the VM: " + std::string(e.what()), true);
+			return false;
+		}
+
+		std::string basePath = libPath.substr(0, libPath.size() - std::filesystem::path(libPath).extension().string().size());
+		std::string srcPath = basePath + ".cpp";
+		std::string tmpPath = libPath + ".tmp";
+		std::string logPath = basePath + ".log";
+
+		std::ofstream srcFile(srcPath, std::ios::binary | std::ios::trunc);
+		if (!srcFile.is_open()) {
+			Logger::Get().Log("Failed to write " + srcPath, true);
+			return false;
+		}
+		srcFile << source;
+		srcFile.close();
+
+		std::error_code fsError;
+		std::string includeDir = std::filesystem::absolute(std::filesystem::path(COMPILED_SHADER_RUNTIME).parent_path(), fsError).string();
+
+		Logger::Get().Log("Building the compiled pixel shader " + libPath);
+
+		std::string cmd = "\"" + m_compiler + "\" -std=c++17 -O2 -shared";
+#if !defined(_WIN32)
+		cmd += " -fPIC";
+#endif
+		cmd += " -I\"" + includeDir + "\" -o \"" + tmpPath + "\" \"" + srcPath + "\" > \"" + logPath + "\" 2>&1";
+#if defined(_WIN32)
+		cmd = "\"" + cmd + "\""; // cmd.exe strips the outer quotes
+#endif
+
+		bool built = system(cmd.c_str()) == 0;
+
+		if (!built) {
+			std::ifstream logFile(logPath);
+			std::stringstream log;
+			log << logFile.rdbuf();
+			logFile.close();
+
+			Logger::Get().Log("Failed to build the compiled pixel shader, using the VM:\n" + log.str().substr(0, 4096), true);
+		}
+		std::filesystem::remove(srcPath, fsError);
+		std::filesystem::remove(logPath, fsError);
+
+		// stamp the library
+		if (built) {
+			std::ifstream libFile(tmpPath, std::ios::binary);
+			std::stringstream lib;
+			lib << libFile.rdbuf();
+			libFile.close();
+
+			uint64_t hash = ShaderCache::Hash(lib.str());
+			uint32_t version = SPIRV_CROSS_INTERFACE_VERSION;
+			uint32_t magic = COMPILED_SHADER_MAGIC;
+
+			std::ofstream stampFile(tmpPath, std::ios::binary | std::ios::app);
+			stampFile.write((char*)&key, sizeof(key));
+			stampFile.write((char*)&hash, sizeof(hash));
+			stampFile.write((char*)&version, sizeof(version));
+			stampFile.write((char*)&magic, sizeof(magic));
+			built = !lib.str().empty() && (bool)stampFile;
+			stampFile.close();
+		}
+
+		// rename so that a half written library is never loaded
+		if (built) {
+			std::filesystem::rename(tmpPath, libPath, fsError);
+			if (fsError) {
+				Logger::Get().Log("Failed to move the compiled pixel shader to " + libPath, true);
+				built = false;
+			}
+		}
+		if (!built)
+			std::filesystem::remove(tmpPath, fsError);
+
+		return built;
+	}
+	CompiledShader* CompiledShaderCache::m_load(uint64_t key, const std::string& libPath)
+	{
+		// check the stamp before dlopen() runs any of the library's code
+		std::ifstream libFile(libPath, std::ios::binary);
+		std::stringstream libData;
+		libData << libFile.rdbuf();
+		libFile.close();
+
+		std::string data = libData.str();
+		bool stamped = false;
+		if (data.size() > COMPILED_SHADER_STAMP_SIZE) {
+			size_t libSize = data.size() - COMPILED_SHADER_STAMP_SIZE;
+			const char* stamp = data.data() + libSize;
+
+			uint64_t fileKey = 0, hash = 0;
+			uint32_t version = 0, magic = 0;
+			memcpy(&fileKey, stamp, sizeof(fileKey));
+			memcpy(&hash, stamp + 8, sizeof(hash));
+			memcpy(&version, stamp + 16, sizeof(version));
+			memcpy(&magic, stamp + 20, sizeof(magic));
+
+			stamped = magic == COMPILED_SHADER_MAGIC && version == SPIRV_CROSS_INTERFACE_VERSION && fileKey == key && hash == ShaderCache::Hash(data.data(), libSize);
+		}
+		if (!stamped) {
+			Logger::Get().Log("\"" + libPath + "\" has a missing or mismatched stamp.", true);
+			return nullptr;
+		}
+
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+		void* lib = dlopen(libPath.c_str(), RTLD_NOW | RTLD_LOCAL);
+		if (lib == nullptr) {
+			Logger::Get().Log("dlopen(\"" + libPath + "\") has failed.", true);
+			return nullptr;
+		}
+
+		spirv_cross_get_interface_fn fnGetInterface = (spirv_cross_get_interface_fn)dlsym(lib, "spirv_cross_get_interface");
+#else
+		HINSTANCE lib = LoadLibraryA(libPath.c_str());
+		if (lib == nullptr) {
+			Logger::Get().Log("LoadLibraryA(\"" + libPath + "\") has failed.", true);
+			return nullptr;
+		}
+
+		spirv_cross_get_interface_fn fnGetInterface = (spirv_cross_get_interface_fn)GetProcAddress(lib, "spirv_cross_get_interface");
+#endif
+
+		const spirv_cross_interface* iface = fnGetInterface ? fnGetInterface() : nullptr;
+		if (iface == nullptr || iface->version != SPIRV_CROSS_INTERFACE_VERSION) {
+			Logger::Get().Log("\"" + libPath + "\" isn't a compatible compiled pixel shader.", true);
+#if defined(__linux__) || defined(__unix__) || defined(__APPLE__)
+			dlclose(lib);
+#else
+			FreeLibrary(lib);
+#endif
+			return nullptr;
+		}
+
+		return new CompiledShader((void*)lib, iface);
+	}
+}
\ No newline at end of file
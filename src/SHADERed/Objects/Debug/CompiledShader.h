@@ -0,0 +1,80 @@
+#pragma once
+#include <SHADERed/Objects/CacheDirectory.h>
+#include <glm/glm.hpp>
+
+#include <future>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+extern "C" {
+	#include <spvm/state.h>
+}
+
+struct spirv_cross_interface;
+
+namespace ed {
+	// pixel shader that was translated to C++ (CompilerCPP) and built into a shared library with the
+	// system's compiler - FrameAnalysis runs it instead of the VM when there is nothing to step through
+	class CompiledShader {
+	public:
+		struct Stats {
+			spvm_word InstructionCount;
+			spvm_word UBLastType, UBLastLine, UBCount; // same values as the VM's undefined behavior callback reports
+		};
+
+		CompiledShader(void* library, const spirv_cross_interface* iface);
+		~CompiledShader();
+
+		// instances aren't thread safe - each rasterizer thread creates its own one
+		void* CreateInstance(spvm_state_t vm); // uniforms & textures are copied from the prepared VM
+		void DestroyInstance(void* instance);
+
+		// inputs are taken from the VM once DebugInformation::SetPixelShaderInput() interpolated them, false -> discarded
+		bool Execute(void* instance, spvm_state_t vm, int x, int y, int loc, glm::vec4& color, Stats& stats);
+
+	private:
+		void* m_library;
+		const spirv_cross_interface* m_iface;
+
+		std::vector<uint32_t> m_inputs, m_uniforms, m_images;
+		std::vector<std::pair<uint32_t, int>> m_outputs; // resource, location
+	};
+
+	// builds & loads the compiled shaders - libraries are cached on disk by the hash of the SPIR-V
+	// and built on the ThreadPool, so the first analyses of a new shader still run on the VM
+	class CompiledShaderCache {
+	public:
+		CompiledShaderCache();
+		~CompiledShaderCache();
+
+		bool IsCompilerAvailable();
+		CompiledShader* Get(const std::vector<unsigned int>& spv); // nullptr -> use the VM (failed or still building)
+
+		void SetMaxSize(size_t maxSize);
+
+		static inline CompiledShaderCache& Instance()
+		{
+			static CompiledShaderCache ret;
+			return ret;
+		}
+
+	private:
+		struct Build {
+			std::future<void> Task;
+			bool Succeeded; // written by the job, read once Task is ready
+		};
+
+		bool m_build(const std::vector<unsigned int>& spv, uint64_t key, const std::string& libPath); // runs on the ThreadPool
+		CompiledShader* m_load(uint64_t key, const std::string& libPath);
+
+		std::mutex m_mutex;
+		bool m_compilerSearched;
+		std::string m_compiler;
+		uint64_t m_runtimeHash;
+		CacheDirectory m_files;
+		std::unordered_map<uint64_t, Build*> m_builds;
+		std::unordered_map<uint64_t, CompiledShader*> m_shaders; // nullptr -> failed to build, don't try again
+	};
+}
\ No newline at end of file
@@ -0,0 +1,457 @@
+#include <SHADERed/Objects/Debug/CompilerCPP.h>
+
+#define COMPILER_CPP_RUNTIME "spirv_cross_runtime.hpp" // found through the include path that CompiledShaderCache passes to the compiler
+
+using namespace spv;
+using namespace spirv_cross;
+
+namespace ed {
+	CompilerCPP::CompilerCPP(const uint32_t* spv, size_t wordCount)
+			: CompilerGLSL(spv, wordCount)
+	{
+	}
+	std::string CompilerCPP::compile()
+	{
+		ir.fixup_reserved_names();
+
+		if (get_execution_model() != ExecutionModelFragment)
+			SPIRV_CROSS_THROW("Only fragment shaders can be translated to C++.");
+
+		// no ES-isms like precision, older extensions and such
+		options.es = false;
+		options.version = 450;
+		options.vulkan_semantics = true;
+		backend.float_literal_suffix = true;
+		backend.double_literal_suffix = false;
+		backend.long_long_literal_suffix = true;
+		backend.uint32_t_literal_suffix = true;
+		backend.basic_int_type = "int32_t";
+		backend.basic_uint_type = "uint32_t";
+		backend.discard_literal = "discard_invocation()";
+		backend.demote_literal = "discard_invocation()";
+		backend.swizzle_is_function = true;
+		backend.shared_is_implied = true;
+		backend.unsized_array_supported = false;
+		backend.explicit_struct_type = false;
+		backend.use_initializer_list = true;
+		backend.use_typed_initializer_list = true;
+		backend.supports_extensions = false;
+		backend.nonuniform_qualifier = "";
+
+		fixup_type_alias();
+		reorder_type_alias();
+		build_function_control_flow_graphs_and_analyze();
+		update_active_builtins();
+		analyze_image_and_sampler_usage();
+
+		// the instruction counters are statements and loop headers with statements in them can't become
+		// for (;;) headers - decide that up front instead of recompiling for each loop
+		ir.for_each_typed_id<SPIRBlock>([&](uint32_t, SPIRBlock& block) {
+			if (block.merge == SPIRBlock::MergeLoop)
+				block.disable_block_optimization = true;
+		});
+
+		uint32_t passCount = 0;
+		do {
+			if (passCount >= 3)
+				SPIRV_CROSS_THROW("Over 3 compilation loops detected. Must be a bug!");
+
+			reset();
+			buffer.reset();
+
+			emit_header();
+			m_emitResources();
+
+			emit_function(get<SPIRFunction>(ir.default_entry_point), Bitset());
+			m_emitResourceTable();
+
+			end_scope_decl();
+			end_scope();
+			statement("");
+			statement("SPIRV_CROSS_DEFINE_INTERFACE(spirv_cross_runtime::Shader)");
+
+			passCount++;
+		} while (is_forcing_recompilation());
+
+		get_entry_point().name = "main";
+
+		return buffer.str();
+	}
+	void CompilerCPP::emit_header()
+	{
+		statement("// Generated by SHADERed, built against the runtime in ", COMPILER_CPP_RUNTIME, ".");
+		statement("#include \"", COMPILER_CPP_RUNTIME, "\"");
+		statement("");
+		statement("namespace spirv_cross_runtime");
+		begin_scope();
+		statement("struct Shader : shader_base");
+		begin_scope();
+	}
+	void CompilerCPP::emit_function_prototype(SPIRFunction& func, const Bitset&)
+	{
+		if (func.self != ir.default_entry_point)
+			add_function_overload(func);
+
+		// avoid shadow declarations
+		local_variable_names = resource_names;
+
+		std::string decl = type_to_glsl(get<SPIRType>(func.return_type)) + " ";
+		if (func.self == ir.default_entry_point) {
+			decl += "main";
+			processing_entry_point = true;
+		} else
+			decl += to_name(func.self);
+
+		SmallVector<std::string> argList;
+		for (auto& arg : func.arguments) {
+			if (skip_argument(arg.id))
+				continue;
+
+			add_local_variable_name(arg.id);
+			argList.push_back(m_argumentDecl(arg));
+
+			// hold a pointer to the parameter so that the readonly field can be invalidated if needed
+			SPIRVariable* var = maybe_get<SPIRVariable>(arg.id);
+			if (var)
+				var->parameter = &arg;
+		}
+		for (auto& arg : func.shadow_arguments) {
+			add_local_variable_name(arg.id);
+			argList.push_back(m_argumentDecl(arg));
+
+			SPIRVariable* var = maybe_get<SPIRVariable>(arg.id);
+			if (var)
+				var->parameter = &arg;
+		}
+
+		statement(decl, "(", merge(argList), ")");
+	}
+	void CompilerCPP::emit_instruction(const Instruction& instr)
+	{
+		// every instruction of the block and its terminator are counted when the block is entered
+		if (current_emitting_block && !current_emitting_block->ops.empty() && &instr == &current_emitting_block->ops.front())
+			statement("SPIRV_CROSS_COUNT(", uint32_t(current_emitting_block->ops.size()) + 1, ");");
+
+		const uint32_t* ops = stream(instr);
+		Op opcode = static_cast<Op>(instr.op);
+
+		uint32_t intWidth = get_integer_width_for_instruction(instr);
+		SPIRType::BaseType intType = to_signed_basetype(intWidth);
+		SPIRType::BaseType uintType = to_unsigned_basetype(intWidth);
+
+		// divisions go through the runtime so that division by zero is reported instead of trapping
+		switch (opcode) {
+		case OpLine:
+			statement("SPIRV_CROSS_LINE(", ops[1], ");");
+			break;
+		case OpSDiv:
+			emit_binary_func_op_cast(ops[0], ops[1], ops[2], ops[3], "checked_div", intType, opcode_is_sign_invariant(opcode));
+			break;
+		case OpUDiv:
+			emit_binary_func_op_cast(ops[0], ops[1], ops[2], ops[3], "checked_div", uintType, opcode_is_sign_invariant(opcode));
+			break;
+		case OpSRem:
+			emit_binary_func_op_cast(ops[0], ops[1], ops[2], ops[3], "checked_rem", intType, opcode_is_sign_invariant(opcode));
+			break;
+		case OpSMod:
+			emit_binary_func_op_cast(ops[0], ops[1], ops[2], ops[3], "checked_smod", intType, opcode_is_sign_invariant(opcode));
+			break;
+		case OpUMod:
+			emit_binary_func_op_cast(ops[0], ops[1], ops[2], ops[3], "checked_rem", uintType, opcode_is_sign_invariant(opcode));
+			break;
+		case OpFDiv:
+			emit_binary_func_op(ops[0], ops[1], ops[2], ops[3], "checked_div");
+			break;
+		default:
+			CompilerGLSL::emit_instruction(instr);
+			break;
+		}
+	}
+	void CompilerCPP::emit_uniform(const SPIRVariable& var)
+	{
+		SPIRType& type = get<SPIRType>(var.basetype);
+
+		add_resource_name(var.self);
+		statement(variable_decl(var), ";");
+
+		// samplers carry no data
+		if (type.basetype == SPIRType::Image || type.basetype == SPIRType::SampledImage)
+			m_emitResource(var, ResourceKind::Image);
+		else if (type.basetype != SPIRType::Sampler)
+			m_emitResource(var, ResourceKind::Uniform);
+	}
+	void CompilerCPP::emit_buffer_block(const SPIRVariable& var)
+	{
+		// blocks are plain structs - the layout of the members doesn't matter since the values are streamed one by one
+		SPIRType& type = get<SPIRType>(get<SPIRType>(var.basetype).self);
+		if (m_emittedBlockTypes.insert(type.self).second)
+			m_emitStruct(type);
+
+		add_resource_name(var.self);
+		statement(variable_decl(var), ";");
+		statement("");
+
+		m_emitResource(var, ResourceKind::Uniform);
+	}
+	void CompilerCPP::emit_push_constant_block(const SPIRVariable& var)
+	{
+		emit_buffer_block(var);
+	}
+	std::string CompilerCPP::type_to_glsl(const SPIRType& type, uint32_t id)
+	{
+		// the runtime only samples 2D, 3D and cube textures
+		if (type.basetype == SPIRType::Image || type.basetype == SPIRType::SampledImage) {
+			const SPIRType::ImageType& image = type.image;
+			if (image.sampled == 2 || image.depth || image.arrayed || image.ms || (image.dim != Dim2D && image.dim != Dim3D && image.dim != DimCube))
+				SPIRV_CROSS_THROW("Only sampled 2D, 3D and cube textures without depth comparison are supported in C++.");
+		}
+
+		// arrays are value types in GLSL - the runtime's array<T, N> keeps them that way
+		std::string ret = CompilerGLSL::type_to_glsl(type, id);
+		for (uint32_t i = 0; i < uint32_t(type.array.size()); i++) {
+			if (type.array_size_literal[i] && type.array[i] == 0)
+				SPIRV_CROSS_THROW("Unsized arrays are not supported in C++.");
+			ret = join("array<", ret, ", ", to_array_size(type, i), ">");
+		}
+		return ret;
+	}
+	std::string CompilerCPP::type_to_array_glsl(const SPIRType&)
+	{
+		return "";
+	}
+	std::string CompilerCPP::layout_for_member(const SPIRType&, uint32_t)
+	{
+		return "";
+	}
+	std::string CompilerCPP::to_qualifiers_glsl(uint32_t)
+	{
+		return "";
+	}
+	void CompilerCPP::replace_illegal_names()
+	{
+		static const std::unordered_set<std::string> keywords = {
+			// C++ keywords that aren't reserved in GLSL
+			"alignas", "alignof", "and", "and_eq", "asm", "auto", "bitand", "bitor", "catch", "char", "char16_t",
+			"char32_t", "class", "compl", "concept", "const_cast", "constexpr", "decltype", "delete", "dynamic_cast",
+			"enum", "explicit", "export", "extern", "friend", "goto", "inline", "long", "mutable", "namespace", "new",
+			"noexcept", "not", "not_eq", "nullptr", "operator", "or", "or_eq", "private", "protected", "public",
+			"register", "reinterpret_cast", "requires", "short", "signed", "sizeof", "static", "static_assert",
+			"static_cast", "template", "this", "thread_local", "throw", "try", "typedef", "typeid", "typename", "union",
+			"unsigned", "using", "virtual", "volatile", "wchar_t", "xor", "xor_eq",
+
+			// names used by the runtime
+			"int8_t", "uint8_t", "int16_t", "uint16_t", "int32_t", "uint32_t", "int64_t", "uint64_t", "size_t", "std",
+			"spirv_cross_runtime", "spirv_cross_stats", "spirv_cross_resource", "spirv_cross_interface", "Shader",
+			"shader_base", "shader_interface", "vec", "mat", "array", "map", "report", "ub_type", "image_data",
+			"sampler", "texture2D", "texture3D", "textureCube", "bit_cast", "checked_div", "checked_rem",
+			"checked_smod", "discard_invocation", "discard_exception", "for_each_leaf", "is_image", "component_count"
+		};
+
+		CompilerGLSL::replace_illegal_names(keywords);
+		CompilerGLSL::replace_illegal_names();
+	}
+	void CompilerCPP::m_emitResources()
+	{
+		replace_illegal_names();
+		m_resources.clear();
+		m_emittedBlockTypes.clear();
+
+		bool emitted = false;
+
+		// specialization constants, constant lookup tables & structs
+		{
+			auto loopLock = ir.create_loop_hard_lock();
+			for (auto& typeID : ir.ids_for_constant_or_type) {
+				Variant& id = ir.ids[typeID];
+
+				if (id.get_type() == TypeConstant) {
+					SPIRConstant& c = id.get<SPIRConstant>();
+					if (c.specialization || c.is_used_as_lut) {
+						// specialization constants become macros like in GL GLSL
+						if (c.specialization)
+							c.specialization_constant_macro_name = constant_value_macro_name(get_decoration(c.self, DecorationSpecId));
+
+						options.vulkan_semantics = false;
+						emit_constant(c);
+						options.vulkan_semantics = true;
+						emitted = true;
+					}
+				} else if (id.get_type() == TypeConstantOp) {
+					emit_specialization_constant_op(id.get<SPIRConstantOp>());
+					emitted = true;
+				} else if (id.get_type() == TypeType) {
+					SPIRType& type = id.get<SPIRType>();
+					bool isNaturalStruct = type.basetype == SPIRType::Struct && type.array.empty() && !type.pointer && !has_decoration(type.self, DecorationBlock) && !has_decoration(type.self, DecorationBufferBlock);
+
+					if (isNaturalStruct) {
+						if (emitted)
+							statement("");
+						emitted = false;
+
+						m_emitStruct(type);
+					}
+				}
+			}
+		}
+
+		if (emitted)
+			statement("");
+
+		// UBOs, SSBOs and push constants
+		ir.for_each_typed_id<SPIRVariable>([&](uint32_t, SPIRVariable& var) {
+			SPIRType& type = this->get<SPIRType>(var.basetype);
+
+			bool isBlockStorage = type.storage == StorageClassStorageBuffer || type.storage == StorageClassUniform || type.storage == StorageClassPushConstant;
+			bool hasBlockFlags = has_decoration(type.self, DecorationBlock) || has_decoration(type.self, DecorationBufferBlock);
+
+			if (var.storage != StorageClassFunction && type.pointer && isBlockStorage && !is_hidden_variable(var) && hasBlockFlags) {
+				if (type.storage == StorageClassPushConstant)
+					emit_push_constant_block(var);
+				else
+					emit_buffer_block(var);
+			}
+		});
+
+		// uniform constants - plain values, images and samplers
+		emitted = false;
+		ir.for_each_typed_id<SPIRVariable>([&](uint32_t, SPIRVariable& var) {
+			SPIRType& type = this->get<SPIRType>(var.basetype);
+
+			if (var.storage != StorageClassFunction && type.pointer && type.storage == StorageClassUniformConstant && !is_hidden_variable(var)) {
+				emit_uniform(var);
+				emitted = true;
+			}
+		});
+
+		if (emitted)
+			statement("");
+		emitted = false;
+
+		// inputs and outputs - built-ins are members of shader_base
+		ir.for_each_typed_id<SPIRVariable>([&](uint32_t, SPIRVariable& var) {
+			SPIRType& type = this->get<SPIRType>(var.basetype);
+
+			bool isInterface = var.storage == StorageClassInput || var.storage == StorageClassOutput;
+			if (var.storage != StorageClassFunction && type.pointer && isInterface && interface_variable_exists_in_entry_point(var.self) && !is_hidden_variable(var)) {
+				add_resource_name(var.self);
+				statement(variable_decl(var), ";");
+				m_emitResource(var, var.storage == StorageClassInput ? ResourceKind::Input : ResourceKind::Output);
+				emitted = true;
+			}
+		});
+
+		// private globals
+		for (auto global : global_variables) {
+			SPIRVariable& var = get<SPIRVariable>(global);
+			if (is_hidden_variable(var, true) || var.storage == StorageClassOutput || variable_is_lut(var))
+				continue;
+
+			add_resource_name(var.self);
+			statement(variable_decl(var), ";");
+			emitted = true;
+		}
+
+		if (emitted)
+			statement("");
+
+		declare_undefined_values();
+	}
+	void CompilerCPP::m_emitStruct(SPIRType& type)
+	{
+		// same as CompilerGLSL::emit_struct(), but the struct also gets a visitor for the runtime
+		if (type.type_alias != TypeID(0) && !has_extended_decoration(type.type_alias, SPIRVCrossDecorationBufferBlockRepacked))
+			return;
+
+		add_resource_name(type.self);
+		std::string name = type_to_glsl(type);
+
+		statement("struct ", name);
+		begin_scope();
+
+		type.member_name_cache.clear();
+
+		uint32_t i = 0;
+		for (auto& member : type.member_types) {
+			add_member_name(type, i);
+			emit_struct_member(type, member, i);
+			i++;
+		}
+
+		if (type_is_empty(type))
+			statement("int32_t empty_struct_member;");
+
+		// streams the members to the host - see for_each_leaf() in the runtime
+		statement("");
+		statement("template <typename F>");
+		statement("void spvc_visit(F &f)");
+		begin_scope();
+		for (i = 0; i < uint32_t(type.member_types.size()); i++)
+			statement("f(", to_member_name(type, i), ");");
+		end_scope();
+
+		end_scope_decl();
+		statement("");
+	}
+	void CompilerCPP::m_emitResource(const SPIRVariable& var, ResourceKind kind)
+	{
+		int32_t location = -1;
+		if (has_decoration(var.self, DecorationLocation))
+			location = int32_t(get_decoration(var.self, DecorationLocation));
+
+		m_resources.push_back({ var.self, kind, location });
+	}
+	void CompilerCPP::m_emitResourceTable()
+	{
+		statement("");
+		statement("static constexpr uint32_t spvc_resource_count = ", m_resources.size(), ";");
+		statement("static const spirv_cross_resource *spvc_resources()");
+		begin_scope();
+		statement("static const spirv_cross_resource resources[] = {");
+		indent++;
+		if (m_resources.empty())
+			statement("{ 0u, 0u, -1, nullptr },");
+		for (const Resource& res : m_resources)
+			statement("{ ", res.ID, "u, ", uint32_t(res.Kind), "u, ", res.Location, ", \"", to_name(res.ID), "\" },");
+		indent--;
+		statement("};");
+		statement("return resources;");
+		end_scope();
+		statement("");
+
+		statement("template <typename F>");
+		statement("void spvc_visit_resource(uint32_t index, F &f)");
+		begin_scope();
+		statement("switch (index)");
+		begin_scope();
+		for (uint32_t i = 0; i < uint32_t(m_resources.size()); i++)
+			statement("case ", i, ": f(", to_name(m_resources[i].ID), "); break;");
+		statement("default: break;");
+		end_scope();
+		end_scope();
+		statement("");
+
+		// every invocation starts with the initial values of the globals it owns, like a fresh VM
+		statement("void spvc_reset()");
+		begin_scope();
+		for (auto global : global_variables) {
+			SPIRVariable& var = get<SPIRVariable>(global);
+			if (is_hidden_variable(var) || variable_is_lut(var) || var.storage == StorageClassWorkgroup)
+				continue;
+			if (var.storage == StorageClassOutput && !interface_variable_exists_in_entry_point(var.self))
+				continue;
+
+			std::string name = to_name(var.self);
+			if (var.initializer && ir.ids[var.initializer].get_type() != TypeUndef)
+				statement(name, " = ", to_initializer_expression(var), ";");
+			else
+				statement(name, " = decltype(", name, ")();");
+		}
+		end_scope();
+	}
+	std::string CompilerCPP::m_argumentDecl(const SPIRFunction::Parameter& arg)
+	{
+		// pointers are references, everything else is an SSA value which is never written to
+		const SPIRType& type = expression_type(arg.id);
+		return join(type.pointer ? "" : "const ", type_to_glsl(type, arg.id), " &", to_name(arg.id));
+	}
+}
\ No newline at end of file
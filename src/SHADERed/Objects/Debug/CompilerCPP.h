@@ -0,0 +1,52 @@
+#pragma once
+#include <SPIRVCross/spirv_glsl.hpp>
+
+#include <unordered_set>
+
+namespace ed {
+	// SPIRV-Cross backend that translates a fragment shader to C++ for CompiledShader - the shader becomes a struct which
+	// is built against data/analysis/spirv_cross_runtime.hpp and exposes its resources through the runtime's C interface.
+	// everything that isn't overridden here is emitted by the GLSL backend, the runtime makes that valid C++
+	class CompilerCPP : public spirv_cross::CompilerGLSL {
+	public:
+		CompilerCPP(const uint32_t* spv, size_t wordCount);
+
+		std::string compile() override;
+
+	private:
+		// same values as spirv_cross_resource_kind in the runtime
+		enum class ResourceKind {
+			Input = 0,
+			Output = 1,
+			Uniform = 2,
+			Image = 3
+		};
+		struct Resource {
+			uint32_t ID;
+			ResourceKind Kind;
+			int32_t Location;
+		};
+
+		// CompilerGLSL overrides - the names have to match
+		void emit_header() override;
+		void emit_function_prototype(spirv_cross::SPIRFunction& func, const spirv_cross::Bitset& returnFlags) override;
+		void emit_instruction(const spirv_cross::Instruction& instr) override;
+		void emit_uniform(const spirv_cross::SPIRVariable& var) override;
+		void emit_buffer_block(const spirv_cross::SPIRVariable& var) override;
+		void emit_push_constant_block(const spirv_cross::SPIRVariable& var) override;
+		std::string type_to_glsl(const spirv_cross::SPIRType& type, uint32_t id = 0) override;
+		std::string type_to_array_glsl(const spirv_cross::SPIRType& type) override;
+		std::string layout_for_member(const spirv_cross::SPIRType& type, uint32_t index) override;
+		std::string to_qualifiers_glsl(uint32_t id) override;
+		void replace_illegal_names() override;
+
+		void m_emitResources();
+		void m_emitStruct(spirv_cross::SPIRType& type);
+		void m_emitResource(const spirv_cross::SPIRVariable& var, ResourceKind kind);
+		void m_emitResourceTable();
+		std::string m_argumentDecl(const spirv_cross::SPIRFunction::Parameter& arg);
+
+		std::vector<Resource> m_resources;
+		std::unordered_set<uint32_t> m_emittedBlockTypes;
+	};
+}
\ No newline at end of file
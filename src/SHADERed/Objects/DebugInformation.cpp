@@ -327,6 +327,20 @@ bool isPointInTriangle(glm::vec2 p, glm::vec2 p0, glm::vec2 p1, glm::vec2 p2)
 
 	return a < 0 ? (s <= 0 && s + t >= a) : (s >= 0 && s + t <= a);
 }
+bool usesDerivatives(const std::vector<unsigned int>& spv)
+{
+	// skip the header, then walk the instructions
+	for (size_t i = 5; i < spv.size();) {
+		spvm_word wordCount = spv[i] >> SpvWordCountShift;
+		spvm_word opcode = spv[i] & SpvOpCodeMask;
+		if (opcode >= SpvOpDPdx && opcode <= SpvOpFwidthCoarse)
+			return true;
+		if (wordCount == 0)
+			break;
+		i += wordCount;
+	}
+	return false;
+}
 bool isPointOnLine(glm::vec2 p, glm::vec2 p0, glm::vec2 p1)
 {
 	float v = glm::distance(p0, p) + glm::distance(p, p1) - glm::distance(p0, p1);
@@ -347,6 +361,11 @@ namespace ed {
 		m_msgs = msgs;
 		m_workgroup = nullptr;
 		m_updatedGeometryOutput = false;
+		m_psInputsCached[0] = m_psInputsCached[1] = false;
+		m_psOutputsCached = false;
+		m_psUsesDerivatives = false;
+		for (int i = 0; i < 4; i++)
+			m_quadLanes[i] = nullptr;
 
 		m_vmContext = spvm_context_initialize();
 		m_vmGLSL = spvm_build_glsl450_ext();
@@ -378,6 +397,9 @@ namespace ed {
 			spvm_member_free(entry.Data.members, entry.Data.member_count);
 		SharedMemory.clear();
 
+		// worker VMs use the current program
+		m_deletePixelShaderWorkers();
+
 		// clear workgroup
 		if (m_workgroup) {
 			for (int j = 0; j < m_originalValues.size(); j++)
@@ -419,6 +441,11 @@ namespace ed {
 
 		// reset undefined behavior info
 		m_ubLastType = m_ubLastLine = m_ubCount = 0;
+
+		// pixel shader layout
+		m_psInputsCached[0] = m_psInputsCached[1] = false;
+		m_psOutputsCached = false;
+		m_psUsesDerivatives = false;
 	}
 	void DebugInformation::m_setupVM(std::vector<unsigned int>& spv)
 	{
@@ -441,6 +468,9 @@ namespace ed {
 
 		// link GLSL.std.450
 		spvm_state_set_extension(m_vm, "GLSL.std.450", m_vmGLSL);
+
+		if (m_stage == ShaderStage::Pixel)
+			m_psUsesDerivatives = usesDerivatives(m_spv);
 	}
 	void DebugInformation::m_setupWorkgroup()
 	{
@@ -477,6 +507,12 @@ namespace ed {
 			}
 		}
 
+		for (int j = 0; j < groupSize; j++)
+			if (m_workgroup[j])
+				m_shareUniforms(m_workgroup[j], m_originalValues);
+	}
+	void DebugInformation::m_shareUniforms(spvm_state_t worker, std::vector<OriginalValue>& originalValues)
+	{
 		for (int i = 0; i < m_shader->bound; i++) {
 			spvm_result_t slot = &m_vm->results[i];
 			
@@ -489,8 +525,8 @@ namespace ed {
 					spvm_result_t type_info = spvm_state_get_type_info(m_vm->results, pointerInfo);
 					bool isBufferBlock = false;
 
-					for (int i = 0; i < type_info->decoration_count; i++)
-						if (type_info->decorations[i].type == SpvDecorationBufferBlock) {
+					for (int j = 0; j < type_info->decoration_count; j++)
+						if (type_info->decorations[j].type == SpvDecorationBufferBlock) {
 							isBufferBlock = true;
 							break;
 						}
@@ -498,32 +534,22 @@ namespace ed {
 					if (pointerInfo->storage_class == SpvStorageClassUniformConstant && !isBufferBlock) {
 						// textures
 						if (type_info->value_type == spvm_value_type_sampled_image || type_info->value_type == spvm_value_type_image) {
-
-							for (int j = 0; j < groupSize; j++)
-								if (m_workgroup[j]) {
-									m_originalValues.push_back(OriginalValue(m_workgroup[j], i, m_workgroup[j]->results[i].member_count, m_workgroup[j]->results[i].members));
-									m_workgroup[j]->results[i].member_count = slot->member_count;
-									m_workgroup[j]->results[i].members = slot->members;
-									wasCopied = true;
-								}
+							originalValues.push_back(OriginalValue(worker, i, worker->results[i].member_count, worker->results[i].members));
+							worker->results[i].member_count = slot->member_count;
+							worker->results[i].members = slot->members;
+							wasCopied = true;
 						}
 					} else if (pointerInfo->storage_class == SpvStorageClassStorageBuffer || isBufferBlock) {
 						// buffers
-						for (int j = 0; j < groupSize; j++)
-							if (m_workgroup[j]) {
-								m_originalValues.push_back(OriginalValue(m_workgroup[j], i, m_workgroup[j]->results[i].member_count, m_workgroup[j]->results[i].members));
-								m_workgroup[j]->results[i].member_count = slot->member_count;
-								m_workgroup[j]->results[i].members = slot->members;
-								wasCopied = true;
-							}
+						originalValues.push_back(OriginalValue(worker, i, worker->results[i].member_count, worker->results[i].members));
+						worker->results[i].member_count = slot->member_count;
+						worker->results[i].members = slot->members;
+						wasCopied = true;
 					}
 				}
 				
-				if (!wasCopied && (pointerInfo->storage_class == SpvStorageClassUniformConstant || pointerInfo->storage_class == SpvStorageClassUniform)) {
-					for (int j = 0; j < groupSize; j++)
-						if (m_workgroup[j])
-							spvm_member_memcpy(m_workgroup[j]->results[i].members, slot->members, slot->member_count);
-				}
+				if (!wasCopied && (pointerInfo->storage_class == SpvStorageClassUniformConstant || pointerInfo->storage_class == SpvStorageClassUniform))
+					spvm_member_memcpy(worker->results[i].members, slot->members, slot->member_count);
 			}
 		}
 	}
@@ -1769,38 +1795,115 @@ namespace ed {
 		m_copyUniforms(owner, item, px);
 
 		// dfdx/y
-		if (m_vm->derivative_used) {
-			for (spvm_word i = 0; i < m_vm->owner->bound; i++) {
-				spvm_result_t slot = &m_vm->results[i];
+		m_copyUniformsToDerivatives(m_vm);
+	}
+	void DebugInformation::m_copyUniformsToDerivatives(spvm_state_t vm)
+	{
+		if (!vm->derivative_used)
+			return;
 
-				spvm_result_t ptrInfo = nullptr;
-				if (slot->pointer)
-					ptrInfo = &m_vm->results[slot->pointer];
+		for (spvm_word i = 0; i < vm->owner->bound; i++) {
+			spvm_result_t slot = &vm->results[i];
 
-				bool needsCopy = false;
+			spvm_result_t ptrInfo = nullptr;
+			if (slot->pointer)
+				ptrInfo = &vm->results[slot->pointer];
 
-				if (ptrInfo)
-					needsCopy = (ptrInfo->storage_class == SpvStorageClassUniform || ptrInfo->storage_class == SpvStorageClassUniformConstant) && ptrInfo->value_type == spvm_value_type_pointer;
+			bool needsCopy = false;
 
-				if (needsCopy && slot->members != nullptr) {
-					if (m_vm->derivative_group_x) spvm_member_memcpy(m_vm->derivative_group_x->results[i].members, slot->members, slot->member_count);
-					if (m_vm->derivative_group_y) spvm_member_memcpy(m_vm->derivative_group_y->results[i].members, slot->members, slot->member_count);
-					if (m_vm->derivative_group_d) spvm_member_memcpy(m_vm->derivative_group_d->results[i].members, slot->members, slot->member_count);
-				}
+			if (ptrInfo)
+				needsCopy = (ptrInfo->storage_class == SpvStorageClassUniform || ptrInfo->storage_class == SpvStorageClassUniformConstant) && ptrInfo->value_type == spvm_value_type_pointer;
+
+			if (needsCopy && slot->members != nullptr) {
+				if (vm->derivative_group_x) spvm_member_memcpy(vm->derivative_group_x->results[i].members, slot->members, slot->member_count);
+				if (vm->derivative_group_y) spvm_member_memcpy(vm->derivative_group_y->results[i].members, slot->members, slot->member_count);
+				if (vm->derivative_group_d) spvm_member_memcpy(vm->derivative_group_d->results[i].members, slot->members, slot->member_count);
 			}
 		}
 	}
+	void DebugInformation::CreatePixelShaderWorkers(int count)
+	{
+		m_deletePixelShaderWorkers();
+
+		if (m_vm == nullptr || m_stage != ShaderStage::Pixel)
+			return;
+
+		for (int i = 0; i < 4; i++)
+			m_quadLanes[i] = m_createQuadLane();
+
+		for (int i = 0; i < count; i++) {
+			PixelShaderWorker* worker = new PixelShaderWorker();
+			worker->UBLastType = worker->UBLastLine = worker->UBCount = 0;
+
+			worker->VM = _spvm_state_create_base(m_shader, true, 0);
+			worker->VM->analyzer = m_vm->analyzer;
+			spvm_state_set_extension(worker->VM, "GLSL.std.450", m_vmGLSL);
+
+			m_shareUniforms(worker->VM, m_pixelWorkerValues);
+			m_copyUniformsToDerivatives(worker->VM);
+
+			for (int j = 0; j < 4; j++)
+				worker->QuadLanes[j] = m_createQuadLane();
+
+			m_pixelWorkers.push_back(worker);
+		}
+	}
+	spvm_state_t DebugInformation::m_createQuadLane()
+	{
+		// created as a derivative group member -> spvm doesn't give it derivative groups of its own
+		// and never steps it together with another VM, so the quad is in full control of the lanes
+		spvm_state_t lane = _spvm_state_create_base(m_shader, false, 1);
+		lane->analyzer = m_vm->analyzer;
+		spvm_state_set_extension(lane, "GLSL.std.450", m_vmGLSL);
+
+		m_shareUniforms(lane, m_pixelWorkerValues);
+
+		return lane;
+	}
+	void DebugInformation::m_deletePixelShaderWorkers()
+	{
+		// shared members belong to m_vm
+		for (const OriginalValue& originalData : m_pixelWorkerValues) {
+			originalData.State->results[originalData.Slot].members = originalData.Members;
+			originalData.State->results[originalData.Slot].member_count = originalData.MemberCount;
+		}
+		m_pixelWorkerValues.clear();
+
+		for (PixelShaderWorker* worker : m_pixelWorkers) {
+			spvm_state_delete(worker->VM);
+			for (int i = 0; i < 4; i++)
+				spvm_state_delete(worker->QuadLanes[i]);
+			delete worker;
+		}
+		m_pixelWorkers.clear();
+
+		for (int i = 0; i < 4; i++) {
+			if (m_quadLanes[i] != nullptr)
+				spvm_state_delete(m_quadLanes[i]);
+			m_quadLanes[i] = nullptr;
+		}
+	}
 	float DebugInformation::SetPixelShaderInput(PixelInformation& pixel)
 	{
 		m_pixel = &pixel;
 		m_ubLastType = m_ubLastLine = m_ubCount = 0;
 
-		glm::vec3 weights = m_processWeight(glm::ivec2(0, 0));
-		m_interpolateValues(m_vm, weights);
+		return m_setPixelShaderInput(m_vm, pixel);
+	}
+	float DebugInformation::SetPixelShaderInput(PixelShaderWorker* worker, PixelInformation& pixel)
+	{
+		worker->UBLastType = worker->UBLastLine = worker->UBCount = 0;
+
+		return m_setPixelShaderInput(worker->VM, pixel);
+	}
+	float DebugInformation::m_setPixelShaderInput(spvm_state_t vm, const PixelInformation& pixel)
+	{
+		glm::vec3 weights = m_processWeight(pixel, glm::ivec2(0, 0));
+		m_interpolateValues(pixel, vm, weights);
 
 		float depth = weights.x * pixel.FinalPosition[0].z + weights.y * pixel.FinalPosition[1].z + weights.z * pixel.FinalPosition[2].z;
 		
-		if (m_vm->derivative_used && !m_vm->_derivative_is_group_member) {
+		if (vm->derivative_used && !vm->_derivative_is_group_member) {
 			spvm_byte isOddX = ((int)pixel.Coordinate.x) % 2 != 0;
 			spvm_byte isOddY = ((int)pixel.Coordinate.y) % 2 != 0;
 			float modX = 1, modY = 1;
@@ -1809,46 +1912,52 @@ namespace ed {
 			if (isOddX) modX = -1;
 			if (isOddY) modY = -1;
 			
-			if (m_vm->derivative_group_x) {
-				weights = m_processWeight(glm::ivec2(modX, 0));
-				m_interpolateValues(m_vm->derivative_group_x, weights);
+			if (vm->derivative_group_x) {
+				weights = m_processWeight(pixel, glm::ivec2(modX, 0));
+				m_interpolateValues(pixel, vm->derivative_group_x, weights);
 			}
-			if (m_vm->derivative_group_y) {
-				weights = m_processWeight(glm::ivec2(0, modY));
-				m_interpolateValues(m_vm->derivative_group_y, weights);
+			if (vm->derivative_group_y) {
+				weights = m_processWeight(pixel, glm::ivec2(0, modY));
+				m_interpolateValues(pixel, vm->derivative_group_y, weights);
 			}
-			if (m_vm->derivative_group_d) {
-				weights = m_processWeight(glm::ivec2(modX, modY));
-				m_interpolateValues(m_vm->derivative_group_d, weights);
+			if (vm->derivative_group_d) {
+				weights = m_processWeight(pixel, glm::ivec2(modX, modY));
+				m_interpolateValues(pixel, vm->derivative_group_d, weights);
 			}
 		}
 
 		return depth / (weights.x + weights.y + weights.z);
 	}
-	glm::vec3 DebugInformation::m_processWeight(glm::ivec2 offset)
+	glm::vec3 DebugInformation::m_processWeight(const PixelInformation& px, glm::ivec2 offset)
 	{
-		// !!! m_pixel must be set !!!
-
-		glm::vec2 pxPosition = glm::vec2(m_pixel->Coordinate + offset) / glm::vec2(m_pixel->RenderTextureSize - 1);
+		glm::vec2 pxPosition = glm::vec2(px.Coordinate + offset) / glm::vec2(px.RenderTextureSize - 1);
 
 		// weigths
-		glm::vec2 scrnPos1 = m_getScreenCoord(m_pixel->FinalPosition[0]);
-		glm::vec2 scrnPos2 = m_getScreenCoord(m_pixel->FinalPosition[1]);
-		glm::vec2 scrnPos3 = m_getScreenCoord(m_pixel->FinalPosition[2]);
+		glm::vec2 scrnPos1 = m_getScreenCoord(px.FinalPosition[0]);
+		glm::vec2 scrnPos2 = m_getScreenCoord(px.FinalPosition[1]);
+		glm::vec2 scrnPos3 = m_getScreenCoord(px.FinalPosition[2]);
 		glm::vec3 weights = m_getWeights(scrnPos1, scrnPos2, scrnPos3, pxPosition);
-		weights *= glm::vec3(m_pixel->FinalPosition[0].w == 0.0f ? 0.0f : (1.0f / m_pixel->FinalPosition[0].w), m_pixel->FinalPosition[1].w == 0.0f ? 0.0f : (1.0f / m_pixel->FinalPosition[1].w), m_pixel->FinalPosition[2].w == 0.0f ? 0.0f : (1.0f / m_pixel->FinalPosition[2].w));
+		weights *= glm::vec3(px.FinalPosition[0].w == 0.0f ? 0.0f : (1.0f / px.FinalPosition[0].w), px.FinalPosition[1].w == 0.0f ? 0.0f : (1.0f / px.FinalPosition[1].w), px.FinalPosition[2].w == 0.0f ? 0.0f : (1.0f / px.FinalPosition[2].w));
 	
 		return weights;
 	}
-	void DebugInformation::m_interpolateValues(spvm_state_t state, glm::vec3 weights)
+	const std::vector<DebugInformation::InterpolatedInput>& DebugInformation::m_getInterpolatedInputs(const PixelInformation& px, spvm_state_t state)
 	{
-		// !!! m_pixel must be set !!!
+		// the layout is the same for every pixel of the prepared shader - look it up only once
+		bool useGS = px.GeometryShaderUsed && px.GeometrySelectedPrimitive != -1 && px.GeometrySelectedVertex != -1;
+		if (m_psInputsCached[useGS].load(std::memory_order_acquire))
+			return m_psInputs[useGS];
 
-		float weightSum = weights.x + weights.y + weights.z;
+		std::lock_guard<std::mutex> lock(m_psCacheMutex);
+		std::vector<InterpolatedInput>& inputs = m_psInputs[useGS];
+		if (m_psInputsCached[useGS].load(std::memory_order_relaxed))
+			return inputs;
 
-		auto* mainStageOutput = &m_pixel->VertexShaderOutput[0];
-		if (m_pixel->GeometryShaderUsed && m_pixel->GeometrySelectedPrimitive != -1 && m_pixel->GeometrySelectedVertex != -1)
-			mainStageOutput = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex];
+		inputs.clear();
+
+		auto* mainStageOutput = &px.VertexShaderOutput[0];
+		if (useGS)
+			mainStageOutput = &px.GeometryOutput[px.GeometrySelectedPrimitive].Output[px.GeometrySelectedVertex];
 
 		// match the ps input with vs output
 		for (int i = 0; i < state->owner->bound; i++) {
@@ -1886,115 +1995,350 @@ namespace ed {
 					}
 				}
 
-				// copy and interpolate values
-				if (outputIndex >= 0) {
-					auto* outputPtr0 = &m_pixel->VertexShaderOutput[0];
-					auto* outputPtr1 = &m_pixel->VertexShaderOutput[1];
-					auto* outputPtr2 = &m_pixel->VertexShaderOutput[2];
+				if (outputIndex < 0)
+					continue;
 
-					if (m_pixel->GeometryShaderUsed && m_pixel->GeometrySelectedPrimitive != -1 && m_pixel->GeometrySelectedVertex != -1) {
-						if (m_pixel->GeometryOutputType == GeometryShaderOutput::Points) {
-							outputPtr0 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex];
-							outputPtr1 = nullptr;
-							outputPtr2 = nullptr;
-						} else if (m_pixel->GeometryOutputType == GeometryShaderOutput::LineStrip) {
-							outputPtr0 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex - 1];
-							outputPtr1 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex];
-							outputPtr2 = nullptr;
-						} else if (m_pixel->GeometryOutputType == GeometryShaderOutput::TriangleStrip) {
-							outputPtr0 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex - 2];
-							outputPtr1 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex - 1];
-							outputPtr2 = &m_pixel->GeometryOutput[m_pixel->GeometrySelectedPrimitive].Output[m_pixel->GeometrySelectedVertex];
-						}
-					}
+				// get type
+				spvm_result_t memType = spvm_state_get_type_info(state->results, pointer);
+				spvm_value_type elType = (spvm_value_type)memType->value_type;
+				spvm_word vbcount = memType->value_bitcount;
+				if (elType == spvm_value_type_vector || elType == spvm_value_type_matrix) {
+					memType = spvm_state_get_type_info(state->results, &state->results[memType->pointer]);
+					elType = (spvm_value_type)memType->value_type;
+					vbcount = memType->value_bitcount;
+				}
 
-					const struct spvm_result* value0 = (outputPtr0 == nullptr || outputPtr0->empty()) ? nullptr : &(*outputPtr0)[outputIndex];
-					const struct spvm_result* value1 = (outputPtr1 == nullptr || outputPtr1->empty()) ? nullptr : &(*outputPtr1)[outputIndex];
-					const struct spvm_result* value2 = (outputPtr2 == nullptr || outputPtr2->empty()) ? nullptr : &(*outputPtr2)[outputIndex];
-					
-					// get type
-					spvm_result_t memType = spvm_state_get_type_info(state->results, pointer);
-					spvm_value_type elType = (spvm_value_type)memType->value_type;
-					spvm_word vbcount = memType->value_bitcount;
-					if (elType == spvm_value_type_vector || elType == spvm_value_type_matrix) {
-						memType = spvm_state_get_type_info(state->results, &state->results[memType->pointer]);
-						elType = (spvm_value_type)memType->value_type;
-						vbcount = memType->value_bitcount;
-					}
+				InterpolatedInput input;
+				input.Slot = i;
+				input.OutputIndex = outputIndex;
+				input.Type = elType;
+				input.BitCount = vbcount;
+				inputs.push_back(input);
+			}
+		}
 
-					// apply values
-					for (int c = 0; c < slot->member_count; c++) {
-						if (slot->members[c].member_count == 0) {
-							if (elType == spvm_value_type_float && vbcount > 32)
-								slot->members[c].value.d = (GET_VALUE_WITH_CHECK_DOUBLE(value0, c) * weights.x + GET_VALUE_WITH_CHECK_DOUBLE(value1, c) * weights.y + GET_VALUE_WITH_CHECK_DOUBLE(value2, c) * weights.z) / weightSum;
-							else if (elType == spvm_value_type_float)
-								slot->members[c].value.f = (GET_VALUE_WITH_CHECK_FLOAT(value0, c) * weights.x + GET_VALUE_WITH_CHECK_FLOAT(value1, c) * weights.y + GET_VALUE_WITH_CHECK_FLOAT(value2, c) * weights.z) / weightSum;
-							else
-								slot->members[c].value.s = (GET_VALUE_WITH_CHECK_INT(value0, c) * weights.x + GET_VALUE_WITH_CHECK_INT(value1, c) * weights.y + GET_VALUE_WITH_CHECK_INT(value2, c) * weights.z) / weightSum;
-						} else {
-							for (int r = 0; r < slot->members[c].member_count; c++) {
-								if (elType == spvm_value_type_float && vbcount > 32)
-									slot->members[c].members[r].value.d = (GET_VALUE2_WITH_CHECK_DOUBLE(value0, c, r) * weights.x + GET_VALUE2_WITH_CHECK_DOUBLE(value1, c, r) * weights.y + GET_VALUE2_WITH_CHECK_DOUBLE(value2, c, r) * weights.z) / weightSum;
-								else if (elType == spvm_value_type_float)
-									slot->members[c].members[r].value.f = (GET_VALUE2_WITH_CHECK_FLOAT(value0, c, r) * weights.x + GET_VALUE2_WITH_CHECK_FLOAT(value1, c, r) * weights.y + GET_VALUE2_WITH_CHECK_FLOAT(value2, c, r) * weights.z) / weightSum;
-								else
-									slot->members[c].members[r].value.s = (GET_VALUE2_WITH_CHECK_INT(value0, c, r) * weights.x + GET_VALUE2_WITH_CHECK_INT(value1, c, r) * weights.y + GET_VALUE2_WITH_CHECK_INT(value2, c, r) * weights.z) / weightSum;
-							}
-						}
+		m_psInputsCached[useGS].store(true, std::memory_order_release);
+
+		return inputs;
+	}
+	void DebugInformation::m_interpolateValues(const PixelInformation& px, spvm_state_t state, glm::vec3 weights)
+	{
+		float weightSum = weights.x + weights.y + weights.z;
+
+		auto* outputPtr0 = &px.VertexShaderOutput[0];
+		auto* outputPtr1 = &px.VertexShaderOutput[1];
+		auto* outputPtr2 = &px.VertexShaderOutput[2];
+
+		if (px.GeometryShaderUsed && px.GeometrySelectedPrimitive != -1 && px.GeometrySelectedVertex != -1) {
+			if (px.GeometryOutputType == GeometryShaderOutput::Points) {
+				outputPtr0 = &px.GeometryOutput[px.GeometrySelectedPrimitive].Output[px.GeometrySelectedVertex];
+				outputPtr1 = nullptr;
+				outputPtr2 = nullptr;
+			} else if (px.GeometryOutputType == GeometryShaderOutput::LineStrip) {
+				outputPtr0 = &px.GeometryOutput[px.GeometrySelectedPrimitive].Output[px.GeometrySelectedVertex - 1];
+				outputPtr1 = &px.GeometryOutput[px.GeometrySelectedPrimitive].Output[px.GeometrySelectedVertex];
+				outputPtr2 = nullptr;
+			} else if (px.GeometryOutputType == GeometryShaderOutput::TriangleStrip) {
+				outputPtr0 = &px.GeometryOutput[px.GeometrySelectedPrimitive].Output[px.GeometrySelectedVertex - 2];
+				outputPtr1 = &px.GeometryOutput[px.GeometrySelectedPrimitive].Output[px.GeometrySelectedVertex - 1];
+				outputPtr2 = &px.GeometryOutput[px.GeometrySelectedPrimitive].Output[px.GeometrySelectedVertex];
+			}
+		}
+
+		// copy and interpolate values
+		for (const InterpolatedInput& input : m_getInterpolatedInputs(px, state)) {
+			spvm_result_t slot = &state->results[input.Slot];
+			int outputIndex = input.OutputIndex;
+			spvm_value_type elType = input.Type;
+			spvm_word vbcount = input.BitCount;
+
+			const struct spvm_result* value0 = (outputPtr0 == nullptr || outputPtr0->empty()) ? nullptr : &(*outputPtr0)[outputIndex];
+			const struct spvm_result* value1 = (outputPtr1 == nullptr || outputPtr1->empty()) ? nullptr : &(*outputPtr1)[outputIndex];
+			const struct spvm_result* value2 = (outputPtr2 == nullptr || outputPtr2->empty()) ? nullptr : &(*outputPtr2)[outputIndex];
+
+			// apply values
+			for (int c = 0; c < slot->member_count; c++) {
+				if (slot->members[c].member_count == 0) {
+					if (elType == spvm_value_type_float && vbcount > 32)
+						slot->members[c].value.d = (GET_VALUE_WITH_CHECK_DOUBLE(value0, c) * weights.x + GET_VALUE_WITH_CHECK_DOUBLE(value1, c) * weights.y + GET_VALUE_WITH_CHECK_DOUBLE(value2, c) * weights.z) / weightSum;
+					else if (elType == spvm_value_type_float)
+						slot->members[c].value.f = (GET_VALUE_WITH_CHECK_FLOAT(value0, c) * weights.x + GET_VALUE_WITH_CHECK_FLOAT(value1, c) * weights.y + GET_VALUE_WITH_CHECK_FLOAT(value2, c) * weights.z) / weightSum;
+					else
+						slot->members[c].value.s = (GET_VALUE_WITH_CHECK_INT(value0, c) * weights.x + GET_VALUE_WITH_CHECK_INT(value1, c) * weights.y + GET_VALUE_WITH_CHECK_INT(value2, c) * weights.z) / weightSum;
+				} else {
+					for (int r = 0; r < slot->members[c].member_count; c++) {
+						if (elType == spvm_value_type_float && vbcount > 32)
+							slot->members[c].members[r].value.d = (GET_VALUE2_WITH_CHECK_DOUBLE(value0, c, r) * weights.x + GET_VALUE2_WITH_CHECK_DOUBLE(value1, c, r) * weights.y + GET_VALUE2_WITH_CHECK_DOUBLE(value2, c, r) * weights.z) / weightSum;
+						else if (elType == spvm_value_type_float)
+							slot->members[c].members[r].value.f = (GET_VALUE2_WITH_CHECK_FLOAT(value0, c, r) * weights.x + GET_VALUE2_WITH_CHECK_FLOAT(value1, c, r) * weights.y + GET_VALUE2_WITH_CHECK_FLOAT(value2, c, r) * weights.z) / weightSum;
+						else
+							slot->members[c].members[r].value.s = (GET_VALUE2_WITH_CHECK_INT(value0, c, r) * weights.x + GET_VALUE2_WITH_CHECK_INT(value1, c, r) * weights.y + GET_VALUE2_WITH_CHECK_INT(value2, c, r) * weights.z) / weightSum;
 					}
 				}
 			}
 		}
-
 	}
 	glm::vec4 DebugInformation::ExecutePixelShader(int x, int y, int loc)
 	{
-		if (m_vm == nullptr)
+		return m_executePixelShader(m_vm, x, y, loc);
+	}
+	glm::vec4 DebugInformation::ExecutePixelShader(PixelShaderWorker* worker, int x, int y, int loc)
+	{
+		return m_executePixelShader(worker->VM, x, y, loc);
+	}
+	spvm_word DebugInformation::m_getPixelShaderEntryPoint(spvm_state_t vm)
+	{
+		spvm_word fnMain = GetEntryPoint(m_stage);
+		if (fnMain == 0)
+			fnMain = spvm_state_get_result_location(vm, "main");
+		return fnMain;
+	}
+	glm::vec4 DebugInformation::m_executePixelShader(spvm_state_t vm, int x, int y, int loc)
+	{
+		if (vm == nullptr)
 			return glm::vec4(0.0f);
 
-		spvm_word fnMain = GetEntryPoint(m_stage);
-		if (fnMain == 0) {
-			fnMain = spvm_state_get_result_location(m_vm, "main");
-			if (fnMain == 0)
-				return glm::vec4(0.0f);
-		}
+		spvm_word fnMain = m_getPixelShaderEntryPoint(vm);
+		if (fnMain == 0)
+			return glm::vec4(0.0f);
 
-		spvm_state_prepare(m_vm, fnMain);
-		spvm_state_set_frag_coord(m_vm, x + 0.5f, y + 0.5f, 1.0f, 1.0f); // TODO: z and w components
-		spvm_state_call_function(m_vm);
+		spvm_state_prepare(vm, fnMain);
+		spvm_state_set_frag_coord(vm, x + 0.5f, y + 0.5f, 1.0f, 1.0f); // TODO: z and w components
+		spvm_state_call_function(vm);
 
-		return GetPixelShaderOutput(loc);
+		return m_getPixelShaderOutput(vm, loc);
 	}
+	bool DebugInformation::InitPixelShaderQuad(PixelShaderWorker* worker, PixelShaderQuad& quad)
+	{
+		spvm_state_t* lanes = worker ? worker->QuadLanes : m_quadLanes;
+		if (lanes[0] == nullptr)
+			return false;
 
-	glm::vec4 DebugInformation::GetPixelShaderOutput(int loc)
+		for (int i = 0; i < 4; i++)
+			quad.Lanes[i] = lanes[i];
+		quad.DivergedMask = 0;
+
+		return true;
+	}
+	void DebugInformation::SetPixelShaderQuadInput(PixelShaderWorker* worker, PixelInformation& pixel, PixelShaderQuad& quad)
 	{
-		glm::vec4 ret(0.0f);
+		if (worker == nullptr)
+			m_pixel = &pixel;
 
-		spvm_word mCount = 0;
-		spvm_member_t pointer = nullptr;
+		glm::vec3 weights[4];
+		for (int i = 0; i < 4; i++) {
+			weights[i] = m_processWeight(pixel, glm::ivec2(i & 1, i >> 1));
+			m_interpolateValues(pixel, quad.Lanes[i], weights[i]);
+		}
 
-		for (spvm_word i = 0; i < m_shader->bound; i++) {
-			spvm_result_t slot = &m_vm->results[i];
-			spvm_result_t type = nullptr, pointerType = nullptr;
-			if (slot->pointer) {
-				type = spvm_state_get_type_info(m_vm->results, &m_vm->results[slot->pointer]);
-				pointerType = &m_vm->results[slot->pointer];
+		// same depth as m_setPixelShaderInput() - a VM with derivative groups divides by the weights of the diagonal neighbour
+		spvm_state_t vm = worker ? worker->VM : m_vm;
+		bool diagonal = vm->derivative_used && vm->derivative_group_d != nullptr;
+		for (int i = 0; i < 4; i++) {
+			const glm::vec3& w = weights[i];
+			const glm::vec3& div = weights[diagonal ? 3 - i : i];
+			float depth = w.x * pixel.FinalPosition[0].z + w.y * pixel.FinalPosition[1].z + w.z * pixel.FinalPosition[2].z;
+			quad.Depth[i] = depth / (div.x + div.y + div.z);
+		}
+	}
+	void DebugInformation::ExecutePixelShaderQuad(PixelShaderWorker* worker, PixelShaderQuad& quad, int x, int y, uint8_t laneMask, int loc)
+	{
+		spvm_state_t vm = worker ? worker->VM : m_vm;
+
+		for (int i = 0; i < 4; i++) {
+			quad.UBLastType[i] = quad.UBLastLine[i] = quad.UBCount[i] = 0;
+			quad.InstCount[i] = 0;
+			for (int c = 0; c < 4; c++)
+				quad.Color[c][i] = 0.0f;
+		}
+		quad.DivergedMask = 0;
+
+		spvm_word fnMain = m_getPixelShaderEntryPoint(vm);
+		if (fnMain == 0)
+			return;
+
+		// uncovered lanes only have to run as helpers when something reads their values
+		uint8_t running = m_psUsesDerivatives ? 0xF : laneMask;
+
+		for (int i = 0; i < 4; i++) {
+			if (!(running & (1 << i)))
+				continue;
+
+			spvm_state_t lane = quad.Lanes[i];
+			lane->analyzer = vm->analyzer;
+			spvm_state_prepare(lane, fnMain);
+			spvm_state_set_frag_coord(lane, x + (i & 1) + 0.5f, y + (i >> 1) + 0.5f, 1.0f, 1.0f); // TODO: z and w components
+		}
+
+		// UB is reported to the worker (or to the debugger) - reset it before each step to find out which lane caused it
+		spvm_word& ubLastType = worker ? worker->UBLastType : m_ubLastType;
+		spvm_word& ubLastLine = worker ? worker->UBLastLine : m_ubLastLine;
+		spvm_word& ubCount = worker ? worker->UBCount : m_ubCount;
+
+		while (true) {
+			// lanes at the lowest address go first - structured control flow puts the merge blocks after
+			// the branches, so the lanes that are ahead wait there until the rest of the quad catches up
+			spvm_source pc = nullptr;
+			for (int i = 0; i < 4; i++) {
+				if (!(running & (1 << i)))
+					continue;
+
+				spvm_source laneCode = quad.Lanes[i]->code_current;
+				if (laneCode == nullptr)
+					running &= ~(1 << i);
+				else if (pc == nullptr || laneCode < pc)
+					pc = laneCode;
 			}
+			if (running == 0)
+				break;
 
-			if (slot->member_count == 0 || pointerType == nullptr || pointerType->storage_class != SpvStorageClassOutput)
+			uint8_t active = 0;
+			for (int i = 0; i < 4; i++)
+				if ((running & (1 << i)) && quad.Lanes[i]->code_current == pc)
+					active |= 1 << i;
+			if (active != running)
+				quad.DivergedMask |= active;
+
+			// the lanes have no derivative groups - derivatives are always computed by the quad
+			spvm_word opcode = pc[0] & SpvOpCodeMask;
+			if (opcode >= SpvOpDPdx && opcode <= SpvOpFwidthCoarse) {
+				m_executeQuadDerivative(quad, active);
 				continue;
+			}
 
-			int decLoc = -1;
-			for (spvm_word j = 0; j < slot->decoration_count; j++) {
-				if (slot->decorations[j].type == SpvDecorationLocation) {
-					decLoc = slot->decorations[j].literal1;
-					break;
+			for (int i = 0; i < 4; i++) {
+				if (!(active & (1 << i)))
+					continue;
+
+				ubLastType = ubLastLine = ubCount = 0;
+				spvm_state_step_opcode(quad.Lanes[i]);
+
+				if (ubCount != 0) {
+					quad.UBLastType[i] = ubLastType;
+					quad.UBLastLine[i] = ubLastLine;
+					quad.UBCount[i] = std::min<spvm_word>(quad.UBCount[i] + ubCount, 11);
 				}
 			}
+		}
 
-			if (decLoc != loc && decLoc != -1)
+		for (int i = 0; i < 4; i++) {
+			if (!(laneMask & (1 << i)))
 				continue;
 
+			glm::vec4 color = m_getPixelShaderOutput(quad.Lanes[i], loc);
+			for (int c = 0; c < 4; c++)
+				quad.Color[c][i] = color[c];
+			quad.InstCount[i] = quad.Lanes[i]->instruction_count;
+		}
+	}
+	void DebugInformation::m_executeQuadDerivative(PixelShaderQuad& quad, uint8_t laneMask)
+	{
+		int first = 0;
+		while (!(laneMask & (1 << first)))
+			first++;
+
+		spvm_source code = quad.Lanes[first]->code_current;
+		spvm_word wordCount = code[0] >> SpvWordCountShift;
+		spvm_word opcode = code[0] & SpvOpCodeMask;
+		spvm_word resultID = code[2];
+		spvm_word operandID = code[3];
+
+		// operands are 32 bit float scalars or vectors - gather them as [component][lane].
+		// lanes that have finished (discarded) or are elsewhere still provide the last value they computed
+		float values[4][4] = { { 0.0f } };
+		spvm_word componentCount = 0;
+		for (int i = 0; i < 4; i++) {
+			spvm_result_t operand = &quad.Lanes[i]->results[operandID];
+			if (operand->members == nullptr)
+				continue;
+
+			spvm_word count = std::min<spvm_word>(operand->member_count, 4);
+			componentCount = std::max<spvm_word>(componentCount, count);
+			for (spvm_word c = 0; c < count; c++)
+				values[c][i] = operand->members[c].value.f;
+		}
+
+		// the VM computes fine derivatives for every variant, so do the same: ddx from the lane's row, ddy from its column
+		float dx[4][4], dy[4][4];
+		for (spvm_word c = 0; c < componentCount; c++) {
+			for (int i = 0; i < 4; i++) {
+				dx[c][i] = values[c][(i & 2) | 1] - values[c][i & 2];
+				dy[c][i] = values[c][(i & 1) | 2] - values[c][i & 1];
+			}
+		}
+
+		bool isX = opcode == SpvOpDPdx || opcode == SpvOpDPdxFine || opcode == SpvOpDPdxCoarse;
+		bool isY = opcode == SpvOpDPdy || opcode == SpvOpDPdyFine || opcode == SpvOpDPdyCoarse;
+
+		for (int i = 0; i < 4; i++) {
+			if (!(laneMask & (1 << i)))
+				continue;
+
+			spvm_state_t lane = quad.Lanes[i];
+			spvm_result_t result = &lane->results[resultID];
+			if (result->members == nullptr) {
+				result->member_count = componentCount;
+				result->members = (spvm_member_t)calloc(componentCount, sizeof(spvm_member));
+			}
+
+			spvm_word count = std::min<spvm_word>(result->member_count, componentCount);
+			for (spvm_word c = 0; c < count; c++) {
+				if (isX)
+					result->members[c].value.f = dx[c][i];
+				else if (isY)
+					result->members[c].value.f = dy[c][i];
+				else
+					result->members[c].value.f = fabsf(dx[c][i]) + fabsf(dy[c][i]);
+			}
+
+			lane->code_current += wordCount;
+			lane->instruction_count++;
+		}
+	}
+
+	glm::vec4 DebugInformation::GetPixelShaderOutput(int loc)
+	{
+		return m_getPixelShaderOutput(m_vm, loc);
+	}
+	glm::vec4 DebugInformation::m_getPixelShaderOutput(spvm_state_t vm, int loc)
+	{
+		// output variables (slot & location) are looked up once per shader
+		if (!m_psOutputsCached.load(std::memory_order_acquire)) {
+			std::lock_guard<std::mutex> lock(m_psCacheMutex);
+			if (!m_psOutputsCached.load(std::memory_order_relaxed)) {
+				m_psOutputs.clear();
+
+				for (spvm_word i = 0; i < m_shader->bound; i++) {
+					spvm_result_t slot = &vm->results[i];
+					spvm_result_t pointerType = nullptr;
+					if (slot->pointer)
+						pointerType = &vm->results[slot->pointer];
+
+					if (slot->member_count == 0 || pointerType == nullptr || pointerType->storage_class != SpvStorageClassOutput)
+						continue;
+
+					int decLoc = -1;
+					for (spvm_word j = 0; j < slot->decoration_count; j++) {
+						if (slot->decorations[j].type == SpvDecorationLocation) {
+							decLoc = slot->decorations[j].literal1;
+							break;
+						}
+					}
+
+					m_psOutputs.push_back(std::make_pair(i, decLoc));
+				}
+
+				m_psOutputsCached.store(true, std::memory_order_release);
+			}
+		}
+
+		glm::vec4 ret(0.0f);
+
+		for (const auto& output : m_psOutputs) {
+			if (output.second != loc && output.second != -1)
+				continue;
+
+			spvm_result_t slot = &vm->results[output.first];
 			for (int j = 0; j < slot->member_count; j++)
 				ret[j] = slot->members[j].value.f;
 
@@ -2820,6 +3164,18 @@ namespace ed {
 	}
 	void DebugInformation::OnUndefinedBehavior(spvm_state_t state, spvm_word ubID)
 	{
+		// called from FrameAnalysis' threads
+		for (PixelShaderWorker* worker : m_pixelWorkers) {
+			spvm_state_t vm = worker->VM;
+			bool isLane = state == worker->QuadLanes[0] || state == worker->QuadLanes[1] || state == worker->QuadLanes[2] || state == worker->QuadLanes[3];
+			if (isLane || state == vm || state == vm->derivative_group_x || state == vm->derivative_group_y || state == vm->derivative_group_d) {
+				worker->UBLastType = ubID;
+				worker->UBLastLine = state->current_line;
+				worker->UBCount = std::min<spvm_word>(worker->UBCount + 1, 11);
+				return;
+			}
+		}
+
 		m_ubLastType = ubID;
 		m_ubLastLine = state->current_line;
 		m_ubCount = std::min<spvm_word>(m_ubCount + 1, 11);
@@ -8,6 +8,8 @@
 #include <SHADERed/Objects/Debug/ExpressionCompiler.h>
 
 #include <sstream>
+#include <atomic>
+#include <mutex>
 
 extern "C" {
 	#include <spvm/program.h>
@@ -48,6 +50,36 @@ namespace ed {
 		glm::vec4 ExecutePixelShader(int x, int y, int loc = 0);
 		glm::vec4 GetPixelShaderOutput(int loc = 0);
 
+		// extra pixel shader VMs for FrameAnalysis' threads - they share the program, uniforms, textures and
+		// buffers with GetVM() and are deleted when another shader is prepared
+		struct PixelShaderWorker {
+			spvm_state_t VM;
+			spvm_state_t QuadLanes[4]; // see PixelShaderQuad
+			spvm_word UBLastType, UBLastLine, UBCount;
+		};
+		void CreatePixelShaderWorkers(int count);
+		inline PixelShaderWorker* GetPixelShaderWorker(int index) { return m_pixelWorkers[index]; }
+		float SetPixelShaderInput(PixelShaderWorker* worker, PixelInformation& pixel);
+		glm::vec4 ExecutePixelShader(PixelShaderWorker* worker, int x, int y, int loc = 0);
+
+		// 2x2 quad that runs in lockstep - lanes are (x, y), (x + 1, y), (x, y + 1) & (x + 1, y + 1) with x and y even.
+		// each lane has a VM without derivative groups (spvm keeps the registers per VM) and ddx/ddy are computed by the quad
+		// from the neighbouring lanes' real values. everything else is stored per lane in SoA order
+		struct PixelShaderQuad {
+			spvm_state_t Lanes[4];
+			float Depth[4];
+			float Color[4][4]; // [component][lane]
+			spvm_word InstCount[4];
+			spvm_word UBLastType[4], UBLastLine[4], UBCount[4];
+			uint8_t DivergedMask; // lanes that had to run without the rest of the quad at some point
+
+			inline glm::vec4 GetColor(int lane) const { return glm::vec4(Color[0][lane], Color[1][lane], Color[2][lane], Color[3][lane]); }
+		};
+		bool InitPixelShaderQuad(PixelShaderWorker* worker, PixelShaderQuad& quad); // false -> no pixel shader was prepared
+		void SetPixelShaderQuadInput(PixelShaderWorker* worker, PixelInformation& pixel, PixelShaderQuad& quad); // pixel.Coordinate -> lane 0
+		void ExecutePixelShaderQuad(PixelShaderWorker* worker, PixelShaderQuad& quad, int x, int y, uint8_t laneMask, int loc = 0); // laneMask -> pixels whose output is used
+		inline bool PixelShaderUsesDerivatives() { return m_psUsesDerivatives; }
+
 		void PrepareGeometryShader(PipelineItem* pass, PipelineItem* item, PixelInformation* px = nullptr);
 		void SetGeometryShaderInput(PixelInformation& pixel);
 		void ExecuteGeometryShader();
@@ -144,6 +176,8 @@ namespace ed {
 		{
 			if (m_vm != nullptr)
 				m_vm->analyzer = analyze ? &m_analyzer : nullptr;
+			for (PixelShaderWorker* worker : m_pixelWorkers)
+				worker->VM->analyzer = analyze ? &m_analyzer : nullptr;
 		}
 		void OnUndefinedBehavior(spvm_state_t state, spvm_word ubID);
 		inline spvm_word GetLastUndefinedBehaviorType() { return m_ubLastType; }
@@ -166,8 +200,31 @@ namespace ed {
 		}
 		glm::vec3 m_getWeights(glm::vec2 a, glm::vec2 b, glm::vec2 c, glm::vec2 p);
 
-		glm::vec3 m_processWeight(glm::ivec2 offset);
-		void m_interpolateValues(spvm_state_t state, glm::vec3 weights);
+		glm::vec3 m_processWeight(const PixelInformation& px, glm::ivec2 offset);
+		void m_interpolateValues(const PixelInformation& px, spvm_state_t state, glm::vec3 weights);
+		float m_setPixelShaderInput(spvm_state_t vm, const PixelInformation& pixel);
+
+		// pixel shader inputs & outputs that are used for each pixel - built on first use after m_setupVM()
+		struct InterpolatedInput {
+			spvm_word Slot;
+			int OutputIndex; // index in the previous stage's output list
+			spvm_value_type Type;
+			spvm_word BitCount;
+		};
+		std::vector<InterpolatedInput> m_psInputs[2]; // [0] -> vertex shader output, [1] -> geometry shader output
+		std::atomic<bool> m_psInputsCached[2];
+		std::vector<std::pair<spvm_word, int>> m_psOutputs; // slot, location
+		std::atomic<bool> m_psOutputsCached;
+		std::mutex m_psCacheMutex;
+		const std::vector<InterpolatedInput>& m_getInterpolatedInputs(const PixelInformation& px, spvm_state_t state);
+		glm::vec4 m_executePixelShader(spvm_state_t vm, int x, int y, int loc);
+		glm::vec4 m_getPixelShaderOutput(spvm_state_t vm, int loc);
+		spvm_word m_getPixelShaderEntryPoint(spvm_state_t vm);
+
+		bool m_psUsesDerivatives; // helper lanes only have to run for OpDPdx & co.
+		spvm_state_t m_quadLanes[4]; // lanes of the debugger's own quad - created with the workers
+		spvm_state_t m_createQuadLane();
+		void m_executeQuadDerivative(PixelShaderQuad& quad, uint8_t laneMask);
 
 		std::vector<spvm_image_t> m_images; // TODO: clear these + smart cache
 
@@ -195,6 +252,12 @@ namespace ed {
 		void m_setupWorkgroup();
 		std::vector<OriginalValue> m_originalValues;
 		void m_setThreadID(spvm_state_t state, int x, int y, int z, int numGroupsX, int numGroupsY, int numGroupsZ);
+		void m_shareUniforms(spvm_state_t worker, std::vector<OriginalValue>& originalValues);
+		void m_copyUniformsToDerivatives(spvm_state_t vm);
+
+		std::vector<PixelShaderWorker*> m_pixelWorkers;
+		std::vector<OriginalValue> m_pixelWorkerValues;
+		void m_deletePixelShaderWorkers();
 		
 		void m_copyUniforms(PipelineItem* pass, PipelineItem* item, PixelInformation* px = nullptr);
 		void m_setupVM(std::vector<unsigned int>& spv);
@@ -3,9 +3,12 @@
 #include <SHADERed/Objects/ShaderCompiler.h>
 #include <SHADERed/Objects/Names.h>
 #include <SHADERed/Objects/BinaryVectorReader.h>
+#include <SHADERed/Objects/Settings.h>
 #include <SHADERed/Engine/GeometryFactory.h>
+#include <SHADERed/Engine/ThreadPool.h>
 
 #include <thread>
+#include <atomic>
 #include <algorithm>
 #include <glm/gtc/type_ptr.hpp>
 
@@ -15,11 +18,23 @@
 namespace ed {
 	FrameAnalysis::EdgeEquation::EdgeEquation(const glm::ivec2& v0, const glm::ivec2& v1)
 	{
-		a = v0.y - v1.y;
-		b = v1.x - v0.x;
-		c = -(a * (v0.x + v1.x) + b * (v0.y + v1.y)) / 2.0f;
+		a = 2 * ((int64_t)v0.y - v1.y);
+		b = 2 * ((int64_t)v1.x - v0.x);
+		c = -(a * ((int64_t)v0.x + v1.x) + b * ((int64_t)v0.y + v1.y)) / 2;
 		tie = a != 0 ? a > 0 : b > 0;
 	}
+	FrameAnalysis::Coverage FrameAnalysis::m_getCoverage(EdgeEquation& e1, EdgeEquation& e2, EdgeEquation& e3, int x0, int y0, int x1, int y1)
+	{
+		// rectangle is completely outside of one of the edges
+		if (!e1.Test(e1.Max(x0, y0, x1, y1)) || !e2.Test(e2.Max(x0, y0, x1, y1)) || !e3.Test(e3.Max(x0, y0, x1, y1)))
+			return Coverage::None;
+
+		// or completely inside of all of them
+		if (e1.Test(e1.Min(x0, y0, x1, y1)) && e2.Test(e2.Min(x0, y0, x1, y1)) && e3.Test(e3.Min(x0, y0, x1, y1)))
+			return Coverage::Full;
+
+		return Coverage::Partial;
+	}
 	glm::vec3 getHeatmapColor(float value)
 	{
 		const glm::vec3 color[5] = { glm::vec3(0, 0, 1), glm::vec3(0, 1, 1), glm::vec3(0, 1, 0), glm::vec3(1, 1, 0), glm::vec3(1, 0, 0) };
@@ -45,17 +60,16 @@ namespace ed {
 
 	FrameAnalysis::FrameAnalysis(DebugInformation* dbgr, RenderEngine* renderer, PipelineManager* pipeline, ObjectManager* objects, MessageStack* msgs)
 	{
-		m_depth = nullptr;
-		m_color = nullptr;
-		m_instCount = nullptr;
-		m_ub = nullptr;
 		m_pass = nullptr;
-		m_bkpt = nullptr;
 
 		m_width = 0;
 		m_height = 0;
+		m_tilesX = m_tilesY = 0;
+		m_clearColor = 0;
 		m_hasBreakpoints = false;
 		m_isRegion = false;
+		m_singleThreaded = false;
+		m_compiled = nullptr;
 		m_instCountAvg = m_instCountAvgN = m_instCountMax = 0;
 		m_pixelCount = m_pixelsDiscarded = m_pixelsUB = m_pixelsFailedDepthTest = 0;
 		m_triangleCount = m_trianglesDiscarded = 0;
@@ -214,32 +228,31 @@ namespace ed {
 
 	void FrameAnalysis::m_clean()
 	{
-		if (m_depth != nullptr) {
-			free(m_depth);
-			m_depth = nullptr;
-		}
+		for (FrameTile* tile : m_tiles)
+			delete tile;
+		m_tiles.clear();
 
-		if (m_color != nullptr) {
-			free(m_color);
-			m_color = nullptr;
-		}
+		m_background.clear();
+		m_background.shrink_to_fit();
+	}
+	FrameAnalysis::FrameTile* FrameAnalysis::m_allocateTile(int x, int y)
+	{
+		FrameTile*& tile = m_tiles[(y / RASTER_TILE_SIZE) * m_tilesX + x / RASTER_TILE_SIZE];
+		if (tile != nullptr)
+			return tile;
 
-		if (m_instCount != nullptr) {
-			free(m_instCount);
-			m_instCount = nullptr;
-		}
+		tile = new FrameTile();
 
-		if (m_ub != nullptr) {
-			free(m_ub);
-			m_ub = nullptr;
-		}
-		
-		if (m_bkpt != nullptr) {
-			free(m_bkpt);
-			m_bkpt = nullptr;
-		}
+		// fill with whatever was there before the analysis
+		int startX = x & ~(RASTER_TILE_SIZE - 1), startY = y & ~(RASTER_TILE_SIZE - 1);
+		for (int ty = 0; ty < RASTER_TILE_SIZE; ty++)
+			for (int tx = 0; tx < RASTER_TILE_SIZE; tx++)
+				tile->Color[ty * RASTER_TILE_SIZE + tx] = (startX + tx < m_width && startY + ty < m_height) ? m_getBackground(startX + tx, startY + ty) : 0;
+		std::fill(tile->Depth, tile->Depth + RASTER_TILE_SIZE * RASTER_TILE_SIZE, FLT_MAX);
+
+		return tile;
 	}
-	void FrameAnalysis::m_copyVBOData(eng::Model::Mesh::Vertex& vertex, GLfloat* vbo, int stride)
+	void FrameAnalysis::m_copyVBOData(eng::Model::Mesh::Vertex& vertex, const GLfloat* vbo, int stride)
 	{
 		if (stride == 18) {
 			vertex.Position = glm::vec3(vbo[0], vbo[1], vbo[2]);
@@ -297,21 +310,12 @@ namespace ed {
 	{
 		m_clean();
 
-		m_depth = (float*)malloc(width * height * sizeof(float));
-		m_color = (uint32_t*)malloc(width * height * sizeof(uint32_t));
-		m_instCount = (uint32_t*)calloc(width * height, sizeof(uint32_t));
-		m_ub = (uint32_t*)calloc(width * height, sizeof(uint32_t));
-
-		if (m_hasBreakpoints)
-			m_bkpt = (uint8_t*)calloc(width * height, sizeof(uint8_t));
+		// tiles are allocated in RenderTriangle()
+		m_tilesX = (width + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+		m_tilesY = (height + RASTER_TILE_SIZE - 1) / RASTER_TILE_SIZE;
+		m_tiles.resize(m_tilesX * m_tilesY, nullptr);
 
-		uint32_t clearColorU32 = m_encodeColor(clearColor);
-
-		for (size_t x = 0; x < width; x++)
-			for (size_t y = 0; y < height; y++) {
-				m_color[y * width + x] = clearColorU32;
-				m_depth[y * width + x] = FLT_MAX;
-			}
+		m_clearColor = m_encodeColor(clearColor);
 
 		m_width = width;
 		m_height = height;
@@ -336,10 +340,12 @@ namespace ed {
 		glBindTexture(GL_TEXTURE_2D, tex);
 		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
 		glBindTexture(GL_TEXTURE_2D, 0);
-		for (size_t x = 0; x < width; x++)
-			for (size_t y = 0; y < height; y++) {
+
+		m_background.resize(width * height);
+		for (size_t y = 0; y < height; y++)
+			for (size_t x = 0; x < width; x++) {
 				uint8_t* px = &pixels[(y * width + x) * 4];
-				m_color[y * width + x] = px[0] | px[1] << 8 | px[2] << 16 | 0x77000000;
+				m_background[y * width + x] = px[0] | px[1] << 8 | px[2] << 16 | 0x77000000;
 			}
 
 		free(pixels);
@@ -384,12 +390,18 @@ namespace ed {
 					pipe::GeometryItem* geom = (pipe::GeometryItem*)item->Data;
 					const int vCount = ed::eng::GeometryFactory::VertexCount[geom->Type];
 					const int vStride = geom->Type == pipe::GeometryItem::GeometryType::ScreenQuadNDC ? 4 : 18;
-					float* vbo = (float*)malloc(vCount * vStride * sizeof(float));
-					
-					// get vertex data on the cpu
-					glBindBuffer(GL_ARRAY_BUFFER, geom->VBO); // TODO: don't bother GPU so much
-					glGetBufferSubData(GL_ARRAY_BUFFER, 0, vCount * vStride * sizeof(float), &vbo[0]);
-					glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+					// get vertex data on the cpu - GeometryFactory keeps a copy of everything it uploads
+					const std::vector<float>* vertData = ed::eng::GeometryFactory::GetVertexData(geom->VBO);
+					std::vector<float> readback;
+					if (vertData == nullptr) {
+						readback.resize(vCount * vStride);
+						glBindBuffer(GL_ARRAY_BUFFER, geom->VBO);
+						glGetBufferSubData(GL_ARRAY_BUFFER, 0, vCount * vStride * sizeof(float), readback.data());
+						glBindBuffer(GL_ARRAY_BUFFER, 0);
+						vertData = &readback;
+					}
+					const float* vbo = vertData->data();
 
 					// loop through all vertices
 					const uint8_t pSize = 3;
@@ -398,9 +410,6 @@ namespace ed {
 							m_copyVBOData(m_pixel.Vertex[v], vbo + (p + v) * vStride, vStride);
 						RenderPrimitive(item, p, pSize, geom->Topology);
 					}
-
-					// free memory
-					free(vbo);
 				}
 				// 3D model
 				else if (item->Type == PipelineItem::ItemType::Model) {
@@ -414,7 +423,7 @@ namespace ed {
 								m_pixel.Vertex[1] = mesh.Vertices[mesh.Indices[p + 1]];
 								m_pixel.Vertex[2] = mesh.Vertices[mesh.Indices[p + 2]];
 
-								RenderPrimitive(item, p, 3, GL_TRIANGLES);
+								RenderPrimitive(item, mesh.IndexOffset + p, 3, GL_TRIANGLES);
 							}
 						}
 					}
@@ -437,11 +446,11 @@ namespace ed {
 					for (const auto& dataEl : tData)
 						stride += ShaderVariable::GetSize(dataEl, true);
 
-					GLfloat* bufPtr = (GLfloat*)malloc(bufData->Size);
-
-					glBindBuffer(GL_ARRAY_BUFFER, bufData->ID);
-					glGetBufferSubData(GL_ARRAY_BUFFER, 0, bufData->Size, &bufPtr[0]);
-					glBindBuffer(GL_ARRAY_BUFFER, 0);
+					// CPU copy is read back only if the buffer was written by a shader
+					m_objects->SyncBuffer(bufData);
+					if (stride == 0 || bufData->Data == nullptr)
+						continue;
+					const GLfloat* bufPtr = (const GLfloat*)bufData->Data;
 
 					for (int p = 0; p < bufData->Size / stride; p += vertexCount) {
 						// copy primitive data
@@ -463,8 +472,6 @@ namespace ed {
 						// render it
 						RenderPrimitive(item, p, vertexCount, vBuffer->Topology);
 					}
-
-					free(bufPtr);
 				} 
 			}
 		}
@@ -551,7 +558,7 @@ namespace ed {
 
 		// check if backfacing
 		m_triangleCount++;
-		if (edge1.c + edge2.c + edge3.c < 0.0f) {
+		if (edge1.c + edge2.c + edge3.c < 0) {
 			m_trianglesDiscarded++;
 			return;
 		}
@@ -570,85 +577,397 @@ namespace ed {
 		minY &= ~(RASTER_BLOCK_SIZE - 1);
 		maxY &= ~(RASTER_BLOCK_SIZE - 1);
 
+		// find the blocks that touch the triangle - 64x64 tiles first, then the 8x8 blocks in the tiles that are partially covered
+		m_blocks.clear();
+		int tileStartX = minX & ~(RASTER_TILE_SIZE - 1);
+		int tileStartY = minY & ~(RASTER_TILE_SIZE - 1);
+		for (int tileY = tileStartY; tileY <= maxY; tileY += RASTER_TILE_SIZE) {
+			for (int tileX = tileStartX; tileX <= maxX; tileX += RASTER_TILE_SIZE) {
+				int blockStartX = std::max<int>(tileX, minX), blockEndX = std::min<int>(tileX + RASTER_TILE_SIZE - RASTER_BLOCK_SIZE, maxX);
+				int blockStartY = std::max<int>(tileY, minY), blockEndY = std::min<int>(tileY + RASTER_TILE_SIZE - RASTER_BLOCK_SIZE, maxY);
+
+				Coverage tileCoverage = m_getCoverage(edge1, edge2, edge3, blockStartX, blockStartY, blockEndX + RASTER_BLOCK_STEP, blockEndY + RASTER_BLOCK_STEP);
+				if (tileCoverage == Coverage::None)
+					continue;
+
+				for (int y = blockStartY; y <= blockEndY; y += RASTER_BLOCK_SIZE) {
+					for (int x = blockStartX; x <= blockEndX; x += RASTER_BLOCK_SIZE) {
+						Coverage blockCoverage = tileCoverage;
+						if (tileCoverage == Coverage::Partial) {
+							blockCoverage = m_getCoverage(edge1, edge2, edge3, x, y, x + RASTER_BLOCK_STEP, y + RASTER_BLOCK_STEP);
+							if (blockCoverage == Coverage::None)
+								continue;
+						}
+
+						m_allocateTile(x, y);
+
+						RasterBlock block;
+						block.X = x;
+						block.Y = y;
+						block.Inside = blockCoverage == Coverage::Full;
+						m_blocks.push_back(block);
+					}
+				}
+			}
+		}
+
+		// breakpoints use the debugger's VM & the shared breakpoint VMs -> always single threaded
+		int threadCount = 1;
+		if (!m_hasBreakpoints && !m_singleThreaded && Settings::Instance().Debug.ParallelAnalysis && m_blocks.size() >= RASTER_PARALLEL_MIN_BLOCKS)
+			threadCount = std::min<int>(eng::ThreadPool::Instance().GetThreadCount() + 1, m_blocks.size());
+
 		// init the renderer
-		// TODO: tested with threads, it was 3-4 times faster though there were some artifacts which appeared only *sometimes*... it's really slow rn :(
 		m_debugger->PreparePixelShader(m_pass, item, &m_pixel);
 		m_debugger->ToggleAnalyzer(true); // turn on the analyzer
-		for (int x = minX; x <= maxX; x += RASTER_BLOCK_SIZE) {
-			for (int y = minY; y <= maxY; y += RASTER_BLOCK_SIZE) {
-				// check if block is inside the triangle
-				// inspired by github.com/trenki2/SoftwareRenderer
-				bool btmLeft1 = edge1.Test(x, y), btmLeft2 = edge2.Test(x, y), btmLeft3 = edge3.Test(x, y), btmLeft = btmLeft1 && btmLeft2 && btmLeft3;
-				bool btmRight1 = edge1.Test(x + RASTER_BLOCK_STEP, y), btmRight2 = edge2.Test(x + RASTER_BLOCK_STEP, y), btmRight3 = edge3.Test(x + RASTER_BLOCK_STEP, y), btmRight = btmRight1 && btmRight2 && btmRight3;
-				bool topLeft1 = edge1.Test(x, y + RASTER_BLOCK_STEP), topLeft2 = edge2.Test(x, y + RASTER_BLOCK_STEP), topLeft3 = edge3.Test(x, y + RASTER_BLOCK_STEP), topLeft = topLeft1 && topLeft2 && topLeft3;
-				bool topRight1 = edge1.Test(x + RASTER_BLOCK_STEP, y + RASTER_BLOCK_STEP), topRight2 = edge2.Test(x + RASTER_BLOCK_STEP, y + RASTER_BLOCK_STEP), topRight3 = edge3.Test(x + RASTER_BLOCK_STEP, y + RASTER_BLOCK_STEP), topRight = topRight1 && topRight2 && topRight3;
-
-				int result = btmLeft + btmRight + topLeft + topRight;
-
-				// TODO: check if triangle and and rectangle don't intersect - skip the m_renderBlock
+		m_debugger->CreatePixelShaderWorkers(threadCount - 1);
+
+		// native pixel shader when nothing has to be stepped through - the VM's quads are needed for the derivatives
+		m_compiled = nullptr;
+		if (!m_hasBreakpoints && Settings::Instance().Debug.CompiledAnalysis && !m_debugger->PixelShaderUsesDerivatives())
+			m_compiled = CompiledShaderCache::Instance().Get(m_debugger->GetSPIRV());
+
+		// the calling thread uses the debugger's VM, others get their own VM & copy of the inputs
+		m_workers.resize(threadCount);
+		for (int i = 0; i < threadCount; i++) {
+			RasterWorker& worker = m_workers[i];
+			if (i == 0) {
+				worker.VM = nullptr;
+				worker.Pixel = &m_pixel;
+			} else {
+				worker.VM = m_debugger->GetPixelShaderWorker(i - 1);
+				worker.PixelCopy = m_pixel;
+				worker.Pixel = &worker.PixelCopy;
+			}
+			worker.PixelCount = worker.PixelsDiscarded = worker.PixelsUB = worker.PixelsFailedDepthTest = 0;
+			worker.InstCountMax = 0;
+			worker.UseQuads = !m_hasBreakpoints && m_debugger->InitPixelShaderQuad(worker.VM, worker.Quad);
+			worker.Compiled = m_compiled ? m_compiled->CreateInstance(m_debugger->GetVM()) : nullptr;
+			worker.HasHistory = false;
+		}
+
+		// workers take the next free block until there are none left
+		std::atomic<size_t> nextBlock(0);
+		auto renderBlocks = [&](int workerIndex) {
+			RasterWorker& worker = m_workers[workerIndex];
+			for (size_t b = nextBlock++; b < m_blocks.size(); b = nextBlock++) {
 				if (m_hasBreakpoints)
-					m_renderBlock<true>(m_debugger, x, y, result == 4, edge1, edge2, edge3);
+					m_renderBlock<true>(worker, m_blocks[b], edge1, edge2, edge3);
+				else if (worker.Compiled)
+					m_renderBlockCompiled(worker, m_blocks[b], edge1, edge2, edge3);
+				else if (worker.UseQuads)
+					m_renderBlockQuads(worker, m_blocks[b], edge1, edge2, edge3);
 				else
-					m_renderBlock<false>(m_debugger, x, y, result == 4, edge1, edge2, edge3);
+					m_renderBlock<false>(worker, m_blocks[b], edge1, edge2, edge3);
 			}
-		}
+		};
+
+		std::vector<std::future<void>> tasks;
+		for (int i = 1; i < threadCount; i++)
+			tasks.push_back(eng::ThreadPool::Instance().Enqueue([&renderBlocks, i]() { renderBlocks(i); }));
+		renderBlocks(0);
+		for (auto& task : tasks)
+			task.wait();
+
 		m_debugger->ToggleAnalyzer(false); // turn off the analyzer
-	}
 
-	float* FrameAnalysis::AllocateHeatmap()
+		// merge the statistics - the average is accumulated in the same order as the single threaded path
+		for (RasterWorker& worker : m_workers) {
+			m_pixelCount += worker.PixelCount;
+			m_pixelsDiscarded += worker.PixelsDiscarded;
+			m_pixelsUB += worker.PixelsUB;
+			m_pixelsFailedDepthTest += worker.PixelsFailedDepthTest;
+			m_instCountMax = std::max<int>(m_instCountMax, worker.InstCountMax);
+
+			if (worker.Compiled) {
+				m_compiled->DestroyInstance(worker.Compiled);
+				worker.Compiled = nullptr;
+			}
+
+			if (worker.HasHistory) {
+				bool exists = false;
+				for (const auto& pixel : m_debugger->GetPixelList())
+					if (pixel.Object == worker.History.Object && pixel.VertexID == worker.History.VertexID) {
+						exists = true;
+						break;
+					}
+
+				if (!exists)
+					m_debugger->AddPixel(worker.History);
+			}
+		}
+		for (const RasterBlock& block : m_blocks) {
+			for (int instCount : block.InstCounts) {
+				m_instCountAvgN++;
+				m_instCountAvg = m_instCountAvg + (instCount - m_instCountAvg) / m_instCountAvgN;
+			}
+		}
+	}
+	void FrameAnalysis::m_renderBlockQuads(RasterWorker& worker, RasterBlock& block, EdgeEquation& e1, EdgeEquation& e2, EdgeEquation& e3)
 	{
-		float* tex = (float*)malloc(m_width * m_height * 3 * sizeof(float));
+		PixelInformation& pixel = *worker.Pixel;
+		DebugInformation::PixelShaderQuad& quad = worker.Quad;
+
+		int endX = std::min<int>(m_width, block.X + RASTER_BLOCK_SIZE);
+		int endY = std::min<int>(m_height, block.Y + RASTER_BLOCK_SIZE);
+
+		FrameTile& tile = *m_getTile(block.X, block.Y);
+
+		// instruction counts are added in row-major order once the block is done, like m_renderBlock() does it
+		int instCounts[RASTER_BLOCK_SIZE * RASTER_BLOCK_SIZE];
+		std::fill(instCounts, instCounts + RASTER_BLOCK_SIZE * RASTER_BLOCK_SIZE, -1);
+
+		// blocks start at a multiple of RASTER_BLOCK_SIZE -> quads start at even coordinates
+		for (int y = block.Y; y < endY; y += 2) {
+			for (int x = block.X; x < endX; x += 2) {
+				uint8_t covered = 0;
+				for (int i = 0; i < 4; i++) {
+					int laneX = x + (i & 1), laneY = y + (i >> 1);
+					if (laneX < endX && laneY < endY && (block.Inside || (e1.Test(laneX, laneY) && e2.Test(laneX, laneY) && e3.Test(laneX, laneY))))
+						covered |= 1 << i;
+				}
+				if (covered == 0)
+					continue;
 
-		for (int y = 0; y < m_height; y++) {
-			for (int x = 0; x < m_width; x++) {
-				float val = m_instCount[y * m_width + x] / (float)m_instCountMax;
-				glm::vec3 color = getHeatmapColor(val);
-				tex[(y * m_width + x) * 3 + 0] = color.r;
-				tex[(y * m_width + x) * 3 + 1] = color.g;
-				tex[(y * m_width + x) * 3 + 2] = color.b; 
+				// prepare inputs for the whole quad
+				pixel.Coordinate = glm::ivec2(x, y);
+				m_debugger->SetPixelShaderQuadInput(worker.VM, pixel, quad);
+
+				// TODO: OpExecutionMode DepthReplacing -> execute pixel shader, then go through depth test
+				uint8_t shaded = 0;
+				for (int i = 0; i < 4; i++) {
+					if (!(covered & (1 << i)))
+						continue;
+
+					if (quad.Depth[i] <= tile.Depth[m_getTileIndex(x + (i & 1), y + (i >> 1))])
+						shaded |= 1 << i;
+					else
+						worker.PixelsFailedDepthTest++;
+				}
+				if (shaded == 0)
+					continue;
+
+				m_debugger->ExecutePixelShaderQuad(worker.VM, quad, x, y, shaded, pixel.RenderTextureIndex);
+
+				for (int i = 0; i < 4; i++) {
+					if (!(shaded & (1 << i)))
+						continue;
+
+					if (quad.Lanes[i]->discarded) {
+						worker.PixelsDiscarded++;
+						continue;
+					}
+
+					int laneX = x + (i & 1), laneY = y + (i >> 1);
+					int index = m_getTileIndex(laneX, laneY);
+
+					// actual color and depth
+					glm::vec4 color = quad.GetColor(i);
+					tile.Color[index] = m_encodeColor(color);
+					tile.Depth[index] = quad.Depth[i];
+					worker.PixelCount++;
+
+					// instruction count / heatmap stuff
+					int instCount = quad.InstCount[i];
+					tile.InstCount[index] = instCount;
+					worker.InstCountMax = std::max<int>(worker.InstCountMax, instCount);
+					instCounts[(laneY - block.Y) * RASTER_BLOCK_SIZE + laneX - block.X] = instCount;
+
+					// undefined behavior
+					tile.UB[index] = (quad.UBLastType[i] & 0x000000FF) | ((quad.UBCount[i] << 8) & 0x00000F00) | ((quad.UBLastLine[i] << 12) & 0xFFFFF000);
+					worker.PixelsUB += (quad.UBLastType[i] > 0);
+
+					// pixel history - added to the debugger after the triangle is done
+					if (m_pixelHistoryLocation == glm::ivec2(laneX, laneY)) {
+						pixel.Coordinate = glm::ivec2(laneX, laneY);
+						pixel.RelativeCoordinate = glm::vec2(laneX, laneY) / glm::vec2(pixel.RenderTextureSize);
+						pixel.DebuggerColor = color;
+
+						worker.History = pixel;
+						worker.History.Color = pixel.DebuggerColor;
+						worker.History.History = true;
+						worker.HasHistory = true;
+					}
+				}
 			}
 		}
 
-		return tex;
+		for (int instCount : instCounts)
+			if (instCount >= 0)
+				block.InstCounts.push_back(instCount);
 	}
-	uint32_t* FrameAnalysis::AllocateUndefinedBehaviorMap()
+	void FrameAnalysis::m_renderBlockCompiled(RasterWorker& worker, RasterBlock& block, EdgeEquation& e1, EdgeEquation& e2, EdgeEquation& e3)
+	{
+		PixelInformation& pixel = *worker.Pixel;
+		spvm_state_t vm = worker.VM ? worker.VM->VM : m_debugger->GetVM();
+
+		int endX = std::min<int>(m_width, block.X + RASTER_BLOCK_SIZE);
+		int endY = std::min<int>(m_height, block.Y + RASTER_BLOCK_SIZE);
+
+		FrameTile& tile = *m_getTile(block.X, block.Y);
+
+		int64_t row1 = e1.Evaluate(block.X, block.Y), row2 = e2.Evaluate(block.X, block.Y), row3 = e3.Evaluate(block.X, block.Y);
+		for (int y = block.Y; y < endY; y++, row1 += e1.b, row2 += e2.b, row3 += e3.b) {
+			int64_t w1 = row1, w2 = row2, w3 = row3;
+			for (int x = block.X; x < endX; x++, w1 += e1.a, w2 += e2.a, w3 += e3.a) {
+				if (!block.Inside && !(e1.Test(w1) && e2.Test(w2) && e3.Test(w3)))
+					continue;
+
+				int index = m_getTileIndex(x, y);
+
+				pixel.Coordinate = glm::ivec2(x, y);
+				pixel.RelativeCoordinate = glm::vec2(x, y) / glm::vec2(pixel.RenderTextureSize);
+
+				// the VM still interpolates the inputs & calculates the depth
+				float depth = worker.VM ? m_debugger->SetPixelShaderInput(worker.VM, pixel) : m_debugger->SetPixelShaderInput(pixel);
+				if (depth > tile.Depth[index]) {
+					worker.PixelsFailedDepthTest++;
+					continue;
+				}
+
+				CompiledShader::Stats stats;
+				if (!m_compiled->Execute(worker.Compiled, vm, x, y, pixel.RenderTextureIndex, pixel.DebuggerColor, stats)) {
+					worker.PixelsDiscarded++;
+					continue;
+				}
+
+				tile.Color[index] = m_encodeColor(pixel.DebuggerColor);
+				tile.Depth[index] = depth;
+				worker.PixelCount++;
+
+				int instCount = stats.InstructionCount;
+				tile.InstCount[index] = instCount;
+				worker.InstCountMax = std::max<int>(worker.InstCountMax, instCount);
+				block.InstCounts.push_back(instCount);
+
+				tile.UB[index] = (stats.UBLastType & 0x000000FF) | ((stats.UBCount << 8) & 0x00000F00) | ((stats.UBLastLine << 12) & 0xFFFFF000);
+				worker.PixelsUB += (stats.UBLastType > 0);
+
+				if (m_pixelHistoryLocation == pixel.Coordinate) {
+					worker.History = pixel;
+					worker.History.Color = pixel.DebuggerColor;
+					worker.History.History = true;
+					worker.HasHistory = true;
+				}
+			}
+		}
+	}
+
+	FrameAnalysis::Output FrameAnalysis::GetOutput()
 	{
-		uint32_t* tex = (uint32_t*)malloc(m_width * m_height * sizeof(uint32_t));
+		Output ret;
+		ret.Color.resize(m_width * m_height);
+		ret.Depth.resize(m_width * m_height);
+		ret.InstCount.resize(m_width * m_height);
+		ret.UB.resize(m_width * m_height);
 
 		for (int y = 0; y < m_height; y++) {
 			for (int x = 0; x < m_width; x++) {
-				uint32_t ubType = GetUndefinedBehaviorLastType(x, y);
+				FrameTile* tile = m_getTile(x, y);
+				int index = m_getTileIndex(x, y), outIndex = y * m_width + x;
 
-				if (ubType)
-					tex[y * m_width + x] = 0xFFFFFFFF;
-				else
-					tex[y * m_width + x] = (m_color[y * m_width + x] & 0x00FFFFFF) | 0x66000000; // darken the texture
+				ret.Color[outIndex] = tile ? tile->Color[index] : m_getBackground(x, y);
+				ret.Depth[outIndex] = tile ? tile->Depth[index] : FLT_MAX;
+				ret.InstCount[outIndex] = tile ? tile->InstCount[index] : 0;
+				ret.UB[outIndex] = tile ? tile->UB[index] : 0;
 			}
 		}
 
-		return tex;
+		ret.PixelCount = m_pixelCount;
+		ret.PixelsDiscarded = m_pixelsDiscarded;
+		ret.PixelsUB = m_pixelsUB;
+		ret.PixelsFailedDepthTest = m_pixelsFailedDepthTest;
+		ret.InstCountMax = m_instCountMax;
+		ret.InstCountAvg = m_instCountAvg;
+
+		return ret;
+	}
+	std::string FrameAnalysis::CompareOutput(const Output& a, const Output& b)
+	{
+		std::string ret;
+		auto addDifference = [&](const std::string& name, const std::string& info) {
+			ret += (ret.empty() ? "" : ", ") + name + " (" + info + ")";
+		};
+
+		if (a.Color.size() != b.Color.size())
+			return "output size";
+
+		// compare the bits, NaN depth/colors are still equal if they are the same NaN
+		auto comparePixels = [&](const std::string& name, const void* dataA, const void* dataB) {
+			const uint32_t* pxA = (const uint32_t*)dataA;
+			const uint32_t* pxB = (const uint32_t*)dataB;
+
+			size_t count = 0;
+			for (size_t i = 0; i < a.Color.size(); i++)
+				count += pxA[i] != pxB[i];
+
+			if (count != 0)
+				addDifference(name, std::to_string(count) + " pixels");
+		};
+		comparePixels("color", a.Color.data(), b.Color.data());
+		comparePixels("depth", a.Depth.data(), b.Depth.data());
+		comparePixels("instruction count", a.InstCount.data(), b.InstCount.data());
+		comparePixels("undefined behavior", a.UB.data(), b.UB.data());
+
+		auto compareValue = [&](const std::string& name, int64_t valA, int64_t valB) {
+			if (valA != valB)
+				addDifference(name, std::to_string(valA) + " vs " + std::to_string(valB));
+		};
+		compareValue("pixel count", a.PixelCount, b.PixelCount);
+		compareValue("discarded pixels", a.PixelsDiscarded, b.PixelsDiscarded);
+		compareValue("undefined behavior pixels", a.PixelsUB, b.PixelsUB);
+		compareValue("pixels that failed the depth test", a.PixelsFailedDepthTest, b.PixelsFailedDepthTest);
+		compareValue("max instruction count", a.InstCountMax, b.InstCountMax);
+		compareValue("average instruction count", a.InstCountAvg, b.InstCountAvg);
+
+		return ret;
+	}
+	uint32_t* FrameAnalysis::AllocateColorOutput()
+	{
+		return m_allocateImage([&](const FrameTile& tile, int index) {
+			return tile.Color[index];
+		}, [&](int x, int y) {
+			return m_getBackground(x, y);
+		});
+	}
+	uint32_t* FrameAnalysis::AllocateHeatmap()
+	{
+		uint32_t empty = m_encodeColor(glm::vec4(getHeatmapColor(0 / (float)m_instCountMax), 1.0f));
+
+		return m_allocateImage([&](const FrameTile& tile, int index) {
+			float val = tile.InstCount[index] / (float)m_instCountMax;
+			return m_encodeColor(glm::vec4(getHeatmapColor(val), 1.0f));
+		}, [&](int x, int y) {
+			return empty;
+		});
+	}
+	uint32_t* FrameAnalysis::AllocateUndefinedBehaviorMap()
+	{
+		return m_allocateImage([&](const FrameTile& tile, int index) {
+			if (tile.UB[index] & 0x000000FF)
+				return 0xFFFFFFFFu;
+			return (tile.Color[index] & 0x00FFFFFF) | 0x66000000; // darken the texture
+		}, [&](int x, int y) {
+			return (m_getBackground(x, y) & 0x00FFFFFF) | 0x66000000;
+		});
 	}
 	uint32_t* FrameAnalysis::AllocateGlobalBreakpointsMap()
 	{
 		if (!m_hasBreakpoints)
 			return nullptr;
 
-		uint32_t* tex = (uint32_t*)malloc(m_width * m_height * sizeof(uint32_t));
-
-		for (int y = 0; y < m_height; y++) {
-			for (int x = 0; x < m_width; x++) {
-				uint8_t bkpt = m_bkpt[y * m_width + x];
-
-				if (bkpt) {
-					for (uint8_t i = 0; i < 8; i++)
-						if (bkpt & (1 << i))
-							tex[y * m_width + x] = m_encodeColor(glm::vec4(m_breakpoint[i].Color, 1.0f));
-				} else
-					tex[y * m_width + x] = (m_color[y * m_width + x] & 0x00FFFFFF) | 0x66000000; // darken the texture
+		return m_allocateImage([&](const FrameTile& tile, int index) {
+			uint8_t bkpt = tile.Breakpoints[index];
+			if (bkpt) {
+				uint32_t ret = 0;
+				for (uint8_t i = 0; i < 8; i++)
+					if (bkpt & (1 << i))
+						ret = m_encodeColor(glm::vec4(m_breakpoint[i].Color, 1.0f));
+				return ret;
 			}
-		}
-
-		return tex;
+			return (tile.Color[index] & 0x00FFFFFF) | 0x66000000; // darken the texture
+		}, [&](int x, int y) {
+			return (m_getBackground(x, y) & 0x00FFFFFF) | 0x66000000;
+		});
 	}
 	void FrameAnalysis::m_variableViewerProcess(spvgentwo::Module* module, const spvgentwo::Function& func, const std::string& variableName, unsigned int line, spvgentwo::Instruction* outputInstruction, spvgentwo::Instruction*& inputInstruction, uint8_t& components)
 	{
@@ -817,7 +1136,8 @@ namespace ed {
 
 		std::string newGLSL = ed::ShaderCompiler::ConvertToGLSL(newSPV, ed::ShaderLanguage::GLSL, ed::ShaderStage::Pixel, passData->TSUsed, passData->GSUsed, nullptr, false);
 		
-		// input the new shader
+		// input the new shader - a queued compilation of the pass would replace it once it's linked
+		m_renderer->FinishCompilation(pass);
 		m_renderer->RecompileFromSource(pass->Name, "", newGLSL);
 		m_renderer->Render();
 
@@ -829,6 +1149,7 @@ namespace ed {
 
 		// return old shader
 		m_renderer->Recompile(pass->Name);
+		m_renderer->FinishCompilation(pass);
 		m_renderer->Render();
 
 		return returnData;
@@ -1,9 +1,13 @@
 #pragma once
 #include <SHADERed/Objects/PipelineItem.h>
 #include <SHADERed/Objects/DebugInformation.h>
+#include <SHADERed/Objects/Debug/CompiledShader.h>
 
+#define RASTER_TILE_SIZE 64 // coarse tiles -> rejected/accepted as a whole before looking at the blocks
 #define RASTER_BLOCK_SIZE 8
-#define RASTER_BLOCK_STEP RASTER_BLOCK_SIZE - 1
+#define RASTER_PARALLEL_MIN_BLOCKS 4 // smaller triangles aren't worth the extra VMs
+
+constexpr int RASTER_BLOCK_STEP = RASTER_BLOCK_SIZE - 1; // offset of a block's last pixel
 
 namespace ed {
 	class FrameAnalysis {
@@ -21,18 +25,23 @@ namespace ed {
 		void RenderPrimitive(PipelineItem* item, unsigned int vertexStart, uint8_t vertexCount, unsigned int topology);
 		void RenderTriangle(PipelineItem* item);
 
-		inline uint32_t* GetColorOutput() { return m_color; }
+		// the Allocate*() images are RGBA8 and ready for glTexImage2D - free() them after the upload
+		uint32_t* AllocateColorOutput();
 		inline glm::ivec2 GetOutputSize() { return glm::ivec2(m_width, m_height); }
 
-		float* AllocateHeatmap();
+		uint32_t* AllocateHeatmap();
 		inline uint32_t GetHeatmapMax() { return m_instCountMax; }
-		inline uint32_t GetInstructionCount(int x, int y) { return m_instCount[y * m_width + x]; }
+		inline uint32_t GetInstructionCount(int x, int y)
+		{
+			FrameTile* tile = m_getTile(x, y);
+			return tile ? tile->InstCount[m_getTileIndex(x, y)] : 0;
+		}
 		inline uint32_t GetInstructionCountAverage() { return m_instCountAvg; }
 
 		uint32_t* AllocateUndefinedBehaviorMap();
-		inline uint32_t GetUndefinedBehaviorLastLine(int x, int y) { return (m_ub[y * m_width + x] & 0xFFFFF000) >> 12; }
-		inline uint32_t GetUndefinedBehaviorCount(int x, int y) { return (m_ub[y * m_width + x] & 0x00000F00) >> 8; }
-		inline uint32_t GetUndefinedBehaviorLastType(int x, int y) { return (m_ub[y * m_width + x] & 0x000000FF); }
+		inline uint32_t GetUndefinedBehaviorLastLine(int x, int y) { return (m_getUndefinedBehavior(x, y) & 0xFFFFF000) >> 12; }
+		inline uint32_t GetUndefinedBehaviorCount(int x, int y) { return (m_getUndefinedBehavior(x, y) & 0x00000F00) >> 8; }
+		inline uint32_t GetUndefinedBehaviorLastType(int x, int y) { return (m_getUndefinedBehavior(x, y) & 0x000000FF); }
 
 		inline uint32_t GetPixelCount() { return m_pixelCount; }
 		inline uint32_t GetPixelsDiscarded() { return m_pixelsDiscarded; }
@@ -47,28 +56,52 @@ namespace ed {
 
 		float* AllocateVariableValueMap(PipelineItem* pass, const std::string& variableName, unsigned int line, uint8_t& components);
 
+		// full frame copy of the results - lets PreviewUI check at runtime that the multi-threaded analysis matches the single-threaded one
+		struct Output {
+			std::vector<uint32_t> Color, InstCount, UB;
+			std::vector<float> Depth;
+			uint32_t PixelCount, PixelsDiscarded, PixelsUB, PixelsFailedDepthTest;
+			int InstCountMax, InstCountAvg;
+		};
+		Output GetOutput();
+		static std::string CompareOutput(const Output& a, const Output& b); // empty string -> bit-for-bit identical
+		inline void SetSingleThreaded(bool singleThreaded) { m_singleThreaded = singleThreaded; }
+
 	private:
+		// a, b & c are doubled so that the edge function can be evaluated exactly with integers
 		class EdgeEquation {
 		public:
-			float a;
-			float b;
-			float c;
+			int64_t a;
+			int64_t b;
+			int64_t c;
 			bool tie;
 
 			EdgeEquation(const glm::ivec2& v0, const glm::ivec2& v1);
 			
+			inline int64_t Evaluate(int x, int y) {
+				return a * x + b * y + c;
+			}
+			inline bool Test(int64_t v) {
+				return (v > 0 || v == 0 && tie);
+			}
 			inline bool Test(int x, int y) {
-				return m_test(m_evaluate(x, y));
+				return Test(Evaluate(x, y));
 			}
 
-		private:
-			inline float m_evaluate(int x, int y) {
-				return a * x + b * y + c;
+			// the edge function is linear -> its extremes over a rectangle are at the corners
+			inline int64_t Min(int x0, int y0, int x1, int y1) {
+				return c + std::min<int64_t>(a * x0, a * x1) + std::min<int64_t>(b * y0, b * y1);
 			}
-			inline bool m_test(float v) {
-				return (v > 0 || v == 0 && tie);
+			inline int64_t Max(int x0, int y0, int x1, int y1) {
+				return c + std::max<int64_t>(a * x0, a * x1) + std::max<int64_t>(b * y0, b * y1);
 			}
 		};
+		enum class Coverage {
+			None,
+			Partial,
+			Full
+		};
+		Coverage m_getCoverage(EdgeEquation& e1, EdgeEquation& e2, EdgeEquation& e3, int x0, int y0, int x1, int y1);
 
 		DebugInformation* m_debugger;
 		RenderEngine* m_renderer;
@@ -77,21 +110,57 @@ namespace ed {
 		MessageStack* m_msgs;
 
 		bool m_isRegion;
+		bool m_singleThreaded;
 		int m_regionX, m_regionY, m_regionEndX, m_regionEndY;
 
-		float* m_depth;
-		uint32_t* m_color;
 		int m_width, m_height;
 
+		// output is stored in RASTER_TILE_SIZE x RASTER_TILE_SIZE tiles which are only allocated once a triangle covers them
+		struct FrameTile {
+			uint32_t Color[RASTER_TILE_SIZE * RASTER_TILE_SIZE];
+			float Depth[RASTER_TILE_SIZE * RASTER_TILE_SIZE];
+			uint32_t InstCount[RASTER_TILE_SIZE * RASTER_TILE_SIZE];
+			uint32_t UB[RASTER_TILE_SIZE * RASTER_TILE_SIZE];
+			uint8_t Breakpoints[RASTER_TILE_SIZE * RASTER_TILE_SIZE];
+		};
+		std::vector<FrameTile*> m_tiles; // nullptr -> nothing was rendered there
+		int m_tilesX, m_tilesY;
+
+		uint32_t m_clearColor;
+		std::vector<uint32_t> m_background; // darkened copy of the frame when analyzing a region, empty -> m_clearColor
+
+		inline FrameTile* m_getTile(int x, int y) { return m_tiles[(y / RASTER_TILE_SIZE) * m_tilesX + x / RASTER_TILE_SIZE]; }
+		inline int m_getTileIndex(int x, int y) { return (y % RASTER_TILE_SIZE) * RASTER_TILE_SIZE + x % RASTER_TILE_SIZE; }
+		inline uint32_t m_getBackground(int x, int y) { return m_background.empty() ? m_clearColor : m_background[y * m_width + x]; }
+		inline uint32_t m_getUndefinedBehavior(int x, int y)
+		{
+			FrameTile* tile = m_getTile(x, y);
+			return tile ? tile->UB[m_getTileIndex(x, y)] : 0;
+		}
+		FrameTile* m_allocateTile(int x, int y);
+
+		// getPixel(tile, index) for the allocated tiles, getEmpty(x, y) for the rest
+		template <typename TileFn, typename EmptyFn>
+		uint32_t* m_allocateImage(TileFn getPixel, EmptyFn getEmpty)
+		{
+			uint32_t* tex = (uint32_t*)malloc(m_width * m_height * sizeof(uint32_t));
+
+			for (int y = 0; y < m_height; y++) {
+				for (int x = 0; x < m_width; x++) {
+					FrameTile* tile = m_getTile(x, y);
+					tex[y * m_width + x] = tile ? getPixel(*tile, m_getTileIndex(x, y)) : getEmpty(x, y);
+				}
+			}
+
+			return tex;
+		}
+
 		glm::ivec2 m_pixelHistoryLocation;
 
 		uint32_t m_pixelCount, m_pixelsDiscarded, m_pixelsUB, m_pixelsFailedDepthTest;
 		uint32_t m_triangleCount, m_trianglesDiscarded;
 
 		int m_instCountMax, m_instCountAvg, m_instCountAvgN;
-		uint32_t* m_instCount;
-
-		uint32_t* m_ub;
 
 		bool m_hasBreakpoints;
 		struct BreakpointData {
@@ -109,7 +178,6 @@ namespace ed {
 			spvm_state_t VM;
 		};
 		std::vector<BreakpointData> m_breakpoint;
-		uint8_t* m_bkpt;
 
 		std::vector<unsigned int>* m_getPixelShaderSPV(const char* path);
 		void m_cacheBreakpoint(int index);
@@ -122,7 +190,7 @@ namespace ed {
 		void m_variableViewerProcess(spvgentwo::Module* module, const spvgentwo::Function& func, const std::string& variableName, unsigned int line, spvgentwo::Instruction* outputInstruction, spvgentwo::Instruction*& inputInstruction, uint8_t& components);
 
 		void m_clean();
-		void m_copyVBOData(eng::Model::Mesh::Vertex& vertex, GLfloat* vbo, int stride);
+		void m_copyVBOData(eng::Model::Mesh::Vertex& vertex, const GLfloat* vbo, int stride);
 		inline uint32_t m_encodeColor(const glm::vec4& color)
 		{
 			return (uint32_t)(color.r * 255) | (uint32_t)(color.g * 255) << 8 |
@@ -131,66 +199,105 @@ namespace ed {
 
 		glm::vec4 m_executePixelShaderWithBreakpoints(int x, int y, uint8_t& res, int loc = 0);
 
+		// state of one rasterizer thread - the statistics are merged once the triangle is done
+		struct RasterWorker {
+			DebugInformation::PixelShaderWorker* VM; // nullptr -> debugger's own VM
+			PixelInformation* Pixel;				 // private copy of the interpolated inputs (or m_pixel)
+			PixelInformation PixelCopy;
+
+			uint32_t PixelCount, PixelsDiscarded, PixelsUB, PixelsFailedDepthTest;
+			int InstCountMax;
+
+			bool UseQuads; // shade 2x2 quads in lockstep instead of one pixel at a time
+			DebugInformation::PixelShaderQuad Quad;
+
+			void* Compiled; // instance of m_compiled, nullptr -> VM
+
+			bool HasHistory;
+			PixelInformation History;
+		};
+		struct RasterBlock {
+			int X, Y;
+			bool Inside;				 // block is fully covered by the triangle
+			std::vector<int> InstCounts; // in the order in which the pixels were shaded
+		};
+		std::vector<RasterWorker> m_workers;
+		std::vector<RasterBlock> m_blocks;
+
+		// same results as m_renderBlock<false>(), the pixels are just shaded a quad at a time
+		void m_renderBlockQuads(RasterWorker& worker, RasterBlock& block, EdgeEquation& e1, EdgeEquation& e2, EdgeEquation& e3);
+
+		// m_renderBlock<false>() with the pixel shader running as native code - the VM only interpolates the inputs.
+		// instruction counts are per basic block, so the heatmap is close to the VM's but not exact
+		void m_renderBlockCompiled(RasterWorker& worker, RasterBlock& block, EdgeEquation& e1, EdgeEquation& e2, EdgeEquation& e3);
+		CompiledShader* m_compiled; // pixel shader of the current triangle, nullptr -> VM
+
 		template <bool hasBreakpoints>
-		void m_renderBlock(DebugInformation* renderer, size_t startX, size_t startY, bool skipChecks, EdgeEquation& e1, EdgeEquation& e2, EdgeEquation& e3)
+		void m_renderBlock(RasterWorker& worker, RasterBlock& block, EdgeEquation& e1, EdgeEquation& e2, EdgeEquation& e3)
 		{
-			for (size_t x = startX; x < std::min<size_t>(m_width, startX + RASTER_BLOCK_SIZE); x++) {
-				for (size_t y = startY; y < std::min<size_t>(m_height, startY + RASTER_BLOCK_SIZE); y++) {
-					if (skipChecks || (e1.Test(x, y) && e2.Test(x, y) && e3.Test(x, y))) {
-						m_pixel.Coordinate = glm::ivec2(x, y);
-						m_pixel.RelativeCoordinate = glm::vec2(x, y) / glm::vec2(m_pixel.RenderTextureSize);
+			PixelInformation& pixel = *worker.Pixel;
+			spvm_state_t vm = worker.VM ? worker.VM->VM : m_debugger->GetVM();
+
+			size_t endX = std::min<size_t>(m_width, block.X + RASTER_BLOCK_SIZE);
+			size_t endY = std::min<size_t>(m_height, block.Y + RASTER_BLOCK_SIZE);
+
+			// blocks never cross tiles - RenderTriangle() allocates the tile before the block gets here
+			FrameTile& tile = *m_getTile(block.X, block.Y);
+
+			// row-major like the framebuffer, edge functions are stepped incrementally
+			int64_t row1 = e1.Evaluate(block.X, block.Y), row2 = e2.Evaluate(block.X, block.Y), row3 = e3.Evaluate(block.X, block.Y);
+			for (size_t y = block.Y; y < endY; y++, row1 += e1.b, row2 += e2.b, row3 += e3.b) {
+				int64_t w1 = row1, w2 = row2, w3 = row3;
+				for (size_t x = block.X; x < endX; x++, w1 += e1.a, w2 += e2.a, w3 += e3.a) {
+					if (block.Inside || (e1.Test(w1) && e2.Test(w2) && e3.Test(w3))) {
+						int index = m_getTileIndex(x, y);
+
+						pixel.Coordinate = glm::ivec2(x, y);
+						pixel.RelativeCoordinate = glm::vec2(x, y) / glm::vec2(pixel.RenderTextureSize);
 
 						// prepare inputs & calculate
-						float depth = renderer->SetPixelShaderInput(m_pixel);
+						float depth = worker.VM ? m_debugger->SetPixelShaderInput(worker.VM, pixel) : m_debugger->SetPixelShaderInput(pixel);
 
-						if (depth <= m_depth[y * m_width + x]) { // TODO: OpExecutionMode DepthReplacing -> execute pixel shader, then go through depth test
+						// each pixel belongs to exactly one block, so the workers never write to the same location
+						if (depth <= tile.Depth[index]) { // TODO: OpExecutionMode DepthReplacing -> execute pixel shader, then go through depth test
 							if constexpr (!hasBreakpoints)
-								m_pixel.DebuggerColor = renderer->ExecutePixelShader(x, y, m_pixel.RenderTextureIndex);
+								pixel.DebuggerColor = worker.VM ? m_debugger->ExecutePixelShader(worker.VM, x, y, pixel.RenderTextureIndex) : m_debugger->ExecutePixelShader(x, y, pixel.RenderTextureIndex);
 							else
-								m_pixel.DebuggerColor = m_executePixelShaderWithBreakpoints(x, y, m_bkpt[y * m_width + x], m_pixel.RenderTextureIndex);
+								pixel.DebuggerColor = m_executePixelShaderWithBreakpoints(x, y, tile.Breakpoints[index], pixel.RenderTextureIndex);
 
-							if (renderer->GetVM()->discarded) {
-								m_pixelsDiscarded++;
+							if (vm->discarded) {
+								worker.PixelsDiscarded++;
 								continue;
 							}
 
 							// actual color and depth
-							m_color[y * m_width + x] = m_encodeColor(m_pixel.DebuggerColor);
-							m_depth[y * m_width + x] = depth;
-							m_pixelCount++;
+							tile.Color[index] = m_encodeColor(pixel.DebuggerColor);
+							tile.Depth[index] = depth;
+							worker.PixelCount++;
 
 							// instruction count / heatmap stuff
-							int instCount = renderer->GetVM()->instruction_count;
-							m_instCount[y * m_width + x] = instCount;
-							m_instCountMax = std::max<int>(m_instCountMax, instCount);
-							m_instCountAvgN++;
-							m_instCountAvg = m_instCountAvg + (instCount - m_instCountAvg) / m_instCountAvgN;
+							int instCount = vm->instruction_count;
+							tile.InstCount[index] = instCount;
+							worker.InstCountMax = std::max<int>(worker.InstCountMax, instCount);
+							block.InstCounts.push_back(instCount);
 
 							// undefined behavior
-							spvm_word ubType = renderer->GetLastUndefinedBehaviorType();
-							spvm_word ubLine = renderer->GetLastUndefinedBehaviorLine();
-							spvm_word ubCount = renderer->GetUndefinedBehaviorCount();
-							m_ub[y * m_width + x] = (ubType & 0x000000FF) | ((ubCount << 8) & 0x00000F00) | ((ubLine << 12) & 0xFFFFF000);
-							m_pixelsUB += (ubType > 0);
-
-							// pixel history
-							if (m_pixelHistoryLocation == m_pixel.Coordinate) {
-								bool exists = false;
-								for (const auto& pixel : m_debugger->GetPixelList())
-									if (pixel.Object == m_pixel.Object && pixel.VertexID == m_pixel.VertexID) {
-										exists = true;
-										break;
-									}
-
-								if (!exists) {
-									m_pixel.Color = m_pixel.DebuggerColor;
-									m_pixel.History = true;
-									m_debugger->AddPixel(m_pixel);
-								}
+							spvm_word ubType = worker.VM ? worker.VM->UBLastType : m_debugger->GetLastUndefinedBehaviorType();
+							spvm_word ubLine = worker.VM ? worker.VM->UBLastLine : m_debugger->GetLastUndefinedBehaviorLine();
+							spvm_word ubCount = worker.VM ? worker.VM->UBCount : m_debugger->GetUndefinedBehaviorCount();
+							tile.UB[index] = (ubType & 0x000000FF) | ((ubCount << 8) & 0x00000F00) | ((ubLine << 12) & 0xFFFFF000);
+							worker.PixelsUB += (ubType > 0);
+
+							// pixel history - added to the debugger after the triangle is done
+							if (m_pixelHistoryLocation == pixel.Coordinate) {
+								worker.History = pixel;
+								worker.History.Color = pixel.DebuggerColor;
+								worker.History.History = true;
+								worker.HasHistory = true;
 							}
 
 						} else
-							m_pixelsFailedDepthTest++;
+							worker.PixelsFailedDepthTest++;
 					}
 				}
 			}
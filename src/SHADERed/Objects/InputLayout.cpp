@@ -1,5 +1,15 @@
 #include <SHADERed/Objects/InputLayout.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
 namespace ed {
 	size_t InputLayoutItem::GetValueSize(InputLayoutValue val)
 	{
@@ -33,4 +43,16 @@ namespace ed {
 		}
 		return 0;
 	}
+
+	VertexFormat::VertexFormat()
+	{
+		for (int i = 0; i <= (int)InputLayoutValue::Color; i++) {
+			InputLayoutValue val = (InputLayoutValue)i;
+			Attributes[i].Type = GL_FLOAT;
+			Attributes[i].Components = InputLayoutItem::GetValueSize(val);
+			Attributes[i].Normalized = false;
+			Attributes[i].Offset = InputLayoutItem::GetValueOffset(val) * sizeof(float);
+		}
+		Stride = 18 * sizeof(float);
+	}
 }
\ No newline at end of file
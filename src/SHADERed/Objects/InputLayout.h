@@ -28,4 +28,21 @@ namespace ed {
 		static size_t GetValueSize(InputLayoutValue val);
 		static size_t GetValueOffset(InputLayoutValue val);
 	};
+
+	// how the geometry attributes (Position ... Color) are stored in a vertex buffer
+	struct VertexAttributeFormat {
+		unsigned int Type; // GL_FLOAT, GL_HALF_FLOAT, GL_INT_2_10_10_10_REV, ... 0 -> attribute isn't stored
+		int Components;
+		bool Normalized;
+		unsigned int Offset; // in bytes
+	};
+	class VertexFormat {
+	public:
+		VertexFormat(); // 18 floats per vertex, see InputLayoutItem::GetValueOffset()
+
+		VertexAttributeFormat Attributes[(int)InputLayoutValue::Color + 1];
+		unsigned int Stride;
+
+		inline const VertexAttributeFormat& Get(InputLayoutValue val) const { return Attributes[(int)val]; }
+	};
 }
\ No newline at end of file
@@ -12,6 +12,8 @@ namespace ed {
 		if (!Settings::Instance().General.Log)
 			return;
 
+		std::lock_guard<std::mutex> lock(m_mutex);
+
 		time_t now = time(0);
 		tm* ltm = localtime(&now);
 
@@ -43,7 +45,7 @@ namespace ed {
 		data << msg;
 
 		if (Settings::Instance().General.PipeLogsToTerminal)
-			std::cout << data.str() << std::endl;
+			(UseStderr ? std::cerr : std::cout) << data.str() << std::endl;
 
 		if (Settings::Instance().General.StreamLogs) {
 			std::ofstream log(ed::Settings::Instance().ConvertPath("log.txt"), std::ios_base::app | std::ios_base::out);
@@ -57,6 +59,8 @@ namespace ed {
 		if (!Settings::Instance().General.Log || Settings::Instance().General.StreamLogs)
 			return;
 
+		std::lock_guard<std::mutex> lock(m_mutex);
+
 		time_t now = time(0);
 		tm* ltm = localtime(&now);
 
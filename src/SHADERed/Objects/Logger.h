@@ -1,15 +1,18 @@
 #pragma once
 #include <SHADERed/Objects/MessageStack.h>
+#include <mutex>
 #include <string>
 
 namespace ed {
 	class Logger {
 	public:
 		MessageStack* Stack;
+		bool UseStderr; // stdout is used for the rendered frames
 
 		Logger()
 		{
 			Stack = nullptr;
+			UseStderr = false;
 		}
 
 		static Logger& Get()
@@ -22,6 +25,7 @@ namespace ed {
 		void Save();
 
 	private:
+		std::mutex m_mutex; // shader compilation logs from worker threads
 		std::vector<std::string> m_msgs;
 	};
 }
\ No newline at end of file
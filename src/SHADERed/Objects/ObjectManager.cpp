@@ -4,9 +4,12 @@
 #include <SHADERed/Objects/RenderEngine.h>
 #include <SHADERed/Objects/Settings.h>
 #include <SHADERed/Engine/Model.h>
+#include <SHADERed/Engine/ThreadPool.h>
 
 #include <unordered_map>
 #include <fstream>
+#include <algorithm>
+#include <chrono>
 
 #include <GLFW/glfw3.h>
 
@@ -18,12 +21,16 @@ extern "C" {
 #include <misc/dds.h>
 }
 
+// maximum amount of texture data copied to the GPU per frame
+#define TEXTURE_UPLOAD_BUDGET (16 * 1024 * 1024)
+
 namespace ed {
 	ObjectManager::ObjectManager(ProjectParser* parser, RenderEngine* rnd)
 			: m_parser(parser)
 			, m_renderer(rnd)
 	{
 		m_binds.clear();
+		m_uploadPBO = 0;
 		memset(m_kbTexture, 0, sizeof(unsigned char) * 256 * 3);
 		
 		m_keyIDs = {
@@ -134,66 +141,89 @@ namespace ed {
 	ObjectManager::~ObjectManager()
 	{
 		Clear();
+
+		if (m_uploadPBO != 0)
+			glDeleteBuffers(1, &m_uploadPBO);
 	}
 
-	void loadCubemapFace(GLuint face, const std::string& path, int& w, int& h)
+	// called from the worker threads - stb_image's flip flag is only set once at startup
+	static bool decodeTextureFile(const std::string& path, int& width, int& height, int& depth, std::vector<unsigned char>& pixels)
 	{
-		stbi_set_flip_vertically_on_load(0);
+		width = height = depth = 0;
 
-		bool isDDS = (std::filesystem::path(path).extension().u8string() == ".dds");
+		if (std::filesystem::path(path).extension().u8string() == ".dds") {
+			dds_image_t ddsImage = dds_load_from_file(path.c_str());
+			if (ddsImage == nullptr)
+				return false;
 
-		unsigned char* data = nullptr;
-		unsigned char* paddedData = nullptr;
-		dds_image_t ddsImage = nullptr;
-		int nrChannels = 0;
+			width = ddsImage->header.width;
+			height = ddsImage->header.height;
+			depth = std::max<int>(1, ddsImage->header.depth);
+			pixels.assign(ddsImage->pixels, ddsImage->pixels + (size_t)width * height * depth * 4);
 
-		if (!isDDS) {
-			data = stbi_load(path.c_str(), &w, &h, &nrChannels, 0);
+			dds_image_free(ddsImage);
 		} else {
-			ddsImage = dds_load_from_file(path.c_str());
+			int nrChannels = 0;
+			unsigned char* data = stbi_load(path.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
+			if (data == nullptr)
+				return false;
 
-			data = ddsImage->pixels;
-			w = ddsImage->header.width;
-			h = ddsImage->header.height;
-			nrChannels = 4;
-		}
+			depth = 1;
+			pixels.assign(data, data + (size_t)width * height * 4);
 
-		if (nrChannels != 4) {
-			paddedData = (unsigned char*)malloc(w * h * 4);
-			for (int x = 0; x < w; x++) {
-				for (int y = 0; y < h; y++) {
-					if (nrChannels == 3) {
-						paddedData[(y * w + x) * 4 + 0] = data[(y * w + x) * 3 + 0];
-						paddedData[(y * w + x) * 4 + 1] = data[(y * w + x) * 3 + 1];
-						paddedData[(y * w + x) * 4 + 2] = data[(y * w + x) * 3 + 2];
-					} else if (nrChannels == 1) {
-						unsigned char val = data[(y * w + x) * 1 + 0];
-						paddedData[(y * w + x) * 4 + 0] = val;
-						paddedData[(y * w + x) * 4 + 1] = val;
-						paddedData[(y * w + x) * 4 + 2] = val;
-					}
-					paddedData[(y * w + x) * 4 + 3] = 255;
-				}
-			}
+			stbi_image_free(data);
 		}
 
-		glTexImage2D(
-			face,
-			0, GL_RGBA, w, h, 0, GL_RGBA, GL_UNSIGNED_BYTE, paddedData == nullptr ? data : paddedData);
+		return width > 0 && height > 0;
+	}
+	static void flipTextureRows(const std::vector<unsigned char>& src, std::vector<unsigned char>& dst, int width, int height)
+	{
+		size_t rowSize = width * 4;
+		dst.resize(src.size());
+		for (int y = 0; y < height; y++)
+			memcpy(&dst[y * rowSize], &src[(height - y - 1) * rowSize], rowSize);
+	}
+	// reads only the header - the image is decoded later on a worker thread
+	static bool isTextureFileValid(const std::string& path)
+	{
+		if (std::filesystem::path(path).extension().u8string() == ".dds")
+			return std::filesystem::exists(path);
+
+		int width = 0, height = 0, nrChannels = 0;
+		return stbi_info(path.c_str(), &width, &height, &nrChannels) != 0;
+	}
+	// 1x1 grey texture that is bound while the real one is being loaded
+	static GLuint createPlaceholderTexture(GLenum target)
+	{
+		const unsigned char pixel[4] = { 128, 128, 128, 255 };
 
-		if (paddedData != nullptr)
-			free(paddedData);
+		GLuint tex = 0;
+		glGenTextures(1, &tex);
+		glBindTexture(target, tex);
+		glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-		if (!isDDS)
-			stbi_image_free(data);
-		else
-			dds_image_free(ddsImage);
+		if (target == GL_TEXTURE_3D)
+			glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA, 1, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+		else if (target == GL_TEXTURE_CUBE_MAP) {
+			for (int i = 0; i < 6; i++)
+				glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+		} else
+			glTexImage2D(target, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixel);
+
+		glBindTexture(target, 0);
+
+		return tex;
 	}
 
 	void ObjectManager::Clear()
 	{
 		Logger::Get().Log("Clearing ObjectManager contents...");
 
+		for (const auto& load : m_textureLoads)
+			glDeleteTextures(2, load->Textures);
+		m_textureLoads.clear();
+
 		for (int i = 0; i < m_items.size(); i++) {
 			if (m_items[i]->Plugin != nullptr) {
 				PluginObject* pobj = m_items[i]->Plugin;
@@ -206,6 +236,8 @@ namespace ed {
 		m_binds.clear();
 		m_uniformBinds.clear();
 		m_items.clear();
+
+		m_renderer->InvalidatePlan();
 	}
 	bool ObjectManager::CreateRenderTexture(const std::string& name)
 	{
@@ -268,26 +300,8 @@ namespace ed {
 			return false;
 		}
 
-		bool isDDS = (std::filesystem::path(file).extension().u8string() == ".dds");
 		std::string path = m_parser->GetProjectPath(file);
-
-		int width = 0, height = 0;
-		unsigned char* data = nullptr;
-		dds_image_t ddsImage = nullptr;
-
-		if (isDDS) {
-			ddsImage = dds_load_from_file(path.c_str());
-
-			data = ddsImage->pixels;
-			width = ddsImage->header.width;
-			height = ddsImage->header.height;
-		} else {
-			int nrChannels = 0;
-			stbi_set_flip_vertically_on_load(1);
-			data = stbi_load(path.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
-		}
-
-		if (data == nullptr || width == 0 || height == 0 || (isDDS && ddsImage == nullptr)) {
+		if (!isTextureFileValid(path)) {
 			Logger::Get().Log("Failed to load a texture " + file + " from file", true);
 			return false;
 		}
@@ -297,47 +311,12 @@ namespace ed {
 		ObjectManagerItem* item = new ObjectManagerItem(file, ObjectType::Texture);
 		m_items.push_back(item);
 
-		// normal texture
-		glGenTextures(1, &item->Texture);
-		glBindTexture(GL_TEXTURE_2D, item->Texture);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-		glGenerateMipmap(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, 0);
-
-		// flipped texture
-		unsigned char* flippedData = (unsigned char*)malloc(width * height * 4);
+		// normal & flipped texture
+		item->Texture = createPlaceholderTexture(GL_TEXTURE_2D);
+		item->FlippedTexture = createPlaceholderTexture(GL_TEXTURE_2D);
+		item->TextureSize = glm::ivec2(1, 1);
 
-		for (int x = 0; x < width; x++) {
-			for (int y = 0; y < height; y++) {
-				flippedData[(y * width + x) * 4 + 0] = data[((height - y - 1) * width + x) * 4 + 0];
-				flippedData[(y * width + x) * 4 + 1] = data[((height - y - 1) * width + x) * 4 + 1];
-				flippedData[(y * width + x) * 4 + 2] = data[((height - y - 1) * width + x) * 4 + 2];
-				flippedData[(y * width + x) * 4 + 3] = data[((height - y - 1) * width + x) * 4 + 3];
-			}
-		}
-
-		glGenTextures(1, &item->FlippedTexture);
-		glBindTexture(GL_TEXTURE_2D, item->FlippedTexture);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, flippedData);
-		glGenerateMipmap(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, 0);
-
-		item->TextureSize = glm::ivec2(width, height);
-
-		free(flippedData);
-
-		if (isDDS)
-			dds_image_free(ddsImage);
-		else
-			stbi_image_free(data);
+		m_startTextureLoad(item, GL_TEXTURE_2D, { path });
 
 		return true;
 	}
@@ -351,9 +330,7 @@ namespace ed {
 		}
 
 		std::string path = m_parser->GetProjectPath(file);
-		dds_image_t ddsImage = dds_load_from_file(path.c_str());
-
-		if (ddsImage == nullptr) {
+		if (!isTextureFileValid(path)) {
 			Logger::Get().Log("Failed to load a texture " + file + " from file", true);
 			return false;
 		}
@@ -363,21 +340,11 @@ namespace ed {
 		ObjectManagerItem* item = new ObjectManagerItem(file, ObjectType::Texture3D);
 		m_items.push_back(item);
 
-		glGenTextures(1, &item->Texture);
-		glBindTexture(GL_TEXTURE_3D, item->Texture);
-		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
-		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
-		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
-		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
-		glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, item->Texture_WrapR);
-		glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA, ddsImage->header.width, ddsImage->header.height, ddsImage->header.depth, 0, GL_RGBA, GL_UNSIGNED_BYTE, ddsImage->pixels);
-		glGenerateMipmap(GL_TEXTURE_3D);
-		glBindTexture(GL_TEXTURE_3D, 0);
-
-		item->TextureSize = glm::ivec2(ddsImage->header.width, ddsImage->header.height);
-		item->Depth = ddsImage->header.depth;
+		item->Texture = createPlaceholderTexture(GL_TEXTURE_3D);
+		item->TextureSize = glm::ivec2(1, 1);
+		item->Depth = 1;
 
-		dds_image_free(ddsImage);
+		m_startTextureLoad(item, GL_TEXTURE_3D, { path });
 
 		return true;
 	}
@@ -395,44 +362,20 @@ namespace ed {
 		ObjectManagerItem* item = new ObjectManagerItem(name, ObjectType::CubeMap);
 		m_items.push_back(item);
 
-		glGenTextures(1, &item->Texture);
-		glBindTexture(GL_TEXTURE_CUBE_MAP, item->Texture);
-		int width, height;
-
-		// properties
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-		glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
-
-		// left face
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_X, m_parser->GetProjectPath(left), width, height);
-		item->CubemapPaths.push_back(left);
-
-		// top
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Y, m_parser->GetProjectPath(top), width, height);
-		item->CubemapPaths.push_back(top);
-
-		// front
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, m_parser->GetProjectPath(front), width, height);
-		item->CubemapPaths.push_back(front);
-
-		// bottom
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, m_parser->GetProjectPath(bottom), width, height);
-		item->CubemapPaths.push_back(bottom);
-
-		// right
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_X, m_parser->GetProjectPath(right), width, height);
-		item->CubemapPaths.push_back(right);
-
-		// back
-		loadCubemapFace(GL_TEXTURE_CUBE_MAP_POSITIVE_Z, m_parser->GetProjectPath(back), width, height);
-		item->CubemapPaths.push_back(back);
-
-		// clean up
-		glBindTexture(GL_TEXTURE_CUBE_MAP, 0);
-		item->TextureSize = glm::ivec2(width, height);
+		// left, top, front, bottom, right, back - the faces are decoded in parallel
+		item->CubemapPaths = { left, top, front, bottom, right, back };
+
+		std::vector<std::string> paths;
+		for (const auto& face : item->CubemapPaths) {
+			paths.push_back(m_parser->GetProjectPath(face));
+			if (!isTextureFileValid(paths.back()))
+				Logger::Get().Log("Failed to load a cubemap face " + face + " from file", true);
+		}
+
+		item->Texture = createPlaceholderTexture(GL_TEXTURE_CUBE_MAP);
+		item->TextureSize = glm::ivec2(1, 1);
+
+		m_startTextureLoad(item, GL_TEXTURE_CUBE_MAP, paths);
 
 		return true;
 	}
@@ -724,9 +667,7 @@ namespace ed {
 			else
 				dds_image_free(ddsImage);
 			
-			glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-			glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
-			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			UploadBuffer(buf);
 		}
 
 		return data != nullptr;
@@ -735,8 +676,9 @@ namespace ed {
 	{
 		ed::Logger::Get().Log("Loading buffer data from a 3D model");
 
+		// only the vertex data is needed
 		ed::eng::Model mdl;
-		bool ret = mdl.LoadFromFile(str);
+		bool ret = mdl.LoadFromFile(str, false);
 
 		if (ret) {
 			int vertCount = 0;
@@ -758,9 +700,7 @@ namespace ed {
 					index += 4;
 				}
 
-			glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-			glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
-			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			UploadBuffer(buf);
 		}
 
 		return ret;
@@ -783,92 +723,353 @@ namespace ed {
 			memcpy(buf->Data, data, bufSize);
 			free(data);
 
-			glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-			glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
-			glBindBuffer(GL_UNIFORM_BUFFER, 0);
+			UploadBuffer(buf);
 		}
 
 		bufRead.close();
 
 		return ret;
 	}
+	void ObjectManager::UploadBuffer(BufferObject* buf)
+	{
+		glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
+		glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-	bool ObjectManager::ReloadTexture(ObjectManagerItem* item, const std::string& newPath)
+		buf->Version++;
+		buf->GPUWritten = false;
+	}
+	void ObjectManager::SyncBuffer(BufferObject* buf)
 	{
-		stbi_set_flip_vertically_on_load(1);
+		if (!buf->GPUWritten || buf->Data == nullptr)
+			return;
 
-		for (int i = 0; i < m_items.size(); i++) {
-			if (m_items[i] == item) {
-				std::string path = m_parser->GetProjectPath(newPath);
-				int width = 0, height = 0, depth = 0;
-				unsigned char* data = nullptr;
-				dds_image_t ddsImage = nullptr;
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf->ID);
+		glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, buf->Size, buf->Data);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
 
-				bool isDDS = (std::filesystem::path(path).extension().u8string() == ".dds");
-				if (!isDDS) {
-					int nrChannels = 0;
-					stbi_load(path.c_str(), &width, &height, &nrChannels, STBI_rgb_alpha);
-				} else {
-					ddsImage = dds_load_from_file(path.c_str());
-
-					data = ddsImage->pixels;
-					width = ddsImage->header.width;
-					height = ddsImage->header.height;
-					depth = ddsImage->header.depth;
-				}
-		
-				if (data == nullptr || (isDDS && ddsImage == nullptr) || (item->Type == ObjectType::Texture3D && depth == 0))
-					return false;
+		buf->Version++;
+		buf->GPUWritten = false;
+	}
+	void ObjectManager::GetBufferBounds(BufferObject* buf, glm::vec3& minPos, glm::vec3& maxPos)
+	{
+		SyncBuffer(buf);
+
+		if (buf->BoundsVersion == buf->Version && buf->BoundsFormat == buf->ViewFormat) {
+			minPos = buf->BoundsMin;
+			maxPos = buf->BoundsMax;
+			return;
+		}
+
+		std::vector<ShaderVariable::ValueType> tData = ParseBufferFormat(buf->ViewFormat);
+
+		int stride = 0;
+		for (const auto& dataEl : tData)
+			stride += ShaderVariable::GetSize(dataEl, true);
+
+		minPos = glm::vec3(0.0f);
+		maxPos = glm::vec3(0.0f);
+
+		if (tData.size() > 0 && stride > 0 && buf->Data != nullptr) {
+			int rows = buf->Size / stride;
+			int rowStride = stride / 4;
+
+			int elCount = ShaderVariable::GetSize(tData[0]) / 4;
+			if (elCount >= 4) elCount = 3;
+
+			const GLfloat* bufPtr = (const GLfloat*)buf->Data;
+			for (int r = 0; r < rows; r++) {
+				const GLfloat* curPtr = bufPtr + r * rowStride;
 
-				if (m_items[i]->Name != newPath) {
-					m_items[i]->Name = newPath;
-					m_parser->ModifyProject();
+				for (int c = 0; c < elCount; c++) {
+					minPos[c] = glm::min(minPos[c], curPtr[c]);
+					maxPos[c] = glm::max(maxPos[c], curPtr[c]);
 				}
+			}
+		}
 
-				if (item->Type == ObjectType::Texture3D) {
-					// normal texture
-					glBindTexture(GL_TEXTURE_3D, item->Texture);
-					glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA, width, height, depth, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-					glGenerateMipmap(GL_TEXTURE_3D);
-					glBindTexture(GL_TEXTURE_3D, 0);
-				} else {
-					// normal texture
-					glBindTexture(GL_TEXTURE_2D, item->Texture);
-					glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
-					glGenerateMipmap(GL_TEXTURE_2D);
-					glBindTexture(GL_TEXTURE_2D, 0);
-
-					// flipped texture
-					unsigned char* flippedData = (unsigned char*)malloc(width * height * 4);
-					for (int x = 0; x < width; x++) {
-						for (int y = 0; y < height; y++) {
-							flippedData[(y * width + x) * 4 + 0] = data[((height - y - 1) * width + x) * 4 + 0];
-							flippedData[(y * width + x) * 4 + 1] = data[((height - y - 1) * width + x) * 4 + 1];
-							flippedData[(y * width + x) * 4 + 2] = data[((height - y - 1) * width + x) * 4 + 2];
-							flippedData[(y * width + x) * 4 + 3] = data[((height - y - 1) * width + x) * 4 + 3];
-						}
+		buf->BoundsVersion = buf->Version;
+		buf->BoundsFormat = buf->ViewFormat;
+		buf->BoundsMin = minPos;
+		buf->BoundsMax = maxPos;
+	}
+
+	bool ObjectManager::ReloadTexture(ObjectManagerItem* item, const std::string& newPath)
+	{
+		if (std::count(m_items.begin(), m_items.end(), item) == 0)
+			return false;
+
+		std::string path = m_parser->GetProjectPath(newPath);
+		if (!isTextureFileValid(path))
+			return false;
+
+		if (item->Name != newPath) {
+			item->Name = newPath;
+			m_parser->ModifyProject();
+		}
+
+		// current texture stays bound until the new one is uploaded
+		m_startTextureLoad(item, item->Type == ObjectType::Texture3D ? GL_TEXTURE_3D : GL_TEXTURE_2D, { path });
+
+		return true;
+	}
+	void ObjectManager::m_startTextureLoad(ObjectManagerItem* item, GLenum target, const std::vector<std::string>& paths)
+	{
+		m_cancelTextureLoad(item);
+
+		std::shared_ptr<TextureLoad> load = std::make_shared<TextureLoad>();
+		load->Item = item;
+		load->Target = target;
+		load->Decoded = false;
+		load->Textures[0] = load->Textures[1] = 0;
+		load->Image = load->Row = 0;
+
+		if (target == GL_TEXTURE_CUBE_MAP) {
+			// same order as ObjectManagerItem::CubemapPaths
+			const GLenum faces[] = {
+				GL_TEXTURE_CUBE_MAP_NEGATIVE_X, GL_TEXTURE_CUBE_MAP_POSITIVE_Y, GL_TEXTURE_CUBE_MAP_NEGATIVE_Z,
+				GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, GL_TEXTURE_CUBE_MAP_POSITIVE_X, GL_TEXTURE_CUBE_MAP_POSITIVE_Z
+			};
+
+			load->Images.resize(paths.size());
+			for (int i = 0; i < paths.size() && i < 6; i++) {
+				load->Images[i].Target = faces[i];
+				load->Images[i].TextureIndex = 0;
+
+				std::string path = paths[i];
+				bool isDDS = (std::filesystem::path(path).extension().u8string() == ".dds");
+				load->Tasks.push_back(eng::ThreadPool::Instance().Enqueue([load, i, path, isDDS]() {
+					DecodedImage& img = load->Images[i];
+					img.Loaded = decodeTextureFile(path, img.Width, img.Height, img.Depth, img.Pixels);
+					img.Depth = 1;
+
+					// cubemap faces are stored top row first
+					if (img.Loaded && !isDDS) {
+						std::vector<unsigned char> pixels;
+						flipTextureRows(img.Pixels, pixels, img.Width, img.Height);
+						img.Pixels = std::move(pixels);
 					}
-					glBindTexture(GL_TEXTURE_2D, item->FlippedTexture);
-					glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, flippedData);
-					glGenerateMipmap(GL_TEXTURE_2D);
-					glBindTexture(GL_TEXTURE_2D, 0);
+				}));
+			}
+		} else if (target == GL_TEXTURE_3D) {
+			load->Images.resize(1);
+			load->Images[0].Target = GL_TEXTURE_3D;
+			load->Images[0].TextureIndex = 0;
+
+			std::string path = paths[0];
+			load->Tasks.push_back(eng::ThreadPool::Instance().Enqueue([load, path]() {
+				DecodedImage& img = load->Images[0];
+				img.Loaded = decodeTextureFile(path, img.Width, img.Height, img.Depth, img.Pixels);
+			}));
+		} else {
+			load->Images.resize(2);
+			for (int i = 0; i < 2; i++) {
+				load->Images[i].Target = GL_TEXTURE_2D;
+				load->Images[i].TextureIndex = i;
+			}
 
-					free(flippedData);
-				}
+			std::string path = paths[0];
+			load->Tasks.push_back(eng::ThreadPool::Instance().Enqueue([load, path]() {
+				DecodedImage& img = load->Images[0];
+				DecodedImage& flipped = load->Images[1];
 
-				item->TextureSize = glm::ivec2(width, height);
-				item->Depth = depth;
+				img.Loaded = flipped.Loaded = decodeTextureFile(path, img.Width, img.Height, img.Depth, img.Pixels);
+				img.Depth = 1;
+				flipped.Width = img.Width;
+				flipped.Height = img.Height;
+				flipped.Depth = 1;
 
-				if (!isDDS)
-					stbi_image_free(data);
-				else
-					dds_image_free(ddsImage);
+				if (img.Loaded)
+					flipTextureRows(img.Pixels, flipped.Pixels, img.Width, img.Height);
+			}));
+		}
 
-				return true;
+		m_textureLoads.push_back(load);
+	}
+	void ObjectManager::m_cancelTextureLoad(ObjectManagerItem* item)
+	{
+		// workers keep their own reference to the load, so it's safe to drop it while they're decoding
+		for (int i = 0; i < m_textureLoads.size(); i++) {
+			if (m_textureLoads[i]->Item != item)
+				continue;
+
+			glDeleteTextures(2, m_textureLoads[i]->Textures);
+			m_textureLoads.erase(m_textureLoads.begin() + i);
+			i--;
+		}
+	}
+	bool ObjectManager::m_allocateTextureLoad(TextureLoad* load)
+	{
+		for (const auto& img : load->Images) {
+			if (!img.Loaded)
+				return false;
+
+			// cubemap faces must have the same size
+			if (img.Width != load->Images[0].Width || img.Height != load->Images[0].Height)
+				return false;
+		}
+
+		for (const auto& img : load->Images) {
+			GLuint& tex = load->Textures[img.TextureIndex];
+			if (tex == 0)
+				glGenTextures(1, &tex);
+
+			glBindTexture(load->Target, tex);
+			if (img.Target == GL_TEXTURE_3D)
+				glTexImage3D(GL_TEXTURE_3D, 0, GL_RGBA, img.Width, img.Height, img.Depth, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+			else
+				glTexImage2D(img.Target, 0, GL_RGBA, img.Width, img.Height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		}
+		glBindTexture(load->Target, 0);
+
+		return true;
+	}
+	void ObjectManager::m_finishTextureLoad(TextureLoad* load)
+	{
+		ObjectManagerItem* item = load->Item;
+
+		for (int i = 0; i < 2; i++) {
+			if (load->Textures[i] == 0)
+				continue;
+
+			glBindTexture(load->Target, load->Textures[i]);
+			if (load->Target == GL_TEXTURE_CUBE_MAP) {
+				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+				glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+			} else {
+				glTexParameteri(load->Target, GL_TEXTURE_MIN_FILTER, item->Texture_MinFilter);
+				glTexParameteri(load->Target, GL_TEXTURE_MAG_FILTER, item->Texture_MagFilter);
+				glTexParameteri(load->Target, GL_TEXTURE_WRAP_S, item->Texture_WrapS);
+				glTexParameteri(load->Target, GL_TEXTURE_WRAP_T, item->Texture_WrapT);
+				if (load->Target == GL_TEXTURE_3D)
+					glTexParameteri(GL_TEXTURE_3D, GL_TEXTURE_WRAP_R, item->Texture_WrapR);
+				glGenerateMipmap(load->Target);
 			}
 		}
+		glBindTexture(load->Target, 0);
+
+		// FlipTexture() swaps the two textures
+		bool hasFlipped = load->Textures[1] != 0;
+		GLuint newTexture = load->Textures[hasFlipped && item->Texture_VFlipped];
+		GLuint newFlipped = load->Textures[!item->Texture_VFlipped];
+
+		for (auto& key : m_binds)
+			std::replace(key.second.begin(), key.second.end(), item->Texture, newTexture);
+		for (auto& key : m_uniformBinds)
+			std::replace(key.second.begin(), key.second.end(), item->Texture, newTexture);
+
+		glDeleteTextures(1, &item->Texture);
+		item->Texture = newTexture;
+		if (hasFlipped) {
+			glDeleteTextures(1, &item->FlippedTexture);
+			item->FlippedTexture = newFlipped;
+		}
 
-		return false;
+		item->TextureSize = glm::ivec2(load->Images[0].Width, load->Images[0].Height);
+		item->Depth = load->Target == GL_TEXTURE_3D ? load->Images[0].Depth : 1;
+
+		load->Textures[0] = load->Textures[1] = 0;
+
+		m_renderer->InvalidatePlan();
+	}
+	void ObjectManager::UpdateTextures(bool wait)
+	{
+		struct UploadChunk {
+			TextureLoad* Load;
+			DecodedImage* Image;
+			int Row, RowCount;
+			size_t Offset;
+		};
+
+		do {
+			std::vector<UploadChunk> chunks;
+			size_t used = 0;
+
+			// take rows from the loads until the frame's budget is used up
+			for (int i = 0; i < m_textureLoads.size() && used < TEXTURE_UPLOAD_BUDGET; i++) {
+				TextureLoad* load = m_textureLoads[i].get();
+
+				if (!load->Decoded) {
+					bool ready = true;
+					for (auto& task : load->Tasks) {
+						if (wait)
+							task.wait();
+						else if (task.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+							ready = false;
+					}
+					if (!ready)
+						continue;
+
+					load->Tasks.clear();
+					load->Decoded = true;
+
+					if (!m_allocateTextureLoad(load)) {
+						Logger::Get().Log("Failed to load a texture " + load->Item->Name + " from file", true);
+						glDeleteTextures(2, load->Textures);
+						m_textureLoads.erase(m_textureLoads.begin() + i);
+						i--;
+						continue;
+					}
+				}
+
+				while (load->Image < load->Images.size() && used < TEXTURE_UPLOAD_BUDGET) {
+					DecodedImage& img = load->Images[load->Image];
+					size_t rowSize = img.Width * 4;
+
+					// chunks can't cross 3D texture slices
+					int rows = std::min<size_t>(img.Height - load->Row % img.Height, std::max<size_t>(1, (TEXTURE_UPLOAD_BUDGET - used) / rowSize));
+					chunks.push_back({ load, &img, load->Row, rows, used });
+
+					used += rows * rowSize;
+					load->Row += rows;
+					if (load->Row >= img.Height * img.Depth) {
+						load->Image++;
+						load->Row = 0;
+					}
+				}
+			}
+
+			if (!chunks.empty()) {
+				if (m_uploadPBO == 0)
+					glGenBuffers(1, &m_uploadPBO);
+
+				// orphan the previous frame's storage so that mapping doesn't wait for its uploads
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_uploadPBO);
+				glBufferData(GL_PIXEL_UNPACK_BUFFER, used, nullptr, GL_STREAM_DRAW);
+				unsigned char* staging = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, used, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+				if (staging != nullptr) {
+					for (const auto& chunk : chunks) {
+						size_t rowSize = chunk.Image->Width * 4;
+						memcpy(staging + chunk.Offset, chunk.Image->Pixels.data() + chunk.Row * rowSize, chunk.RowCount * rowSize);
+					}
+					glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+					for (const auto& chunk : chunks) {
+						const DecodedImage* img = chunk.Image;
+						glBindTexture(chunk.Load->Target, chunk.Load->Textures[img->TextureIndex]);
+						if (img->Target == GL_TEXTURE_3D)
+							glTexSubImage3D(GL_TEXTURE_3D, 0, 0, chunk.Row % img->Height, chunk.Row / img->Height, img->Width, chunk.RowCount, 1, GL_RGBA, GL_UNSIGNED_BYTE, (void*)chunk.Offset);
+						else
+							glTexSubImage2D(img->Target, 0, 0, chunk.Row, img->Width, chunk.RowCount, GL_RGBA, GL_UNSIGNED_BYTE, (void*)chunk.Offset);
+						glBindTexture(chunk.Load->Target, 0);
+					}
+				}
+				glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+			}
+
+			// replace the placeholders
+			for (int i = 0; i < m_textureLoads.size(); i++) {
+				TextureLoad* load = m_textureLoads[i].get();
+				if (load->Decoded && load->Image >= load->Images.size()) {
+					m_finishTextureLoad(load);
+					m_textureLoads.erase(m_textureLoads.begin() + i);
+					i--;
+				}
+			}
+		} while (wait && !m_textureLoads.empty());
 	}
 
 	void ObjectManager::Pause(bool pause)
@@ -1029,6 +1230,8 @@ namespace ed {
 			pobj->Owner->Object_Remove(file.c_str(), pobj->Type, pobj->Data, pobj->ID);
 		}
 
+		m_cancelTextureLoad(item);
+
 		delete item;
 		m_items.erase(m_items.begin() + index);
 	}
@@ -1,4 +1,6 @@
 #pragma once
+#include <future>
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -32,6 +34,11 @@ namespace ed {
 		void OnEvent(const AppEvent& e);
 		void Update(float delta);
 
+		// textures are decoded on eng::ThreadPool and copied to the GPU over multiple frames
+		// items use a placeholder texture until then (wait = true -> finish everything now)
+		void UpdateTextures(bool wait = false);
+		inline bool IsLoadingTextures() { return !m_textureLoads.empty(); }
+
 		void Pause(bool pause);
 
 		void Remove(const std::string& file);
@@ -49,6 +56,12 @@ namespace ed {
 		bool LoadBufferFromModel(BufferObject* buf, const std::string& str);
 		bool LoadBufferFromFile(BufferObject* buf, const std::string& str);
 
+		// upload Data to the GPU / read back the GPU data if a shader might have written to it
+		void UploadBuffer(BufferObject* buf);
+		void SyncBuffer(BufferObject* buf);
+		// bounds of the first element in the buffer's format, recalculated only when the data changes
+		void GetBufferBounds(BufferObject* buf, glm::vec3& minPos, glm::vec3& maxPos);
+
 		bool ReloadTexture(ObjectManagerItem* item, const std::string& newPath);
 
 		void Clear();
@@ -93,6 +106,31 @@ namespace ed {
 		RenderEngine* m_renderer;
 		ProjectParser* m_parser;
 
+		struct DecodedImage {
+			GLenum Target;	  // GL_TEXTURE_2D, GL_TEXTURE_3D or a cubemap face
+			int TextureIndex; // 0 -> Texture, 1 -> FlippedTexture
+			bool Loaded;
+			int Width, Height, Depth;
+			std::vector<unsigned char> Pixels; // RGBA8
+		};
+		struct TextureLoad {
+			ObjectManagerItem* Item;
+			GLenum Target;
+			std::vector<DecodedImage> Images;	  // written by the workers
+			std::vector<std::future<void>> Tasks; // one per file
+
+			bool Decoded;
+			GLuint Textures[2]; // replace the item's textures once all of the images are uploaded
+			int Image, Row;		// upload progress
+		};
+		std::vector<std::shared_ptr<TextureLoad>> m_textureLoads;
+		GLuint m_uploadPBO;
+
+		void m_startTextureLoad(ObjectManagerItem* item, GLenum target, const std::vector<std::string>& paths);
+		void m_cancelTextureLoad(ObjectManagerItem* item);
+		bool m_allocateTextureLoad(TextureLoad* load);
+		void m_finishTextureLoad(TextureLoad* load);
+
 		std::vector<ObjectManagerItem*> m_items;
 
 		std::unordered_map<int, int> m_keyIDs;
@@ -60,6 +60,16 @@ namespace ed {
 		char ViewFormat[256]; // vec3;vec3;vec2
 		bool PreviewPaused;
 		GLuint ID;
+
+		// Data is the CPU copy of the buffer - Version is incremented every time it changes
+		// GPUWritten is set once the buffer is bound as a SSBO, ObjectManager::SyncBuffer reads it back
+		unsigned int Version;
+		bool GPUWritten;
+
+		// cached by ObjectManager::GetBufferBounds
+		unsigned int BoundsVersion;
+		std::string BoundsFormat;
+		glm::vec3 BoundsMin, BoundsMax;
 	};
 	struct ImageObject {
 		glm::ivec2 Size;
@@ -0,0 +1,135 @@
+#include <SHADERed/Objects/PerformanceTimer.h>
+
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+#include <algorithm>
+
+namespace ed {
+	PerformanceTimer::PerformanceTimer(PipelineItem* pass)
+	{
+		IsCreated = false;
+		LastTime = 0;
+		Pass = pass;
+
+		for (int i = 0; i < PERFORMANCE_TIMER_RING; i++) {
+			m_ring[i].Begin = m_ring[i].End = 0;
+			m_ring[i].Pending = false;
+		}
+		m_ringPos = 0;
+		m_measuring = false;
+
+		m_historyPos = 0;
+		m_historyCount = 0;
+	}
+	void PerformanceTimer::Create()
+	{
+		if (IsCreated)
+			return;
+
+		for (int i = 0; i < PERFORMANCE_TIMER_RING; i++) {
+			glGenQueries(1, &m_ring[i].Begin);
+			glGenQueries(1, &m_ring[i].End);
+			m_ring[i].Pending = false;
+		}
+
+		IsCreated = true;
+	}
+	void PerformanceTimer::Destroy()
+	{
+		if (IsCreated) {
+			for (int i = 0; i < PERFORMANCE_TIMER_RING; i++) {
+				glDeleteQueries(1, &m_ring[i].Begin);
+				glDeleteQueries(1, &m_ring[i].End);
+				m_ring[i].Begin = m_ring[i].End = 0;
+				m_ring[i].Pending = false;
+			}
+			IsCreated = false;
+		}
+
+		for (auto& child : Children)
+			child.Destroy();
+		Children.clear();
+	}
+	void PerformanceTimer::Begin()
+	{
+		// GPU is more than PERFORMANCE_TIMER_RING frames behind - skip this frame instead of waiting
+		m_measuring = IsCreated && !m_ring[m_ringPos].Pending;
+
+		// timestamps don't have to be paired like GL_TIME_ELAPSED, so a Begin() with no End() is harmless
+		if (m_measuring)
+			glQueryCounter(m_ring[m_ringPos].Begin, GL_TIMESTAMP);
+	}
+	void PerformanceTimer::End()
+	{
+		if (!m_measuring)
+			return;
+
+		glQueryCounter(m_ring[m_ringPos].End, GL_TIMESTAMP);
+		m_ring[m_ringPos].Pending = true;
+		m_ringPos = (m_ringPos + 1) % PERFORMANCE_TIMER_RING;
+		m_measuring = false;
+	}
+	void PerformanceTimer::Poll()
+	{
+		// results become available in order, so stop at the first one that isn't ready
+		for (int i = 0; i < PERFORMANCE_TIMER_RING; i++) {
+			Slot& slot = m_ring[(m_ringPos + i) % PERFORMANCE_TIMER_RING];
+			if (!slot.Pending)
+				continue;
+
+			int available = 0;
+			glGetQueryObjectiv(slot.End, GL_QUERY_RESULT_AVAILABLE, &available);
+			if (!available)
+				break;
+
+			GLuint64 begin = 0, end = 0;
+			glGetQueryObjectui64v(slot.Begin, GL_QUERY_RESULT, &begin);
+			glGetQueryObjectui64v(slot.End, GL_QUERY_RESULT, &end);
+			slot.Pending = false;
+
+			LastTime = end > begin ? end - begin : 0;
+
+			m_history[m_historyPos].Start = begin;
+			m_history[m_historyPos].Duration = LastTime;
+			m_historyPos = (m_historyPos + 1) % PERFORMANCE_TIMER_HISTORY;
+			m_historyCount = std::min<int>(m_historyCount + 1, PERFORMANCE_TIMER_HISTORY);
+		}
+
+		for (auto& child : Children)
+			child.Poll();
+	}
+	PerformanceStats PerformanceTimer::GetStats() const
+	{
+		PerformanceStats ret = { 0, 0, 0, 0, m_historyCount };
+		if (m_historyCount == 0)
+			return ret;
+
+		uint64_t times[PERFORMANCE_TIMER_HISTORY];
+		uint64_t sum = 0;
+		for (int i = 0; i < m_historyCount; i++) {
+			times[i] = m_history[i].Duration;
+			sum += times[i];
+		}
+		std::sort(times, times + m_historyCount);
+
+		ret.Min = times[0];
+		ret.Max = times[m_historyCount - 1];
+		ret.Avg = sum / m_historyCount;
+		ret.P95 = times[std::min<int>((m_historyCount * 95) / 100, m_historyCount - 1)];
+
+		return ret;
+	}
+	std::vector<PerformanceTimer::Sample> PerformanceTimer::GetHistory() const
+	{
+		std::vector<Sample> ret(m_historyCount);
+		int first = (m_historyPos - m_historyCount + PERFORMANCE_TIMER_HISTORY) % PERFORMANCE_TIMER_HISTORY;
+		for (int i = 0; i < m_historyCount; i++)
+			ret[i] = m_history[(first + i) % PERFORMANCE_TIMER_HISTORY];
+		return ret;
+	}
+}
\ No newline at end of file
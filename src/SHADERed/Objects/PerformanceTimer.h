@@ -1,22 +1,55 @@
 #pragma once
 #include <SHADERed/Objects/PipelineItem.h>
+#include <stdint.h>
+#include <vector>
+
+#define PERFORMANCE_TIMER_RING 4		// frames that can be in flight before a measurement gets skipped
+#define PERFORMANCE_TIMER_HISTORY 240 // samples kept for the statistics & trace export
 
 namespace ed {
+	struct PerformanceStats {
+		uint64_t Min, Avg, P95, Max;
+		int Count;
+	};
+
+	// GPU time of a pipeline item (or of a single draw inside a shader pass)
+	// GL_TIMESTAMP query pairs are kept in a ring and read back a few frames later so that the CPU never waits for the GPU
 	class PerformanceTimer {
 	public:
-		PerformanceTimer(PipelineItem* pass) {
-			IsDone = true;
-			IsCreated = false;
-			Object = 0;
-			LastTime = 0;
-			Pass = pass;
-		}
+		struct Sample {
+			uint64_t Start;	   // GL_TIMESTAMP, ns
+			uint64_t Duration; // ns
+		};
+
+		PerformanceTimer(PipelineItem* pass);
+
+		void Create();
+		void Destroy(); // also destroys the children
+
+		void Begin();
+		void End();
+		void Poll(); // collects the finished measurements, doesn't block
+
+		PerformanceStats GetStats() const;
+		std::vector<Sample> GetHistory() const; // oldest first
 
 		bool IsCreated;
-		bool IsDone;
-		uint64_t LastTime; // Last timer results
+		uint64_t LastTime; // last result
 		PipelineItem* Pass;
 
-		unsigned int Object; // OpenGL Query
+		std::vector<PerformanceTimer> Children; // per draw call timers of a shader pass
+
+	private:
+		struct Slot {
+			unsigned int Begin, End; // OpenGL queries
+			bool Pending;
+		};
+
+		Slot m_ring[PERFORMANCE_TIMER_RING];
+		int m_ringPos;	// slot used by the next measurement
+		bool m_measuring; // Begin() found a free slot
+
+		Sample m_history[PERFORMANCE_TIMER_HISTORY];
+		int m_historyPos, m_historyCount;
 	};
 }
\ No newline at end of file
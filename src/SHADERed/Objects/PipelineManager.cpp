@@ -1,3 +1,4 @@
+#include <SHADERed/Engine/GeometryFactory.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/PipelineManager.h>
 #include <SHADERed/Objects/ProjectParser.h>
@@ -74,6 +75,7 @@ namespace ed {
 
 				pdata->Owner->PipelineItem_AddChild(owner, name, (plugin::PipelineItemType)type, data);
 
+				m_sendEvent(EventType::ItemModified, item);
 				m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemAdded, (void*)name, nullptr);
 
 				return true;
@@ -91,6 +93,7 @@ namespace ed {
 
 				Logger::Get().Log("Item " + std::string(name) + " added to the project");
 
+				m_sendEvent(EventType::ItemModified, item);
 				m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemAdded, (void*)name, nullptr);
 
 				return true;
@@ -133,7 +136,8 @@ namespace ed {
 				}
 
 				Logger::Get().Log("Item " + std::string(name) + " added to the project");
-				
+
+				m_sendEvent(EventType::ItemModified, item);
 				m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemAdded, (void*)name, nullptr);
 
 				return true;
@@ -148,6 +152,7 @@ namespace ed {
 			m_items.push_back(pitem);
 			strcpy(pitem->Name, name);
 
+			m_sendEvent(EventType::ItemAdded, pitem);
 			m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemAdded, (void*)name, nullptr);
 
 			return true;
@@ -169,6 +174,7 @@ namespace ed {
 		m_items.push_back(new PipelineItem("\0", PipelineItem::ItemType::ShaderPass, data));
 		strcpy(m_items.at(m_items.size() - 1)->Name, name);
 
+		m_sendEvent(EventType::ItemAdded, m_items.back());
 		m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemAdded, (void*)name, nullptr);
 
 		return true;
@@ -187,6 +193,7 @@ namespace ed {
 		m_items.push_back(new PipelineItem("\0", PipelineItem::ItemType::ComputePass, data));
 		strcpy(m_items.at(m_items.size() - 1)->Name, name);
 
+		m_sendEvent(EventType::ItemAdded, m_items.back());
 		m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemAdded, (void*)name, nullptr);
 
 		return true;
@@ -205,6 +212,7 @@ namespace ed {
 		m_items.push_back(new PipelineItem("\0", PipelineItem::ItemType::AudioPass, data));
 		strcpy(m_items.at(m_items.size() - 1)->Name, name);
 
+		m_sendEvent(EventType::ItemAdded, m_items.back());
 		m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemAdded, (void*)name, nullptr);
 
 		return true;
@@ -217,6 +225,8 @@ namespace ed {
 
 		for (int i = 0; i < m_items.size(); i++) {
 			if (strcmp(m_items[i]->Name, name) == 0) {
+				m_sendEvent(EventType::ItemRemoved, m_items[i]);
+
 				if (m_items[i]->Type == PipelineItem::ItemType::ShaderPass) {
 					pipe::ShaderPass* data = (pipe::ShaderPass*)m_items[i]->Data;
 					glDeleteFramebuffers(1, &data->FBO);
@@ -226,7 +236,8 @@ namespace ed {
 						if (passItem->Type == PipelineItem::ItemType::Geometry) {
 							pipe::GeometryItem* geo = (pipe::GeometryItem*)passItem->Data;
 							glDeleteVertexArrays(1, &geo->VAO);
-							glDeleteVertexArrays(1, &geo->VBO);
+							glDeleteBuffers(1, &geo->VBO);
+							eng::GeometryFactory::ReleaseVertexData(geo->VBO);
 						} else if (passItem->Type == PipelineItem::ItemType::PluginItem) {
 							pipe::PluginItemData* pdata = (pipe::PluginItemData*)passItem->Data;
 							pdata->Owner->PipelineItem_Remove(passItem->Name, pdata->Type, pdata->PluginData);
@@ -247,7 +258,8 @@ namespace ed {
 						if (passItem->Type == PipelineItem::ItemType::Geometry) {
 							pipe::GeometryItem* geo = (pipe::GeometryItem*)passItem->Data;
 							glDeleteVertexArrays(1, &geo->VAO);
-							glDeleteVertexArrays(1, &geo->VBO);
+							glDeleteBuffers(1, &geo->VBO);
+							eng::GeometryFactory::ReleaseVertexData(geo->VBO);
 						} else if (passItem->Type == PipelineItem::ItemType::PluginItem) {
 							pipe::PluginItemData* pldata = (pipe::PluginItemData*)passItem->Data;
 							pdata->Owner->PipelineItem_Remove(passItem->Name, pldata->Type, pldata->PluginData);
@@ -277,7 +289,8 @@ namespace ed {
 							if (child->Type == PipelineItem::ItemType::Geometry) {
 								pipe::GeometryItem* geo = (pipe::GeometryItem*)child->Data;
 								glDeleteVertexArrays(1, &geo->VAO);
-								glDeleteVertexArrays(1, &geo->VBO);
+								glDeleteBuffers(1, &geo->VBO);
+								eng::GeometryFactory::ReleaseVertexData(geo->VBO);
 							} else if (child->Type == PipelineItem::ItemType::PluginItem) {
 								pipe::PluginItemData* pdata = (pipe::PluginItemData*)child->Data;
 								pdata->Owner->PipelineItem_Remove(child->Name, pdata->Type, pdata->PluginData);
@@ -290,6 +303,7 @@ namespace ed {
 							child->Data = nullptr;
 							delete child;
 							data->Items.erase(data->Items.begin() + j);
+							m_sendEvent(EventType::ItemModified, m_items[i]);
 							break;
 						}
 					}
@@ -304,7 +318,8 @@ namespace ed {
 							if (child->Type == PipelineItem::ItemType::Geometry) {
 								pipe::GeometryItem* geo = (pipe::GeometryItem*)child->Data;
 								glDeleteVertexArrays(1, &geo->VAO);
-								glDeleteVertexArrays(1, &geo->VBO);
+								glDeleteBuffers(1, &geo->VBO);
+								eng::GeometryFactory::ReleaseVertexData(geo->VBO);
 							} else if (child->Type == PipelineItem::ItemType::PluginItem) {
 								pipe::PluginItemData* pdata = (pipe::PluginItemData*)child->Data;
 								pdata->Owner->PipelineItem_Remove(child->Name, pdata->Type, pdata->PluginData);
@@ -317,6 +332,7 @@ namespace ed {
 							child->Data = nullptr;
 							delete child;
 							data->Items.erase(data->Items.begin() + j);
+							m_sendEvent(EventType::ItemModified, m_items[i]);
 							break;
 						}
 					}
@@ -326,6 +342,34 @@ namespace ed {
 
 		m_project->ModifyProject();
 	}
+	void PipelineManager::Move(std::vector<PipelineItem*>& items, int from, int to)
+	{
+		if (from < 0 || to < 0 || from >= items.size() || to >= items.size())
+			return;
+
+		m_project->ModifyProject();
+
+		PipelineItem* temp = items[to];
+		items[to] = items[from];
+		items[from] = temp;
+
+		if (&items == &m_items) {
+			m_sendEvent(EventType::ItemMoved, items[to]);
+			return;
+		}
+
+		// find the pass that owns these items
+		for (PipelineItem* item : m_items)
+			if ((item->Type == PipelineItem::ItemType::ShaderPass && &((pipe::ShaderPass*)item->Data)->Items == &items) || (item->Type == PipelineItem::ItemType::PluginItem && &((pipe::PluginItemData*)item->Data)->Items == &items)) {
+				m_sendEvent(EventType::ItemModified, item);
+				break;
+			}
+	}
+	void PipelineManager::m_sendEvent(EventType type, PipelineItem* item)
+	{
+		for (const auto& handler : m_handlers)
+			handler(type, item);
+	}
 	bool PipelineManager::Has(const char* name)
 	{
 		for (int i = 0; i < m_items.size(); i++) {
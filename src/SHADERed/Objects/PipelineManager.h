@@ -2,6 +2,7 @@
 #include <SHADERed/Objects/PipelineItem.h>
 #include <SHADERed/Objects/PluginManager.h>
 #include <SHADERed/Options.h>
+#include <functional>
 #include <vector>
 
 namespace ed {
@@ -12,6 +13,16 @@ namespace ed {
 		PipelineManager(ProjectParser* project, PluginManager* plugins);
 		~PipelineManager();
 
+		// events are sent for the top level items (passes), PipelineItem pointers stay valid until ItemRemoved
+		enum class EventType {
+			ItemAdded,
+			ItemRemoved, // sent before the item is freed
+			ItemMoved,
+			ItemModified // child item was added or removed
+		};
+		typedef std::function<void(EventType, PipelineItem*)> EventHandler;
+		inline void AddEventHandler(const EventHandler& handler) { m_handlers.push_back(handler); }
+
 		void Clear();
 
 		bool AddItem(const char* owner, const char* name, PipelineItem::ItemType type, void* data);
@@ -20,6 +31,7 @@ namespace ed {
 		bool AddComputePass(const char* name, pipe::ComputePass* data);
 		bool AddAudioPass(const char* name, pipe::AudioPass* data);
 		void Remove(const char* name);
+		void Move(std::vector<PipelineItem*>& items, int from, int to); // swap two items in the pipeline or in a pass
 		bool Has(const char* name);
 		PipelineItem* Get(const char* name);
 		char* GetItemOwner(const char* name);
@@ -33,5 +45,8 @@ namespace ed {
 		PluginManager* m_plugins;
 		ProjectParser* m_project;
 		std::vector<PipelineItem*> m_items;
+
+		std::vector<EventHandler> m_handlers;
+		void m_sendEvent(EventType type, PipelineItem* item);
 	};
 }
\ No newline at end of file
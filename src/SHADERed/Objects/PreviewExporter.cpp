@@ -0,0 +1,231 @@
+#include <SHADERed/Objects/PreviewExporter.h>
+#include <SHADERed/Objects/CommandLineOptionParser.h>
+#include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Objects/RenderEngine.h>
+#include <SHADERed/Objects/SequenceExporter.h>
+#include <SHADERed/Objects/SystemVariableManager.h>
+
+#include <misc/stb_image_resize.h>
+#include <misc/stb_image_write.h>
+
+#include <algorithm>
+#include <cmath>
+#include <ctype.h>
+#include <stdlib.h>
+
+namespace ed {
+	PreviewExporter::PreviewExporter()
+	{
+		Path = "render.png";
+		Format = "";
+		Size = glm::ivec2(1920, 1080);
+		Supersample = 1;
+
+		Time = CachedTime = 0.0f;
+		TimeDelta = 1 / 60.0f;
+		FrameIndex = 0;
+		WASD[0] = WASD[1] = WASD[2] = WASD[3] = false;
+		Mouse = glm::vec4(0.0f);
+
+		Sequence = false;
+		SequenceDuration = 5.5f;
+		SequenceFPS = 30;
+		FrameStart = 0;
+		FrameEnd = -1;
+		ShardIndex = 0;
+		ShardCount = 1;
+		Resume = false;
+	}
+	void PreviewExporter::LoadCommandLineOptions(const CommandLineOptionParser& options)
+	{
+		Path = options.RenderPath;
+		Format = options.RenderFormat;
+		Size = glm::ivec2(options.RenderWidth, options.RenderHeight);
+		Supersample = options.RenderSupersampling;
+
+		Time = CachedTime = options.RenderTime;
+		TimeDelta = 1 / 60.0f;
+		FrameIndex = options.RenderFrameIndex;
+
+		Sequence = options.RenderSequence;
+		SequenceDuration = options.RenderSequenceDuration;
+		SequenceFPS = options.RenderSequenceFPS;
+		FrameStart = options.RenderFrameStart;
+		FrameEnd = options.RenderFrameEnd;
+		ShardIndex = options.RenderShardIndex;
+		ShardCount = options.RenderShardCount;
+		Resume = options.RenderResume;
+	}
+	void PreviewExporter::Export(RenderEngine* renderer)
+	{
+		int actualSizeX = Size.x * Supersample;
+		int actualSizeY = Size.y * Supersample;
+
+		SystemVariableManager::Instance().SetSavingToFile(true);
+
+		if (!Sequence)
+			m_exportImage(renderer, actualSizeX, actualSizeY);
+		else if (actualSizeX > 0 && actualSizeY > 0)
+			m_exportSequence(renderer, actualSizeX, actualSizeY);
+
+		SystemVariableManager::Instance().SetSavingToFile(false);
+	}
+	void PreviewExporter::m_exportImage(RenderEngine* renderer, int actualSizeX, int actualSizeY)
+	{
+		if (actualSizeX > 0 && actualSizeY > 0) {
+			SystemVariableManager::Instance().CopyState();
+
+			SystemVariableManager::Instance().SetTimeDelta(TimeDelta);
+			SystemVariableManager::Instance().SetFrameIndex(FrameIndex);
+			SystemVariableManager::Instance().SetKeysWASD(WASD[0], WASD[1], WASD[2], WASD[3]);
+			SystemVariableManager::Instance().SetMousePosition(Mouse.x, Mouse.y);
+			SystemVariableManager::Instance().SetMouse(Mouse.x, Mouse.y, Mouse.z, Mouse.w);
+
+			renderer->Render(actualSizeX, actualSizeY);
+
+			SystemVariableManager::Instance().AdvanceTimer(CachedTime - Time);
+		}
+
+		unsigned char* pixels = (unsigned char*)malloc(actualSizeX * actualSizeY * 4);
+		unsigned char* outPixels = nullptr;
+
+		if (Supersample != 1)
+			outPixels = (unsigned char*)malloc(Size.x * Size.y * 4);
+		else
+			outPixels = pixels;
+
+		GLuint tex = renderer->GetTexture();
+		glBindTexture(GL_TEXTURE_2D, tex);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+		glBindTexture(GL_TEXTURE_2D, 0);
+
+		// resize image
+		if (Supersample != 1) {
+			stbir_resize_uint8(pixels, actualSizeX, actualSizeY, actualSizeX * 4,
+				outPixels, Size.x, Size.y, Size.x * 4, 4);
+		}
+
+		std::string ext = Path.substr(Path.find_last_of('.') + 1);
+
+		if (ext == "jpg" || ext == "jpeg")
+			stbi_write_jpg(Path.c_str(), Size.x, Size.y, 4, outPixels, 100);
+		else if (ext == "bmp")
+			stbi_write_bmp(Path.c_str(), Size.x, Size.y, 4, outPixels);
+		else if (ext == "tga")
+			stbi_write_tga(Path.c_str(), Size.x, Size.y, 4, outPixels);
+		else
+			stbi_write_png(Path.c_str(), Size.x, Size.y, 4, outPixels, Size.x * 4);
+
+		if (Supersample != 1) free(outPixels);
+		free(pixels);
+	}
+	void PreviewExporter::m_exportSequence(RenderEngine* renderer, int actualSizeX, int actualSizeY)
+	{
+		float seqDelta = 1.0f / SequenceFPS;
+
+		SystemVariableManager::Instance().SetKeysWASD(WASD[0], WASD[1], WASD[2], WASD[3]);
+		SystemVariableManager::Instance().SetMousePosition(Mouse.x, Mouse.y);
+		SystemVariableManager::Instance().SetMouse(Mouse.x, Mouse.y, Mouse.z, Mouse.w);
+
+		GLuint tex = renderer->GetTexture();
+
+		size_t lastDot = Path.find_last_of('.');
+		std::string ext = lastDot == std::string::npos ? "png" : Path.substr(lastDot + 1);
+		std::string filename = Path;
+
+		// raw/y4m frames are streamed into a single file (or stdout)
+		std::string format = Format.empty() ? ext : Format;
+		if (Path == "-" && Format.empty())
+			format = "y4m";
+		SequenceExporter::Format exportFormat = SequenceExporter::Format::Image;
+		if (format == "y4m")
+			exportFormat = SequenceExporter::Format::Y4M;
+		else if (format == "raw" || format == "rgba")
+			exportFormat = SequenceExporter::Format::Raw;
+		else
+			ext = format;
+
+		if (exportFormat == SequenceExporter::Format::Image) {
+			// allow only one %??d
+			bool inFormat = false;
+			int lastFormatPos = -1;
+			int formatCount = 0;
+			for (int i = 0; i < filename.size(); i++) {
+				if (filename[i] == '%') {
+					inFormat = true;
+					lastFormatPos = i;
+					continue;
+				}
+
+				if (inFormat) {
+					if (isdigit(filename[i])) {
+					} else {
+						if (filename[i] != '%' && ((filename[i] == 'd' && formatCount > 0) || (filename[i] != 'd'))) {
+							filename.insert(lastFormatPos, 1, '%');
+						}
+
+						if (filename[i] == 'd')
+							formatCount++;
+						inFormat = false;
+					}
+				}
+			}
+
+			// no %d found? add one
+			if (formatCount == 0) {
+				int frameCountDigits = log10((int)(SequenceDuration / seqDelta)) + 1;
+				filename.insert(lastDot == std::string::npos ? filename.size() : lastDot, "%0" + std::to_string(frameCountDigits) + "d"); // frame%d
+			}
+		}
+
+		// frame range: --frame-start/--frame-end, then split into --shard parts
+		// frame indices (and file names) stay global so that the shards can be rendered on different machines
+		int frameCount = std::ceil(SequenceDuration * SequenceFPS - 0.001f);
+		int firstFrame = std::min<int>(FrameStart, frameCount);
+		int lastFrame = FrameEnd < 0 ? frameCount : std::min<int>(FrameEnd + 1, frameCount); // exclusive
+		lastFrame = std::max<int>(firstFrame, lastFrame);
+		if (ShardCount > 1) {
+			int rangeSize = lastFrame - firstFrame;
+			int shardStart = firstFrame + rangeSize * ShardIndex / ShardCount;
+			lastFrame = firstFrame + rangeSize * (ShardIndex + 1) / ShardCount;
+			firstFrame = shardStart;
+		}
+
+		// seek to the first frame - history (feedback buffers, etc...) of the skipped frames isn't replayed
+		SystemVariableManager::Instance().AdvanceTimer(CachedTime - TimeDelta + firstFrame * seqDelta);
+		SystemVariableManager::Instance().SetTimeDelta(seqDelta);
+
+		stbi_write_png_compression_level = 5; // set to lowest compression level
+
+		// frame N is read back & encoded while the frame N+1 is being rendered
+		SequenceExporter exporter;
+		bool exporting = exporter.Begin(filename, exportFormat, ext, actualSizeX, actualSizeY, Size.x, Size.y, SequenceFPS);
+
+		if (Resume && exportFormat != SequenceExporter::Format::Image)
+			Logger::Get().Log("Can't resume rendering to a stream - rendering all of the frames", true);
+
+		int skipped = 0;
+		for (int globalFrame = firstFrame; exporting && globalFrame < lastFrame; globalFrame++) {
+			if (Resume && exporter.IsFrameWritten(globalFrame)) {
+				SystemVariableManager::Instance().AdvanceTimer(seqDelta);
+				skipped++;
+				continue;
+			}
+
+			SystemVariableManager::Instance().CopyState();
+			SystemVariableManager::Instance().SetFrameIndex(FrameIndex + globalFrame);
+
+			renderer->Render(actualSizeX, actualSizeY);
+			exporter.Capture(tex, globalFrame);
+
+			SystemVariableManager::Instance().AdvanceTimer(seqDelta);
+		}
+
+		exporter.End();
+
+		if (skipped > 0)
+			Logger::Get().Log("Skipped " + std::to_string(skipped) + " already rendered frames");
+
+		stbi_write_png_compression_level = 8; // set back to default compression level
+	}
+}
\ No newline at end of file
@@ -0,0 +1,39 @@
+#pragma once
+#include <glm/glm.hpp>
+#include <string>
+
+namespace ed {
+	class RenderEngine;
+	class CommandLineOptionParser;
+
+	// renders the preview to an image, an image sequence or a raw/Y4M stream
+	// shared by the "Save preview" dialog, --render and the headless backend
+	class PreviewExporter {
+	public:
+		PreviewExporter();
+
+		void LoadCommandLineOptions(const CommandLineOptionParser& options);
+		void Export(RenderEngine* renderer);
+
+		std::string Path;	// "-" -> stdout (streams only)
+		std::string Format; // empty -> pick by the extension
+		glm::ivec2 Size;
+		int Supersample; // 1, 2, 4 or 8
+
+		float Time, CachedTime, TimeDelta;
+		int FrameIndex;
+		bool WASD[4];
+		glm::vec4 Mouse;
+
+		bool Sequence;
+		float SequenceDuration;
+		int SequenceFPS;
+		int FrameStart, FrameEnd; // FrameEnd is inclusive, -1 -> last frame
+		int ShardIndex, ShardCount;
+		bool Resume;
+
+	private:
+		void m_exportImage(RenderEngine* renderer, int width, int height);
+		void m_exportSequence(RenderEngine* renderer, int width, int height);
+	};
+}
\ No newline at end of file
@@ -74,6 +74,11 @@ namespace ed {
 	ProjectParser::~ProjectParser()
 	{
 	}
+	void ProjectParser::ModifyProject()
+	{
+		m_modified = true;
+		m_renderer->InvalidatePlan();
+	}
 	void ProjectParser::Open(const std::string& file)
 	{
 		Logger::Get().Log("Opening a project file " + file);
@@ -106,6 +111,10 @@ namespace ed {
 				pluginTest = false;
 
 				std::string msg = "The project you are trying to open requires plugin \"" + pname + "\".";
+				if (m_ui == nullptr) { // headless
+					Logger::Get().Log(msg, true);
+					continue;
+				}
 
 				const SDL_MessageBoxButtonData buttons[] = {
 					{ SDL_MESSAGEBOX_BUTTON_RETURNKEY_DEFAULT, 0, "OK" },
@@ -132,6 +141,10 @@ namespace ed {
 						pluginTest = false;
 
 						std::string msg = "The project you are trying to open requires plugin " + pname + " version " + std::to_string(pver) + " while you have version " + std::to_string(instPVer) + " installed.\n";
+						if (m_ui == nullptr) { // headless
+							Logger::Get().Log(msg, true);
+							continue;
+						}
 
 						const SDL_MessageBoxButtonData buttons[] = {
 							{ /* .flags, .buttonid, .text */ 0, 1, "NO" },
@@ -991,22 +1004,75 @@ namespace ed {
 	}
 	eng::Model* ProjectParser::LoadModel(const std::string& file)
 	{
-		// return already loaded model
+		// return already loaded model, try again if it failed to load
+		Settings& settings = Settings::Instance();
+
 		for (auto& mdl : m_models)
-			if (mdl.first == file)
+			if (mdl.first == file) {
+				if (!mdl.second->IsLoaded() && !mdl.second->IsLoading()) {
+					mdl.second->SetOptimization(settings.General.OptimizeModels, settings.General.OptimizeModelOverdraw);
+					mdl.second->LoadFromFileAsync(GetProjectPath(file));
+				}
 				return mdl.second;
+			}
 
-		m_models.push_back(std::make_pair(file, new eng::Model()));
-
-		// load the model
-		std::string path = GetProjectPath(file);
-		bool loaded = m_models[m_models.size() - 1].second->LoadFromFile(path);
-		if (!loaded) {
-			m_models.erase(m_models.begin() + (m_models.size() - 1));
+		if (!FileExists(file)) {
+			Logger::Get().Log("3D model file \"" + file + "\" doesn't exist", true);
 			return nullptr;
 		}
 
-		return m_models[m_models.size() - 1].second;
+		// the items get an empty model right away, meshes are added once the import finishes
+		eng::Model* mdl = new eng::Model();
+		mdl->SetOptimization(settings.General.OptimizeModels, settings.General.OptimizeModelOverdraw);
+		mdl->LoadFromFileAsync(GetProjectPath(file));
+		m_models.push_back(std::make_pair(file, mdl));
+
+		return mdl;
+	}
+	void ProjectParser::UpdateModels(bool wait)
+	{
+		for (auto& mdl : m_models) {
+			if (mdl.second->Update(wait) && mdl.second->IsLoaded())
+				RecreateModelVAOs(mdl.second);
+		}
+	}
+	void ProjectParser::RecreateModelVAOs(eng::Model* model)
+	{
+		// VAOs depend on the pass' input layout and on the instance buffer
+		for (PipelineItem* pass : m_pipe->GetList()) {
+			if (pass->Type != PipelineItem::ItemType::ShaderPass)
+				continue;
+
+			pipe::ShaderPass* passData = (pipe::ShaderPass*)pass->Data;
+			for (PipelineItem* item : passData->Items) {
+				if (item->Type != PipelineItem::ItemType::Model || ((pipe::Model*)item->Data)->Data != model)
+					continue;
+
+				BufferObject* bobj = (BufferObject*)((pipe::Model*)item->Data)->InstanceBuffer;
+				if (bobj != nullptr)
+					gl::CreateVAO(model, passData->InputLayout, bobj->ID, m_objects->ParseBufferFormat(bobj->ViewFormat));
+				else
+					gl::CreateVAO(model, passData->InputLayout);
+			}
+		}
+	}
+	bool ProjectParser::IsLoadingModels()
+	{
+		for (auto& mdl : m_models)
+			if (mdl.second->IsLoading())
+				return true;
+		return false;
+	}
+	float ProjectParser::GetModelLoadProgress()
+	{
+		float progress = 0.0f;
+		int count = 0;
+		for (auto& mdl : m_models)
+			if (mdl.second->IsLoading()) {
+				progress += mdl.second->GetLoadProgress();
+				count++;
+			}
+		return count == 0 ? 1.0f : progress / count;
 	}
 	void ProjectParser::SaveProjectFile(const std::string& file, const std::string& data)
 	{
@@ -1327,6 +1393,8 @@ namespace ed {
 					itemNode.append_child("instancecount").text().set(data->InstanceCount);
 				if (data->InstanceBuffer != nullptr)
 					itemNode.append_child("instancebuffer").text().set(m_objects->GetByBufferID(((BufferObject*)data->InstanceBuffer)->ID)->Name.c_str());
+				if (data->Data != nullptr && data->Data->GetVertexCompression() != eng::Model::VertexCompression::None)
+					itemNode.append_child("vertexformat").text().set(data->Data->GetVertexCompression() == eng::Model::VertexCompression::Compact ? "compact" : "quantized");
 			} else if (item->Type == PipelineItem::ItemType::VertexBuffer) {
 				itemNode.append_attribute("type").set_value("vertexbuffer");
 
@@ -1389,6 +1457,7 @@ namespace ed {
 			char itemName[PIPELINE_ITEM_NAME_LENGTH];
 			ed::PipelineItem::ItemType itemType = ed::PipelineItem::ItemType::Geometry;
 			void* itemData = nullptr;
+			eng::Model::VertexCompression vertexCompression = eng::Model::VertexCompression::None;
 
 			strcpy(itemName, itemNode.attribute("name").as_string());
 
@@ -1572,6 +1641,12 @@ namespace ed {
 						mdata->InstanceCount = attrNode.text().as_int();
 					else if (strcmp(attrNode.name(), "instancebuffer") == 0)
 						modelUBOs[mdata] = std::make_pair(attrNode.text().as_string(), data);
+					else if (strcmp(attrNode.name(), "vertexformat") == 0) {
+						if (strcmp(attrNode.text().as_string(), "compact") == 0)
+							vertexCompression = eng::Model::VertexCompression::Compact;
+						else if (strcmp(attrNode.text().as_string(), "quantized") == 0)
+							vertexCompression = eng::Model::VertexCompression::Quantized;
+					}
 				}
 
 				if (strlen(mdata->Filename) > 0)
@@ -1664,9 +1739,10 @@ namespace ed {
 				eng::Model* ptrObject = LoadModel(tData->Filename);
 				bool loaded = ptrObject != nullptr;
 
-				if (loaded)
+				if (loaded) {
 					tData->Data = ptrObject;
-				else
+					ptrObject->SetVertexCompression(vertexCompression);
+				} else
 					m_msgs->Add(ed::MessageStack::Type::Error, name, "Failed to load .obj model " + std::string(itemName));
 			}
 
@@ -1708,7 +1784,7 @@ namespace ed {
 			// check if it should be collapsed
 			if (!passNode.attribute("collapsed").empty()) {
 				bool cs = passNode.attribute("collapsed").as_bool();
-				if (cs)
+				if (cs && m_ui != nullptr)
 					((PipelineUI*)m_ui->Get(ViewID::Pipeline))->Collapse(data);
 			}
 
@@ -2191,6 +2267,11 @@ namespace ed {
 		for (pugi::xml_node settingItem : projectNode.child("settings").children("entry")) {
 			if (!settingItem.attribute("type").empty()) {
 				std::string type = settingItem.attribute("type").as_string();
+
+				// UI state - there is no UI when rendering headless
+				if (m_ui == nullptr && (type == "property" || type == "file" || type == "pinned"))
+					continue;
+
 				if (type == "property") {
 					PropertyUI* props = ((PropertyUI*)m_ui->Get(ViewID::Properties));
 					if (!settingItem.attribute("name").empty()) {
@@ -2335,7 +2416,7 @@ namespace ed {
 				// check if it should be collapsed
 				if (!passNode.attribute("collapsed").empty()) {
 					bool cs = passNode.attribute("collapsed").as_bool();
-					if (cs)
+					if (cs && m_ui != nullptr)
 						((PipelineUI*)m_ui->Get(ViewID::Pipeline))->Collapse(data);
 				}
 
@@ -3133,9 +3214,7 @@ namespace ed {
 					bufRead.read((char*)buf->Data, buf->Size);
 				bufRead.close();
 
-				glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-				glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // allocate 0 bytes of memory
-				glBindBuffer(GL_UNIFORM_BUFFER, 0);
+				m_objects->UploadBuffer(buf);
 
 				for (pugi::xml_node bindNode : objectNode.children("bind")) {
 					const pugi::char_t* passBindName = bindNode.attribute("name").as_string();
@@ -3205,11 +3284,11 @@ namespace ed {
 				BufferObject* bobj = m_objects->Get(mdl.second.first)->Buffer;
 				mdl.first->InstanceBuffer = bobj;
 
-				for (auto& mesh : mdl.first->Data->Meshes)
-					gl::CreateVAO(mesh.VAO, mesh.VBO, mdl.second.second->InputLayout, mesh.EBO, bobj->ID, m_objects->ParseBufferFormat(bobj->ViewFormat));
+				if (mdl.first->Data->IsLoaded())
+					gl::CreateVAO(mdl.first->Data, mdl.second.second->InputLayout, bobj->ID, m_objects->ParseBufferFormat(bobj->ViewFormat));
 			} else { // recreate vao anyway
-				for (auto& mesh : mdl.first->Data->Meshes)
-					gl::CreateVAO(mesh.VAO, mesh.VBO, mdl.second.second->InputLayout, mesh.EBO);
+				if (mdl.first->Data->IsLoaded())
+					gl::CreateVAO(mdl.first->Data, mdl.second.second->InputLayout);
 			}
 		}
 		for (auto& vb : vbUBOs) {
@@ -3246,6 +3325,11 @@ namespace ed {
 		for (pugi::xml_node settingItem : projectNode.child("settings").children("entry")) {
 			if (!settingItem.attribute("type").empty()) {
 				std::string type = settingItem.attribute("type").as_string();
+
+				// UI state - there is no UI when rendering headless
+				if (m_ui == nullptr && (type == "property" || type == "file" || type == "pinned"))
+					continue;
+
 				if (type == "property") {
 					PropertyUI* props = ((PropertyUI*)m_ui->Get(ViewID::Properties));
 					if (!settingItem.attribute("name").empty()) {
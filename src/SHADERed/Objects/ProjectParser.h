@@ -46,7 +46,11 @@ namespace ed {
 		std::string LoadProjectFile(const std::string& file);
 		std::string LoadFile(const std::string& file);
 		char* LoadProjectFile(const std::string& file, size_t& len);
-		eng::Model* LoadModel(const std::string& file);
+		eng::Model* LoadModel(const std::string& file); // model is loaded in the background, see UpdateModels()
+		void UpdateModels(bool wait = false);			// upload the models that were loaded on the worker threads
+		void RecreateModelVAOs(eng::Model* model);		// call after the model's GPU buffers were recreated
+		bool IsLoadingModels();
+		float GetModelLoadProgress();
 
 		void SaveProjectFile(const std::string& file, const std::string& data);
 
@@ -63,7 +67,7 @@ namespace ed {
 		inline const std::string& GetOpenedFile() { return m_file; }
 		inline const std::string& GetTemplate() { return m_template; }
 
-		inline void ModifyProject() { m_modified = true; }
+		void ModifyProject(); // also invalidates the renderer's cached render plan
 		inline bool IsProjectModified() { return m_modified; }
 
 	private:
@@ -8,10 +8,13 @@
 #include <SHADERed/Objects/PipelineManager.h>
 #include <SHADERed/Objects/RenderEngine.h>
 #include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/ShaderCache.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
 #include <SHADERed/Objects/SystemVariableManager.h>
 
 #include <algorithm>
+#include <fstream>
+#include <iomanip>
 #include <glm/gtx/intersect.hpp>
 
 static const GLenum fboBuffers[] = { GL_COLOR_ATTACHMENT0, GL_COLOR_ATTACHMENT1, GL_COLOR_ATTACHMENT2, GL_COLOR_ATTACHMENT3, GL_COLOR_ATTACHMENT4, GL_COLOR_ATTACHMENT5, GL_COLOR_ATTACHMENT6, GL_COLOR_ATTACHMENT7, GL_COLOR_ATTACHMENT8, GL_COLOR_ATTACHMENT9, GL_COLOR_ATTACHMENT10, GL_COLOR_ATTACHMENT11, GL_COLOR_ATTACHMENT12, GL_COLOR_ATTACHMENT13, GL_COLOR_ATTACHMENT14, GL_COLOR_ATTACHMENT15 };
@@ -87,8 +90,14 @@ namespace ed {
 			, m_tessellationSupported(true)
 			, m_tessMaxPatchVertices(0)
 			, m_wasMultiPick(false)
+			, m_frameTimer(nullptr)
 	{
 		m_paused = false;
+		m_totalPerfTime = 0;
+		m_frameTimer.Create();
+		m_planDirty = true;
+		m_cacheDirty = false;
+		m_cacheResync = false;
 
 		glGenTextures(1, &m_rtColor);
 		glGenTextures(1, &m_rtDepth);
@@ -100,6 +109,20 @@ namespace ed {
 		bool isDebugShaderCompiled = gl::CheckShaderCompilationStatus(m_generalDebugShader, msg);
 		if (!isDebugShaderCompiled)
 			Logger::Get().Log("Failed to compile the debug pixel shader.", true);
+
+		// program binaries are only valid for the driver that created them
+		GLint binaryFormatCount = 0;
+		if (GLEW_ARB_get_program_binary)
+			glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &binaryFormatCount);
+		m_programBinarySupported = binaryFormatCount > 0;
+		m_programCacheHits = 0;
+		m_programCacheMisses = 0;
+
+		const GLubyte* glInfo[] = { glGetString(GL_VENDOR), glGetString(GL_RENDERER), glGetString(GL_VERSION) };
+		m_programCacheInfo = "program " + std::to_string(SHADERED_VERSION);
+		for (int i = 0; i < 3; i++)
+			if (glInfo[i] != nullptr)
+				m_programCacheInfo += " " + std::string((const char*)glInfo[i]);
 	}
 	RenderEngine::~RenderEngine()
 	{
@@ -109,6 +132,7 @@ namespace ed {
 		glDeleteTextures(1, &m_rtDepthMS);
 		glDeleteShader(m_generalDebugShader);
 		FlushCache();
+		m_frameTimer.Destroy();
 	}
 	void RenderEngine::Render(int width, int height, bool isDebug, PipelineItem* breakItem)
 	{
@@ -117,6 +141,8 @@ namespace ed {
 		if (isMSAA)
 			glEnable(GL_MULTISAMPLE);
 
+		ShaderVariableContainer::ResetUniformCallCount();
+
 		// recreate render texture if size has changed
 		if (m_lastSize.x != width || m_lastSize.y != height) {
 			m_lastSize = glm::vec2(width, height);
@@ -154,6 +180,19 @@ namespace ed {
 		// cache elements
 		m_cache();
 
+		// link the shader passes that were compiled on the worker threads
+		m_updateCompileJobs(isDebug || SystemVariableManager::Instance().IsSavingToFile());
+
+		// upload the 3D models that were imported on the worker threads
+		m_project->UpdateModels(isDebug || SystemVariableManager::Instance().IsSavingToFile());
+
+		// copy the textures that were decoded on the worker threads to the GPU
+		m_objects->UpdateTextures(isDebug || SystemVariableManager::Instance().IsSavingToFile());
+
+		// resolve bindings & draw calls only when something has changed
+		if (m_planDirty || m_plan.size() != m_items.size())
+			m_buildPlan();
+
 		auto& systemVM = SystemVariableManager::Instance();
 
 		auto& itemVarValues = GetItemVariableValues();
@@ -164,41 +203,21 @@ namespace ed {
 
 		m_plugins->BeginRender();
 
-		// check if we need to perform performance measurement
-		bool performPerfMeasure = Settings::Instance().General.Profiler && m_lastPerfMeasure.GetElapsedTime() > 0.4f;
+		// collect the GPU times from the previous frames & measure this one (debug renders would only pollute the history)
+		bool performPerfMeasure = Settings::Instance().General.Profiler && !isDebug;
+		bool performDrawMeasure = performPerfMeasure && Settings::Instance().General.ProfilerDraws;
 		if (performPerfMeasure) {
-			bool isAllDone = true;
-			unsigned long long totalTime = 0;
-
-			for (int i = 0; i < m_perfTimers.size(); i++) {
-				if (!m_perfTimers[i].IsDone) {
-					isAllDone = false;
-
-					int queryDone = 0;
-					glGetQueryObjectiv(m_perfTimers[i].Object, GL_QUERY_RESULT_AVAILABLE, &queryDone);
-
-					if (queryDone) {
-						glGetQueryObjectui64v(m_perfTimers[i].Object, GL_QUERY_RESULT, &m_perfTimers[i].LastTime);
-						m_perfTimers[i].IsDone = true;
-					}
-				}
-				totalTime += m_perfTimers[i].LastTime;
-			}
-			
-			m_totalPerfTime = totalTime;
-			performPerfMeasure &= isAllDone;
-
-			if (performPerfMeasure)
-				m_lastPerfMeasure.Restart();
+			PollPerformanceTimers();
+			m_frameTimer.Begin();
 		}
 
 		for (int i = 0; i < m_items.size(); i++) {
 			PipelineItem* it = m_items[i];
 
-			if (performPerfMeasure) {
-				glBeginQuery(GL_TIME_ELAPSED, m_perfTimers[i].Object);
-				m_perfTimers[i].IsDone = false;
-			}
+			if (performPerfMeasure)
+				m_perfTimers[i].Begin();
+
+			const PlanPass& plan = m_plan[i];
 
 			if (it->Type == PipelineItem::ItemType::ShaderPass) {
 				pipe::ShaderPass* data = (pipe::ShaderPass*)it->Data;
@@ -206,9 +225,6 @@ namespace ed {
 				if (!data->Active || data->Items.size() <= 0 || data->RTCount == 0)
 					continue;
 
-				const std::vector<GLuint>& srvs = m_objects->GetBindList(m_items[i]);
-				const std::vector<GLuint>& ubos = m_objects->GetUniformBindList(m_items[i]);
-
 				// create/update fbo if necessary
 				m_updatePassFBO(data);
 
@@ -244,7 +260,9 @@ namespace ed {
 					GLuint rt = data->RenderTextures[i];
 
 					if (rt != m_rtColor) {
-						ed::RenderTextureObject* rtObject = m_objects->GetByTextureID(rt)->RT;
+						ed::RenderTextureObject* rtObject = plan.RenderTextures[i];
+						if (rtObject == nullptr)
+							continue;
 
 						rtSize = rtObject->CalculateSize(width, height);
 
@@ -279,27 +297,11 @@ namespace ed {
 					glUseProgram(m_shaders[i]);
 
 				// bind shader resource views
-				for (int j = 0; j < srvs.size(); j++) {
-					ObjectManagerItem* srvData = m_objects->GetByTextureID(srvs[j]);
-
-					glActiveTexture(GL_TEXTURE0 + j);
-					if (srvData->Type == ObjectType::CubeMap)
-						glBindTexture(GL_TEXTURE_CUBE_MAP, srvs[j]);
-					else if (srvData->Type == ObjectType::Image3D || srvData->Type == ObjectType::Texture3D)
-						glBindTexture(GL_TEXTURE_3D, srvs[j]);
-					else if (srvData->Type == ObjectType::PluginObject) {
-						PluginObject* pobj = srvData->Plugin;
-						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
-					} else
-						glBindTexture(GL_TEXTURE_2D, srvs[j]);
-
-					
-					if (ShaderCompiler::GetShaderLanguageFromExtension(data->PSPath) == ShaderLanguage::GLSL) // TODO: or should this be for vulkan glsl too?
-						data->Variables.UpdateTexture(m_shaders[i], j);
-				}
+				m_bindTextures(plan, data->Variables, m_shaders[i]);
 
-				for (int j = 0; j < ubos.size(); j++)
-					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
+				for (int j = 0; j < plan.UBOs.size(); j++)
+					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, plan.UBOs[j].ID);
+				m_markWrittenBuffers(plan);
 
 				// clear messages
 				//if (m_msgs->GetGroupWarningMsgCount(it->Name) > 0)
@@ -308,18 +310,25 @@ namespace ed {
 				// bind default states for each shader pass
 				DefaultState::Bind();
 
+				if (performDrawMeasure)
+					m_updateDrawTimers(m_perfTimers[i], plan);
+
 				// render pipeline items
-				for (int j = 0; j < data->Items.size(); j++) {
-					PipelineItem* item = data->Items[j];
+				data->Variables.BeginPass();
+				for (int j = 0; j < plan.Draws.size(); j++) {
+					const PlanDraw& draw = plan.Draws[j];
+					PipelineItem* item = draw.Item;
+
+					if (performDrawMeasure)
+						m_perfTimers[i].Children[j].Begin();
 
 					systemVM.SetPicked(false);
 
 					// update the value for this element and check if we picked it
 					if (item->Type == PipelineItem::ItemType::Geometry || item->Type == PipelineItem::ItemType::Model || item->Type == PipelineItem::ItemType::VertexBuffer || item->Type == PipelineItem::ItemType::PluginItem) {
 						if (m_pickAwaiting) m_pickItem(item, m_wasMultiPick);
-						for (int k = 0; k < itemVarValues.size(); k++)
-							if (itemVarValues[k].Item == item)
-								itemVarValues[k].Variable->Data = itemVarValues[k].NewValue->Data;
+						for (int k : draw.ItemValues)
+							itemVarValues[k].Variable->Data = itemVarValues[k].NewValue->Data;
 
 						if (isDebug) {
 							float r = (debugID & 0x000000FF) / 255.0f;
@@ -342,7 +351,7 @@ namespace ed {
 						} else
 							systemVM.SetGeometryTransform(item, geoData->Scale, geoData->Rotation, geoData->Position);
 
-						systemVM.SetPicked(std::count(m_pick.begin(), m_pick.end(), item));
+						systemVM.SetPicked(draw.Picked);
 
 						// bind variables
 						data->Variables.Bind(item);
@@ -355,7 +364,7 @@ namespace ed {
 					} else if (item->Type == PipelineItem::ItemType::Model) {
 						pipe::Model* objData = reinterpret_cast<pipe::Model*>(item->Data);
 
-						systemVM.SetPicked(std::count(m_pick.begin(), m_pick.end(), item));
+						systemVM.SetPicked(draw.Picked);
 						systemVM.SetGeometryTransform(item, objData->Scale, objData->Rotation, objData->Position);
 
 						// bind variables
@@ -366,28 +375,20 @@ namespace ed {
 						pipe::VertexBuffer* vbData = reinterpret_cast<pipe::VertexBuffer*>(item->Data);
 						ed::BufferObject* bobj = (ed::BufferObject*)vbData->Buffer;
 
-						if (bobj != 0) {
-							auto bobjFmt = m_objects->ParseBufferFormat(bobj->ViewFormat);
-							int stride = 0;
-							for (const auto& f : bobjFmt)
-								stride += ShaderVariable::GetSize(f, true);
-
-							if (stride != 0) {
-								int vertCount = bobj->Size / stride;
+						if (bobj != 0 && draw.Stride != 0) {
+							int vertCount = bobj->Size / draw.Stride;
 
-								systemVM.SetGeometryTransform(item, vbData->Scale, vbData->Rotation, vbData->Position);
-								systemVM.SetPicked(std::count(m_pick.begin(), m_pick.end(), item));
+							systemVM.SetGeometryTransform(item, vbData->Scale, vbData->Rotation, vbData->Position);
+							systemVM.SetPicked(draw.Picked);
 
-								// bind variables
-								data->Variables.Bind(item);
+							// bind variables
+							data->Variables.Bind(item);
 
-								
-								glBindVertexArray(vbData->VAO);
-								if (vbData->Instanced)
-									glDrawArraysInstanced(vbData->Topology, 0, vertCount, vbData->InstanceCount);
-								else
-									glDrawArrays(vbData->Topology, 0, vertCount);
-							}
+							glBindVertexArray(vbData->VAO);
+							if (vbData->Instanced)
+								glDrawArraysInstanced(vbData->Topology, 0, vertCount, vbData->InstanceCount);
+							else
+								glDrawArrays(vbData->Topology, 0, vertCount);
 						}
 					} else if (item->Type == PipelineItem::ItemType::RenderState) {
 						pipe::RenderState* state = reinterpret_cast<pipe::RenderState*>(item->Data);
@@ -445,7 +446,7 @@ namespace ed {
 							m_pickItem(item, m_wasMultiPick);
 
 						if (pldata->Owner->PipelineItem_IsPickable(pldata->Type, pldata->PluginData))
-							systemVM.SetPicked(std::count(m_pick.begin(), m_pick.end(), item));
+							systemVM.SetPicked(draw.Picked);
 						else
 							systemVM.SetPicked(false);
 
@@ -453,11 +454,13 @@ namespace ed {
 					}
 
 					// set the old value back
-					if (item->Type == PipelineItem::ItemType::Geometry || item->Type == PipelineItem::ItemType::Model || item->Type == PipelineItem::ItemType::VertexBuffer || item->Type == PipelineItem::ItemType::PluginItem)
-						for (int k = 0; k < itemVarValues.size(); k++)
-							if (itemVarValues[k].Item == item)
-								itemVarValues[k].Variable->Data = itemVarValues[k].OldValue;
+					for (int k : draw.ItemValues)
+						itemVarValues[k].Variable->Data = itemVarValues[k].OldValue;
+
+					if (performDrawMeasure)
+						m_perfTimers[i].Children[j].End();
 				}
+				data->Variables.EndPass();
 
 				if (isDebug)
 					data->Variables.UpdateUniformInfo(m_shaders[i]); // return old variable data
@@ -479,9 +482,6 @@ namespace ed {
 				if (!data->Active)
 					continue;
 
-				const std::vector<GLuint>& srvs = m_objects->GetBindList(m_items[i]);
-				const std::vector<GLuint>& ubos = m_objects->GetUniformBindList(m_items[i]);
-
 				if (m_shaders[i] == 0)
 					continue;
 
@@ -489,46 +489,27 @@ namespace ed {
 				glUseProgram(m_shaders[i]);
 				
 				// bind shader resource views
-				for (int j = 0; j < srvs.size(); j++) {
-					ObjectManagerItem* srvData = m_objects->GetByTextureID(srvs[j]);
-
-					glActiveTexture(GL_TEXTURE0 + j);
-					if (srvData->Type == ObjectType::CubeMap)
-						glBindTexture(GL_TEXTURE_CUBE_MAP, srvs[j]);
-					else if (srvData->Type == ObjectType::Image3D || srvData->Type == ObjectType::Texture3D)
-						glBindTexture(GL_TEXTURE_3D, srvs[j]);
-					else if (srvData->Type == ObjectType::PluginObject) {
-						PluginObject* pobj = srvData->Plugin;
-						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
-					} else
-						glBindTexture(GL_TEXTURE_2D, srvs[j]);
-
-					if (ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL)
-						data->Variables.UpdateTexture(m_shaders[i], j);
-				}
+				m_bindTextures(plan, data->Variables, m_shaders[i]);
 
 				// bind buffers
-				int cMax = (m_uboMax[data] = std::max<int>(ubos.size(), m_uboMax[data]));
-				for (int j = ubos.size(); j < cMax; j++)
+				int cMax = (m_uboMax[data] = std::max<int>(plan.UBOs.size(), m_uboMax[data]));
+				for (int j = plan.UBOs.size(); j < cMax; j++)
 					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, 0);
 
-				for (int j = 0; j < ubos.size(); j++) {
-					ObjectManagerItem* uboData = m_objects->GetByTextureID(ubos[j]);
-					if (uboData == nullptr)
-						uboData = m_objects->GetByBufferID(ubos[j]);
-
-					if (uboData->Type == ObjectType::Image) {
-						ImageObject* iobj = uboData->Image;
-						glBindImageTexture(j, ubos[j], 0, GL_FALSE, 0, GL_WRITE_ONLY | GL_READ_ONLY, iobj->Format);
-					} else if (uboData->Type == ObjectType::Image3D) {
-						Image3DObject* iobj = uboData->Image3D;
-						glBindImageTexture(j, ubos[j], 0, GL_TRUE, 0, GL_WRITE_ONLY | GL_READ_ONLY, iobj->Format);
-					} else if (uboData->Type == ObjectType::PluginObject) {
-						PluginObject* pobj = uboData->Plugin;
+				for (int j = 0; j < plan.UBOs.size(); j++) {
+					const PlanBinding& ubo = plan.UBOs[j];
+
+					if (ubo.Target == GL_TEXTURE_2D)
+						glBindImageTexture(j, ubo.ID, 0, GL_FALSE, 0, GL_WRITE_ONLY | GL_READ_ONLY, ubo.Object->Image->Format);
+					else if (ubo.Target == GL_TEXTURE_3D)
+						glBindImageTexture(j, ubo.ID, 0, GL_TRUE, 0, GL_WRITE_ONLY | GL_READ_ONLY, ubo.Object->Image3D->Format);
+					else if (ubo.Target == 0) {
+						PluginObject* pobj = ubo.Object->Plugin;
 						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
 					} else
-						glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
+						glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubo.ID);
 				}
+				m_markWrittenBuffers(plan);
 
 				// bind variables
 				data->Variables.Bind();
@@ -543,31 +524,13 @@ namespace ed {
 			else if (it->Type == PipelineItem::ItemType::AudioPass && !isDebug) {
 				pipe::AudioPass* data = (pipe::AudioPass*)it->Data;
 
-				const std::vector<GLuint>& srvs = m_objects->GetBindList(m_items[i]);
-				const std::vector<GLuint>& ubos = m_objects->GetUniformBindList(m_items[i]);
-
 				// bind shader resource views
-				for (int j = 0; j < srvs.size(); j++) {
-					ObjectManagerItem* srvData = m_objects->GetByTextureID(srvs[j]);
-
-					glActiveTexture(GL_TEXTURE0 + j);
-					if (srvData->Type == ObjectType::CubeMap)
-						glBindTexture(GL_TEXTURE_CUBE_MAP, srvs[j]);
-					else if (srvData->Type == ObjectType::Image3D || srvData->Type == ObjectType::Texture3D)
-						glBindTexture(GL_TEXTURE_3D, srvs[j]);
-					else if (srvData->Type == ObjectType::PluginObject) {
-						PluginObject* pobj = srvData->Plugin;
-						pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
-					} else
-						glBindTexture(GL_TEXTURE_2D, srvs[j]);
-
-					if (ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL) // TODO: or should this be for vulkan glsl too?
-						data->Variables.UpdateTexture(m_shaders[i], j);
-				}
+				m_bindTextures(plan, data->Variables, m_shaders[i]);
 
 				// bind buffers
-				for (int j = 0; j < ubos.size(); j++)
-					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, ubos[j]);
+				for (int j = 0; j < plan.UBOs.size(); j++)
+					glBindBufferBase(GL_SHADER_STORAGE_BUFFER, j, plan.UBOs[j].ID);
+				m_markWrittenBuffers(plan);
 
 				// bind variables
 				data->Variables.Bind();
@@ -584,12 +547,15 @@ namespace ed {
 			}
 
 			if (performPerfMeasure)
-				glEndQuery(GL_TIME_ELAPSED);
+				m_perfTimers[i].End();
 
 			if (it == breakItem && breakItem != nullptr)
 				break;
 		}
 
+		if (performPerfMeasure)
+			m_frameTimer.End();
+
 		m_plugins->EndRender();
 
 		// update frame index
@@ -607,6 +573,7 @@ namespace ed {
 			if (m_pickHandle != nullptr)
 				m_pickHandle(m_pick.size() == 0 ? nullptr : m_pick[m_pick.size() - 1]);
 			m_pickAwaiting = false;
+			m_planDirty = true;
 		}
 
 		if (isMSAA)
@@ -749,19 +716,16 @@ namespace ed {
 					// bind variables
 					vertexPass->Variables.Bind(item);
 
-					int vbase = 0;
-					for (const auto& mesh : objData->Data->Meshes) {
-						int vertexStart = (group >= 0) * group;
-						int maxVertexCount = (group < 0 ? mesh.Indices.size() : (vertexStart + DEBUG_PRIMITIVE_GROUP * 3));
-						int vertexCount = (group < 0 ? DEBUG_PRIMITIVE_GROUP : 1) * 3;
-
-						maxVertexCount = std::min<int>(maxVertexCount, mesh.Indices.size());
+					// meshes share one index buffer, so the model is a single primitive stream
+					int indexCount = objData->Data->GetIndexCount();
+					int vertexStart = (group >= 0) * group;
+					int maxVertexCount = (group < 0 ? indexCount : (vertexStart + DEBUG_PRIMITIVE_GROUP * 3));
+					int vertexCount = (group < 0 ? DEBUG_PRIMITIVE_GROUP : 1) * 3;
 
-						glBindVertexArray(mesh.VAO);
-						DebugDrawPrimitives(vertexStart, vertexCount, maxVertexCount, 0, GL_TRIANGLES, sedVarLoc, objData->Instanced, objData->InstanceCount, true, vbase);
+					maxVertexCount = std::min<int>(maxVertexCount, indexCount);
 
-						vbase += mesh.Indices.size();
-					}
+					glBindVertexArray(objData->Data->VAO);
+					DebugDrawPrimitives(vertexStart, vertexCount, maxVertexCount, 0, GL_TRIANGLES, sedVarLoc, objData->Instanced, objData->InstanceCount, true);
 				} else if (item->Type == PipelineItem::ItemType::PluginItem) {
 					pipe::PluginItemData* plData = reinterpret_cast<pipe::PluginItemData*>(item->Data);
 
@@ -998,17 +962,15 @@ namespace ed {
 					// bind variables
 					vertexPass->Variables.Bind(item);
 
-					for (const auto& mesh : objData->Data->Meshes) {
-						int vertexCount = mesh.Indices.size();
-						int iStart = (group >= 0) * group;
-						int iCount = group < 0 ? objData->InstanceCount : (objData->InstanceCount + DEBUG_INSTANCE_GROUP);
-						int iStep = group < 0 ? DEBUG_INSTANCE_GROUP : 1;
+					int vertexCount = objData->Data->GetIndexCount();
+					int iStart = (group >= 0) * group;
+					int iCount = group < 0 ? objData->InstanceCount : (objData->InstanceCount + DEBUG_INSTANCE_GROUP);
+					int iStep = group < 0 ? DEBUG_INSTANCE_GROUP : 1;
 
-						iCount = std::min<int>(iCount, objData->InstanceCount);
+					iCount = std::min<int>(iCount, objData->InstanceCount);
 
-						glBindVertexArray(mesh.VAO);
-						DebugDrawInstanced(iStart, iStep, iCount, vertexCount, GL_TRIANGLES, sedVarLoc);
-					}
+					glBindVertexArray(objData->Data->VAO);
+					DebugDrawInstanced(iStart, iStep, iCount, vertexCount, GL_TRIANGLES, sedVarLoc, true);
 				} else if (item->Type == PipelineItem::ItemType::VertexBuffer) {
 					pipe::VertexBuffer* vbData = reinterpret_cast<pipe::VertexBuffer*>(item->Data);
 					ed::BufferObject* bobj = (ed::BufferObject*)vbData->Buffer;
@@ -1108,6 +1070,23 @@ namespace ed {
 	}
 	void RenderEngine::Recompile(const char* name)
 	{
+		for (int i = 0; i < m_items.size(); i++)
+			if (strcmp(m_items[i]->Name, name) == 0)
+				m_recompileItem(m_items[i]);
+
+		Render();
+	}
+	void RenderEngine::RecompileAll()
+	{
+		for (int i = 0; i < m_items.size(); i++)
+			m_recompileItem(m_items[i]);
+
+		Render();
+	}
+	void RenderEngine::m_recompileItem(PipelineItem* item)
+	{
+		const char* name = item->Name;
+
 		Logger::Get().Log("Recompiling " + std::string(name));
 
 		m_msgs->BuildOccured = true;
@@ -1115,304 +1094,379 @@ namespace ed {
 
 		m_plugins->HandleApplicationEvent(plugin::ApplicationEvent::PipelineItemCompiled, (void*)name, nullptr);
 
-		GLchar shaderMessage[1024] = { 0 };
-		for (int i = 0; i < m_items.size(); i++) {
-			PipelineItem* item = m_items[i];
-			if (strcmp(item->Name, name) == 0) {
-				if (item->Type == PipelineItem::ItemType::ShaderPass) {
-					pipe::ShaderPass* shader = (pipe::ShaderPass*)item->Data;
-					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(name);
-
-					SPIRVQueue.push_back(item);
-
-					m_msgs->ClearGroup(name);
-
-					glDeleteShader(m_shaderSources[i].VS);
-					glDeleteShader(m_shaderSources[i].PS);
-					glDeleteShader(m_shaderSources[i].GS);
-					glDeleteShader(m_shaderSources[i].TCS);
-					glDeleteShader(m_shaderSources[i].TES);
-
-					std::string psContent = "", vsContent = "",
-								vsEntry = shader->VSEntry,
-								psEntry = shader->PSEntry;
-					int lineBias = 0;
-					ShaderLanguage psLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->PSPath);
-					ShaderLanguage vsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->VSPath);
-					ShaderLanguage gsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->GSPath);
-					ShaderLanguage tcsLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->TCSPath);
-					ShaderLanguage tesLang = ShaderCompiler::GetShaderLanguageFromExtension(shader->TESPath);
+		if (item->Type == PipelineItem::ItemType::ShaderPass || (item->Type == PipelineItem::ItemType::ComputePass && m_computeSupported))
+			m_queueCompileJob(m_createCompileJob(item, true));
+		else if (item->Type == PipelineItem::ItemType::AudioPass) {
+			pipe::AudioPass* shader = (pipe::AudioPass*)item->Data;
 
-					// pixel shader
-					bool psCompiled = false;
+			m_msgs->ClearGroup(name);
 
-					if (psLang == ShaderLanguage::Plugin)
-						psCompiled = m_pluginCompileToSpirv(item, shader->PSSPV, shader->PSPath, psEntry, plugin::ShaderStage::Pixel, shader->Macros.data(), shader->Macros.size());
-					else
-						psCompiled = ShaderCompiler::CompileToSPIRV(shader->PSSPV, psLang, shader->PSPath, ShaderStage::Pixel, psEntry, shader->Macros, m_msgs, m_project);
+			std::string content = m_project->LoadProjectFile(shader->Path);
 
-					if (psLang == ShaderLanguage::GLSL) { // GLSL
-						psContent = m_project->LoadProjectFile(shader->PSPath);
-						m_includeCheck(psContent, std::vector<std::string>(), lineBias);
-						m_applyMacros(psContent, shader);
-					} else { // HLSL / VK
-						psContent = ShaderCompiler::ConvertToGLSL(shader->PSSPV, psLang, ShaderStage::Pixel, shader->TSUsed, shader->GSUsed, m_msgs);
-						psEntry = "main";
+			// audio shader
+			if (ShaderCompiler::GetShaderLanguageFromExtension(shader->Path) == ShaderLanguage::GLSL)
+				m_applyMacros(content, shader);
 
-						if (psLang == ShaderLanguage::Plugin)
-							psContent = m_pluginProcessGLSL(shader->PSPath, psContent.c_str());		
-					}
-
-					shader->Variables.UpdateTextureList(psContent);
-					GLuint ps = gl::CompileShader(GL_FRAGMENT_SHADER, psContent.c_str());
-					psCompiled &= gl::CheckShaderCompilationStatus(ps, shaderMessage);
-
-					// vertex shader
-					lineBias = 0;
-					bool vsCompiled = false;
-
-					if (vsLang == ShaderLanguage::Plugin)
-						vsCompiled = m_pluginCompileToSpirv(item, shader->VSSPV, shader->VSPath, vsEntry, plugin::ShaderStage::Vertex, shader->Macros.data(), shader->Macros.size());
-					else
-						vsCompiled = ShaderCompiler::CompileToSPIRV(shader->VSSPV, vsLang, shader->VSPath, ShaderStage::Vertex, vsEntry, shader->Macros, m_msgs, m_project);
-					
-					// generate glsl
-					if (vsLang == ShaderLanguage::GLSL) { // GLSL
-						vsContent = m_project->LoadProjectFile(shader->VSPath);
-						m_includeCheck(vsContent, std::vector<std::string>(), lineBias);
-						m_applyMacros(vsContent, shader);
-					} else { // HLSL / VK
-						vsContent = ShaderCompiler::ConvertToGLSL(shader->VSSPV, vsLang, ShaderStage::Vertex, shader->TSUsed, shader->GSUsed, m_msgs);
-						vsEntry = "main";
+			shader->Variables.RemoveProgram(shader->Stream.GetShader());
+			shader->Stream.CompileFromShaderSource(m_project, m_msgs, content, shader->Macros, ShaderCompiler::GetShaderLanguageFromExtension(shader->Path) == ShaderLanguage::HLSL);
+			shader->Variables.UpdateUniformInfo(shader->Stream.GetShader());
+		} 
+		else if (item->Type == PipelineItem::ItemType::PluginItem) {
+			pipe::PluginItemData* idata = (pipe::PluginItemData*)item->Data;
+			idata->Owner->HandleRecompile(name);
+		}
+	}
+	void RenderEngine::FinishCompilation(PipelineItem* item)
+	{
+		m_updateCompileJobs(true, item);
+	}
+	RenderEngine::CompileJob* RenderEngine::m_createCompileJob(PipelineItem* item, bool isRecompile)
+	{
+		CompileJob* job = new CompileJob();
+		job->Item = item;
+		job->IsRecompile = isRecompile;
+		job->Discarded = false;
+		job->Linked = false;
+		job->Succeeded = false;
+		job->SourceEmpty = false;
+		job->LinkTime = 0.0f;
+		job->GSUsed = false;
+		job->TSUsed = false;
+
+		auto addStage = [&](ShaderStage stage, GLenum type, const char* path, const char* entry) {
+			CompileStage ret;
+			ret.Stage = stage;
+			ret.Type = type;
+			ret.Language = ShaderCompiler::GetShaderLanguageFromExtension(path);
+			ret.Path = path;
+			ret.Entry = entry;
+			ret.Compiled = false;
+			ret.Time = 0.0f;
+			ret.Messages.CurrentItem = item->Name;
+			job->Stages.push_back(std::move(ret));
+		};
+
+		if (item->Type == PipelineItem::ItemType::ShaderPass) {
+			pipe::ShaderPass* shader = (pipe::ShaderPass*)item->Data;
+			job->GSUsed = shader->GSUsed;
+			job->TSUsed = shader->TSUsed;
+			job->Macros = shader->Macros;
+
+			addStage(ShaderStage::Vertex, GL_VERTEX_SHADER, shader->VSPath, shader->VSEntry);
+			addStage(ShaderStage::Pixel, GL_FRAGMENT_SHADER, shader->PSPath, shader->PSEntry);
+			if (shader->GSUsed && strlen(shader->GSPath) > 0 && strlen(shader->GSEntry) > 0)
+				addStage(ShaderStage::Geometry, GL_GEOMETRY_SHADER, shader->GSPath, shader->GSEntry);
+			if (shader->TSUsed && m_tessellationSupported) {
+				if (strlen(shader->TCSPath) > 0 && strlen(shader->TCSEntry) > 0)
+					addStage(ShaderStage::TessellationControl, GL_TESS_CONTROL_SHADER, shader->TCSPath, shader->TCSEntry);
+				if (strlen(shader->TESPath) > 0 && strlen(shader->TESEntry) > 0)
+					addStage(ShaderStage::TessellationEvaluation, GL_TESS_EVALUATION_SHADER, shader->TESPath, shader->TESEntry);
+			}
+		} else if (item->Type == PipelineItem::ItemType::ComputePass) {
+			pipe::ComputePass* shader = (pipe::ComputePass*)item->Data;
+			job->Macros = shader->Macros;
 
-						if (vsLang == ShaderLanguage::Plugin)
-							vsContent = m_pluginProcessGLSL(shader->VSPath, vsContent.c_str());
-					}
+			addStage(ShaderStage::Compute, GL_COMPUTE_SHADER, shader->Path, shader->Entry);
+		}
 
-					GLuint vs = gl::CompileShader(GL_VERTEX_SHADER, vsContent.c_str());
-					vsCompiled &= gl::CheckShaderCompilationStatus(vs, shaderMessage);
+		return job;
+	}
+	void RenderEngine::m_queueCompileJob(CompileJob* job)
+	{
+		// results of the older compilations are not needed anymore
+		m_discardCompileJobs(job->Item);
 
-					// geometry shader
-					bool gsCompiled = true;
-					GLuint gs = 0;
-					if (shader->GSUsed && strlen(shader->GSPath) > 0 && strlen(shader->GSEntry) > 0) {
-						std::string gsContent = "",
-									gsEntry = shader->GSEntry;
+		// plugins aren't thread safe - compile everything on this thread if any of the stages needs them
+		bool usesPlugin = false;
+		for (const auto& stage : job->Stages)
+			usesPlugin |= stage.Language == ShaderLanguage::Plugin;
 
-						lineBias = 0;
-						
-						if (gsLang == ShaderLanguage::Plugin)
-							gsCompiled = m_pluginCompileToSpirv(item, shader->GSSPV, shader->GSPath, gsEntry, plugin::ShaderStage::Geometry, shader->Macros.data(), shader->Macros.size());
-						else
-							gsCompiled = ShaderCompiler::CompileToSPIRV(shader->GSSPV, gsLang, shader->GSPath, ShaderStage::Geometry, gsEntry, shader->Macros, m_msgs, m_project);
-						
-						if (gsLang == ShaderLanguage::GLSL) { // GLSL
-							gsContent = m_project->LoadProjectFile(shader->GSPath);
-							m_includeCheck(gsContent, std::vector<std::string>(), lineBias);
-							m_applyMacros(gsContent, shader);
-						} else { // HLSL / VK
-							gsContent = ShaderCompiler::ConvertToGLSL(shader->GSSPV, gsLang, ShaderStage::Geometry, shader->TSUsed, shader->GSUsed, m_msgs);
-							gsEntry = "main";
+		for (int i = 0; i < job->Stages.size(); i++) {
+			if (usesPlugin)
+				m_compileStage(job, job->Stages[i]);
+			else
+				job->Stages[i].Task = eng::ThreadPool::Instance().Enqueue([this, job, i]() {
+					m_compileStage(job, job->Stages[i]);
+				});
+		}
 
-							if (gsLang == ShaderLanguage::Plugin)
-								gsContent = m_pluginProcessGLSL(shader->GSPath, gsContent.c_str());
-						}
+		m_compileJobs.push_back(job);
+	}
+	void RenderEngine::m_discardCompileJobs(PipelineItem* item)
+	{
+		for (CompileJob* job : m_compileJobs)
+			if (job->Item == item)
+				job->Discarded = true;
+	}
+	void RenderEngine::m_compileStage(CompileJob* job, CompileStage& stage)
+	{
+		eng::Timer timer;
+		std::string entry = stage.Entry;
 
-						gs = gl::CompileShader(GL_GEOMETRY_SHADER, gsContent.c_str());
-						gsCompiled &= gl::CheckShaderCompilationStatus(gs, shaderMessage);
+		if (stage.Language == ShaderLanguage::Plugin)
+			stage.Compiled = m_pluginCompileToSpirv(job->Item, stage.SPV, stage.Path, entry, (plugin::ShaderStage)stage.Stage, job->Macros.data(), job->Macros.size());
+		else
+			stage.Compiled = ShaderCompiler::CompileToSPIRV(stage.SPV, stage.Language, stage.Path, stage.Stage, entry, job->Macros, &stage.Messages, m_project);
+
+		if (stage.Language == ShaderLanguage::GLSL) { // GLSL
+			int lineBias = 0;
+			stage.GLSL = m_project->LoadProjectFile(stage.Path);
+			m_includeCheck(stage.GLSL, std::vector<std::string>(), lineBias, &stage.Messages);
+			m_applyMacros(stage.GLSL, job->Macros);
+		} else if (stage.Compiled) { // HLSL / VK
+			stage.GLSL = ShaderCompiler::ConvertToGLSL(stage.SPV, stage.Language, stage.Stage, job->TSUsed, job->GSUsed, &stage.Messages);
+
+			if (stage.Language == ShaderLanguage::Plugin)
+				stage.GLSL = m_pluginProcessGLSL(stage.Path.c_str(), stage.GLSL.c_str());
+		}
 
-						if (gsContent.empty())
-							gsCompiled = false;
-					}
+		stage.Time = timer.GetElapsedTime();
+	}
+	void RenderEngine::m_linkCompileJob(CompileJob* job)
+	{
+		job->Linked = true;
 
-					// tessellation shader
-					bool tsCompiled = ((shader->TSUsed && m_tessellationSupported) || !shader->TSUsed);
-					GLuint tcs = 0, tes = 0;
-					if (shader->TSUsed && m_tessellationSupported) {
-						// tess control
-						if (strlen(shader->TCSPath) > 0 && strlen(shader->TCSEntry) > 0) {
-							std::string tcsContent = "",
-										tcsEntry = shader->TCSEntry;
+		int i = -1;
+		for (int j = 0; j < m_items.size(); j++)
+			if (m_items[j] == job->Item) {
+				i = j;
+				break;
+			}
+		if (job->Discarded || i == -1) {
+			job->Discarded = true;
+			return;
+		}
 
-							lineBias = 0;
+		eng::Timer linkTimer;
 
-							if (gsLang == ShaderLanguage::Plugin)
-								tsCompiled &= m_pluginCompileToSpirv(item, shader->TCSSPV, shader->TCSPath, tcsEntry, plugin::ShaderStage::TessellationControl, shader->Macros.data(), shader->Macros.size());
-							else
-								tsCompiled &= ShaderCompiler::CompileToSPIRV(shader->TCSSPV, tcsLang, shader->TCSPath, ShaderStage::TessellationControl, tcsEntry, shader->Macros, m_msgs, m_project);
-
-							if (tcsLang == ShaderLanguage::GLSL) { // GLSL
-								tcsContent = m_project->LoadProjectFile(shader->TCSPath);
-								m_includeCheck(tcsContent, std::vector<std::string>(), lineBias);
-								m_applyMacros(tcsContent, shader);
-							} else { // HLSL / VK
-								tcsContent = ShaderCompiler::ConvertToGLSL(shader->TCSSPV, gsLang, ShaderStage::TessellationControl, shader->TSUsed, shader->GSUsed, m_msgs);
-								tcsEntry = "main";
-
-								if (tcsLang == ShaderLanguage::Plugin)
-									tcsContent = m_pluginProcessGLSL(shader->TCSPath, tcsContent.c_str());
-							}
+		PipelineItem* item = job->Item;
+		GLchar shaderMessage[1024] = { 0 };
+		bool compiled = !job->TSUsed || m_tessellationSupported;
+		std::vector<GLuint> shaders;
+		ShaderPack pack;
+
+		for (auto& stage : job->Stages) {
+			if (stage.Stage == ShaderStage::Pixel)
+				((pipe::ShaderPass*)item->Data)->Variables.UpdateTextureList(stage.GLSL);
+
+			GLuint shader = gl::CompileShader(stage.Type, stage.GLSL.c_str());
+			stage.Compiled &= gl::CheckShaderCompilationStatus(shader, shaderMessage);
+
+			compiled &= stage.Compiled;
+			job->SourceEmpty |= stage.GLSL.empty();
+			shaders.push_back(shader);
+
+			if (stage.Stage == ShaderStage::Vertex)
+				pack.VS = shader;
+			else if (stage.Stage == ShaderStage::Pixel)
+				pack.PS = shader;
+			else if (stage.Stage == ShaderStage::Geometry)
+				pack.GS = shader;
+			else if (stage.Stage == ShaderStage::TessellationControl)
+				pack.TCS = shader;
+			else if (stage.Stage == ShaderStage::TessellationEvaluation)
+				pack.TES = shader;
+		}
+		job->Succeeded = compiled && !job->SourceEmpty;
+		job->LinkMessage = shaderMessage;
+
+		// SPIR-V is used by the debugger, auto-uniforms, etc...
+		if (item->Type == PipelineItem::ItemType::ShaderPass) {
+			pipe::ShaderPass* data = (pipe::ShaderPass*)item->Data;
+			for (auto& stage : job->Stages) {
+				if (stage.Stage == ShaderStage::Vertex)
+					data->VSSPV = std::move(stage.SPV);
+				else if (stage.Stage == ShaderStage::Pixel)
+					data->PSSPV = std::move(stage.SPV);
+				else if (stage.Stage == ShaderStage::Geometry)
+					data->GSSPV = std::move(stage.SPV);
+				else if (stage.Stage == ShaderStage::TessellationControl)
+					data->TCSSPV = std::move(stage.SPV);
+				else if (stage.Stage == ShaderStage::TessellationEvaluation)
+					data->TESSPV = std::move(stage.SPV);
+			}
+		} else
+			((pipe::ComputePass*)item->Data)->SPV = std::move(job->Stages[0].SPV);
+		SPIRVQueue.push_back(item);
+
+		// replace the old program
+		glDeleteShader(m_shaderSources[i].VS);
+		glDeleteShader(m_shaderSources[i].PS);
+		glDeleteShader(m_shaderSources[i].GS);
+		glDeleteShader(m_shaderSources[i].TCS);
+		glDeleteShader(m_shaderSources[i].TES);
+
+		m_deleteProgram(item, m_shaders[i]);
+		m_deleteProgram(item, m_debugShaders[i]);
+
+		m_shaders[i] = 0;
+		m_debugShaders[i] = 0;
+
+		if (job->Succeeded) {
+			uint64_t programKey = 0;
+			if (m_programBinarySupported && Settings::Instance().General.ProgramCache && ShaderCache::Instance().IsAvailable()) {
+				programKey = ShaderCache::Hash(m_programCacheInfo);
+				for (const auto& stage : job->Stages) {
+					programKey = ShaderCache::Hash(&stage.Type, sizeof(stage.Type), programKey);
+					programKey = ShaderCache::Hash(stage.GLSL, programKey);
+				}
+			}
 
-							tcs = gl::CompileShader(GL_TESS_CONTROL_SHADER, tcsContent.c_str());
-							tsCompiled &= gl::CheckShaderCompilationStatus(tcs, shaderMessage);
+			m_shaders[i] = m_linkProgram(shaders, programKey);
 
-							if (tcsContent.empty())
-								tsCompiled = false;
-						}
-						
-						// tess evaluation
-						if (strlen(shader->TESPath) > 0 && strlen(shader->TESEntry) > 0) {
-							std::string tesContent = "",
-										tesEntry = shader->TESEntry;
+			if (item->Type == PipelineItem::ItemType::ShaderPass) {
+				std::vector<GLuint> debugShaders = { m_generalDebugShader };
+				for (int j = 0; j < job->Stages.size(); j++)
+					if (job->Stages[j].Stage != ShaderStage::Pixel)
+						debugShaders.push_back(shaders[j]);
+				m_debugShaders[i] = m_linkProgram(debugShaders, programKey == 0 ? 0 : ShaderCache::Hash(std::string("debug"), programKey));
+			}
 
-							lineBias = 0;
+			if (programKey != 0)
+				Logger::Get().Log("Program binary cache - hits: " + std::to_string(m_programCacheHits) + ", misses: " + std::to_string(m_programCacheMisses));
+		}
 
-							if (gsLang == ShaderLanguage::Plugin)
-								tsCompiled &= m_pluginCompileToSpirv(item, shader->TESSPV, shader->TESPath, tesEntry, plugin::ShaderStage::TessellationEvaluation, shader->Macros.data(), shader->Macros.size());
-							else
-								tsCompiled &= ShaderCompiler::CompileToSPIRV(shader->TESSPV, tcsLang, shader->TESPath, ShaderStage::TessellationEvaluation, tesEntry, shader->Macros, m_msgs, m_project);
-
-							if (tesLang == ShaderLanguage::GLSL) { // GLSL
-								tesContent = m_project->LoadProjectFile(shader->TESPath);
-								m_includeCheck(tesContent, std::vector<std::string>(), lineBias);
-								m_applyMacros(tesContent, shader);
-							} else { // HLSL / VK
-								tesContent = ShaderCompiler::ConvertToGLSL(shader->TESSPV, gsLang, ShaderStage::TessellationEvaluation, shader->TSUsed, shader->GSUsed, m_msgs);
-								tesEntry = "main";
-
-								if (tesLang == ShaderLanguage::Plugin)
-									tesContent = m_pluginProcessGLSL(shader->TESPath, tesContent.c_str());
-							}
+		if (item->Type == PipelineItem::ItemType::ShaderPass) {
+			m_shaderSources[i] = pack;
 
-							tes = gl::CompileShader(GL_TESS_EVALUATION_SHADER, tesContent.c_str());
-							tsCompiled &= gl::CheckShaderCompilationStatus(tes, shaderMessage);
+			if (m_shaders[i] != 0)
+				((pipe::ShaderPass*)item->Data)->Variables.UpdateUniformInfo(m_shaders[i]);
+		} else {
+			for (GLuint shader : shaders)
+				glDeleteShader(shader);
+			m_shaderSources[i] = ShaderPack();
 
-							if (tesContent.empty())
-								tsCompiled = false;
-						}
-					}
+			if (m_shaders[i] != 0)
+				((pipe::ComputePass*)item->Data)->Variables.UpdateUniformInfo(m_shaders[i]);
+		}
 
+		job->LinkTime = linkTimer.GetElapsedTime();
+	}
+	GLuint RenderEngine::m_linkProgram(const std::vector<GLuint>& shaders, uint64_t cacheKey)
+	{
+		GLuint program = glCreateProgram();
+
+		if (cacheKey != 0) {
+			// [GLenum format][binary]
+			std::string binary;
+			if (ShaderCache::Instance().Load(cacheKey, binary) && binary.size() > sizeof(GLenum)) {
+				GLenum format = 0;
+				memcpy(&format, binary.data(), sizeof(GLenum));
+				glProgramBinary(program, format, binary.data() + sizeof(GLenum), binary.size() - sizeof(GLenum));
+
+				GLint status = GL_FALSE;
+				glGetProgramiv(program, GL_LINK_STATUS, &status);
+				if (status == GL_TRUE) {
+					m_programCacheHits++;
+					return program;
+				}
 
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
-
-					if (!vsCompiled || !psCompiled || !gsCompiled || !tsCompiled || vsContent.empty() || psContent.empty()) {
-						Logger::Get().Log("Shaders not compiled", true);
-						if (vsContent.empty() || psContent.empty())
-							m_msgs->Add(MessageStack::Type::Error, name, "Shader source empty - try recompiling");
-						else {
-							if (shaderMessage[0] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(name))
-								m_msgs->Add(MessageStack::Type::Error, name, shaderMessage);
-							m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the shader(s)");
-						}
+				// driver rejected the binary - link the program normally
+				glDeleteProgram(program);
+				program = glCreateProgram();
+			}
 
-						m_shaders[i] = 0;
-					} else {
-						m_msgs->Add(MessageStack::Type::Message, name, "Compiled the shaders.");
+			m_programCacheMisses++;
+			glProgramParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+		}
 
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], vs);
-						if (shader->TSUsed) glAttachShader(m_shaders[i], tcs);
-						if (shader->TSUsed) glAttachShader(m_shaders[i], tes);
-						if (shader->GSUsed) glAttachShader(m_shaders[i], gs);
-						glAttachShader(m_shaders[i], ps);
-						glLinkProgram(m_shaders[i]);
-					}
+		for (GLuint shader : shaders)
+			glAttachShader(program, shader);
+		glLinkProgram(program);
+		// XXX TODO check link status
 
-					if (m_shaders[i] != 0)
-						shader->Variables.UpdateUniformInfo(m_shaders[i]);
+		if (cacheKey != 0) {
+			GLint status = GL_FALSE, length = 0;
+			glGetProgramiv(program, GL_LINK_STATUS, &status);
+			glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
 
-					m_shaderSources[i].VS = vs;
-					m_shaderSources[i].PS = ps;
-					m_shaderSources[i].GS = gs;
-					m_shaderSources[i].TCS = tcs;
-					m_shaderSources[i].TES = tes;
-				} 
-				else if (item->Type == PipelineItem::ItemType::ComputePass && m_computeSupported) {
-					pipe::ComputePass* shader = (pipe::ComputePass*)item->Data;
-					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(name);
+			if (status == GL_TRUE && length > 0) {
+				std::string binary(sizeof(GLenum) + length, 0);
+				GLenum format = 0;
+				glGetProgramBinary(program, length, &length, &format, &binary[sizeof(GLenum)]);
+				memcpy(&binary[0], &format, sizeof(GLenum));
+				binary.resize(sizeof(GLenum) + length);
 
-					SPIRVQueue.push_back(item);
+				ShaderCache::Instance().Store(cacheKey, binary);
+			}
+		}
 
-					m_msgs->ClearGroup(name);
+		return program;
+	}
+	void RenderEngine::m_reportCompileJob(CompileJob* job)
+	{
+		if (job->Discarded)
+			return;
 
-					std::string content = "", entry = shader->Entry;
-					int lineBias = 0;
-					ShaderLanguage lang = ShaderCompiler::GetShaderLanguageFromExtension(shader->Path);
+		const char* name = job->Item->Name;
+		bool isCompute = job->Item->Type == PipelineItem::ItemType::ComputePass;
 
-					// compute shader
-					bool compiled = false;
-						
-					if (lang == ShaderLanguage::Plugin)
-						compiled = m_pluginCompileToSpirv(item, shader->SPV, shader->Path, entry, plugin::ShaderStage::Compute, shader->Macros.data(), shader->Macros.size());
-					else
-						compiled = ShaderCompiler::CompileToSPIRV(shader->SPV, lang, shader->Path, ShaderStage::Compute, entry, shader->Macros, m_msgs, m_project);
-					
-					if (lang == ShaderLanguage::GLSL) { // GLSL
-						content = m_project->LoadProjectFile(shader->Path);
-						m_includeCheck(content, std::vector<std::string>(), lineBias);
-						m_applyMacros(content, shader);
-					} else { // HLSL / VK
-						content = ShaderCompiler::ConvertToGLSL(shader->SPV, lang, ShaderStage::Compute, false, false, m_msgs);
-						entry = "main";
+		float compileTime = job->LinkTime;
+		for (const auto& stage : job->Stages)
+			compileTime += stage.Time;
+		m_compileTimes[job->Item] = compileTime;
 
-						if (lang == ShaderLanguage::Plugin)
-							content = m_pluginProcessGLSL(shader->Path, content.c_str());		
-					}
+		int frontEndMessages = 0;
+		for (auto& stage : job->Stages)
+			frontEndMessages += stage.Messages.GetErrorAndWarningMsgCount();
 
-					// compute shader supported == version 4.3 == not needed: shader->Variables.UpdateTextureList(content);
-					GLuint cs = gl::CompileShader(GL_COMPUTE_SHADER, content.c_str());
-					compiled &= gl::CheckShaderCompilationStatus(cs, shaderMessage);
+		if (job->IsRecompile)
+			m_msgs->ClearGroup(name);
 
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
-
-					if (!compiled || content.empty()) {
-						Logger::Get().Log("Compute shader was not compiled", true);
-						if (content.empty())
-							m_msgs->Add(MessageStack::Type::Error, name, "Shader source empty - try recompiling");
-						else {
-							if (shaderMessage[0] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(name))
-								m_msgs->Add(MessageStack::Type::Error, name, shaderMessage);
-							m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the compute shader");
-						}
+		if (job->Succeeded) {
+			if (job->IsRecompile) {
+				for (auto& stage : job->Stages)
+					m_msgs->Add(stage.Messages.GetMessages());
+				m_msgs->Add(MessageStack::Type::Message, name, isCompute ? "Compiled the compute shader." : "Compiled the shaders.");
+			} else
+				m_msgs->ClearGroup(name);
+		} else {
+			Logger::Get().Log(isCompute ? "Compute shader was not compiled" : "Shaders not compiled", true);
 
-						m_shaders[i] = 0;
-					} else {
-						m_msgs->Add(MessageStack::Type::Message, name, "Compiled the compute shader.");
+			for (auto& stage : job->Stages)
+				m_msgs->Add(stage.Messages.GetMessages());
 
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], cs);
-						glLinkProgram(m_shaders[i]);
-					}
+			if (job->SourceEmpty && frontEndMessages == 0)
+				m_msgs->Add(MessageStack::Type::Error, name, "Shader source empty - try recompiling");
+			else {
+				if (!job->LinkMessage.empty() && frontEndMessages == 0)
+					m_msgs->Add(MessageStack::Type::Error, name, job->LinkMessage);
+				m_msgs->Add(MessageStack::Type::Error, name, isCompute ? "Failed to compile the compute shader" : "Failed to compile the shader(s)");
+			}
+		}
+	}
+	void RenderEngine::m_updateCompileJobs(bool wait, PipelineItem* item)
+	{
+		// link the programs as soon as the workers are done with them
+		for (CompileJob* job : m_compileJobs) {
+			if (job->Linked)
+				continue;
 
-					glDeleteShader(cs);
+			bool waitForJob = wait && (item == nullptr || job->Item == item);
 
-					if (m_shaders[i] != 0)
-						shader->Variables.UpdateUniformInfo(m_shaders[i]);
-				} 
-				else if (item->Type == PipelineItem::ItemType::AudioPass) {
-					pipe::AudioPass* shader = (pipe::AudioPass*)item->Data;
+			bool isDone = true;
+			for (auto& stage : job->Stages) {
+				if (!stage.Task.valid())
+					continue;
 
-					m_msgs->ClearGroup(name);
+				if (waitForJob)
+					stage.Task.wait();
+				else if (stage.Task.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+					isDone = false;
+			}
 
-					std::string content = m_project->LoadProjectFile(shader->Path);
+			if (isDone)
+				m_linkCompileJob(job);
+		}
 
-					// audio shader
-					if (ShaderCompiler::GetShaderLanguageFromExtension(shader->Path) == ShaderLanguage::GLSL)
-						m_applyMacros(content, shader);
+		// report the results in the order in which the items were queued
+		while (!m_compileJobs.empty() && m_compileJobs.front()->Linked) {
+			CompileJob* job = m_compileJobs.front();
+			m_compileJobs.pop_front();
 
-					shader->Stream.CompileFromShaderSource(m_project, m_msgs, content, shader->Macros, ShaderCompiler::GetShaderLanguageFromExtension(shader->Path) == ShaderLanguage::HLSL);
-					shader->Variables.UpdateUniformInfo(shader->Stream.GetShader());
-				} 
-				else if (item->Type == PipelineItem::ItemType::PluginItem) {
-					pipe::PluginItemData* idata = (pipe::PluginItemData*)item->Data;
-					idata->Owner->HandleRecompile(name);
-				}
-			}
+			m_reportCompileJob(job);
+			delete job;
 		}
-
-		Render();
 	}
 	void RenderEngine::RecompileFile(const char* fname)
 	{
@@ -1445,6 +1499,9 @@ namespace ed {
 		for (int i = 0; i < m_items.size(); i++) {
 			PipelineItem* item = m_items[i];
 			if (strcmp(item->Name, name) == 0) {
+				// editor's source replaces whatever is still being compiled from the files
+				m_discardCompileJobs(item);
+
 				if (item->Type == PipelineItem::ItemType::ShaderPass) {
 					pipe::ShaderPass* shader = (pipe::ShaderPass*)item->Data;
 					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(name);
@@ -1609,8 +1666,7 @@ namespace ed {
 						}
 					}
 
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
+					m_deleteProgram(item, m_shaders[i]);
 
 					if (!vsCompiled || !psCompiled || !gsCompiled || !tsCompiled) {
 						if (shaderMessage[0] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(name))
@@ -1669,11 +1725,7 @@ namespace ed {
 						compiled &= gl::CheckShaderCompilationStatus(cs);
 					}
 
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
-
-					if (m_shaders[i] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(name))
-						shader->Variables.UpdateUniformInfo(m_shaders[i]);
+					m_deleteProgram(item, m_shaders[i]);
 
 					if (!compiled) {
 						m_msgs->Add(MessageStack::Type::Error, name, "Failed to compile the compute shader");
@@ -1684,6 +1736,9 @@ namespace ed {
 						m_shaders[i] = glCreateProgram();
 						glAttachShader(m_shaders[i], cs);
 						glLinkProgram(m_shaders[i]);
+
+						if (shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(name))
+							shader->Variables.UpdateUniformInfo(m_shaders[i]);
 					}
 
 					glDeleteShader(cs);
@@ -1696,8 +1751,10 @@ namespace ed {
 					GLuint ss = 0;
 
 					// audio shader
-					if (vssrc.size() > 0)
+					if (vssrc.size() > 0) {
+						shader->Variables.RemoveProgram(shader->Stream.GetShader());
 						shader->Stream.CompileFromShaderSource(m_project, m_msgs, vssrc, shader->Macros, true);
+					}
 					shader->Variables.UpdateUniformInfo(shader->Stream.GetShader());
 				}
 			}
@@ -1727,6 +1784,8 @@ namespace ed {
 	}
 	void RenderEngine::Pick(PipelineItem* item, bool add)
 	{
+		m_planDirty = true;
+
 		// check if it already exists
 		bool skipAdd = false;
 		for (int i = 0; i < m_pick.size(); i++)
@@ -1829,42 +1888,36 @@ namespace ed {
 			glm::vec3 minb = obj->Data->GetMinBound();
 			glm::vec3 maxb = obj->Data->GetMaxBound();
 
-			float triDist = std::numeric_limits<float>::infinity();
-			if (ray::IntersectBox(vec3Origin, vec3Dir, minb, maxb, triDist)) {
-				bool donetris = false;
-				for (auto& mesh : obj->Data->Meshes) {
-					for (int i = 0; i + 2 < mesh.Vertices.size(); i += 3) {
-						glm::vec3 v0 = mesh.Vertices[i + 0].Position;
-						glm::vec3 v1 = mesh.Vertices[i + 1].Position;
-						glm::vec3 v2 = mesh.Vertices[i + 2].Position;
-
-						if (ray::IntersectTriangle(vec3Origin, vec3Dir, v0, v1, v2, triDist))
-							if (triDist < myDist) {
-								myDist = triDist;
-
-								if (triDist < m_pickDist) {
-									donetris = true;
-									break;
-								}
-							}
-					}
+			float boxDist = std::numeric_limits<float>::infinity();
+			if (ray::IntersectBox(vec3Origin, vec3Dir, minb, maxb, boxDist)) {
+				for (int i = 0; i < obj->Data->Meshes.size(); i++) {
+					const eng::BVH* bvh = obj->Data->GetBVH(i);
 
-					if (donetris)
-						break;
+					float triDist = 0.0f;
+					if (bvh == nullptr) // still being built
+						myDist = std::min<float>(myDist, boxDist);
+					else if (bvh->Intersect(vec3Origin, vec3Dir, triDist))
+						myDist = std::min<float>(myDist, triDist);
 				}
 			}
 		} else if (item->Type == PipelineItem::ItemType::VertexBuffer) {
 			pipe::VertexBuffer* obj = (pipe::VertexBuffer*)item->Data;
 
-			glm::vec3 b1(0.0f);
-			glm::vec3 b2(0.0f);
-			gl::GetVertexBufferBounds(m_objects, obj, b1, b2);
-
-			// TODO: use ray-triangle intersection for more precision
+			const eng::BVH* bvh = m_getVertexBufferBVH(item);
+			if (bvh != nullptr) {
+				float triDist = 0.0f;
+				if (bvh->Intersect(vec3Origin, vec3Dir, triDist))
+					myDist = triDist;
+			} else {
+				// points, lines, ...
+				glm::vec3 b1(0.0f);
+				glm::vec3 b2(0.0f);
+				gl::GetVertexBufferBounds(m_objects, obj, b1, b2);
 
-			float distHit;
-			if (ray::IntersectBox(vec3Origin, vec3Dir, b1, b2, distHit))
-				myDist = distHit;
+				float distHit;
+				if (ray::IntersectBox(vec3Origin, vec3Dir, b1, b2, distHit))
+					myDist = distHit;
+			}
 		} else if (item->Type == PipelineItem::ItemType::PluginItem) {
 			pipe::PluginItemData* obj = (pipe::PluginItemData*)item->Data;
 
@@ -1881,8 +1934,70 @@ namespace ed {
 			AddPickedItem(item, multiPick);
 		}
 	}
+	const eng::BVH* RenderEngine::m_getVertexBufferBVH(PipelineItem* item)
+	{
+		pipe::VertexBuffer* vb = (pipe::VertexBuffer*)item->Data;
+		BufferObject* buffer = (BufferObject*)vb->Buffer;
+
+		if (buffer == nullptr || buffer->Size <= 0)
+			return nullptr;
+		if (vb->Topology != GL_TRIANGLES && vb->Topology != GL_TRIANGLE_STRIP && vb->Topology != GL_TRIANGLE_FAN)
+			return nullptr;
+
+		std::vector<ShaderVariable::ValueType> format = m_objects->ParseBufferFormat(buffer->ViewFormat);
+		if (format.empty())
+			return nullptr;
+
+		int stride = 0;
+		for (const auto& el : format)
+			stride += ShaderVariable::GetSize(el, true);
+		if (stride <= 0)
+			return nullptr;
+
+		// the CPU copy is read back only if a shader could have written to the buffer
+		m_objects->SyncBuffer(buffer);
+		if (buffer->Data == nullptr)
+			return nullptr;
+
+		VertexBufferBVH& cached = m_vbBVH[item];
+		if (cached.Topology == vb->Topology && cached.Buffer == buffer && cached.Version == buffer->Version && cached.Format == buffer->ViewFormat)
+			return cached.Tree.IsEmpty() ? nullptr : &cached.Tree;
+
+		const GLfloat* data = (const GLfloat*)buffer->Data;
+		int vertexCount = buffer->Size / stride;
+		int rowStride = stride / sizeof(GLfloat);
+		int elCount = std::min<int>(3, ShaderVariable::GetSize(format[0]) / sizeof(GLfloat));
+
+		std::vector<glm::vec3> positions(vertexCount, glm::vec3(0.0f));
+		for (int i = 0; i < vertexCount; i++)
+			for (int c = 0; c < elCount; c++)
+				positions[i][c] = data[i * rowStride + c];
+
+		std::vector<unsigned int> indices;
+		if (vb->Topology == GL_TRIANGLES) {
+			indices.resize((vertexCount / 3) * 3);
+			for (int i = 0; i < indices.size(); i++)
+				indices[i] = i;
+		} else {
+			for (int i = 0; i + 2 < vertexCount; i++) {
+				indices.push_back(vb->Topology == GL_TRIANGLE_FAN ? 0 : i);
+				indices.push_back(i + 1);
+				indices.push_back(i + 2);
+			}
+		}
+
+		cached.Topology = vb->Topology;
+		cached.Buffer = buffer;
+		cached.Version = buffer->Version;
+		cached.Format = buffer->ViewFormat;
+		cached.Tree.Build(std::move(positions), std::move(indices));
+
+		return cached.Tree.IsEmpty() ? nullptr : &cached.Tree;
+	}
 	void RenderEngine::AddPickedItem(PipelineItem* pipe, bool multiPick)
 	{
+		m_planDirty = true;
+
 		// check if it already exists
 		bool skipAdd = false;
 		for (int i = 0; i < m_pick.size(); i++)
@@ -1945,8 +2060,104 @@ namespace ed {
 
 		return std::make_pair(nullptr, nullptr);
 	}
+	void RenderEngine::PollPerformanceTimers()
+	{
+		unsigned long long totalTime = 0;
+
+		m_frameTimer.Poll();
+		for (int i = 0; i < m_perfTimers.size(); i++) {
+			m_perfTimers[i].Poll();
+			totalTime += m_perfTimers[i].LastTime;
+		}
+
+		m_totalPerfTime = totalTime;
+	}
+	bool RenderEngine::ExportProfilerTrace(const std::string& path)
+	{
+		struct TraceEvent {
+			std::string Name;
+			const char* Category;
+			PerformanceTimer::Sample Sample;
+		};
+		std::vector<TraceEvent> events;
+
+		auto addEvents = [&](const PerformanceTimer& timer, const std::string& name, const char* category) {
+			for (const auto& sample : timer.GetHistory())
+				events.push_back({ name, category, sample });
+		};
+
+		addEvents(m_frameTimer, "Frame", "frame");
+		for (const auto& timer : m_perfTimers) {
+			addEvents(timer, timer.Pass->Name, "pass");
+			for (const auto& child : timer.Children)
+				addEvents(child, std::string(timer.Pass->Name) + "/" + child.Pass->Name, "draw");
+		}
+
+		if (events.empty())
+			return false;
+
+		std::ofstream file(path);
+		if (!file.is_open()) {
+			Logger::Get().Log("Failed to open " + path + " for writing", true);
+			return false;
+		}
+
+		// timestamps are in ns, trace viewers expect us relative to some point in time
+		uint64_t origin = events[0].Sample.Start;
+		for (const auto& ev : events)
+			origin = std::min<uint64_t>(origin, ev.Sample.Start);
+
+		file << std::fixed << std::setprecision(3);
+		file << "{\"traceEvents\":[\n";
+		for (int i = 0; i < events.size(); i++) {
+			std::string name;
+			for (char c : events[i].Name) {
+				if (c == '"' || c == '\\')
+					name += '\\';
+				if ((unsigned char)c >= 0x20)
+					name += c;
+			}
+
+			file << "{\"name\":\"" << name << "\",\"cat\":\"" << events[i].Category << "\",\"ph\":\"X\",\"pid\":0,\"tid\":0"
+				 << ",\"ts\":" << (events[i].Sample.Start - origin) / 1000.0
+				 << ",\"dur\":" << events[i].Sample.Duration / 1000.0 << "}"
+				 << (i + 1 < events.size() ? ",\n" : "\n");
+		}
+		file << "],\"displayTimeUnit\":\"ms\"}\n";
+
+		Logger::Get().Log("Exported " + std::to_string(events.size()) + " profiler events to " + path);
+
+		return true;
+	}
+	void RenderEngine::m_updateDrawTimers(PerformanceTimer& timer, const PlanPass& plan)
+	{
+		// the plan gets rebuilt when the pass' children change - recreate the timers only if the draw list doesn't match anymore
+		bool matches = timer.Children.size() == plan.Draws.size();
+		for (int j = 0; matches && j < plan.Draws.size(); j++)
+			matches = timer.Children[j].Pass == plan.Draws[j].Item;
+		if (matches)
+			return;
+
+		for (auto& child : timer.Children)
+			child.Destroy();
+		timer.Children.clear();
+
+		for (const auto& draw : plan.Draws) {
+			timer.Children.push_back(PerformanceTimer(draw.Item));
+			timer.Children.back().Create();
+		}
+	}
 	void RenderEngine::FlushCache()
 	{
+		// the results of the queued compilations aren't needed anymore
+		for (CompileJob* job : m_compileJobs) {
+			for (auto& stage : job->Stages)
+				if (stage.Task.valid())
+					stage.Task.wait();
+			delete job;
+		}
+		m_compileJobs.clear();
+
 		for (int i = 0; i < m_shaders.size(); i++) {
 			glDeleteShader(m_shaderSources[i].VS);
 			glDeleteShader(m_shaderSources[i].PS);
@@ -1954,17 +2165,28 @@ namespace ed {
 			glDeleteShader(m_shaderSources[i].TCS);
 			glDeleteShader(m_shaderSources[i].TES);
 			glDeleteProgram(m_shaders[i]);
-			glDeleteQueries(1, &m_perfTimers[i].Object);
+			glDeleteProgram(m_debugShaders[i]);
+			m_perfTimers[i].Destroy();
 		}
 
 		m_fbos.clear();
 		m_fboCount.clear();
 		m_items.clear();
 		m_shaders.clear();
+		m_debugShaders.clear();
 		m_perfTimers.clear();
+		m_compileTimes.clear();
+		m_vbBVH.clear();
 		m_shaderSources.clear();
 		m_uboMax.clear();
+		m_plan.clear();
+		m_cacheQueue.clear();
 		m_fbosNeedUpdate = true;
+		m_planDirty = true;
+
+		// items that are still in the pipeline are cached again before the next frame
+		m_cacheDirty = true;
+		m_cacheResync = true;
 
 		// clear textures
 		glBindTexture(GL_TEXTURE_2D, m_rtColor);
@@ -1975,439 +2197,306 @@ namespace ed {
 
 		m_lastSize = glm::ivec2(1, 1); // recreate window rt!
 	}
-	void RenderEngine::m_cache()
+	void RenderEngine::OnPipelineEvent(PipelineManager::EventType type, PipelineItem* item)
 	{
-		// check for any changes
-		std::vector<ed::PipelineItem*>& items = m_pipeline->GetList();
-
-		// check if no major changes were made, if so dont cache for another 0.25s
-		if (m_items.size() == items.size()) {
-			if (m_cacheTimer.GetElapsedTime() > 0.5f)
-				m_cacheTimer.Restart();
-			else
-				return;
-		}
-
-		// check if some item was added
-		GLchar shaderMessage[1024] = { 0 };
-		for (int i = 0; i < items.size(); i++) {
-			bool found = false;
-			for (int j = 0; j < m_items.size(); j++)
-				if (items[i]->Data == m_items[j]->Data) {
-					found = true;
+		if (type == PipelineManager::EventType::ItemAdded) {
+			// item's properties are usually set after it has been added - cache it before the next frame
+			if (m_isCacheable(item))
+				m_cacheQueue.push_back(item);
+			m_cacheDirty = true;
+		} else if (type == PipelineManager::EventType::ItemRemoved) {
+			// item's data is freed right after this event - remove it from the cache immediately
+			m_cacheQueue.erase(std::remove(m_cacheQueue.begin(), m_cacheQueue.end(), item), m_cacheQueue.end());
+			m_vbBVH.erase(item);
+			for (int i = 0; i < m_items.size(); i++)
+				if (m_items[i] == item) {
+					m_uncacheItem(i);
 					break;
 				}
+		} else if (type == PipelineManager::EventType::ItemMoved)
+			m_cacheDirty = true;
 
-			if (!found) {
-				Logger::Get().Log("Caching a new shader pass " + std::string(items[i]->Name));
-
-				if (items[i]->Type == PipelineItem::ItemType::ShaderPass) {
-					pipe::ShaderPass* data = reinterpret_cast<ed::pipe::ShaderPass*>(items[i]->Data);
-					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(items[i]->Name);
-
-					m_items.insert(m_items.begin() + i, items[i]);
-					m_shaders.insert(m_shaders.begin() + i, 0);
-					m_debugShaders.insert(m_debugShaders.begin() + i, 0);
-					m_shaderSources.insert(m_shaderSources.begin() + i, ShaderPack());
-					
-					SPIRVQueue.push_back(items[i]);
-
-					// cache performance timer
-					m_perfTimers.insert(m_perfTimers.begin() + i, PerformanceTimer(items[i]));
-					glGenQueries(1, &m_perfTimers[i].Object);
-					m_perfTimers[i].IsCreated = true;
-
-					if (strlen(data->VSPath) == 0 || strlen(data->PSPath) == 0) {
-						Logger::Get().Log("No shader paths are set", true);
-						continue;
-					}
-
-					glDeleteShader(m_shaderSources[i].VS);
-					glDeleteShader(m_shaderSources[i].PS);
-					glDeleteShader(m_shaderSources[i].GS);
-					glDeleteShader(m_shaderSources[i].TCS);
-					glDeleteShader(m_shaderSources[i].TES);
-
-					/*
-						ITEM CACHING
-					*/
-
-					m_fbos[data].resize(MAX_RENDER_TEXTURES);
-
-					GLuint ps = 0, vs = 0, gs = 0, tcs = 0, tes = 0;
-
-					m_msgs->CurrentItem = items[i]->Name;
-
-					int lineBias = 0;
-					std::string psContent = "", vsContent = "",
-								vsEntry = data->VSEntry,
-								psEntry = data->PSEntry;
-					ShaderLanguage vsLang = ShaderCompiler::GetShaderLanguageFromExtension(data->VSPath);
-					ShaderLanguage psLang = ShaderCompiler::GetShaderLanguageFromExtension(data->PSPath);
-
-					// vertex shader
-					bool vsCompiled = false;
-
-					if (vsLang == ShaderLanguage::Plugin)
-						vsCompiled = m_pluginCompileToSpirv(items[i], data->VSSPV, data->VSPath, vsEntry, plugin::ShaderStage::Vertex, data->Macros.data(), data->Macros.size());
-					else
-						vsCompiled = ShaderCompiler::CompileToSPIRV(data->VSSPV, vsLang, data->VSPath, ShaderStage::Vertex, vsEntry, data->Macros, m_msgs, m_project);
-					
-					// generate glsl
-					if (vsLang == ShaderLanguage::GLSL) { // GLSL
-						vsContent = m_project->LoadProjectFile(data->VSPath);
-						m_includeCheck(vsContent, std::vector<std::string>(), lineBias);
-						m_applyMacros(vsContent, data);
-					} else if (vsCompiled) {
-						vsContent = ShaderCompiler::ConvertToGLSL(data->VSSPV, vsLang, ShaderStage::Vertex, data->TSUsed, data->GSUsed, m_msgs);
-						vsEntry = "main";
-
-						if (vsLang == ShaderLanguage::Plugin)
-							vsContent = std::string(m_pluginProcessGLSL(data->VSPath, vsContent.c_str()));
-					}
+		m_planDirty = true;
+	}
+	void RenderEngine::m_cache()
+	{
+		if (!m_cacheDirty)
+			return;
+		m_cacheDirty = false;
 
-					vs = gl::CompileShader(GL_VERTEX_SHADER, vsContent.c_str());
-					vsCompiled &= gl::CheckShaderCompilationStatus(vs, shaderMessage);
-					
-					// pixel shader
-					lineBias = 0;
-					bool psCompiled = false;
+		std::vector<ed::PipelineItem*>& items = m_pipeline->GetList();
+		std::unordered_map<PipelineItem*, int> order;
+		for (int i = 0; i < items.size(); i++)
+			order[items[i]] = i;
+
+		// cache the items that were added since the last frame
+		std::vector<PipelineItem*> queue;
+		queue.swap(m_cacheQueue);
+		if (m_cacheResync) {
+			for (PipelineItem* item : items)
+				if (m_isCacheable(item))
+					queue.push_back(item);
+			m_cacheResync = false;
+		}
+		for (PipelineItem* item : queue)
+			if (order.count(item) && std::count(m_items.begin(), m_items.end(), item) == 0)
+				m_cacheItem(item);
+
+		// keep the cached items in the same order as the pipeline items
+		std::vector<int> perm(m_items.size());
+		for (int i = 0; i < perm.size(); i++)
+			perm[i] = i;
+		std::stable_sort(perm.begin(), perm.end(), [&](int a, int b) { return order[m_items[a]] < order[m_items[b]]; });
+
+		bool isSorted = true;
+		for (int i = 0; i < perm.size() && isSorted; i++)
+			isSorted = perm[i] == i;
+
+		if (!isSorted) {
+			Logger::Get().Log("Updating the order of the cached items");
+
+			std::vector<PipelineItem*> itemsCopy(m_items.size());
+			std::vector<GLuint> shadersCopy(m_items.size()), debugShadersCopy(m_items.size());
+			std::vector<ShaderPack> sourcesCopy(m_items.size());
+			std::vector<PerformanceTimer> timersCopy;
+			for (int i = 0; i < perm.size(); i++) {
+				itemsCopy[i] = m_items[perm[i]];
+				shadersCopy[i] = m_shaders[perm[i]];
+				debugShadersCopy[i] = m_debugShaders[perm[i]];
+				sourcesCopy[i] = m_shaderSources[perm[i]];
+				timersCopy.push_back(m_perfTimers[perm[i]]);
+			}
 
-					if (psLang == ShaderLanguage::Plugin)
-						psCompiled = m_pluginCompileToSpirv(items[i], data->PSSPV, data->PSPath, psEntry, plugin::ShaderStage::Pixel, data->Macros.data(), data->Macros.size());
-					else
-						psCompiled = ShaderCompiler::CompileToSPIRV(data->PSSPV, psLang, data->PSPath, ShaderStage::Pixel, psEntry, data->Macros, m_msgs, m_project);
-					
-					if (psLang == ShaderLanguage::GLSL) { // GLSL
-						psContent = m_project->LoadProjectFile(data->PSPath);
-						m_includeCheck(psContent, std::vector<std::string>(), lineBias);
-						m_applyMacros(psContent, data);
-					} else if (psCompiled) { // HLSL / VK
-						psContent = ShaderCompiler::ConvertToGLSL(data->PSSPV, psLang, ShaderStage::Pixel, data->TSUsed, data->GSUsed, m_msgs);
-						psEntry = "main";
+			m_items.swap(itemsCopy);
+			m_shaders.swap(shadersCopy);
+			m_debugShaders.swap(debugShadersCopy);
+			m_shaderSources.swap(sourcesCopy);
+			m_perfTimers.swap(timersCopy);
+		}
 
-						if (psLang == ShaderLanguage::Plugin)
-							psContent = m_pluginProcessGLSL(data->PSPath, psContent.c_str());
-					}
+		m_planDirty = true;
+	}
+	bool RenderEngine::m_isCacheable(PipelineItem* item)
+	{
+		return item->Type == PipelineItem::ItemType::ShaderPass || (item->Type == PipelineItem::ItemType::ComputePass && m_computeSupported) || item->Type == PipelineItem::ItemType::AudioPass || item->Type == PipelineItem::ItemType::PluginItem;
+	}
+	void RenderEngine::m_cacheItem(PipelineItem* item)
+	{
+		Logger::Get().Log("Caching a new shader pass " + std::string(item->Name));
 
-					data->Variables.UpdateTextureList(psContent);
-					ps = gl::CompileShader(GL_FRAGMENT_SHADER, psContent.c_str());
-					psCompiled &= gl::CheckShaderCompilationStatus(ps, shaderMessage);
+		m_items.push_back(item);
+		m_shaders.push_back(0);
+		m_debugShaders.push_back(0);
+		m_shaderSources.push_back(ShaderPack());
 
-					// geometry shader
-					lineBias = 0;
-					bool gsCompiled = true;
-					if (data->GSUsed && strlen(data->GSEntry) > 0 && strlen(data->GSPath) > 0) {
-						std::string gsContent = "", gsEntry = data->GSEntry;
-						ShaderLanguage gsLang = ShaderCompiler::GetShaderLanguageFromExtension(data->GSPath);
-						
-						if (gsLang == ShaderLanguage::Plugin)
-							gsCompiled = m_pluginCompileToSpirv(items[i], data->GSSPV, data->GSPath, gsEntry, plugin::ShaderStage::Geometry, data->Macros.data(), data->Macros.size());
-						else
-							gsCompiled = ShaderCompiler::CompileToSPIRV(data->GSSPV, gsLang, data->GSPath, ShaderStage::Geometry, gsEntry, data->Macros, m_msgs, m_project);
-						
-						if (gsLang == ShaderLanguage::GLSL) { // GLSL
-							gsContent = m_project->LoadProjectFile(data->GSPath);
-							m_includeCheck(gsContent, std::vector<std::string>(), lineBias);
-							m_applyMacros(gsContent, data);
-						} else if (gsCompiled) { // HLSL
-							gsContent = ShaderCompiler::ConvertToGLSL(data->GSSPV, gsLang, ShaderStage::Geometry, data->TSUsed, data->GSUsed, m_msgs);
-							gsEntry = "main";
+		// cache performance timer
+		m_perfTimers.push_back(PerformanceTimer(item));
+		m_perfTimers.back().Create();
 
-							if (gsLang == ShaderLanguage::Plugin)
-								gsContent = m_pluginProcessGLSL(data->GSPath, gsContent.c_str());
-						}
+		if (item->Type == PipelineItem::ItemType::ShaderPass || item->Type == PipelineItem::ItemType::ComputePass) {
+			if (item->Type == PipelineItem::ItemType::ShaderPass) {
+				pipe::ShaderPass* data = reinterpret_cast<ed::pipe::ShaderPass*>(item->Data);
+				m_fbos[data].resize(MAX_RENDER_TEXTURES);
 
-						gs = gl::CompileShader(GL_GEOMETRY_SHADER, gsContent.c_str());
-						gsCompiled &= gl::CheckShaderCompilationStatus(gs, shaderMessage);
-					}
+				if (strlen(data->VSPath) == 0 || strlen(data->PSPath) == 0) {
+					Logger::Get().Log("No shader paths are set", true);
+					return;
+				}
+			} else {
+				pipe::ComputePass* data = reinterpret_cast<ed::pipe::ComputePass*>(item->Data);
+				if (strlen(data->Path) == 0) {
+					Logger::Get().Log("No shader paths are set", true);
+					return;
+				}
+			}
 
-					// tessellation shader
-					lineBias = 0;
-					bool tsCompiled = ((data->TSUsed && m_tessellationSupported) || !data->TSUsed);
-					if (data->TSUsed && m_tessellationSupported) {
-						// tessellation control shader
-						if (strlen(data->TCSEntry) > 0 && strlen(data->TCSPath) > 0) {
-							std::string tcsContent = "", tcsEntry = data->TCSEntry;
-							ShaderLanguage tcsLang = ShaderCompiler::GetShaderLanguageFromExtension(data->TCSPath);
+			/*
+				ITEM CACHING
+			*/
 
-							if (tcsLang == ShaderLanguage::Plugin)
-								tsCompiled &= m_pluginCompileToSpirv(items[i], data->TCSSPV, data->TCSPath, tcsEntry, plugin::ShaderStage::TessellationControl, data->Macros.data(), data->Macros.size());
-							else
-								tsCompiled &= ShaderCompiler::CompileToSPIRV(data->TCSSPV, tcsLang, data->TCSPath, ShaderStage::TessellationControl, tcsEntry, data->Macros, m_msgs, m_project);
-
-							if (tcsLang == ShaderLanguage::GLSL) { // GLSL
-								tcsContent = m_project->LoadProjectFile(data->TCSPath);
-								m_includeCheck(tcsContent, std::vector<std::string>(), lineBias);
-								m_applyMacros(tcsContent, data);
-							} else if (gsCompiled) { // HLSL
-								tcsContent = ShaderCompiler::ConvertToGLSL(data->TCSSPV, tcsLang, ShaderStage::TessellationControl, data->TSUsed, data->GSUsed, m_msgs);
-								tcsEntry = "main";
-
-								if (tcsLang == ShaderLanguage::Plugin)
-									tcsContent = m_pluginProcessGLSL(data->TCSPath, tcsContent.c_str());
-							}
+			m_msgs->CurrentItem = item->Name;
 
-							tcs = gl::CompileShader(GL_TESS_CONTROL_SHADER, tcsContent.c_str());
-							tsCompiled &= gl::CheckShaderCompilationStatus(tcs, shaderMessage);
-						}
+			// the program is linked once the worker threads compile all of the stages
+			m_queueCompileJob(m_createCompileJob(item, false));
+		} else if (item->Type == PipelineItem::ItemType::AudioPass) {
+			pipe::AudioPass* data = reinterpret_cast<ed::pipe::AudioPass*>(item->Data);
 
-						// tessellation evauluation shader
-						if (strlen(data->TESEntry) > 0 && strlen(data->TESPath) > 0) {
-							std::string tesContent = "", tesEntry = data->TESEntry;
-							ShaderLanguage tesLang = ShaderCompiler::GetShaderLanguageFromExtension(data->TESPath);
+			/*
+				ITEM CACHING
+			*/
 
-							if (tesLang == ShaderLanguage::Plugin)
-								tsCompiled &= m_pluginCompileToSpirv(items[i], data->TESSPV, data->TESPath, tesEntry, plugin::ShaderStage::TessellationEvaluation, data->Macros.data(), data->Macros.size());
-							else
-								tsCompiled &= ShaderCompiler::CompileToSPIRV(data->TESSPV, tesLang, data->TESPath, ShaderStage::TessellationEvaluation, tesEntry, data->Macros, m_msgs, m_project);
-
-							if (tesLang == ShaderLanguage::GLSL) { // GLSL
-								tesContent = m_project->LoadProjectFile(data->TESPath);
-								m_includeCheck(tesContent, std::vector<std::string>(), lineBias);
-								m_applyMacros(tesContent, data);
-							} else if (gsCompiled) { // HLSL
-								tesContent = ShaderCompiler::ConvertToGLSL(data->TESSPV, tesLang, ShaderStage::TessellationEvaluation, data->TSUsed, data->GSUsed, m_msgs);
-								tesEntry = "main";
-
-								if (tesLang == ShaderLanguage::Plugin)
-									tesContent = m_pluginProcessGLSL(data->TESPath, tesContent.c_str());
-							}
+			m_msgs->CurrentItem = item->Name;
+			std::string content = m_project->LoadProjectFile(data->Path);
 
-							tes = gl::CompileShader(GL_TESS_EVALUATION_SHADER, tesContent.c_str());
-							tsCompiled &= gl::CheckShaderCompilationStatus(tes, shaderMessage);
-						}
-					}
+			// vertex shader
+			if (ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL)
+				m_applyMacros(content, data);
+			data->Stream.CompileFromShaderSource(m_project, m_msgs, content, data->Macros, ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::HLSL);
 
+			data->Variables.UpdateUniformInfo(data->Stream.GetShader());
+		}
+	}
+	void RenderEngine::m_uncacheItem(int index)
+	{
+		PipelineItem* item = m_items[index];
+
+		m_discardCompileJobs(item);
+
+		m_deleteProgram(item, m_shaders[index]);
+		m_deleteProgram(item, m_debugShaders[index]);
+		glDeleteShader(m_shaderSources[index].VS);
+		glDeleteShader(m_shaderSources[index].PS);
+		glDeleteShader(m_shaderSources[index].GS);
+		glDeleteShader(m_shaderSources[index].TCS);
+		glDeleteShader(m_shaderSources[index].TES);
+		m_perfTimers[index].Destroy();
+		m_compileTimes.erase(item);
+
+		Logger::Get().Log("Removing an item from cache");
+
+		if (item->Type == PipelineItem::ItemType::ShaderPass) {
+			pipe::ShaderPass* data = (pipe::ShaderPass*)item->Data;
+			if (m_fboMS.count(data))
+				glDeleteFramebuffers(1, &m_fboMS[data]);
+
+			m_fbos.erase(data);
+			m_fboMS.erase(data);
+			m_fboCount.erase(data);
+		} else if (item->Type == PipelineItem::ItemType::ComputePass)
+			m_uboMax.erase((pipe::ComputePass*)item->Data);
+
+		m_items.erase(m_items.begin() + index);
+		m_shaders.erase(m_shaders.begin() + index);
+		m_debugShaders.erase(m_debugShaders.begin() + index);
+		m_shaderSources.erase(m_shaderSources.begin() + index);
+		m_perfTimers.erase(m_perfTimers.begin() + index);
+	}
+	void RenderEngine::m_deleteProgram(PipelineItem* item, GLuint program)
+	{
+		if (program == 0)
+			return;
 
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
-
-					if (m_debugShaders[i] != 0)
-						glDeleteProgram(m_debugShaders[i]);
+		if (item->Type == PipelineItem::ItemType::ShaderPass)
+			((pipe::ShaderPass*)item->Data)->Variables.RemoveProgram(program);
+		else if (item->Type == PipelineItem::ItemType::ComputePass)
+			((pipe::ComputePass*)item->Data)->Variables.RemoveProgram(program);
 
-					if (!vsCompiled || !psCompiled || !gsCompiled || !tsCompiled) {
-						if (shaderMessage[0] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(items[i]->Name))
-							m_msgs->Add(MessageStack::Type::Error, items[i]->Name, shaderMessage);
-						m_msgs->Add(MessageStack::Type::Error, items[i]->Name, "Failed to compile the shader");
-						m_shaders[i] = 0;
-					} else {
-						m_msgs->ClearGroup(items[i]->Name);
-
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], vs);
-						glAttachShader(m_shaders[i], ps);
-						if (data->GSUsed) glAttachShader(m_shaders[i], gs);
-						if (data->TSUsed) glAttachShader(m_shaders[i], tcs);
-						if (data->TSUsed) glAttachShader(m_shaders[i], tes);
-						glLinkProgram(m_shaders[i]);
-						// XXX TODO check link status
-
-						m_debugShaders[i] = glCreateProgram();
-						glAttachShader(m_debugShaders[i], m_generalDebugShader);
-						glAttachShader(m_debugShaders[i], vs);
-						if (data->GSUsed) glAttachShader(m_debugShaders[i], gs);
-						if (data->TSUsed) glAttachShader(m_debugShaders[i], tcs);
-						if (data->TSUsed) glAttachShader(m_debugShaders[i], tes);
-						glLinkProgram(m_debugShaders[i]);
-					}
+		glDeleteProgram(program);
+	}
+	void RenderEngine::m_buildPlan()
+	{
+		m_plan.clear();
+		m_plan.resize(m_items.size());
 
-					if (m_shaders[i] != 0)
-						data->Variables.UpdateUniformInfo(m_shaders[i]);
+		for (int i = 0; i < m_items.size(); i++) {
+			PipelineItem* it = m_items[i];
+			PlanPass& plan = m_plan[i];
 
-					m_shaderSources[i].VS = vs;
-					m_shaderSources[i].PS = ps;
-					m_shaderSources[i].GS = gs;
-					m_shaderSources[i].TCS = tcs;
-					m_shaderSources[i].TES = tes;
-				}
-				else if (items[i]->Type == PipelineItem::ItemType::ComputePass && m_computeSupported) {
-					pipe::ComputePass* data = reinterpret_cast<ed::pipe::ComputePass*>(items[i]->Data);
-					int shaderMessagesBefore = m_msgs->GetGroupErrorAndWarningMsgCount(items[i]->Name);
+			plan.IsGLSL = false;
+			for (int j = 0; j < MAX_RENDER_TEXTURES; j++)
+				plan.RenderTextures[j] = nullptr;
 
-					m_items.insert(m_items.begin() + i, items[i]);
-					m_shaders.insert(m_shaders.begin() + i, 0);
-					m_debugShaders.insert(m_debugShaders.begin() + i, 0);
-					m_shaderSources.insert(m_shaderSources.begin() + i, ShaderPack());
+			m_buildBindTable(plan.SRVs, m_objects->GetBindList(it), false);
+			m_buildBindTable(plan.UBOs, m_objects->GetUniformBindList(it), true);
 
-					SPIRVQueue.push_back(items[i]);
+			if (it->Type == PipelineItem::ItemType::ShaderPass) {
+				pipe::ShaderPass* data = (pipe::ShaderPass*)it->Data;
 
-					// cache performance timer
-					m_perfTimers.insert(m_perfTimers.begin() + i, PerformanceTimer(items[i]));
-					glGenQueries(1, &m_perfTimers[i].Object);
-					m_perfTimers[i].IsCreated = true;
+				plan.IsGLSL = ShaderCompiler::GetShaderLanguageFromExtension(data->PSPath) == ShaderLanguage::GLSL;
 
-					if (strlen(data->Path) == 0) {
-						Logger::Get().Log("No shader paths are set", true);
+				for (int j = 0; j < MAX_RENDER_TEXTURES && data->RenderTextures[j] != 0; j++) {
+					if (data->RenderTextures[j] == m_rtColor)
 						continue;
-					}
-
-					/*
-						ITEM CACHING
-					*/
 
-					GLuint cs = 0;
-
-					m_msgs->CurrentItem = items[i]->Name;
-
-					std::string content = "", entry = data->Entry;
-					int lineBias = 0;
-					ShaderLanguage lang = ShaderCompiler::GetShaderLanguageFromExtension(data->Path);
-
-					// compute shader
-					bool compiled = false;
-
-					if (lang == ShaderLanguage::Plugin)
-						compiled = m_pluginCompileToSpirv(items[i], data->SPV, data->Path, entry, plugin::ShaderStage::Compute, data->Macros.data(), data->Macros.size());
-					else
-						compiled = ShaderCompiler::CompileToSPIRV(data->SPV, lang, data->Path, ShaderStage::Compute, entry, data->Macros, m_msgs, m_project);
-					
-					if (lang == ShaderLanguage::GLSL) { // GLSL
-						content = m_project->LoadProjectFile(data->Path);
-						m_includeCheck(content, std::vector<std::string>(), lineBias);
-						m_applyMacros(content, data);
-					} else if (compiled) { // HLSL / VK
-						content = ShaderCompiler::ConvertToGLSL(data->SPV, lang, ShaderStage::Compute, false, false, m_msgs);
-						entry = "main";
+					ObjectManagerItem* rtData = m_objects->GetByTextureID(data->RenderTextures[j]);
+					if (rtData != nullptr)
+						plan.RenderTextures[j] = rtData->RT;
+				}
 
-						if (lang == ShaderLanguage::Plugin)
-							content = m_pluginProcessGLSL(data->Path, content.c_str());
-					}
+				plan.Draws.resize(data->Items.size());
+				for (int j = 0; j < data->Items.size(); j++) {
+					PipelineItem* item = data->Items[j];
+					PlanDraw& draw = plan.Draws[j];
 
-					cs = gl::CompileShader(GL_COMPUTE_SHADER, content.c_str());
-					compiled &= gl::CheckShaderCompilationStatus(cs, shaderMessage);
+					draw.Item = item;
+					draw.Picked = std::count(m_pick.begin(), m_pick.end(), item) > 0;
+					draw.Stride = 0;
 
-					if (m_shaders[i] != 0)
-						glDeleteProgram(m_shaders[i]);
+					for (int k = 0; k < m_itemValues.size(); k++)
+						if (m_itemValues[k].Item == item)
+							draw.ItemValues.push_back(k);
 
-					if (!compiled) {
-						if (shaderMessage[0] != 0 && shaderMessagesBefore == m_msgs->GetGroupErrorAndWarningMsgCount(items[i]->Name))
-							m_msgs->Add(MessageStack::Type::Error, items[i]->Name, shaderMessage);
-						m_msgs->Add(MessageStack::Type::Error, items[i]->Name, "Failed to compile the compute shader");
-						m_shaders[i] = 0;
-					} else {
-						m_msgs->ClearGroup(items[i]->Name);
-
-						m_shaders[i] = glCreateProgram();
-						glAttachShader(m_shaders[i], cs);
-						glLinkProgram(m_shaders[i]);
+					if (item->Type == PipelineItem::ItemType::VertexBuffer) {
+						ed::BufferObject* bobj = (ed::BufferObject*)((pipe::VertexBuffer*)item->Data)->Buffer;
+						if (bobj != nullptr) {
+							auto bobjFmt = m_objects->ParseBufferFormat(bobj->ViewFormat);
+							for (const auto& f : bobjFmt)
+								draw.Stride += ShaderVariable::GetSize(f, true);
+						}
 					}
-
-					if (m_shaders[i] != 0)
-						data->Variables.UpdateUniformInfo(m_shaders[i]);
-
-					m_shaderSources[i].VS = 0;
-					m_shaderSources[i].PS = 0;
-					m_shaderSources[i].GS = 0;
-					m_shaderSources[i].TCS = 0;
-					m_shaderSources[i].TES = 0;
-				} 
-				else if (items[i]->Type == PipelineItem::ItemType::AudioPass) {
-					pipe::AudioPass* data = reinterpret_cast<ed::pipe::AudioPass*>(items[i]->Data);
-
-					m_items.insert(m_items.begin() + i, items[i]);
-					m_shaders.insert(m_shaders.begin() + i, 0);
-					m_debugShaders.insert(m_debugShaders.begin() + i, 0);
-					m_shaderSources.insert(m_shaderSources.begin() + i, ShaderPack());
-
-					// cache performance timer
-					m_perfTimers.insert(m_perfTimers.begin() + i, PerformanceTimer(items[i]));
-					glGenQueries(1, &m_perfTimers[i].Object);
-					m_perfTimers[i].IsCreated = true;
-
-					/*
-						ITEM CACHING
-					*/
-
-					m_msgs->CurrentItem = items[i]->Name;
-					std::string content = m_project->LoadProjectFile(data->Path);
-
-					// vertex shader
-					if (ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::GLSL)
-						m_applyMacros(content, data);
-					data->Stream.CompileFromShaderSource(m_project, m_msgs, content, data->Macros, ShaderCompiler::GetShaderLanguageFromExtension(data->Path) == ShaderLanguage::HLSL);
-
-					data->Variables.UpdateUniformInfo(data->Stream.GetShader());
-				} 
-				else if (items[i]->Type == PipelineItem::ItemType::PluginItem) {
-					pipe::PluginItemData* data = reinterpret_cast<pipe::PluginItemData*>(items[i]->Data);
-
-					m_items.insert(m_items.begin() + i, items[i]);
-					m_shaders.insert(m_shaders.begin() + i, 0);
-					m_debugShaders.insert(m_debugShaders.begin() + i, 0);
-					m_shaderSources.insert(m_shaderSources.begin() + i, ShaderPack());
-
-					// cache performance timer
-					m_perfTimers.insert(m_perfTimers.begin() + i, PerformanceTimer(items[i]));
-					glGenQueries(1, &m_perfTimers[i].Object);
-					m_perfTimers[i].IsCreated = true;
 				}
-			}
+			} else if (it->Type == PipelineItem::ItemType::ComputePass)
+				plan.IsGLSL = ShaderCompiler::GetShaderLanguageFromExtension(((pipe::ComputePass*)it->Data)->Path) == ShaderLanguage::GLSL;
+			else if (it->Type == PipelineItem::ItemType::AudioPass)
+				plan.IsGLSL = ShaderCompiler::GetShaderLanguageFromExtension(((pipe::AudioPass*)it->Data)->Path) == ShaderLanguage::GLSL;
 		}
 
-		// check if some item was removed
-		for (int i = 0; i < m_items.size(); i++) {
-			bool found = false;
-			for (int j = 0; j < items.size(); j++)
-				if (items[j]->Data == m_items[i]->Data) {
-					found = true;
-					break;
-				}
-
-			if (!found) {
-				glDeleteProgram(m_shaders[i]);
-				glDeleteProgram(m_debugShaders[i]);
-				glDeleteQueries(1, &m_perfTimers[i].Object);
-
-				Logger::Get().Log("Removing an item from cache");
-
-				if (m_items[i]->Type == PipelineItem::ItemType::ShaderPass)
-					m_fbos.erase((pipe::ShaderPass*)m_items[i]->Data);
-
-				m_items.erase(m_items.begin() + i);
-				m_shaders.erase(m_shaders.begin() + i);
-				m_debugShaders.erase(m_debugShaders.begin() + i);
-				m_shaderSources.erase(m_shaderSources.begin() + i);
-				m_perfTimers.erase(m_perfTimers.begin() + i);
+		m_planDirty = false;
+	}
+	void RenderEngine::m_buildBindTable(std::vector<PlanBinding>& table, const std::vector<GLuint>& ids, bool isUBO)
+	{
+		table.resize(ids.size());
+		for (int j = 0; j < ids.size(); j++) {
+			PlanBinding& bind = table[j];
+			bind.ID = ids[j];
+			bind.Object = m_objects->GetByTextureID(ids[j]);
+			if (bind.Object == nullptr && isUBO)
+				bind.Object = m_objects->GetByBufferID(ids[j]);
+
+			ObjectType type = bind.Object == nullptr ? ObjectType::Unknown : bind.Object->Type;
+			if (type == ObjectType::PluginObject)
+				bind.Target = 0;
+			else if (isUBO) {
+				// image objects are bound as images in compute passes
+				if (type == ObjectType::Image)
+					bind.Target = GL_TEXTURE_2D;
+				else if (type == ObjectType::Image3D)
+					bind.Target = GL_TEXTURE_3D;
+				else
+					bind.Target = GL_SHADER_STORAGE_BUFFER;
+			} else {
+				if (type == ObjectType::CubeMap)
+					bind.Target = GL_TEXTURE_CUBE_MAP;
+				else if (type == ObjectType::Image3D || type == ObjectType::Texture3D)
+					bind.Target = GL_TEXTURE_3D;
+				else
+					bind.Target = GL_TEXTURE_2D;
 			}
 		}
-
-		// check if the order of the items changed
-		for (int i = 0; i < m_items.size(); i++) {
-			// two items at the same position dont match
-			if (items[i]->Data != m_items[i]->Data) {
-				// find the real position from original list
-				for (int j = 0; j < items.size(); j++) {
-					// we found the original position so move the item
-					if (items[j]->Data == m_items[i]->Data) {
-						Logger::Get().Log("Updating cached item " + std::string(items[j]->Name));
-
-						int dest = j > i ? (j - 1) : j;
-						m_items.erase(m_items.begin() + i, m_items.begin() + i + 1);
-						m_items.insert(m_items.begin() + dest, items[j]);
-
-						GLuint sCopy = m_shaders[i];
-						GLuint sdbgCopy = m_debugShaders[i];
-						ShaderPack ssrcCopy = m_shaderSources[i];
-						PerformanceTimer perfTimerCopy = m_perfTimers[i];
-
-						m_shaders.erase(m_shaders.begin() + i);
-						m_shaders.insert(m_shaders.begin() + dest, sCopy);
-
-						m_debugShaders.erase(m_debugShaders.begin() + i);
-						m_debugShaders.insert(m_debugShaders.begin() + dest, sdbgCopy);
-
-						m_shaderSources.erase(m_shaderSources.begin() + i);
-						m_shaderSources.insert(m_shaderSources.begin() + dest, ssrcCopy);
-
-						m_perfTimers.erase(m_perfTimers.begin() + i);
-						m_perfTimers.insert(m_perfTimers.begin() + dest, perfTimerCopy);
-					}
-				}
-			}
+	}
+	void RenderEngine::m_markWrittenBuffers(const PlanPass& pass)
+	{
+		for (const auto& ubo : pass.UBOs)
+			if (ubo.Target == GL_SHADER_STORAGE_BUFFER && ubo.Object != nullptr && ubo.Object->Buffer != nullptr)
+				ubo.Object->Buffer->GPUWritten = true;
+	}
+	void RenderEngine::m_bindTextures(const PlanPass& pass, ShaderVariableContainer& vars, GLuint program)
+	{
+		for (int j = 0; j < pass.SRVs.size(); j++) {
+			const PlanBinding& srv = pass.SRVs[j];
+
+			glActiveTexture(GL_TEXTURE0 + j);
+			if (srv.Target == 0) {
+				PluginObject* pobj = srv.Object->Plugin;
+				pobj->Owner->Object_Bind(pobj->Type, pobj->Data, pobj->ID);
+			} else
+				glBindTexture(srv.Target, srv.ID);
+
+			if (pass.IsGLSL) // TODO: or should this be for vulkan glsl too?
+				vars.UpdateTexture(program, j);
 		}
 	}
-	void RenderEngine::m_applyMacros(std::string& src, pipe::ShaderPass* pass)
+	void RenderEngine::m_applyMacros(std::string& src, const std::vector<ShaderMacro>& macros)
 	{
 		size_t verLoc = src.find_first_of("#version");
 		size_t lineLoc = src.find_first_of('\n', verLoc + 1) + 1;
@@ -2420,7 +2509,7 @@ namespace ed {
 #endif
 		strMacro += "#define SHADERED_VERSION " + std::to_string(SHADERED_VERSION) + "\n";
 
-		for (auto& macro : pass->Macros) {
+		for (auto& macro : macros) {
 			if (!macro.Active)
 				continue;
 
@@ -2430,51 +2519,17 @@ namespace ed {
 		if (strMacro.size() > 0)
 			src.insert(lineLoc, strMacro);
 	}
+	void RenderEngine::m_applyMacros(std::string& src, pipe::ShaderPass* pass)
+	{
+		m_applyMacros(src, pass->Macros);
+	}
 	void RenderEngine::m_applyMacros(std::string& src, pipe::ComputePass* pass)
 	{
-		size_t verLoc = src.find_first_of("#version");
-		size_t lineLoc = src.find_first_of('\n', verLoc + 1) + 1;
-		std::string strMacro = "";
-
-#ifdef SHADERED_WEB
-		strMacro += "#define SHADERED_WEB\n";
-#else
-		strMacro += "#define SHADERED_DESKTOP\n";
-#endif
-		strMacro += "#define SHADERED_VERSION " + std::to_string(SHADERED_VERSION) + "\n";
-
-		for (auto& macro : pass->Macros) {
-			if (!macro.Active)
-				continue;
-
-			strMacro += "#define " + std::string(macro.Name) + " " + std::string(macro.Value) + "\n";
-		}
-
-		if (strMacro.size() > 0)
-			src.insert(lineLoc, strMacro);
+		m_applyMacros(src, pass->Macros);
 	}
 	void RenderEngine::m_applyMacros(std::string& src, pipe::AudioPass* pass)
 	{
-		size_t verLoc = src.find_first_of("#version");
-		size_t lineLoc = src.find_first_of('\n', verLoc + 1) + 1;
-		std::string strMacro = "";
-
-#ifdef SHADERED_WEB
-		strMacro += "#define SHADERED_WEB\n";
-#else
-		strMacro += "#define SHADERED_DESKTOP\n";
-#endif
-		strMacro += "#define SHADERED_VERSION " + std::to_string(SHADERED_VERSION) + "\n";
-
-		for (auto& macro : pass->Macros) {
-			if (!macro.Active)
-				continue;
-
-			strMacro += "#define " + std::string(macro.Name) + " " + std::string(macro.Value) + "\n";
-		}
-
-		if (strMacro.size() > 0)
-			src.insert(lineLoc, strMacro);
+		m_applyMacros(src, pass->Macros);
 	}
 	
 	
@@ -2519,8 +2574,11 @@ namespace ed {
 		
 		return ret;
 	}
-	void RenderEngine::m_includeCheck(std::string& src, std::vector<std::string> includeStack, int& lineBias)
+	void RenderEngine::m_includeCheck(std::string& src, std::vector<std::string> includeStack, int& lineBias, MessageStack* msgs)
 	{
+		if (msgs == nullptr)
+			msgs = m_msgs;
+
 		size_t incLoc = src.find("#include");
 		Settings& settings = Settings::Instance();
 
@@ -2553,7 +2611,7 @@ namespace ed {
 				src.erase(incLoc, src.find_first_of('\n', incLoc) - incLoc);
 
 				if (std::count(includeStack.begin(), includeStack.end(), ipath) > 0)
-					m_msgs->Add(ed::MessageStack::Type::Error, m_msgs->CurrentItem, "Recursive #include detected");
+					msgs->Add(ed::MessageStack::Type::Error, msgs->CurrentItem, "Recursive #include detected");
 
 				if (m_project->FileExists(ipath) && std::count(includeStack.begin(), includeStack.end(), ipath) == 0) {
 					includeStack.push_back(ipath);
@@ -2561,7 +2619,7 @@ namespace ed {
 					std::string incFileSrc = m_project->LoadProjectFile(ipath);
 					lineBias = std::count(incFileSrc.begin(), incFileSrc.end(), '\n');
 
-					m_includeCheck(incFileSrc, includeStack, lineBias);
+					m_includeCheck(incFileSrc, includeStack, lineBias, msgs);
 
 					src.insert(incLoc, incFileSrc);
 
@@ -1,4 +1,6 @@
 #pragma once
+#include <SHADERed/Engine/BVH.h>
+#include <SHADERed/Engine/ThreadPool.h>
 #include <SHADERed/Engine/Timer.h>
 #include <SHADERed/Objects/DebugInformation.h>
 #include <SHADERed/Objects/MessageStack.h>
@@ -6,8 +8,11 @@
 #include <SHADERed/Objects/PluginManager.h>
 #include <SHADERed/Objects/ProjectParser.h>
 #include <SHADERed/Objects/PerformanceTimer.h>
+#include <SHADERed/Objects/ShaderLanguage.h>
 
+#include <deque>
 #include <functional>
+#include <future>
 #include <unordered_map>
 
 #include <glm/glm.hpp>
@@ -23,6 +28,8 @@
 
 namespace ed {
 	class ObjectManager;
+	class ObjectManagerItem;
+	struct RenderTextureObject;
 
 	uint32_t getPixelID(GLuint rt, uint8_t* data, int x, int y, int width);
 
@@ -36,7 +43,8 @@ namespace ed {
 
 		void Render(int width, int height, bool isDebug = false, PipelineItem* breakItem = nullptr);
 		inline void Render(bool isDebug = false, PipelineItem* breakItem = nullptr) { Render(m_lastSize.x, m_lastSize.y, isDebug, breakItem); }
-		void Recompile(const char* name);
+		void Recompile(const char* name); // doesn't wait either - use FinishCompilation(item) when the new program is needed right away
+		void RecompileAll(); // doesn't wait for the compilation to finish - passes are linked once they are compiled
 		void RecompileFile(const char* fname);
 		void RecompileFromSource(const char* name, const std::string& vs = "", const std::string& ps = "", const std::string& gs = "", const std::string& tcs = "", const std::string& tes = "");
 		void Pick(float sx, float sy, bool multiPick, std::function<void(PipelineItem*)> func = nullptr);
@@ -44,6 +52,10 @@ namespace ed {
 		inline bool IsPicked(PipelineItem* item) { return std::count(m_pick.begin(), m_pick.end(), item); }
 
 		void FlushCache();
+		void OnPipelineEvent(PipelineManager::EventType type, PipelineItem* item);
+		void FinishCompilation(PipelineItem* item = nullptr); // block until the queued shader passes (or only item's) are compiled and linked
+		inline bool IsCompiling() { return !m_compileJobs.empty(); }
+
 		void AddPickedItem(PipelineItem* pipe, bool multiPick = false);
 
 		std::pair<PipelineItem*, PipelineItem*> GetPipelineItemByDebugID(int id); // get pipeline item by it's debug id
@@ -61,11 +73,24 @@ namespace ed {
 		inline glm::ivec2 GetLastRenderSize() { return m_lastSize; }
 
 		inline const std::vector<PerformanceTimer>& GetPerformanceTimers() { return m_perfTimers; }
+		inline const PerformanceTimer& GetFrameTimer() { return m_frameTimer; }
 		inline unsigned long long GetGPUTime() { return m_totalPerfTime; }
+		void PollPerformanceTimers(); // called by Render() - call it manually only after a glFinish() to read the last frame's results right away
+		bool ExportProfilerTrace(const std::string& path); // Chrome trace event format (chrome://tracing, Perfetto)
 
 		inline bool IsPaused() { return m_paused; }
+
+		// CPU time (front-end stages + GL compile & link) of the item's last compilation in seconds, -1 -> not compiled yet
+		inline float GetCompileTime(PipelineItem* item)
+		{
+			auto it = m_compileTimes.find(item);
+			return it == m_compileTimes.end() ? -1.0f : it->second;
+		}
 		void Pause(bool pause);
 
+		// rebuild the render plan before the next frame - called whenever the project is modified
+		inline void InvalidatePlan() { m_planDirty = true; }
+
 		// list of items waiting to be parsed
 		std::vector<PipelineItem*> SPIRVQueue;
 
@@ -86,9 +111,14 @@ namespace ed {
 		};
 
 		inline std::vector<ItemVariableValue>& GetItemVariableValues() { return m_itemValues; }
-		inline void AddItemVariableValue(const ItemVariableValue& item) { m_itemValues.push_back(item); }
+		inline void AddItemVariableValue(const ItemVariableValue& item)
+		{
+			m_itemValues.push_back(item);
+			m_planDirty = true;
+		}
 		inline void RemoveItemVariableValue(PipelineItem* item, ShaderVariable* var)
 		{
+			m_planDirty = true;
 			for (int i = 0; i < m_itemValues.size(); i++)
 				if (m_itemValues[i].Item == item && m_itemValues[i].Variable == var) {
 					m_itemValues.erase(m_itemValues.begin() + i);
@@ -97,6 +127,7 @@ namespace ed {
 		}
 		inline void RemoveItemVariableValues(PipelineItem* item)
 		{
+			m_planDirty = true;
 			for (int i = 0; i < m_itemValues.size(); i++)
 				if (m_itemValues[i].Item == item) {
 					m_itemValues.erase(m_itemValues.begin() + i);
@@ -128,12 +159,13 @@ namespace ed {
 		bool m_fbosNeedUpdate;
 
 		// check for the #include's & change the source code accordingly (includeStack == prevent recursion)
-		void m_includeCheck(std::string& src, std::vector<std::string> includeStack, int& lineBias);
+		void m_includeCheck(std::string& src, std::vector<std::string> includeStack, int& lineBias, MessageStack* msgs = nullptr);
 
 		// apply macros to GLSL source code
+		void m_applyMacros(std::string& source, const std::vector<ShaderMacro>& macros);
 		void m_applyMacros(std::string& source, pipe::ShaderPass* pass);
 		void m_applyMacros(std::string& source, pipe::ComputePass* pass);
-		void m_applyMacros(std::string& source, pipe::AudioPass* pass); // TODO: merge this function with the ones above
+		void m_applyMacros(std::string& source, pipe::AudioPass* pass);
 
 		// compile to spirv - plugin edition
 		bool m_pluginCompileToSpirv(PipelineItem* owner, std::vector<GLuint>& spv, const std::string& path, const std::string& entry, plugin::ShaderStage stage, ed::ShaderMacro* macros, size_t macroCount, const std::string& actualSrc = "");
@@ -149,6 +181,23 @@ namespace ed {
 		bool m_wasMultiPick;
 		void m_pickItem(PipelineItem* item, bool multiPick);
 
+		// models build their BVH when they are loaded, vertex buffers are built on the first pick & rebuilt when their data changes
+		struct VertexBufferBVH {
+			VertexBufferBVH()
+			{
+				Topology = 0;
+				Buffer = nullptr;
+				Version = 0;
+			}
+			unsigned int Topology;
+			BufferObject* Buffer;
+			unsigned int Version;
+			std::string Format;
+			eng::BVH Tree;
+		};
+		std::unordered_map<PipelineItem*, VertexBufferBVH> m_vbBVH;
+		const eng::BVH* m_getVertexBufferBVH(PipelineItem* item); // nullptr -> not a triangle list/strip/fan
+
 		// cache
 		std::vector<PipelineItem*> m_items;
 		std::vector<GLuint> m_shaders;
@@ -164,8 +213,9 @@ namespace ed {
 		std::vector<ShaderPack> m_shaderSources;
 
 		std::vector<PerformanceTimer> m_perfTimers;
+		PerformanceTimer m_frameTimer;
 		unsigned long long m_totalPerfTime;
-		eng::Timer m_lastPerfMeasure;
+		void m_updateDrawTimers(PerformanceTimer& timer, const PlanPass& plan);
 
 		GLuint m_generalDebugShader;
 
@@ -173,7 +223,82 @@ namespace ed {
 
 		std::vector<ItemVariableValue> m_itemValues; // list of all values to apply once we start rendering
 
-		eng::Timer m_cacheTimer;
+		// cache is updated from PipelineManager's events
+		bool m_cacheDirty, m_cacheResync;
+		std::vector<PipelineItem*> m_cacheQueue; // added items that are cached before the next frame
 		void m_cache();
+		bool m_isCacheable(PipelineItem* item);
+		void m_cacheItem(PipelineItem* item);
+		void m_uncacheItem(int index);
+		void m_deleteProgram(PipelineItem* item, GLuint program); // also drops the program from item's variable container
+
+		/* render plan - pipeline resolved into flat bind tables & draw lists so that the frame loop doesn't do any lookups */
+		struct PlanBinding {
+			GLuint ID;
+			GLenum Target;				// texture target, GL_SHADER_STORAGE_BUFFER or 0 if the object is bound by the plugin
+			ObjectManagerItem* Object;	// nullptr if the object wasn't found
+		};
+		struct PlanDraw {
+			PipelineItem* Item;
+			bool Picked;
+			int Stride;					  // vertex buffers - vertex count is Size/Stride
+			std::vector<int> ItemValues;  // indices of the overriden variable values in m_itemValues
+		};
+		struct PlanPass {
+			bool IsGLSL;
+			RenderTextureObject* RenderTextures[MAX_RENDER_TEXTURES]; // nullptr -> window
+			std::vector<PlanBinding> SRVs, UBOs;
+			std::vector<PlanDraw> Draws;
+		};
+		std::vector<PlanPass> m_plan; // same order as m_items
+		bool m_planDirty;
+		void m_buildPlan();
+		void m_buildBindTable(std::vector<PlanBinding>& table, const std::vector<GLuint>& ids, bool isUBO);
+		void m_bindTextures(const PlanPass& pass, ShaderVariableContainer& vars, GLuint program);
+		void m_markWrittenBuffers(const PlanPass& pass); // SSBOs -> CPU copy might be out of date
+
+		/* shader compilation - preprocessing, glslang and SPIRV-Cross run on eng::ThreadPool, only the GL compile & link run on this thread */
+		struct CompileStage {
+			ShaderStage Stage;
+			GLenum Type;
+			ShaderLanguage Language;
+			std::string Path, Entry;
+
+			bool Compiled;
+			float Time; // seconds spent in m_compileStage
+			std::vector<unsigned int> SPV;
+			std::string GLSL;
+			MessageStack Messages; // each stage has its own stack so that the workers don't share anything
+
+			std::future<void> Task; // not valid if the stage was compiled on this thread
+		};
+		struct CompileJob {
+			PipelineItem* Item;
+			bool IsRecompile; // initial caching clears the message group on success, recompiling reports the result
+			bool Discarded;	  // item was removed or a newer compilation was queued
+			bool Linked, Succeeded, SourceEmpty;
+			std::string LinkMessage;
+			float LinkTime;
+
+			bool GSUsed, TSUsed;
+			std::vector<ShaderMacro> Macros;
+			std::vector<CompileStage> Stages;
+		};
+		std::deque<CompileJob*> m_compileJobs; // in the order in which they were queued
+		std::unordered_map<PipelineItem*, float> m_compileTimes;
+		void m_recompileItem(PipelineItem* item);
+		CompileJob* m_createCompileJob(PipelineItem* item, bool isRecompile);
+		void m_queueCompileJob(CompileJob* job);
+		void m_discardCompileJobs(PipelineItem* item);
+		void m_compileStage(CompileJob* job, CompileStage& stage);
+		void m_linkCompileJob(CompileJob* job);
+		void m_reportCompileJob(CompileJob* job);
+		void m_updateCompileJobs(bool wait, PipelineItem* item = nullptr); // item != nullptr -> only wait for its jobs
+
+		/* GL program binary cache - linked programs are stored in ShaderCache, keyed by the final GLSL + GL driver */
+		bool m_programBinarySupported;
+		std::string m_programCacheInfo; // GL vendor, renderer & version
+		int m_programCacheHits, m_programCacheMisses;
+		GLuint m_linkProgram(const std::vector<GLuint>& shaders, uint64_t cacheKey); // cacheKey == 0 -> don't use the cache
 	};
 }
\ No newline at end of file
@@ -0,0 +1,363 @@
+#include <SHADERed/Objects/SequenceExporter.h>
+#include <SHADERed/Objects/Logger.h>
+#include <SHADERed/Options.h>
+
+#include <misc/stb_image_resize.h>
+#include <misc/stb_image_write.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <string.h>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#endif
+
+namespace ed {
+	SequenceExporter::SequenceExporter()
+	{
+		m_width = m_height = 0;
+		m_outWidth = m_outHeight = 0;
+		m_started = false;
+		m_format = Format::Image;
+		m_stream = nullptr;
+		m_nextSequence = m_nextWrite = 0;
+		m_ringPos = 0;
+		m_stop = false;
+		m_written = 0;
+	}
+	SequenceExporter::~SequenceExporter()
+	{
+		End();
+	}
+	bool SequenceExporter::Begin(const std::string& filename, Format format, const std::string& ext, int width, int height, int outWidth, int outHeight, int fps, int ringSize)
+	{
+		End();
+
+		m_filename = filename;
+		m_format = format;
+		m_ext = ext;
+		m_width = width;
+		m_height = height;
+		m_outWidth = outWidth;
+		m_outHeight = outHeight;
+		m_ringPos = 0;
+		m_stop = false;
+		m_written = 0;
+		m_nextSequence = m_nextWrite = 0;
+
+		if (format != Format::Image) {
+			if (filename == "-") {
+#ifdef _WIN32
+				_setmode(_fileno(stdout), _O_BINARY);
+#endif
+				m_stream = stdout;
+			} else
+				m_stream = fopen(filename.c_str(), "wb");
+
+			if (m_stream == nullptr) {
+				Logger::Get().Log("Failed to open " + filename + " for writing", true);
+				return false;
+			}
+
+			if (format == Format::Y4M) {
+				bool is420 = outWidth % 2 == 0 && outHeight % 2 == 0;
+				fprintf(m_stream, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 %s\n", outWidth, outHeight, fps, is420 ? "C420jpeg" : "C444");
+			}
+		}
+
+		size_t frameSize = width * height * 4;
+
+		m_ring.resize(std::max<int>(ringSize, 1));
+		for (auto& rb : m_ring) {
+			glGenBuffers(1, &rb.PBO);
+			glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.PBO);
+			glBufferData(GL_PIXEL_PACK_BUFFER, frameSize, nullptr, GL_STREAM_READ);
+			rb.Fence = nullptr;
+			rb.Frame = 0;
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		int workerCount = std::thread::hardware_concurrency();
+		workerCount = workerCount == 0 ? 2 : workerCount;
+
+		// each worker can be busy with one frame while another one is waiting for it
+		for (int i = 0; i < workerCount + 2; i++) {
+			Frame* frame = new Frame();
+			frame->Index = 0;
+			frame->Sequence = 0;
+			frame->Pixels.resize(frameSize);
+			m_pool.push_back(frame);
+			m_freeFrames.push_back(frame);
+		}
+
+		for (int i = 0; i < workerCount; i++)
+			m_workers.push_back(std::thread(&SequenceExporter::m_worker, this));
+
+		m_started = true;
+
+		return true;
+	}
+	void SequenceExporter::Capture(GLuint texture, int frameIndex)
+	{
+		if (!m_started)
+			return;
+
+		// the slot that we are about to reuse holds the oldest frame
+		Readback& rb = m_ring[m_ringPos];
+		if (rb.Fence != nullptr)
+			m_retire(rb);
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.PBO);
+		glBindTexture(GL_TEXTURE_2D, texture);
+		glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+		glBindTexture(GL_TEXTURE_2D, 0);
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		rb.Fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		rb.Frame = frameIndex;
+
+		m_ringPos = (m_ringPos + 1) % m_ring.size();
+	}
+	void SequenceExporter::End()
+	{
+		if (!m_started)
+			return;
+
+		// read back the remaining frames, oldest first
+		for (int i = 0; i < m_ring.size(); i++) {
+			Readback& rb = m_ring[(m_ringPos + i) % m_ring.size()];
+			if (rb.Fence != nullptr)
+				m_retire(rb);
+		}
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_stop = true;
+		}
+		m_queueCond.notify_all();
+
+		for (auto& worker : m_workers)
+			if (worker.joinable())
+				worker.join();
+		m_workers.clear();
+
+		for (auto& rb : m_ring)
+			glDeleteBuffers(1, &rb.PBO);
+		m_ring.clear();
+
+		for (Frame* frame : m_pool)
+			delete frame;
+		m_pool.clear();
+		m_freeFrames.clear();
+		m_queue.clear();
+
+		if (m_stream != nullptr) {
+			if (m_stream == stdout)
+				fflush(m_stream);
+			else
+				fclose(m_stream);
+			m_stream = nullptr;
+		}
+
+		m_started = false;
+
+		Logger::Get().Log("Exported " + std::to_string(m_written) + " frames");
+	}
+	void SequenceExporter::m_retire(Readback& rb)
+	{
+		// wait for the GPU copy
+		GLenum status = GL_TIMEOUT_EXPIRED;
+		while (status == GL_TIMEOUT_EXPIRED)
+			status = glClientWaitSync(rb.Fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+		glDeleteSync(rb.Fence);
+		rb.Fence = nullptr;
+
+		if (status == GL_WAIT_FAILED) {
+			Logger::Get().Log("Failed to read back frame " + std::to_string(rb.Frame), true);
+			return;
+		}
+
+		// wait for a free frame - this is where the rendering waits if the encoders can't keep up
+		Frame* frame = nullptr;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_freeCond.wait(lock, [&]() { return !m_freeFrames.empty(); });
+			frame = m_freeFrames.back();
+			m_freeFrames.pop_back();
+		}
+
+		frame->Index = rb.Frame;
+
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, rb.PBO);
+		void* data = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frame->Pixels.size(), GL_MAP_READ_BIT);
+		if (data != nullptr) {
+			memcpy(frame->Pixels.data(), data, frame->Pixels.size());
+			glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+		}
+		glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			if (data != nullptr) {
+				frame->Sequence = m_nextSequence++;
+				m_queue.push_back(frame);
+			} else
+				m_freeFrames.push_back(frame);
+		}
+		m_queueCond.notify_one();
+	}
+	void SequenceExporter::m_worker()
+	{
+		std::vector<unsigned char> resized, converted;
+
+		while (true) {
+			Frame* frame = nullptr;
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_queueCond.wait(lock, [&]() { return m_stop || !m_queue.empty(); });
+
+				if (m_queue.empty())
+					return;
+
+				frame = m_queue.front();
+				m_queue.pop_front();
+			}
+
+			m_write(frame, resized, converted);
+			m_written++;
+
+			{
+				std::unique_lock<std::mutex> lock(m_mutex);
+				m_freeFrames.push_back(frame);
+			}
+			m_freeCond.notify_one();
+		}
+	}
+	void SequenceExporter::m_write(Frame* frame, std::vector<unsigned char>& resized, std::vector<unsigned char>& converted)
+	{
+		unsigned char* pixels = frame->Pixels.data();
+		int w = m_outWidth, h = m_outHeight;
+
+		// resize image
+		if (m_width != m_outWidth || m_height != m_outHeight) {
+			resized.resize(w * h * 4);
+			stbir_resize_uint8(frame->Pixels.data(), m_width, m_height, m_width * 4, resized.data(), w, h, w * 4, 4);
+			pixels = resized.data();
+		}
+
+		if (m_format != Format::Image) {
+			// GL rows are bottom-up - flip them the same way stbi_flip_vertically_on_write does for the image files
+			std::vector<unsigned char> row(w * 4);
+			for (int y = 0; y < h / 2; y++) {
+				unsigned char* top = pixels + y * w * 4;
+				unsigned char* bottom = pixels + (h - y - 1) * w * 4;
+				memcpy(row.data(), top, w * 4);
+				memcpy(top, bottom, w * 4);
+				memcpy(bottom, row.data(), w * 4);
+			}
+
+			size_t dataSize = w * h * 4;
+			if (m_format == Format::Y4M) {
+				m_convertToYUV(pixels, converted);
+				pixels = converted.data();
+				dataSize = converted.size();
+			}
+
+			// resizing & conversion run in parallel but the stream has to be written in order
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_writeCond.wait(lock, [&]() { return m_nextWrite == frame->Sequence; });
+
+			if (m_format == Format::Y4M)
+				fwrite("FRAME\n", 1, 6, m_stream);
+			fwrite(pixels, 1, dataSize, m_stream);
+
+			m_nextWrite++;
+			lock.unlock();
+			m_writeCond.notify_all();
+
+			return;
+		}
+
+		// a crashed/killed render must not leave a truncated file behind (see IsFrameWritten)
+		std::string path = m_getPath(frame->Index);
+		std::string tempPath = path + ".tmp";
+
+		int status = 0;
+		if (m_ext == "jpg" || m_ext == "jpeg")
+			status = stbi_write_jpg(tempPath.c_str(), w, h, 4, pixels, 100);
+		else if (m_ext == "bmp")
+			status = stbi_write_bmp(tempPath.c_str(), w, h, 4, pixels);
+		else if (m_ext == "tga")
+			status = stbi_write_tga(tempPath.c_str(), w, h, 4, pixels);
+		else
+			status = stbi_write_png(tempPath.c_str(), w, h, 4, pixels, w * 4);
+
+		std::error_code fsError;
+		if (status)
+			std::filesystem::rename(tempPath, path, fsError);
+		if (!status || fsError) {
+			std::filesystem::remove(tempPath, fsError);
+			Logger::Get().Log("Failed to write " + path, true);
+		}
+	}
+	bool SequenceExporter::IsFrameWritten(int frameIndex)
+	{
+		if (m_format != Format::Image)
+			return false;
+
+		std::error_code fsError;
+		return std::filesystem::exists(m_getPath(frameIndex), fsError);
+	}
+	std::string SequenceExporter::m_getPath(int frameIndex)
+	{
+		char path[SHADERED_MAX_PATH];
+		snprintf(path, SHADERED_MAX_PATH, m_filename.c_str(), frameIndex);
+		return path;
+	}
+	void SequenceExporter::m_convertToYUV(const unsigned char* rgba, std::vector<unsigned char>& out)
+	{
+		int w = m_outWidth, h = m_outHeight;
+		bool is420 = w % 2 == 0 && h % 2 == 0;
+		int cw = is420 ? w / 2 : w, ch = is420 ? h / 2 : h;
+
+		out.resize(w * h + cw * ch * 2);
+		unsigned char* yPlane = out.data();
+		unsigned char* uPlane = yPlane + w * h;
+		unsigned char* vPlane = uPlane + cw * ch;
+
+		// BT.601, limited range
+		for (int i = 0; i < w * h; i++) {
+			int r = rgba[i * 4 + 0], g = rgba[i * 4 + 1], b = rgba[i * 4 + 2];
+			yPlane[i] = ((66 * r + 129 * g + 25 * b + 128) >> 8) + 16;
+		}
+
+		for (int y = 0; y < ch; y++) {
+			for (int x = 0; x < cw; x++) {
+				int r = 0, g = 0, b = 0;
+				if (is420) {
+					// average the 2x2 block
+					for (int j = 0; j < 2; j++) {
+						const unsigned char* px = rgba + ((y * 2 + j) * w + x * 2) * 4;
+						r += px[0] + px[4];
+						g += px[1] + px[5];
+						b += px[2] + px[6];
+					}
+					r = (r + 2) / 4;
+					g = (g + 2) / 4;
+					b = (b + 2) / 4;
+				} else {
+					const unsigned char* px = rgba + (y * w + x) * 4;
+					r = px[0];
+					g = px[1];
+					b = px[2];
+				}
+
+				uPlane[y * cw + x] = ((-38 * r - 74 * g + 112 * b + 128) >> 8) + 128;
+				vPlane[y * cw + x] = ((112 * r - 94 * g - 18 * b + 128) >> 8) + 128;
+			}
+		}
+	}
+}
\ No newline at end of file
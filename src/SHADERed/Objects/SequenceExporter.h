@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#include <windows.h>
+#endif
+#include <GL/glew.h>
+#if defined(__APPLE__)
+#include <OpenGL/gl.h>
+#else
+#include <GL/gl.h>
+#endif
+
+namespace ed {
+	// saves rendered frames as an image sequence or as a single raw RGBA / YUV4MPEG2 stream
+	// frames are read back through a ring of pixel pack buffers (frame N is copied while frame N+1 renders) and encoded on worker threads
+	class SequenceExporter {
+	public:
+		enum class Format {
+			Image, // one file per frame, type is picked by the extension
+			Raw,   // RGBA8 frames, one after another
+			Y4M	   // YUV4MPEG2, 4:2:0 (4:4:4 if the size is odd)
+		};
+
+		SequenceExporter();
+		~SequenceExporter();
+
+		// image sequences: filename must contain a single %d
+		// streams: filename "-" writes to stdout, frames are written in the order in which they were captured
+		// frames are resized if the output size doesn't match the render size
+		bool Begin(const std::string& filename, Format format, const std::string& ext, int width, int height, int outWidth, int outHeight, int fps, int ringSize = 3);
+		void Capture(GLuint texture, int frameIndex); // call right after the frame was rendered to the texture
+		void End();									 // blocks until all of the frames are written
+
+		inline int GetWrittenCount() { return m_written; }
+
+		// image sequences only - frames are written to a temporary file first, so an existing file is always complete
+		bool IsFrameWritten(int frameIndex);
+
+	private:
+		struct Readback {
+			GLuint PBO;
+			GLsync Fence; // nullptr -> slot is free
+			int Frame;
+		};
+		struct Frame {
+			int Index;
+			int Sequence; // order in which the frames were captured
+			std::vector<unsigned char> Pixels;
+		};
+
+		void m_retire(Readback& rb);
+		void m_worker();
+		void m_write(Frame* frame, std::vector<unsigned char>& resized, std::vector<unsigned char>& converted);
+		void m_convertToYUV(const unsigned char* rgba, std::vector<unsigned char>& out);
+		std::string m_getPath(int frameIndex);
+
+		std::string m_filename, m_ext;
+		Format m_format;
+		int m_width, m_height, m_outWidth, m_outHeight;
+		bool m_started;
+
+		// stream output
+		FILE* m_stream;
+		int m_nextSequence, m_nextWrite;
+		std::condition_variable m_writeCond;
+
+		std::vector<Readback> m_ring;
+		int m_ringPos;
+
+		// frames are taken from a fixed pool so the amount of memory waiting for the encoders is bounded
+		std::vector<Frame*> m_pool;
+		std::vector<Frame*> m_freeFrames;
+		std::deque<Frame*> m_queue;
+		std::mutex m_mutex;
+		std::condition_variable m_queueCond, m_freeCond;
+		bool m_stop;
+
+		std::vector<std::thread> m_workers;
+		std::atomic<int> m_written;
+	};
+}
\ No newline at end of file
@@ -16,6 +16,7 @@ namespace ed {
 		General.AutoOpenErrorWindow = true;
 		General.Toolbar = false;
 		General.Profiler = false;
+		General.ProfilerDraws = false;
 		General.Recovery = false;
 		General.CheckUpdates = true;
 		General.CheckPluginUpdates = true;
@@ -67,6 +68,9 @@ namespace ed {
 		Debug.AutoFetch = true;
 		Debug.PrimitiveOutline = true;
 		Debug.PixelOutline = true;
+		Debug.ParallelAnalysis = true;
+		Debug.VerifyParallelAnalysis = false;
+		Debug.CompiledAnalysis = false;
 
 		Preview.PausedOnStartup = false;
 		Preview.SwitchLeftRightClick = false;
@@ -102,12 +106,20 @@ namespace ed {
 		General.AutoOpenErrorWindow = ini.GetBoolean("general", "autoerror", true);
 		General.Toolbar = ini.GetBoolean("general", "toolbar", false);
 		General.Profiler = ini.GetBoolean("general", "profiler", false);
+		General.ProfilerDraws = ini.GetBoolean("general", "profilerdraws", false);
 		General.Recovery = ini.GetBoolean("general", "recovery", false);
 		General.CheckUpdates = ini.GetBoolean("general", "checkupdates", true);
 		General.CheckPluginUpdates = ini.GetBoolean("general", "checkpluginupdates", true);
 		General.Log = ini.GetBoolean("general", "log", false);
 		General.StreamLogs = ini.GetBoolean("general", "streamlogs", false);
 		General.PipeLogsToTerminal = ini.GetBoolean("general", "pipelogsterminal", false);
+		General.ShaderCache = ini.GetBoolean("general", "shadercache", true);
+		General.ProgramCache = ini.GetBoolean("general", "programcache", true);
+		General.ShaderCacheSize = ini.GetInteger("general", "shadercachesize", 256);
+		General.MeshCache = ini.GetBoolean("general", "meshcache", true);
+		General.MeshCacheSize = ini.GetInteger("general", "meshcachesize", 1024);
+		General.OptimizeModels = ini.GetBoolean("general", "optimizemodels", false);
+		General.OptimizeModelOverdraw = ini.GetBoolean("general", "optimizemodeloverdraw", false);
 		General.ReopenShaders = ini.GetBoolean("general", "reopenshaders", false);
 		General.UseExternalEditor = ini.GetBoolean("general", "useexternaleditor", false);
 		General.OpenShadersOnDblClk = ini.GetBoolean("general", "openshadersdblclk", true);
@@ -154,6 +166,9 @@ namespace ed {
 		Debug.AutoFetch = ini.GetBoolean("debug", "autofetch", true);
 		Debug.PixelOutline = ini.GetBoolean("debug", "pixeloutline", true);
 		Debug.PrimitiveOutline = ini.GetBoolean("debug", "primitiveoutline", true);
+		Debug.ParallelAnalysis = ini.GetBoolean("debug", "parallelanalysis", true);
+		Debug.VerifyParallelAnalysis = ini.GetBoolean("debug", "verifyparallelanalysis", false);
+		Debug.CompiledAnalysis = ini.GetBoolean("debug", "compiledanalysis", false);
 
 		Preview.PausedOnStartup = ini.GetBoolean("preview", "pausedonstartup", false);
 		Preview.SwitchLeftRightClick = ini.GetBoolean("preview", "switchleftrightclick", false);
@@ -194,12 +209,20 @@ namespace ed {
 		ini << "autoerror=" << General.AutoOpenErrorWindow << std::endl;
 		ini << "toolbar=" << General.Toolbar << std::endl;
 		ini << "profiler=" << General.Profiler << std::endl;
+		ini << "profilerdraws=" << General.ProfilerDraws << std::endl;
 		ini << "recovery=" << General.Recovery << std::endl;
 		ini << "checkupdates=" << General.CheckUpdates << std::endl;
 		ini << "checkpluginupdates=" << General.CheckPluginUpdates << std::endl;
 		ini << "log=" << General.Log << std::endl;
 		ini << "streamlogs=" << General.StreamLogs << std::endl;
 		ini << "pipelogsterminal=" << General.PipeLogsToTerminal << std::endl;
+		ini << "shadercache=" << General.ShaderCache << std::endl;
+		ini << "programcache=" << General.ProgramCache << std::endl;
+		ini << "shadercachesize=" << General.ShaderCacheSize << std::endl;
+		ini << "meshcache=" << General.MeshCache << std::endl;
+		ini << "meshcachesize=" << General.MeshCacheSize << std::endl;
+		ini << "optimizemodels=" << General.OptimizeModels << std::endl;
+		ini << "optimizemodeloverdraw=" << General.OptimizeModelOverdraw << std::endl;
 		ini << "reopenshaders=" << General.ReopenShaders << std::endl;
 		ini << "useexternaleditor=" << General.UseExternalEditor << std::endl;
 		ini << "openshadersdblclk=" << General.OpenShadersOnDblClk << std::endl;
@@ -290,6 +313,9 @@ namespace ed {
 		ini << "autofetch=" << Debug.AutoFetch << std::endl;
 		ini << "pixeloutline=" << Debug.PixelOutline << std::endl;
 		ini << "primitiveoutline=" << Debug.PrimitiveOutline << std::endl;
+		ini << "parallelanalysis=" << Debug.ParallelAnalysis << std::endl;
+		ini << "verifyparallelanalysis=" << Debug.VerifyParallelAnalysis << std::endl;
+		ini << "compiledanalysis=" << Debug.CompiledAnalysis << std::endl;
 
 		ini << "[plugins]" << std::endl;
 		ini << "notloaded=";
@@ -26,6 +26,7 @@ namespace ed {
 			bool Toolbar;
 			bool Recovery; // [TODO] Not implemented
 			bool Profiler;
+			bool ProfilerDraws; // per draw call timers
 			bool CheckUpdates;
 			bool CheckPluginUpdates;
 			bool RecompileOnFileChange;
@@ -42,6 +43,13 @@ namespace ed {
 			bool Log;
 			bool StreamLogs;
 			bool PipeLogsToTerminal;
+			bool ShaderCache; // SPIR-V & cross-compiled GLSL
+			bool ProgramCache; // linked GL program binaries - same storage as the shader cache, but independent of ShaderCache
+			int ShaderCacheSize; // in MB
+			bool MeshCache;
+			int MeshCacheSize; // in MB
+			bool OptimizeModels;
+			bool OptimizeModelOverdraw;
 			std::string StartUpTemplate;
 			char Font[SHADERED_MAX_PATH];
 			int FontSize;
@@ -80,6 +88,9 @@ namespace ed {
 			bool AutoFetch;
 			bool PrimitiveOutline;
 			bool PixelOutline;
+			bool ParallelAnalysis; // run the frame analysis on multiple threads
+			bool VerifyParallelAnalysis; // run it again on one thread and log the differences - manual check for the current scene only
+			bool CompiledAnalysis; // build the pixel shader with the system's C++ compiler instead of running it in the VM - faster, but not identical, so it's off by default
 		} Debug;
 
 		struct strPreview {
@@ -0,0 +1,128 @@
+#include <SHADERed/Objects/ShaderCache.h>
+#include <SHADERed/Objects/Logger.h>
+
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#define SHADERCACHE_MAGIC 0x48435345 // "ESCH"
+
+namespace ed {
+	ShaderCache::ShaderCache()
+	{
+		m_enabled = false;
+		m_hits = 0;
+		m_misses = 0;
+	}
+	void ShaderCache::Initialize(const std::string& dir, size_t maxSize)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+
+		if (!m_files.Open(dir, ".bin", maxSize, "Shader cache")) {
+			Logger::Get().Log("Failed to create the shader cache directory " + dir, true);
+			m_enabled = false;
+			return;
+		}
+
+		m_enabled = true;
+
+		Logger::Get().Log("Shader cache has " + std::to_string(m_files.GetEntryCount()) + " entries (" + std::to_string(m_files.GetSize() / 1024) + "KB)");
+	}
+	bool ShaderCache::Load(uint64_t key, std::string& data)
+	{
+		std::string path;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_files.Contains(key)) {
+				m_misses++;
+				return false;
+			}
+			path = m_files.GetPath(key);
+		}
+
+		bool loaded = false;
+		std::ifstream file(path, std::ios::binary);
+		if (file.is_open()) {
+			uint32_t magic = 0;
+			uint64_t fileKey = 0, size = 0;
+			file.read((char*)&magic, sizeof(magic));
+			file.read((char*)&fileKey, sizeof(fileKey));
+			file.read((char*)&size, sizeof(size));
+
+			if (file && magic == SHADERCACHE_MAGIC && fileKey == key) {
+				data.resize(size);
+				file.read(&data[0], size);
+				loaded = (uint64_t)file.gcount() == size;
+			}
+			file.close();
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (!loaded) {
+			// corrupted or deleted
+			m_files.Remove(key);
+			m_misses++;
+			return false;
+		}
+
+		m_files.Touch(key);
+		m_hits++;
+
+		return true;
+	}
+	void ShaderCache::Store(uint64_t key, const std::string& data)
+	{
+		std::string path;
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			if (!m_files.IsOpen())
+				return;
+			path = m_files.GetPath(key);
+		}
+
+		// write to a temporary file first - other threads or SHADERed instances might be reading this entry
+		std::stringstream tempPath;
+		tempPath << path << "." << std::this_thread::get_id() << ".tmp";
+
+		std::ofstream file(tempPath.str(), std::ios::binary | std::ios::trunc);
+		if (!file.is_open())
+			return;
+
+		uint32_t magic = SHADERCACHE_MAGIC;
+		uint64_t size = data.size();
+		file.write((char*)&magic, sizeof(magic));
+		file.write((char*)&key, sizeof(key));
+		file.write((char*)&size, sizeof(size));
+		file.write(data.data(), data.size());
+		bool written = (bool)file;
+		file.close();
+
+		std::error_code fsError;
+		if (written)
+			std::filesystem::rename(tempPath.str(), path, fsError);
+		if (!written || fsError) {
+			std::filesystem::remove(tempPath.str(), fsError);
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_files.Add(key, data.size() + sizeof(magic) + sizeof(key) + sizeof(size));
+	}
+	void ShaderCache::Clear()
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_files.Clear();
+
+		Logger::Get().Log("Cleared the shader cache");
+	}
+	uint64_t ShaderCache::Hash(const void* data, size_t len, uint64_t seed)
+	{
+		const unsigned char* bytes = (const unsigned char*)data;
+		uint64_t ret = seed;
+		for (size_t i = 0; i < len; i++) {
+			ret ^= bytes[i];
+			ret *= 1099511628211ULL;
+		}
+		return ret;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,45 @@
+#pragma once
+#include <SHADERed/Objects/CacheDirectory.h>
+
+#include <mutex>
+#include <string>
+
+namespace ed {
+	// persistent key -> blob storage for compiler output (SPIR-V, GLSL, ...)
+	// keys are hashes of everything that affects the output, least recently used entries are removed once the cache grows over the size limit
+	class ShaderCache {
+	public:
+		ShaderCache();
+
+		void Initialize(const std::string& dir, size_t maxSize);
+		inline bool IsEnabled() { return m_enabled; } // SPIR-V & GLSL caching
+		inline bool IsAvailable() { return m_files.IsOpen(); } // Load() & Store() work - GL program binaries only need this
+		inline void SetEnabled(bool enabled) { m_enabled = enabled && m_files.IsOpen(); }
+		inline void SetMaxSize(size_t maxSize) { m_files.SetMaxSize(maxSize); }
+
+		bool Load(uint64_t key, std::string& data);
+		void Store(uint64_t key, const std::string& data);
+		void Clear();
+
+		inline int GetEntryCount() { return m_files.GetEntryCount(); }
+		inline size_t GetSize() { return m_files.GetSize(); }
+		inline int GetHitCount() { return m_hits; }
+		inline int GetMissCount() { return m_misses; }
+
+		// FNV-1a - pass the previous hash as the seed to hash multiple blocks of data
+		static uint64_t Hash(const void* data, size_t len, uint64_t seed = 14695981039346656037ULL);
+		static inline uint64_t Hash(const std::string& str, uint64_t seed = 14695981039346656037ULL) { return Hash(str.data(), str.size(), seed); }
+
+		static inline ShaderCache& Instance()
+		{
+			static ShaderCache ret;
+			return ret;
+		}
+
+	private:
+		std::mutex m_mutex;
+		CacheDirectory m_files;
+		bool m_enabled;
+		int m_hits, m_misses;
+	};
+}
\ No newline at end of file
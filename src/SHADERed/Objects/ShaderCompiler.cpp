@@ -2,12 +2,14 @@
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <string.h>
 #include <vector>
 
 #include <SHADERed/Engine/GLUtils.h>
 #include <SHADERed/Objects/ShaderFileIncluder.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/ShaderCache.h>
 #include <SHADERed/Objects/ShaderCompiler.h>
 #include <SHADERed/Objects/BinaryVectorReader.h>
 
@@ -135,19 +137,39 @@ const TBuiltInResource DefaultTBuiltInResource = {
 };
 
 namespace ed {
+	// part of the cache keys - SPIR-V built by an older glslang must not be reused after an update
+	static const std::string& getCompilerVersion()
+	{
+		static const std::string ret = std::string(glslang::GetGlslVersionString()) + " " + glslang::GetEsslVersionString() + " " + std::to_string(glslang::GetKhronosToolId());
+		return ret;
+	}
+
 	std::string ShaderCompiler::ConvertToGLSL(const std::vector<unsigned int>& spvIn, ShaderLanguage inLang, ShaderStage sType, bool tsUsed, bool gsUsed, MessageStack* msgs, bool convertNames)
 	{
 		if (spvIn.empty())
 			return "";
 
+		int ver = 330;
+		if (GLEW_ARB_shader_storage_buffer_object)
+			ver = 430;
+
+		// output only depends on the SPIR-V and on the options
+		ShaderCache& cache = ShaderCache::Instance();
+		uint64_t cacheKey = 0;
+		if (cache.IsEnabled()) {
+			std::string cacheInfo = "glsl " + std::to_string(SHADERED_VERSION) + " " + getCompilerVersion() + " " + std::to_string((int)inLang) + " " + std::to_string((int)sType) + " " + std::to_string(tsUsed) + std::to_string(gsUsed) + std::to_string(convertNames) + " " + std::to_string(ver);
+			cacheKey = ShaderCache::Hash(spvIn.data(), spvIn.size() * sizeof(unsigned int), ShaderCache::Hash(cacheInfo));
+
+			std::string cached;
+			if (cache.Load(cacheKey, cached))
+				return cached;
+		}
+
 		// Read SPIR-V
 		spirv_cross::CompilerGLSL glsl(std::move(spvIn));
 
 		// Set options
 		spirv_cross::CompilerGLSL::Options options;
-		int ver = 330;
-		if (GLEW_ARB_shader_storage_buffer_object)
-			ver = 430;
 		options.version = (sType == ShaderStage::Compute) ? 430 : ver;
 		glsl.set_common_options(options);
 
@@ -349,6 +371,9 @@ namespace ed {
 			}
 		}
 
+		if (cache.IsEnabled())
+			cache.Store(cacheKey, source);
+
 		return source;
 	}
 	std::string ShaderCompiler::ConvertToHLSL(const std::vector<unsigned int>& spvIn, ShaderStage sType)
@@ -505,6 +530,30 @@ namespace ed {
 			return false;
 		}
 
+		// preprocessed source already contains the #include'd files - skip the rest if this exact shader was compiled before
+		ShaderCache& cache = ShaderCache::Instance();
+		uint64_t cacheKey = 0;
+		if (cache.IsEnabled()) {
+			std::string cacheInfo = "spv2 " + std::to_string(SHADERED_VERSION) + " " + getCompilerVersion() + " " + std::to_string((int)inLang) + " " + std::to_string((int)sType) + " " + entry + " " + preambleStr;
+			cacheKey = ShaderCache::Hash(processedShader, ShaderCache::Hash(cacheInfo));
+
+			// entry = info log size, glslang's info log (warnings) & the SPIR-V
+			std::string cached;
+			uint32_t logSize = 0;
+			if (cache.Load(cacheKey, cached) && cached.size() >= sizeof(logSize)) {
+				memcpy(&logSize, cached.data(), sizeof(logSize));
+				if (cached.size() >= sizeof(logSize) + logSize) {
+					if (msgs != nullptr && logSize > 0)
+						msgs->Add(gl::ParseGlslangMessages(msgs->CurrentItem, sType, cached.substr(sizeof(logSize), logSize)));
+
+					size_t spvStart = sizeof(logSize) + logSize;
+					spvOut.resize((cached.size() - spvStart) / sizeof(unsigned int));
+					memcpy(spvOut.data(), cached.data() + spvStart, spvOut.size() * sizeof(unsigned int));
+					return true;
+				}
+			}
+		}
+
 		// update strings
 		const char* processedStr = processedShader.c_str();
 		shader.setStrings(&processedStr, 1);
@@ -549,6 +598,19 @@ namespace ed {
 		spvOptions.validate = true;
 
 		glslang::GlslangToSpv(*prog.getIntermediate(shaderType), spvOut, &logger, &spvOptions);
+
+		// warnings - also replayed when the SPIR-V comes from the cache
+		std::string infoLog = std::string(shader.getInfoLog()) + prog.getInfoLog();
+		if (msgs != nullptr)
+			msgs->Add(gl::ParseGlslangMessages(msgs->CurrentItem, sType, infoLog));
+
+		if (cache.IsEnabled()) {
+			uint32_t logSize = infoLog.size();
+			std::string entry((const char*)&logSize, sizeof(logSize));
+			entry += infoLog;
+			entry.append((const char*)spvOut.data(), spvOut.size() * sizeof(unsigned int));
+			cache.Store(cacheKey, entry);
+		}
 	
 		return true;
 	}
@@ -5,7 +5,15 @@
 #include <regex>
 
 namespace ed {
-	ShaderVariableContainer::ShaderVariableContainer() { }
+	int ShaderVariableContainer::m_uniformCalls = 0;
+	int ShaderVariableContainer::m_lastUniformCalls = 0;
+
+	ShaderVariableContainer::ShaderVariableContainer()
+	{
+		m_current = nullptr;
+		m_passActive = false;
+		m_passIndex = 0;
+	}
 	ShaderVariableContainer::~ShaderVariableContainer()
 	{
 		for (int i = 0; i < m_vars.size(); i++) {
@@ -47,7 +55,10 @@ namespace ed {
 		GLsizei length;				// name length
 		GLuint samplerLoc = 0;
 
-		m_uLocs.clear();
+		// program might be new (or a new program got an ID of some deleted one) - resolve the slots again
+		m_current = &m_programs[pass];
+		m_current->Locations.clear();
+		m_current->Slots.clear();
 
 		glGetProgramiv(pass, GL_ACTIVE_UNIFORMS, &count);
 		for (GLuint i = 0; i < count; i++) {
@@ -59,9 +70,41 @@ namespace ed {
 			if (type == GL_SAMPLER_2D)
 				glUniform1i(glGetUniformLocation(pass, name), samplerLoc++);
 			else
-				m_uLocs[name] = glGetUniformLocation(pass, name);
+				m_current->Locations[name] = glGetUniformLocation(pass, name);
 		}
 	}
+	void ShaderVariableContainer::RemoveProgram(GLuint pass)
+	{
+		auto it = m_programs.find(pass);
+		if (it == m_programs.end())
+			return;
+
+		if (m_current == &it->second)
+			m_current = nullptr;
+		m_programs.erase(it);
+	}
+	void ShaderVariableContainer::BeginPass()
+	{
+		m_passActive = true;
+		m_passIndex++;
+	}
+	void ShaderVariableContainer::m_resolveSlot(UniformSlot& slot, ShaderVariable* var)
+	{
+		slot.Variable = var;
+		slot.Name = var->Name;
+		slot.Type = var->GetType();
+		slot.Uploaded = false;
+		slot.UpdatedData = nullptr;
+		slot.UpdatedPass = -1;
+
+		auto loc = m_current->Locations.find(slot.Name);
+		slot.Location = (loc == m_current->Locations.end()) ? -1 : loc->second;
+	}
+	bool ShaderVariableContainer::m_isFrameConstant(ShaderVariable* var)
+	{
+		// these depend on the item that is being rendered
+		return var->System != SystemShaderVariable::None && var->System != SystemShaderVariable::GeometryTransform && var->System != SystemShaderVariable::IsPicked && var->System != SystemShaderVariable::PluginVariable;
+	}
 	void ShaderVariableContainer::UpdateTextureList(const std::string& fragShader)
 	{
 		m_samplers.clear();
@@ -91,75 +134,101 @@ namespace ed {
 	}
 	void ShaderVariableContainer::Bind(void* item)
 	{
+		if (m_current == nullptr)
+			return;
+
+		std::vector<UniformSlot>& slots = m_current->Slots;
+		if (slots.size() != m_vars.size())
+			slots.resize(m_vars.size(), { nullptr, "", ShaderVariable::ValueType::Count, -1, false, { 0 }, nullptr, -1 });
+
 		for (int i = 0; i < m_vars.size(); i++) {
-			FunctionVariableManager::Instance().AddToList(m_vars[i]);
+			ShaderVariable* var = m_vars[i];
+			UniformSlot& slot = slots[i];
+
+			FunctionVariableManager::Instance().AddToList(var);
+
+			// variable list can be reordered, variables can be renamed and their type changed directly through the UI
+			if (slot.Variable != var || slot.Type != var->GetType() || slot.Name != var->Name)
+				m_resolveSlot(slot, var);
 
-			if (m_uLocs.count(m_vars[i]->Name) == 0)
+			if (slot.Location == -1)
 				continue;
 
-			GLint loc = m_uLocs[m_vars[i]->Name];
-
-			// update values if needed
-			SystemVariableManager::Instance().Update(m_vars[i], item);
-			FunctionVariableManager::Instance().Update(m_vars[i]);
-
-			// update uniform every time we bind this container
-			// TODO: maybe we shouldn't update variables that havent changed
-			ShaderVariable::ValueType type = m_vars[i]->GetType();
-
-			// check the flags
-			if (m_vars[i]->Flags & (char)ShaderVariable::Flag::Inverse) {
-				if (type == ShaderVariable::ValueType::Float4x4) {
-					glm::mat4x4 matVal = glm::make_mat4x4(m_vars[i]->AsFloatPtr());
-					memcpy(m_vars[i]->Data, glm::value_ptr(glm::inverse(matVal)), sizeof(glm::mat4x4));
-				} else if (type == ShaderVariable::ValueType::Float3x3) {
-					glm::mat3x3 matVal = glm::make_mat3x3(m_vars[i]->AsFloatPtr());
-					memcpy(m_vars[i]->Data, glm::value_ptr(glm::inverse(matVal)), sizeof(glm::mat3x3));
-				} else if (type == ShaderVariable::ValueType::Float2x2) {
-					glm::mat2x2 matVal = glm::make_mat2x2(m_vars[i]->AsFloatPtr());
-					memcpy(m_vars[i]->Data, glm::value_ptr(glm::inverse(matVal)), sizeof(glm::mat2x2));
+			GLint loc = slot.Location;
+			ShaderVariable::ValueType type = slot.Type;
+
+			// update values if needed - frame-constant values only once per pass
+			if (!m_passActive || slot.UpdatedPass != m_passIndex || slot.UpdatedData != var->Data) {
+				SystemVariableManager::Instance().Update(var, item);
+				FunctionVariableManager::Instance().Update(var);
+
+				// check the flags
+				if (var->Flags & (char)ShaderVariable::Flag::Inverse) {
+					if (type == ShaderVariable::ValueType::Float4x4) {
+						glm::mat4x4 matVal = glm::make_mat4x4(var->AsFloatPtr());
+						memcpy(var->Data, glm::value_ptr(glm::inverse(matVal)), sizeof(glm::mat4x4));
+					} else if (type == ShaderVariable::ValueType::Float3x3) {
+						glm::mat3x3 matVal = glm::make_mat3x3(var->AsFloatPtr());
+						memcpy(var->Data, glm::value_ptr(glm::inverse(matVal)), sizeof(glm::mat3x3));
+					} else if (type == ShaderVariable::ValueType::Float2x2) {
+						glm::mat2x2 matVal = glm::make_mat2x2(var->AsFloatPtr());
+						memcpy(var->Data, glm::value_ptr(glm::inverse(matVal)), sizeof(glm::mat2x2));
+					}
+				}
+
+				if (m_passActive && m_isFrameConstant(var)) {
+					slot.UpdatedPass = m_passIndex;
+					slot.UpdatedData = var->Data;
 				}
 			}
 
+			// skip the upload if the program already has this value
+			int size = ShaderVariable::GetSize(type);
+			if (slot.Uploaded && memcmp(slot.LastValue, var->Data, size) == 0)
+				continue;
+			memcpy(slot.LastValue, var->Data, size);
+			slot.Uploaded = true;
+			m_uniformCalls++;
+
 			switch (type) {
 			case ShaderVariable::ValueType::Boolean1:
-				glUniform1i(loc, m_vars[i]->AsBoolean());
+				glUniform1i(loc, var->AsBoolean());
 				break;
 			case ShaderVariable::ValueType::Integer1:
-				glUniform1i(loc, m_vars[i]->AsInteger());
+				glUniform1i(loc, var->AsInteger());
 				break;
 			case ShaderVariable::ValueType::Boolean2:
 			case ShaderVariable::ValueType::Integer2:
-				glUniform2iv(loc, 1, m_vars[i]->AsIntegerPtr());
+				glUniform2iv(loc, 1, var->AsIntegerPtr());
 				break;
 			case ShaderVariable::ValueType::Boolean3:
 			case ShaderVariable::ValueType::Integer3:
-				glUniform3iv(loc, 1, m_vars[i]->AsIntegerPtr());
+				glUniform3iv(loc, 1, var->AsIntegerPtr());
 				break;
 			case ShaderVariable::ValueType::Boolean4:
 			case ShaderVariable::ValueType::Integer4:
-				glUniform4iv(loc, 1, m_vars[i]->AsIntegerPtr());
+				glUniform4iv(loc, 1, var->AsIntegerPtr());
 				break;
 			case ShaderVariable::ValueType::Float1:
-				glUniform1f(loc, m_vars[i]->AsFloat());
+				glUniform1f(loc, var->AsFloat());
 				break;
 			case ShaderVariable::ValueType::Float2:
-				glUniform2fv(loc, 1, m_vars[i]->AsFloatPtr());
+				glUniform2fv(loc, 1, var->AsFloatPtr());
 				break;
 			case ShaderVariable::ValueType::Float3:
-				glUniform3fv(loc, 1, m_vars[i]->AsFloatPtr());
+				glUniform3fv(loc, 1, var->AsFloatPtr());
 				break;
 			case ShaderVariable::ValueType::Float4:
-				glUniform4fv(loc, 1, m_vars[i]->AsFloatPtr());
+				glUniform4fv(loc, 1, var->AsFloatPtr());
 				break;
 			case ShaderVariable::ValueType::Float2x2:
-				glUniformMatrix2fv(loc, 1, GL_FALSE, m_vars[i]->AsFloatPtr());
+				glUniformMatrix2fv(loc, 1, GL_FALSE, var->AsFloatPtr());
 				break;
 			case ShaderVariable::ValueType::Float3x3:
-				glUniformMatrix3fv(loc, 1, GL_FALSE, m_vars[i]->AsFloatPtr());
+				glUniformMatrix3fv(loc, 1, GL_FALSE, var->AsFloatPtr());
 				break;
 			case ShaderVariable::ValueType::Float4x4:
-				glUniformMatrix4fv(loc, 1, GL_FALSE, m_vars[i]->AsFloatPtr());
+				glUniformMatrix4fv(loc, 1, GL_FALSE, var->AsFloatPtr());
 				break;
 			}
 		}
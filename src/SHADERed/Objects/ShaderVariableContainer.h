@@ -1,6 +1,7 @@
 #pragma once
 #include <SHADERed/Objects/ShaderVariable.h>
-#include <map>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #ifdef _WIN32
@@ -25,15 +26,55 @@ namespace ed {
 
 		bool ContainsVariable(const char* name);
 		void UpdateUniformInfo(GLuint pass);
+		void RemoveProgram(GLuint pass); // program was deleted - forget its locations & slots
 		void UpdateTexture(GLuint pass, GLuint unit);
 		void UpdateTextureList(const std::string& fragShader);
 		void Bind(void* item = nullptr);
 		inline std::vector<ShaderVariable*>& GetVariables() { return m_vars; }
 		inline const std::vector<std::string>& GetSamplerList() { return m_samplers; }
 
+		// frame-constant system variables (time, camera, viewport, ...) are only updated on the first Bind() between these two calls
+		void BeginPass();
+		inline void EndPass() { m_passActive = false; }
+
+		// number of glUniform* calls made by all containers in the previous frame
+		static inline int GetUniformCallCount() { return m_lastUniformCalls; }
+		static inline void ResetUniformCallCount()
+		{
+			m_lastUniformCalls = m_uniformCalls;
+			m_uniformCalls = 0;
+		}
+
 	private:
 		std::vector<ShaderVariable*> m_vars;
-		std::map<std::string, GLint> m_uLocs;
 		std::vector<std::string> m_samplers;
+
+		// a variable resolved to a uniform location in some program
+		struct UniformSlot {
+			ShaderVariable* Variable;
+			std::string Name; // detect renamed variables
+			ShaderVariable::ValueType Type;
+			GLint Location;
+
+			bool Uploaded;
+			char LastValue[64]; // value that the program currently has - don't call glUniform* if it didn't change
+
+			char* UpdatedData; // frame-constant value was already written to this buffer in pass UpdatedPass
+			int UpdatedPass;
+		};
+		struct ProgramInfo {
+			std::unordered_map<std::string, GLint> Locations;
+			std::vector<UniformSlot> Slots; // same order as m_vars
+		};
+		std::unordered_map<GLuint, ProgramInfo> m_programs;
+		ProgramInfo* m_current;
+
+		void m_resolveSlot(UniformSlot& slot, ShaderVariable* var);
+		bool m_isFrameConstant(ShaderVariable* var);
+
+		bool m_passActive;
+		int m_passIndex;
+
+		static int m_uniformCalls, m_lastUniformCalls;
 	};
 }
\ No newline at end of file
@@ -31,6 +31,7 @@ namespace ed {
 	{
 		SetOwner(nullptr);
 		m_item.Data = nullptr;
+		m_groupsModel = nullptr;
 		m_selectedGroup = 0;
 		m_errorOccured = false;
 		memset(m_owner, 0, PIPELINE_ITEM_NAME_LENGTH * sizeof(char));
@@ -658,6 +659,18 @@ namespace ed {
 			}
 			ImGui::NextColumn();
 
+			if (m_groupsModel != nullptr) {
+				if (m_groupsModel->IsLoading()) {
+					ImGui::Text("Loading:");
+					ImGui::NextColumn();
+					ImGui::ProgressBar(m_groupsModel->GetLoadProgress(), ImVec2(-1, 0));
+					ImGui::NextColumn();
+				} else {
+					m_groups = m_groupsModel->GetMeshNames();
+					m_groupsModel = nullptr;
+				}
+			}
+
 			if (m_groups.size() > 0) {
 				// should we render only a part of the mesh?
 				ImGui::Text("Render group only:");
@@ -715,9 +728,9 @@ namespace ed {
 
 				strcpy(m_dialogPath, file.c_str());
 
-				eng::Model* mdl = m_data->Parser.LoadModel(m_dialogPath);
-				if (mdl != nullptr)
-					m_groups = mdl->GetMeshNames();
+				m_selectedGroup = 0;
+				m_groups.clear();
+				m_groupsModel = m_data->Parser.LoadModel(m_dialogPath);
 			}
 			ifd::FileDialog::Instance().Close();
 		}
@@ -787,6 +800,7 @@ namespace ed {
 
 			m_selectedGroup = 0;
 			m_groups.clear();
+			m_groupsModel = nullptr;
 
 			pipe::Model* allocatedData = new pipe::Model();
 			allocatedData->OnlyGroup = false;
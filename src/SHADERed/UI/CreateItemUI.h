@@ -25,6 +25,7 @@ namespace ed {
 		void m_updateItemFilenames();
 
 		std::vector<std::string> m_groups;
+		eng::Model* m_groupsModel; // mesh names are read once it's loaded
 		int m_selectedGroup;
 
 		bool m_errorOccured;
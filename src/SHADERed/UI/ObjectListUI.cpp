@@ -245,8 +245,8 @@ namespace ed {
 									pipe::Model* mitem = (pipe::Model*)pitem->Data;
 
 									if (mitem->InstanceBuffer == (void*)oItem->Buffer) {
-										for (auto& mesh : mitem->Data->Meshes)
-											gl::CreateVAO(mesh.VAO, mesh.VBO, pdata->InputLayout, mesh.EBO);
+										if (mitem->Data->IsLoaded())
+											gl::CreateVAO(mitem->Data, pdata->InputLayout);
 										mitem->InstanceBuffer = nullptr;
 									}
 								} else if (pitem->Type == ed::PipelineItem::ItemType::VertexBuffer) {
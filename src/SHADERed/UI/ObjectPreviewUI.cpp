@@ -235,9 +235,7 @@ namespace ed {
 							free(buf->Data);
 							buf->Data = newData;
 
-							glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-							glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // resize
-							glBindBuffer(GL_UNIFORM_BUFFER, 0);
+							m_data->Objects.UploadBuffer(buf);
 
 							m_data->Parser.ModifyProject();
 						}
@@ -248,9 +246,7 @@ namespace ed {
 						if (ImGui::Button("CLEAR##objprev_clearbuf")) {
 							memset(buf->Data, 0, buf->Size);
 
-							glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-							glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // upload data
-							glBindBuffer(GL_UNIFORM_BUFFER, 0);
+							m_data->Objects.UploadBuffer(buf);
 
 							m_data->Parser.ModifyProject();
 						}
@@ -298,9 +294,7 @@ namespace ed {
 						// update buffer data every 350ms
 						ImGui::Text(buf->PreviewPaused ? "Buffer view is paused" : "Buffer view is updated every 350ms");
 						if (!buf->PreviewPaused && m_bufUpdateClock.GetElapsedTime() > 0.350f && buf->Data != nullptr) {
-							glBindBuffer(GL_SHADER_STORAGE_BUFFER, buf->ID);
-							glGetBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, buf->Size, buf->Data);
-							glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+							m_data->Objects.SyncBuffer(buf);
 							m_bufUpdateClock.Restart();
 						}
 
@@ -345,9 +339,7 @@ namespace ed {
 
 									int dOffset = j * perRow + curColOffset;
 									if (m_drawBufferElement(j, k, (void*)(((char*)buf->Data) + dOffset), m_cachedBufFormat[i][k])) {
-										glBindBuffer(GL_UNIFORM_BUFFER, buf->ID);
-										glBufferData(GL_UNIFORM_BUFFER, buf->Size, buf->Data, GL_STATIC_DRAW); // allocate 0 bytes of memory
-										glBindBuffer(GL_UNIFORM_BUFFER, 0);
+										m_data->Objects.UploadBuffer(buf);
 
 										m_data->Parser.ModifyProject();
 									}
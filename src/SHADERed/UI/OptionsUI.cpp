@@ -1,7 +1,10 @@
 #include <SHADERed/AppEvent.h>
+#include <SHADERed/Engine/MeshCache.h>
+#include <SHADERed/Objects/Debug/CompiledShader.h>
 #include <SHADERed/Objects/KeyboardShortcuts.h>
 #include <SHADERed/Objects/Logger.h>
 #include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/ShaderCache.h>
 #include <SHADERed/Objects/ThemeContainer.h>
 #include <SHADERed/Options.h>
 #include <SHADERed/UI/CodeEditorUI.h>
@@ -281,6 +284,19 @@ namespace ed {
 		ImGui::SameLine();
 		ImGui::Checkbox("##optg_profiler", &settings->General.Profiler);
 
+		/* PROFILE DRAW CALLS: */
+		ImGui::Text("Profile draw calls: ");
+		ImGui::SameLine();
+		if (!settings->General.Profiler) {
+			ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
+			ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+		}
+		ImGui::Checkbox("##optg_profilerdraws", &settings->General.ProfilerDraws);
+		if (!settings->General.Profiler) {
+			ImGui::PopStyleVar();
+			ImGui::PopItemFlag();
+		}
+
 		/* AUTO ERROR SHOW: */
 		ImGui::Text("Show error list window when build finishes with an error: ");
 		ImGui::SameLine();
@@ -596,6 +612,99 @@ namespace ed {
 			ImGui::PopStyleVar();
 			ImGui::PopItemFlag();
 		}
+
+		/* SHADER CACHE STUFF */
+		ImGui::NewLine();
+		ImGui::Separator();
+		ImGui::NewLine();
+
+		/* SHADER CACHE: */
+		ImGui::Text("Cache compiled shaders: ");
+		ImGui::SameLine();
+		if (ImGui::Checkbox("##optg_shadercache", &settings->General.ShaderCache))
+			ShaderCache::Instance().SetEnabled(settings->General.ShaderCache);
+
+		/* PROGRAM CACHE: */
+		ImGui::Text("Cache linked programs: ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optg_programcache", &settings->General.ProgramCache);
+
+		// both caches share the storage
+		bool cacheUsed = settings->General.ShaderCache || settings->General.ProgramCache;
+		if (!cacheUsed) {
+			ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
+			ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+		}
+
+		/* SHADER CACHE SIZE: */
+		ImGui::Text("Shader cache size (MB): ");
+		ImGui::SameLine();
+		ImGui::PushItemWidth(settings->CalculateSize(100));
+		if (ImGui::InputInt("##optg_shadercachesize", &settings->General.ShaderCacheSize, 16, 128)) {
+			settings->General.ShaderCacheSize = std::max<int>(1, settings->General.ShaderCacheSize);
+			ShaderCache::Instance().SetMaxSize((size_t)settings->General.ShaderCacheSize * 1024 * 1024);
+			CompiledShaderCache::Instance().SetMaxSize((size_t)settings->General.ShaderCacheSize * 1024 * 1024);
+		}
+		ImGui::PopItemWidth();
+
+		ImGui::TextDisabled("%d entries, %d KB", ShaderCache::Instance().GetEntryCount(), (int)(ShaderCache::Instance().GetSize() / 1024));
+		ImGui::SameLine();
+		if (ImGui::Button("CLEAR##optg_shadercacheclear"))
+			ShaderCache::Instance().Clear();
+
+		if (!cacheUsed) {
+			ImGui::PopStyleVar();
+			ImGui::PopItemFlag();
+		}
+
+		/* MESH CACHE: */
+		ImGui::Text("Cache imported 3D models: ");
+		ImGui::SameLine();
+		if (ImGui::Checkbox("##optg_meshcache", &settings->General.MeshCache))
+			eng::MeshCache::Instance().SetEnabled(settings->General.MeshCache);
+
+		if (!settings->General.MeshCache) {
+			ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
+			ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+		}
+
+		/* MESH CACHE SIZE: */
+		ImGui::Text("3D model cache size (MB): ");
+		ImGui::SameLine();
+		ImGui::PushItemWidth(settings->CalculateSize(100));
+		if (ImGui::InputInt("##optg_meshcachesize", &settings->General.MeshCacheSize, 64, 512)) {
+			settings->General.MeshCacheSize = std::max<int>(1, settings->General.MeshCacheSize);
+			eng::MeshCache::Instance().SetMaxSize((size_t)settings->General.MeshCacheSize * 1024 * 1024);
+		}
+		ImGui::PopItemWidth();
+
+		ImGui::TextDisabled("%d models, %d KB", eng::MeshCache::Instance().GetEntryCount(), (int)(eng::MeshCache::Instance().GetSize() / 1024));
+		ImGui::SameLine();
+		if (ImGui::Button("CLEAR##optg_meshcacheclear"))
+			eng::MeshCache::Instance().Clear();
+
+		if (!settings->General.MeshCache) {
+			ImGui::PopStyleVar();
+			ImGui::PopItemFlag();
+		}
+
+		/* OPTIMIZE MODELS: */
+		ImGui::Text("Optimize 3D models for the vertex cache: ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optg_optimizemodels", &settings->General.OptimizeModels);
+
+		/* OPTIMIZE OVERDRAW: */
+		if (!settings->General.OptimizeModels) {
+			ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
+			ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+		}
+		ImGui::Text("Sort triangles to reduce overdraw: ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optg_optimizeoverdraw", &settings->General.OptimizeModelOverdraw);
+		if (!settings->General.OptimizeModels) {
+			ImGui::PopStyleVar();
+			ImGui::PopItemFlag();
+		}
 	}
 	void OptionsUI::m_renderEditor()
 	{
@@ -993,6 +1102,46 @@ namespace ed {
 		ImGui::Text("Primitive outline: ");
 		ImGui::SameLine();
 		ImGui::Checkbox("##optdbg_primitiveoutline", &settings->Debug.PrimitiveOutline);
+
+		/* PARALLEL ANALYSIS: */
+		ImGui::Text("Multi-threaded frame analysis: ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optdbg_parallelanalysis", &settings->Debug.ParallelAnalysis);
+
+		if (!settings->Debug.ParallelAnalysis) {
+			ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
+			ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+		}
+
+		/* VERIFY PARALLEL ANALYSIS: */
+		ImGui::Text("Compare with the single-threaded analysis: ");
+		ImGui::SameLine();
+		ImGui::Checkbox("##optdbg_verifyparallelanalysis", &settings->Debug.VerifyParallelAnalysis);
+		if (ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+			ImGui::SetTooltip("Runs the frame analysis twice and logs the buffers that differ - a manual check for the current scene, not an automated test");
+
+		if (!settings->Debug.ParallelAnalysis) {
+			ImGui::PopStyleVar();
+			ImGui::PopItemFlag();
+		}
+
+		/* COMPILED ANALYSIS: */
+		bool hasCompiler = CompiledShaderCache::Instance().IsCompilerAvailable();
+		ImGui::Text("Compile the pixel shader for the frame analysis: ");
+		ImGui::SameLine();
+		if (!hasCompiler) {
+			ImGui::PushItemFlag(ImGuiItemFlags_Disabled, true);
+			ImGui::PushStyleVar(ImGuiStyleVar_Alpha, ImGui::GetStyle().Alpha * 0.5f);
+		}
+		ImGui::Checkbox("##optdbg_compiledanalysis", &settings->Debug.CompiledAnalysis);
+		if (!hasCompiler) {
+			ImGui::PopStyleVar();
+			ImGui::PopItemFlag();
+		}
+		if (!hasCompiler && ImGui::IsItemHovered(ImGuiHoveredFlags_AllowWhenDisabled))
+			ImGui::SetTooltip("No C++ compiler was found - set the CXX environment variable");
+		else if (hasCompiler && ImGui::IsItemHovered())
+			ImGui::SetTooltip("Faster, but the heatmap counts whole basic blocks and textures are always sampled with nearest filtering & repeat wrapping");
 	}
 	void OptionsUI::m_renderProject()
 	{
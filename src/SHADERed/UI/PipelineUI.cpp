@@ -246,11 +246,11 @@ namespace ed {
 						pipe::Model* mitem = (pipe::Model*)pitem->Data;
 						BufferObject* bobj = (BufferObject*)mitem->InstanceBuffer;
 						if (bobj == nullptr) {
-							for (auto& mesh : mitem->Data->Meshes)
-								gl::CreateVAO(mesh.VAO, mesh.VBO, pass->InputLayout, mesh.EBO);
+							if (mitem->Data->IsLoaded())
+								gl::CreateVAO(mitem->Data, pass->InputLayout);
 						} else {
-							for (auto& mesh : mitem->Data->Meshes)
-								gl::CreateVAO(mesh.VAO, mesh.VBO, pass->InputLayout, mesh.EBO, bobj->ID, m_data->Objects.ParseBufferFormat(bobj->ViewFormat));
+							if (mitem->Data->IsLoaded())
+								gl::CreateVAO(mitem->Data, pass->InputLayout, bobj->ID, m_data->Objects.ParseBufferFormat(bobj->ViewFormat));
 						}
 					} else if (pitem->Type == PipelineItem::ItemType::VertexBuffer) {
 						pipe::VertexBuffer* mitem = (pipe::VertexBuffer*)pitem->Data;
@@ -357,8 +357,6 @@ namespace ed {
 
 		if (ImGui::Button(std::string(UI_ICON_ARROW_UP "##U" + std::string(items[index]->Name)).c_str(), BUTTON_ICON_SIZE)) {
 			if (index != 0) {
-				m_data->Parser.ModifyProject();
-
 				PropertyUI* props = (reinterpret_cast<PropertyUI*>(m_ui->Get(ViewID::Properties)));
 				std::string oldPropertyItemName = "";
 				if (props->HasItemSelected())
@@ -367,9 +365,7 @@ namespace ed {
 				if (owner != nullptr)
 					owner->Owner->PipelineItem_MoveUp(owner->PluginData, owner->Type, items[index]->Name);
 
-				ed::PipelineItem* temp = items[index - 1];
-				items[index - 1] = items[index];
-				items[index] = temp;
+				m_data->Pipeline.Move(items, index, index - 1);
 
 				if (props->HasItemSelected()) {
 					if (oldPropertyItemName == items[index - 1]->Name)
@@ -383,8 +379,6 @@ namespace ed {
 
 		if (ImGui::Button(std::string(UI_ICON_ARROW_DOWN "##D" + std::string(items[index]->Name)).c_str(), BUTTON_ICON_SIZE)) {
 			if (index != items.size() - 1) {
-				m_data->Parser.ModifyProject();
-
 				PropertyUI* props = (reinterpret_cast<PropertyUI*>(m_ui->Get(ViewID::Properties)));
 				std::string oldPropertyItemName = "";
 				if (props->HasItemSelected())
@@ -393,9 +387,7 @@ namespace ed {
 				if (owner != nullptr)
 					owner->Owner->PipelineItem_MoveDown(owner->PluginData, owner->Type, items[index]->Name);
 
-				ed::PipelineItem* temp = items[index + 1];
-				items[index + 1] = items[index];
-				items[index] = temp;
+				m_data->Pipeline.Move(items, index, index + 1);
 
 				if (props->HasItemSelected()) {
 					if (oldPropertyItemName == items[index + 1]->Name)
@@ -2130,6 +2122,15 @@ namespace ed {
 
 			ImGui::EndDragDropSource();
 		}
+
+		// placeholder until the model is imported
+		if (item->Type == PipelineItem::ItemType::Model) {
+			eng::Model* mdl = ((pipe::Model*)item->Data)->Data;
+			if (mdl != nullptr && mdl->IsLoading()) {
+				ImGui::SameLine();
+				ImGui::TextDisabled("(loading %d%%)", (int)(mdl->GetLoadProgress() * 100.0f));
+			}
+		}
 		ImGui::Unindent(PIPELINE_ITEM_INDENT);
 	}
 	void PipelineUI::m_handleObjectDrop(ed::PipelineItem* pass, ed::ObjectManagerItem* object)
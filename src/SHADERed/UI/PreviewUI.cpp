@@ -465,7 +465,8 @@ namespace ed {
 			if (!paused) {
 				renderer->Render(imageSize.x, imageSize.y);
 				m_data->Objects.Update(delta);
-			}
+			} else if (renderer->IsCompiling())
+				renderer->Render(imageSize.x, imageSize.y); // passes are linked in Render() - keep polling until they are done
 
 			float fps = m_fpsTimer.Restart();
 			if (m_fpsUpdateTime > FPS_UPDATE_RATE) {
@@ -500,6 +501,15 @@ namespace ed {
 		ImGui::Image((void*)displayImagePtr, imageSize, ImVec2(zPos.x, zPos.y + zSize.y), ImVec2(zPos.x + zSize.x, zPos.y));
 		m_hasFocus = ImGui::IsWindowFocused();
 
+		// 3D models are imported in the background and are not drawn until they are uploaded
+		if (m_data->Parser.IsLoadingModels()) {
+			char loadingText[64];
+			snprintf(loadingText, 64, "Loading 3D models... %d%%", (int)(m_data->Parser.GetModelLoadProgress() * 100.0f));
+
+			ImVec2 textPos = ImVec2(ImGui::GetItemRectMin().x + 5.0f, ImGui::GetItemRectMin().y + 5.0f);
+			ImGui::GetWindowDrawList()->AddText(textPos, ImGui::GetColorU32(ImGuiCol_Text), loadingText);
+		}
+
 		// analyzer tooltip
 		if ((m_view == PreviewView::UndefinedBehavior || m_view == PreviewView::Heatmap || m_view == PreviewView::VariableValue) && ImGui::IsItemHovered()) {
 			// heatmap tooltip
@@ -1623,21 +1633,6 @@ namespace ed {
 		}
 		m_data->Analysis.SetBreakpoints(bkpts, bkptColors, bkptPaths);
 
-		// initialize buffers
-		glm::vec4 clearColor = Settings::Instance().Project.ClearColor;
-		clearColor.a = Settings::Instance().Project.UseAlphaChannel ? clearColor.a : 1.0f;
-		m_data->Analysis.Init(m_imgSize.x, m_imgSize.y, clearColor);
-
-		// turn on "region based" rendering
-		if (!m_isAnalyzingFullFrame) {
-			m_data->Analysis.Copy(m_data->Renderer.GetTexture(), m_imgSize.x, m_imgSize.y);
-			float minX = std::min<float>(m_regionEnd.x, m_regionStart.x);
-			float minY = std::min<float>(m_regionStart.y, m_regionEnd.y);
-			float maxX = std::max<float>(m_regionEnd.x, m_regionStart.x);
-			float maxY = std::max<float>(m_regionEnd.y, m_regionStart.y);	
-			m_data->Analysis.SetRegion(minX * m_imgSize.x, (1.0f - maxY) * m_imgSize.y, maxX * m_imgSize.x, (1.0f - minY) * m_imgSize.y);
-		}
-		
 		// find the range of passes to render
 		int passStartPos = -1;
 		int passEndPos = -1;
@@ -1662,10 +1657,44 @@ namespace ed {
 			}
 		}
 
-		// render the pass
-		if (passStartPos != -1 && passEndPos != -1) {
-			for (int i = passStartPos; i <= passEndPos; i++)
-				m_data->Analysis.RenderPass(passes[i]);
+		// optionally run the multi-threaded analysis first and check it against the single-threaded one
+		bool verify = Settings::Instance().Debug.ParallelAnalysis && Settings::Instance().Debug.VerifyParallelAnalysis && !m_data->Analysis.HasGlobalBreakpoints();
+		FrameAnalysis::Output parallelOutput;
+		for (int run = verify ? 0 : 1; run < 2; run++) {
+			m_data->Analysis.SetSingleThreaded(run == 1 && verify);
+
+			// initialize buffers
+			glm::vec4 clearColor = Settings::Instance().Project.ClearColor;
+			clearColor.a = Settings::Instance().Project.UseAlphaChannel ? clearColor.a : 1.0f;
+			m_data->Analysis.Init(m_imgSize.x, m_imgSize.y, clearColor);
+
+			// turn on "region based" rendering
+			if (!m_isAnalyzingFullFrame) {
+				m_data->Analysis.Copy(m_data->Renderer.GetTexture(), m_imgSize.x, m_imgSize.y);
+				float minX = std::min<float>(m_regionEnd.x, m_regionStart.x);
+				float minY = std::min<float>(m_regionStart.y, m_regionEnd.y);
+				float maxX = std::max<float>(m_regionEnd.x, m_regionStart.x);
+				float maxY = std::max<float>(m_regionEnd.y, m_regionStart.y);	
+				m_data->Analysis.SetRegion(minX * m_imgSize.x, (1.0f - maxY) * m_imgSize.y, maxX * m_imgSize.x, (1.0f - minY) * m_imgSize.y);
+			}
+			
+			// render the pass
+			if (passStartPos != -1 && passEndPos != -1) {
+				for (int i = passStartPos; i <= passEndPos; i++)
+					m_data->Analysis.RenderPass(passes[i]);
+			}
+
+			if (run == 0)
+				parallelOutput = m_data->Analysis.GetOutput();
+		}
+		m_data->Analysis.SetSingleThreaded(false);
+
+		if (verify) {
+			std::string differences = FrameAnalysis::CompareOutput(parallelOutput, m_data->Analysis.GetOutput());
+			if (differences.empty())
+				Logger::Get().Log("Multi-threaded frame analysis matches the single-threaded analysis");
+			else
+				Logger::Get().Log("Multi-threaded frame analysis doesn't match the single-threaded analysis: " + differences, true);
 		}
 
 		// build a histogram and other stuff
@@ -1674,6 +1703,7 @@ namespace ed {
 		// TODO: ayo, why didn't I create gl::CreateTexture() ???
 
 		// normal texture
+		uint32_t* colorOutput = m_data->Analysis.AllocateColorOutput();
 		glDeleteTextures(1, &m_viewDebugger);
 		glGenTextures(1, &m_viewDebugger);
 		glBindTexture(GL_TEXTURE_2D, m_viewDebugger);
@@ -1681,10 +1711,11 @@ namespace ed {
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_imgSize.x, m_imgSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, m_data->Analysis.GetColorOutput());
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_imgSize.x, m_imgSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, colorOutput);
+		free(colorOutput);
 	
 		// heatmap
-		float* heatmap = m_data->Analysis.AllocateHeatmap();
+		uint32_t* heatmap = m_data->Analysis.AllocateHeatmap();
 		glDeleteTextures(1, &m_viewHeatmap);
 		glGenTextures(1, &m_viewHeatmap);
 		glBindTexture(GL_TEXTURE_2D, m_viewHeatmap);
@@ -1692,7 +1723,7 @@ namespace ed {
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
 		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_imgSize.x, m_imgSize.y, 0, GL_RGB, GL_FLOAT, heatmap);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, m_imgSize.x, m_imgSize.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, heatmap);
 		free(heatmap);
 
 		// undefined behavior
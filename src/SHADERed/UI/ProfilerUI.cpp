@@ -1,6 +1,8 @@
 #include <SHADERed/AppEvent.h>
 #include <SHADERed/UI/ProfilerUI.h>
 #include <SHADERed/Objects/Settings.h>
+#include <SHADERed/Objects/ShaderVariableContainer.h>
+#include <misc/ImFileDialog.h>
 
 #define IMGUI_DEFINE_MATH_OPERATORS
 #include <imgui/imgui_internal.h>
@@ -29,6 +31,56 @@ namespace ed {
 			timeOffset += timer.LastTime;
 			index++;
 		}
+
+		// CPU side
+		const float rowHeight = Settings::Instance().General.FontSize + 2 * PROFILER_PADDING;
+		ImGui::SetCursorPos(ImVec2(5.0f, ImGui::GetWindowContentRegionMin().y + rowHeight * index + 5.0f));
+		ImGui::Text("Uniform calls: %d", ShaderVariableContainer::GetUniformCallCount());
+		ImGui::SameLine();
+		if (ImGui::Button("Export trace"))
+			ifd::FileDialog::Instance().Save("ProfilerTraceDlg", "Export profiler trace", "Chrome trace (*.json){.json},.*");
+
+		if (ifd::FileDialog::Instance().IsDone("ProfilerTraceDlg")) {
+			if (ifd::FileDialog::Instance().HasResult())
+				m_data->Renderer.ExportProfilerTrace(ifd::FileDialog::Instance().GetResult().u8string());
+			ifd::FileDialog::Instance().Close();
+		}
+
+		// statistics over the last PERFORMANCE_TIMER_HISTORY measurements
+		bool showDraws = Settings::Instance().General.ProfilerDraws;
+		if (ImGui::BeginTable("##profiler_stats", 6, ImGuiTableFlags_Resizable | ImGuiTableFlags_ScrollFreezeTopRow | ImGuiTableFlags_ScrollY)) {
+			ImGui::TableSetupColumn("Item", ImGuiTableColumnFlags_WidthStretch);
+			ImGui::TableSetupColumn("Last", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+			ImGui::TableSetupColumn("Min", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+			ImGui::TableSetupColumn("Avg", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+			ImGui::TableSetupColumn("P95", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+			ImGui::TableSetupColumn("Max", ImGuiTableColumnFlags_WidthFixed, 70.0f);
+			ImGui::TableAutoHeaders();
+
+			m_renderStats("Frame", m_data->Renderer.GetFrameTimer());
+			for (const auto& timer : perfTimers) {
+				m_renderStats(timer.Pass->Name, timer);
+
+				if (showDraws)
+					for (const auto& child : timer.Children)
+						m_renderStats(("    " + std::string(child.Pass->Name)).c_str(), child);
+			}
+
+			ImGui::EndTable();
+		}
+	}
+	void ProfilerUI::m_renderStats(const char* name, const PerformanceTimer& timer)
+	{
+		PerformanceStats stats = timer.GetStats();
+		const uint64_t values[] = { timer.LastTime, stats.Min, stats.Avg, stats.P95, stats.Max };
+
+		ImGui::TableNextRow();
+		ImGui::TableSetColumnIndex(0);
+		ImGui::TextUnformatted(name);
+		for (int i = 0; i < 5; i++) {
+			ImGui::TableSetColumnIndex(i + 1);
+			ImGui::Text("%.4f", values[i] / 1000000.0f);
+		}
 	}
 	void ProfilerUI::m_renderRow(int index, const char* name, uint64_t time, uint64_t timeOffset, uint64_t totalTime)
 	{
@@ -1,6 +1,7 @@
 #pragma once
 #include <SDL2/SDL_events.h>
 #include <SHADERed/UI/UIView.h>
+#include <SHADERed/Objects/PerformanceTimer.h>
 
 namespace ed {
 	struct AppEvent;
@@ -18,5 +19,6 @@ namespace ed {
 
 	private:
 		void m_renderRow(int index, const char* name, uint64_t time, uint64_t timeOffset, uint64_t totalTime);
+		void m_renderStats(const char* name, const PerformanceTimer& timer);
 	};
 }
\ No newline at end of file
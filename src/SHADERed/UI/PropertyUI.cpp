@@ -997,8 +997,8 @@ namespace ed {
 							char* owner = m_data->Pipeline.GetItemOwner(m_current->Name);
 							pipe::ShaderPass* ownerData = (pipe::ShaderPass*)(m_data->Pipeline.Get(owner)->Data);
 
-							for (auto& mesh : item->Data->Meshes)
-								gl::CreateVAO(mesh.VAO, mesh.VBO, ownerData->InputLayout, mesh.EBO);
+							if (item->Data->IsLoaded())
+								gl::CreateVAO(item->Data, ownerData->InputLayout);
 
 							m_data->Parser.ModifyProject();
 						}
@@ -1016,8 +1016,8 @@ namespace ed {
 								char* owner = m_data->Pipeline.GetItemOwner(m_current->Name);
 								pipe::ShaderPass* ownerData = (pipe::ShaderPass*)(m_data->Pipeline.Get(owner)->Data);
 
-								for (auto& mesh : item->Data->Meshes)
-									gl::CreateVAO(mesh.VAO, mesh.VBO, ownerData->InputLayout, mesh.EBO, buf->ID, fmtList);
+								if (item->Data->IsLoaded())
+									gl::CreateVAO(item->Data, ownerData->InputLayout, buf->ID, fmtList);
 
 								m_data->Parser.ModifyProject();
 							}
@@ -1026,6 +1026,54 @@ namespace ed {
 						ImGui::EndCombo();
 					}
 					ImGui::PopItemWidth();
+					ImGui::NextColumn();
+					ImGui::Separator();
+
+					/* vertex format */
+					ImGui::Text("Vertex format:");
+					ImGui::NextColumn();
+
+					const char* vertexFormatNames[] = { "Full", "Compact", "Quantized" };
+					int vertexFormat = (int)item->Data->GetVertexCompression();
+					ImGui::PushItemWidth(-1);
+					if (ImGui::Combo("##pui_mdl_vtxfmt", &vertexFormat, vertexFormatNames, HARRAYSIZE(vertexFormatNames))) {
+						if (item->Data->SetVertexCompression((eng::Model::VertexCompression)vertexFormat))
+							m_data->Parser.RecreateModelVAOs(item->Data); // shared by all items that use this file
+						m_data->Parser.ModifyProject();
+					}
+					ImGui::PopItemWidth();
+					ImGui::NextColumn();
+					ImGui::Separator();
+
+					/* vertex memory */
+					ImGui::Text("Vertex memory:");
+					ImGui::NextColumn();
+
+					if (item->Data->IsLoaded())
+						ImGui::Text("%d KB (%d KB saved)", (int)(item->Data->GetVertexBufferSize() / 1024), (int)((item->Data->GetUncompressedVertexBufferSize() - item->Data->GetVertexBufferSize()) / 1024));
+					else
+						ImGui::Text("-");
+					ImGui::NextColumn();
+					ImGui::Separator();
+
+					/* vertex cache statistics */
+					ImGui::Text("ACMR / ATVR:");
+					ImGui::NextColumn();
+
+					if (item->Data->IsLoaded()) {
+						const eng::MeshOptimizer::Statistics& cur = item->Data->GetCacheStatistics();
+						const eng::MeshOptimizer::Statistics& orig = item->Data->GetOriginalCacheStatistics();
+						if (!item->Data->IsOptimized())
+							ImGui::Text("%.3f / %.3f", cur.GetACMR(), cur.GetATVR());
+						else if (orig.Triangles == 0) // loaded from the cache
+							ImGui::Text("%.3f / %.3f (optimized)", cur.GetACMR(), cur.GetATVR());
+						else
+							ImGui::Text("%.3f / %.3f -> %.3f / %.3f", orig.GetACMR(), orig.GetATVR(), cur.GetACMR(), cur.GetATVR());
+
+						if (ImGui::IsItemHovered())
+							ImGui::SetTooltip("Vertex shader invocations per triangle / per vertex (16 entry FIFO cache)");
+					} else
+						ImGui::Text("-");
 				} 
 				else if (m_current->Type == ed::PipelineItem::ItemType::PluginItem) {
 					ImGui::Columns(1);